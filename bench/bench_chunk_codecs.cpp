@@ -0,0 +1,242 @@
+// 录制块压缩基准
+// - 数据：模拟的传感器信号（每通道若干正弦分量 + 工频干扰 + 高斯噪声），按 24 位 / 16 位 ADC 量化后转为 float32；
+//   另有未量化的白噪声作为最坏情况
+// - 单核：每种编码在单个线程上压缩/解压 1MB 的录制块，报告压缩比、每核 MB/s 与相对实时流速率的倍数
+// - 线程池：用 1..N 个线程（调用线程 + 工作线程）压缩，报告扩展性
+// - 端到端：Recorder 以各编码录制，RecordingReader 逐块解码核对；并检查截掉索引区后的扫描恢复
+// 任何校验失败都以非零退出码返回
+// 用法: bench_chunk_codecs [数据秒数，默认 4] [目录，默认 /tmp]
+#include "Core/CodecPool.h"
+#include "Storage/Recorder.h"
+#include "Storage/RecordingCodec.h"
+#include "Storage/RecordingReader.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr ChunkCodec CODECS[] = {ChunkCodec::XorBytes, ChunkCodec::Gorilla, ChunkCodec::ShuffleRle};
+
+struct Dataset {
+    const char* name;
+    std::vector<uint8_t> packets;    // 通道优先布局的数据包
+    size_t packet_count;
+};
+
+// bits 为 ADC 位数（满量程 ±10V），0 表示不量化的白噪声
+Dataset makeDataset(const char* name, const StreamDescriptor& stream, double seconds, int bits) {
+    Dataset data;
+    data.name = name;
+    data.packet_count = static_cast<size_t>(seconds * stream.packetsPerSecond());
+    data.packets.resize(data.packet_count * stream.packetSize());
+
+    const size_t spp = stream.samples_per_packet;
+    const double lsb = bits > 0 ? 20.0 / double(1 << bits) : 0.0;
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    for (size_t ch = 0; ch < stream.channel_count; ++ch) {
+        const double f1 = 3.0 + ch * 1.7, f2 = 120.0 + ch * 13.0;
+        const double a1 = 2.0 + (ch % 5) * 0.5, a2 = 0.3 + (ch % 3) * 0.1;
+        for (size_t p = 0; p < data.packet_count; ++p) {
+            float* packet = reinterpret_cast<float*>(data.packets.data() + p * stream.packetSize());
+            for (size_t s = 0; s < spp; ++s) {
+                double t = double(p * spp + s) / stream.sample_rate;
+                double value;
+                if (bits > 0) {
+                    value = a1 * std::sin(2 * M_PI * f1 * t) + a2 * std::sin(2 * M_PI * f2 * t) +
+                            0.05 * std::sin(2 * M_PI * 50.0 * t) + 0.002 * noise(rng);
+                    value = std::round(value / lsb) * lsb;
+                } else {
+                    value = noise(rng);
+                }
+                packet[ch * spp + s] = static_cast<float>(value);
+            }
+        }
+    }
+    return data;
+}
+
+struct CodecResult {
+    double ratio = 0.0;
+    double encode_mbps = 0.0;
+    double decode_mbps = 0.0;
+    size_t errors = 0;
+};
+
+// 按录制块大小切分，逐块压缩再解压，返回原始数据量对应的吞吐
+CodecResult measure(const StreamDescriptor& stream, const Dataset& data, ChunkCodec codec, CodecPool& pool,
+                    bool verify) {
+    const size_t packets_per_chunk =
+        (Recorder::DEFAULT_CHUNK_SIZE - RecordingFormat::CHUNK_HEADER_SIZE) / stream.packetSize();
+    RecordingChunkEncoder encoder(stream, packets_per_chunk, codec);
+    const size_t chunk_count = (data.packet_count + packets_per_chunk - 1) / packets_per_chunk;
+    std::vector<std::vector<uint8_t>> encoded(chunk_count, std::vector<uint8_t>(encoder.maxPayloadSize()));
+    std::vector<size_t> sizes(chunk_count);
+
+    CodecResult result;
+    size_t stored = 0;
+    Clock::time_point start = Clock::now();
+    for (size_t c = 0; c < chunk_count; ++c) {
+        size_t first = c * packets_per_chunk;
+        size_t count = std::min(packets_per_chunk, data.packet_count - first);
+        sizes[c] = encoder.encode(data.packets.data() + first * stream.packetSize(), count, encoded[c].data(), pool);
+        stored += sizes[c];
+    }
+    double encode_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<uint8_t> decoded(packets_per_chunk * stream.packetSize());
+    std::vector<float> scratch;
+    double decode_seconds = 0.0;
+    for (size_t c = 0; c < chunk_count; ++c) {
+        size_t first = c * packets_per_chunk;
+        size_t count = std::min(packets_per_chunk, data.packet_count - first);
+        start = Clock::now();
+        bool ok = decodeRecordingChunk(stream, encoded[c].data(), sizes[c], count, decoded.data(), scratch, pool);
+        decode_seconds += std::chrono::duration<double>(Clock::now() - start).count();
+        if (verify && (!ok || std::memcmp(decoded.data(), data.packets.data() + first * stream.packetSize(),
+                                          count * stream.packetSize()) != 0)) {
+            if (result.errors == 0) {
+                std::printf("  %s/%s: chunk %zu does not round-trip\n", data.name, chunkCodecName(codec), c);
+            }
+            ++result.errors;
+        }
+    }
+
+    const double raw_mb = data.packets.size() / 1e6;
+    result.ratio = double(data.packets.size()) / stored;
+    result.encode_mbps = raw_mb / encode_seconds;
+    result.decode_mbps = raw_mb / decode_seconds;
+    return result;
+}
+
+// Recorder 以 codec 录制 data，读回逐包核对；再截掉索引区，检查扫描恢复的块数
+size_t recordAndVerify(const StreamDescriptor& stream, const Dataset& data, ChunkCodec codec,
+                       const std::string& path) {
+    Recorder recorder;
+    if (!recorder.open(path, stream, Recorder::DEFAULT_CHUNK_SIZE, Recorder::DEFAULT_BUFFER_COUNT, codec)) return 1;
+    const size_t batch_packets = 16;
+    const size_t packets_per_chunk =
+        (Recorder::DEFAULT_CHUNK_SIZE - RecordingFormat::CHUNK_HEADER_SIZE) / stream.packetSize();
+    for (size_t first = 0; first < data.packet_count; first += batch_packets) {
+        PacketBatch batch;
+        batch.data = data.packets.data() + first * stream.packetSize();
+        batch.packet_count = std::min(batch_packets, data.packet_count - first);
+        batch.packet_size = stream.packetSize();
+        recorder.append(batch);
+        // 不测磁盘带宽：按写线程的进度节流，保证不丢包
+        while ((first + batch.packet_count) / packets_per_chunk >
+               recorder.getStats().chunks_written + Recorder::DEFAULT_BUFFER_COUNT / 2) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    recorder.close();
+    RecorderStats stats = recorder.getStats();
+
+    size_t errors = 0;
+    uint64_t last_offset = 0;
+    size_t chunk_count = 0;
+    {
+        RecordingReader reader;
+        if (!reader.open(path) || reader.codec() != codec || reader.recovered()) {
+            std::printf("  record %s: cannot reopen with the expected codec and index\n", chunkCodecName(codec));
+            return errors + 1;
+        }
+        std::vector<uint8_t> packets;
+        uint64_t sequence = 0;
+        for (size_t chunk = 0; chunk < reader.chunkCount(); ++chunk) {
+            const RecordingIndexEntry& info = reader.chunkInfo(chunk);
+            if (!reader.decodeChunk(chunk, packets) || info.first_sample != sequence * stream.samples_per_packet ||
+                std::memcmp(packets.data(), data.packets.data() + sequence * stream.packetSize(), packets.size()) != 0) {
+                if (errors == 0) std::printf("  record %s: chunk %zu does not match\n", chunkCodecName(codec), chunk);
+                ++errors;
+            }
+            sequence += info.packet_count;
+            last_offset = info.file_offset + info.stored_size;
+        }
+        chunk_count = reader.chunkCount();
+        if (sequence != data.packet_count || stats.dropped_packets != 0) {
+            std::printf("  record %s: %lu packets read back, %lu dropped, expected %zu\n", chunkCodecName(codec),
+                        static_cast<unsigned long>(sequence), static_cast<unsigned long>(stats.dropped_packets),
+                        data.packet_count);
+            ++errors;
+        }
+    }
+
+    // 模拟异常退出：去掉索引区后按块头扫描
+    if (truncate(path.c_str(), static_cast<off_t>(last_offset)) == 0) {
+        RecordingReader reader;
+        if (!reader.open(path) || !reader.recovered() || reader.chunkCount() != chunk_count) {
+            std::printf("  record %s: recovery found %zu of %zu chunks\n", chunkCodecName(codec),
+                        reader.chunkCount(), chunk_count);
+            ++errors;
+        }
+    }
+
+    std::printf("record   %-12s %8.1f MB -> %8.1f MB on disk (%5.2fx), %zu chunks, %zu errors\n",
+                chunkCodecName(codec), stats.packet_bytes / 1e6, stats.bytes_written / 1e6,
+                stats.bytes_written ? double(stats.packet_bytes) / stats.bytes_written : 0.0, chunk_count, errors);
+    unlink(path.c_str());
+    return errors;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 4.0;
+    std::string dir = argc > 2 ? argv[2] : "/tmp";
+
+    StreamDescriptor stream;
+    const double stream_mbps = stream.packetsPerSecond() * stream.packetSize() / 1e6;
+    std::printf("stream: %zu channels @ %.0f Hz float32 = %.1f MB/s\n\n", stream.channel_count, stream.sample_rate,
+                stream_mbps);
+
+    std::vector<Dataset> datasets;
+    datasets.push_back(makeDataset("adc24", stream, seconds, 24));
+    datasets.push_back(makeDataset("adc16", stream, seconds, 16));
+    datasets.push_back(makeDataset("noise", stream, seconds, 0));
+
+    size_t errors = 0;
+    CodecPool single(0);
+    std::printf("%-6s %-12s %6s %14s %14s %12s\n", "data", "codec", "ratio", "encode MB/s", "decode MB/s",
+                "x realtime");
+    for (const Dataset& data : datasets) {
+        for (ChunkCodec codec : CODECS) {
+            CodecResult result = measure(stream, data, codec, single, true);
+            errors += result.errors;
+            std::printf("%-6s %-12s %6.2f %14.0f %14.0f %12.1f\n", data.name, chunkCodecName(codec), result.ratio,
+                        result.encode_mbps, result.decode_mbps, result.encode_mbps / stream_mbps);
+        }
+    }
+
+    // 线程池扩展性：调用线程 + (threads - 1) 个工作线程
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("\npool scaling (adc24, encode MB/s):\n");
+    for (size_t threads = 1; threads <= std::min<size_t>(hardware, 8); threads *= 2) {
+        CodecPool pool(threads - 1);
+        std::printf("  %zu thread%s:", threads, threads > 1 ? "s" : " ");
+        for (ChunkCodec codec : CODECS) {
+            CodecResult result = measure(stream, datasets[0], codec, pool, false);
+            std::printf("  %s %.0f", chunkCodecName(codec), result.encode_mbps);
+        }
+        std::printf("\n");
+    }
+
+    std::printf("\n");
+    for (ChunkCodec codec : {ChunkCodec::Raw, ChunkCodec::XorBytes, ChunkCodec::Gorilla, ChunkCodec::ShuffleRle}) {
+        errors += recordAndVerify(stream, datasets[0], codec, dir + "/sensormonitor_bench_codec.rec");
+    }
+
+    std::printf("\nverification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+// 数据包解码内核的正确性校验与微基准
+// 1. 对每种样本类型、排列方式和若干几何尺寸（含环尾回绕、非整块的通道数/样本数），带与不带包头，
+//    用各个可用指令集的内核解码，与独立的标量参考实现逐位比较
+// 2. 默认几何（128通道 x 8样本/包，每批64包）下测量各内核的解码带宽
+// 任何不一致都以非零退出码返回
+// 用法: bench_decode_kernels [每个基准的最短秒数，默认 0.5]
+#include "Core/PacketDecoder.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr DecodeIsa ISAS[] = {DecodeIsa::Scalar, DecodeIsa::Sse2, DecodeIsa::Avx2};
+constexpr SampleType TYPES[] = {SampleType::Float32, SampleType::Int16, SampleType::Int24};
+constexpr SampleLayout LAYOUTS[] = {SampleLayout::ChannelMajor, SampleLayout::Interleaved};
+
+// 参考实现：逐个样本按定义解码
+float referenceSample(const StreamDescriptor& stream, const uint8_t* packet, size_t channel, size_t sample) {
+    size_t index = stream.layout == SampleLayout::ChannelMajor ? channel * stream.samples_per_packet + sample
+                                                               : sample * stream.channel_count + channel;
+    const uint8_t* p = packet + index * stream.bytesPerSample();
+    switch (stream.sample_type) {
+    case SampleType::Int16: {
+        int16_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value / 32768.0f;
+    }
+    case SampleType::Int24: {
+        int32_t value = p[0] | (p[1] << 8) | (p[2] << 16);
+        if (value & 0x800000) value -= 0x1000000;
+        return value / 8388608.0f;
+    }
+    default: {
+        float value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    }
+}
+
+std::vector<uint8_t> randomPackets(const StreamDescriptor& stream, size_t packet_count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data(stream.packetSize() * packet_count);
+    if (stream.sample_type == SampleType::Float32) {
+        std::normal_distribution<float> dist(0.0f, 100.0f);
+        for (size_t i = 0; i < data.size() / sizeof(float); ++i) {
+            float value = dist(rng);
+            std::memcpy(data.data() + i * sizeof(float), &value, sizeof(value));
+        }
+    } else {
+        for (auto& byte : data) byte = static_cast<uint8_t>(rng());
+    }
+    return data;
+}
+
+// 解码 packet_count 个包（分两批，覆盖批边界），比较环中保留的最近样本
+size_t verify(const StreamDescriptor& stream, DecodeIsa isa, size_t packet_count, size_t ring_samples) {
+    std::vector<uint8_t> data = randomPackets(stream, packet_count, 1234);
+    ChannelRingStore store(stream.channel_count, ring_samples);
+    PacketDecoder decoder(stream, isa);
+
+    size_t split = packet_count / 3;
+    PacketBatch batch;
+    batch.packet_size = stream.packetSize();
+    batch.data = data.data();
+    batch.packet_count = split;
+    decoder.decode(batch, store);
+    batch.data = data.data() + split * batch.packet_size;
+    batch.packet_count = packet_count - split;
+    decoder.decode(batch, store);
+    store.publish();
+
+    uint64_t total = static_cast<uint64_t>(packet_count) * stream.samples_per_packet;
+    uint64_t first = total > store.capacity() ? total - store.capacity() : 0;
+    size_t mismatches = 0;
+    for (size_t ch = 0; ch < stream.channel_count; ++ch) {
+        const float* ring = store.channelData(ch);
+        for (uint64_t index = first; index < total; ++index) {
+            const uint8_t* packet = data.data() + (index / stream.samples_per_packet) * stream.packetSize() +
+                                    stream.headerSize();
+            float expected = referenceSample(stream, packet, ch, index % stream.samples_per_packet);
+            float actual = ring[index & store.mask()];
+            if (std::memcmp(&expected, &actual, sizeof(float)) != 0) {
+                if (mismatches < 3) {
+                    std::printf("  mismatch: %s %s %zux%zu%s %s ch %zu index %lu: %.9g vs %.9g\n",
+                                sampleTypeName(stream.sample_type), sampleLayoutName(stream.layout),
+                                stream.channel_count, stream.samples_per_packet,
+                                stream.packet_header ? " +header" : "", PacketDecoder::isaName(isa),
+                                ch, static_cast<unsigned long>(index), expected, actual);
+                }
+                ++mismatches;
+            }
+        }
+    }
+    return mismatches;
+}
+
+void benchmark(const StreamDescriptor& stream, DecodeIsa isa, double min_seconds) {
+    const size_t batch_packets = 64;
+    std::vector<uint8_t> data = randomPackets(stream, batch_packets, 99);
+    ChannelRingStore store(stream.channel_count, 50000);
+    PacketDecoder decoder(stream, isa);
+
+    PacketBatch batch;
+    batch.data = data.data();
+    batch.packet_count = batch_packets;
+    batch.packet_size = stream.packetSize();
+
+    size_t iterations = 0;
+    auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        for (int i = 0; i < 64; ++i) {
+            decoder.decode(batch, store);
+            store.publish();
+        }
+        iterations += 64;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < min_seconds);
+
+    double ns_per_batch = elapsed * 1e9 / iterations;
+    double input_bytes = static_cast<double>(batch.byteSize()) * iterations;
+    double output_bytes = static_cast<double>(batch_packets) * stream.channel_count *
+                          stream.samples_per_packet * sizeof(float) * iterations;
+    char name[96];
+    std::snprintf(name, sizeof(name), "BM_Decode/%s/%s/%s", sampleTypeName(stream.sample_type),
+                  sampleLayoutName(stream.layout), PacketDecoder::isaName(isa));
+    std::printf("%-44s %10.0f ns %10zu  in %6.2f GB/s  out %6.2f GB/s  %9.2f Mpackets/s\n",
+                name, ns_per_batch, iterations, input_bytes / elapsed / 1e9, output_bytes / elapsed / 1e9,
+                batch_packets * iterations / elapsed / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double min_seconds = argc > 1 ? std::atof(argv[1]) : 0.5;
+
+    // 几何尺寸：默认格式、非整块的通道数和样本数、较小的环（频繁回绕）
+    struct Geometry { size_t channels; size_t samples; size_t ring; };
+    const Geometry geometries[] = {{128, 8, 4096}, {37, 8, 64}, {64, 5, 64}, {19, 16, 256}, {1024, 4, 64}};
+
+    size_t mismatches = 0;
+    size_t cases = 0;
+    for (DecodeIsa isa : ISAS) {
+        if (!PacketDecoder::isSupported(isa)) {
+            std::printf("%s: not supported on this CPU/build, skipped\n", PacketDecoder::isaName(isa));
+            continue;
+        }
+        for (SampleType type : TYPES) {
+            for (SampleLayout layout : LAYOUTS) {
+                for (const Geometry& g : geometries) {
+                    for (bool header : {false, true}) {
+                        StreamDescriptor stream;
+                        stream.channel_count = g.channels;
+                        stream.samples_per_packet = g.samples;
+                        stream.sample_type = type;
+                        stream.layout = layout;
+                        stream.packet_header = header;
+                        mismatches += verify(stream, isa, 97, g.ring);
+                        ++cases;
+                    }
+                }
+            }
+        }
+    }
+    std::printf("bit-exactness: %zu cases, %zu mismatched samples\n\n", cases, mismatches);
+
+    std::printf("%-44s %13s %10s\n", "Benchmark (128ch x 8, 64 packets/batch)", "Time/batch", "Iterations");
+    for (SampleType type : TYPES) {
+        for (SampleLayout layout : LAYOUTS) {
+            for (DecodeIsa isa : ISAS) {
+                if (!PacketDecoder::isSupported(isa)) continue;
+                StreamDescriptor stream;
+                stream.sample_type = type;
+                stream.layout = layout;
+                benchmark(stream, isa, min_seconds);
+            }
+        }
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+// 显示流水线运行时的写入延迟基准
+// 写入线程按流速率（或尽可能快）调用 addBinaryPacket，模拟的UI线程按60Hz请求并读取显示帧，
+// 统计每个数据包写入耗时的分位数，并校验显示帧内容与写入数据一致、只改变通道范围时也会生成新帧
+// 用法: bench_display_pipeline [seconds] [rate_multiplier，0表示不限速] [pacing 0|1]
+#include "Core/DataManager.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t CHANNEL_COUNT = StreamFormat::CHANNEL_COUNT;
+constexpr size_t SAMPLES_PER_PACKET = StreamFormat::SAMPLES_PER_PACKET;
+constexpr double SAMPLE_RATE = StreamFormat::SAMPLE_RATE;
+
+using Clock = std::chrono::steady_clock;
+
+float sampleValue(uint64_t sample_index, size_t channel) {
+    return static_cast<float>((sample_index * 131 + channel) % 4096);
+}
+
+void fillPacket(std::vector<uint8_t>& packet, uint64_t first_sample) {
+    float* samples = reinterpret_cast<float*>(packet.data());
+    for (size_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+        for (size_t s = 0; s < SAMPLES_PER_PACKET; ++s) {
+            samples[ch * SAMPLES_PER_PACKET + s] = sampleValue(first_sample + s, ch);
+        }
+    }
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+    double rate_multiplier = argc > 2 ? std::atof(argv[2]) : 1.0;
+    bool pacing = argc > 3 ? std::atoi(argv[3]) != 0 : true;
+
+    DataManager manager;
+    manager.setFramePacing(pacing);
+    manager.setProcessingEnabled(true);
+
+    std::atomic<bool> done{false};
+    size_t frames_seen = 0;
+    size_t frames_checked = 0;
+    size_t frames_mismatched = 0;
+
+    // 模拟UI线程：60Hz 请求并读取显示帧
+    std::thread ui([&] {
+        uint64_t last_generation = 0;
+        auto next = Clock::now();
+        while (!done) {
+            manager.requestDisplayFrame();
+            const DisplayFrame& frame = manager.acquireDisplayFrame();
+            if (frame.generation != last_generation) {
+                last_generation = frame.generation;
+                ++frames_seen;
+                if (frame.sample_count > 0) {
+                    ++frames_checked;
+                    bool ok = true;
+                    for (size_t ch = frame.channel_first; ch < frame.channel_first + frame.channel_count && ok; ++ch) {
+                        const float* values = frame.channel(ch);
+                        for (size_t i = 0; i < frame.sample_count; ++i) {
+                            if (values[frame.physicalIndex(i)] != sampleValue(frame.first_sample + i, ch)) {
+                                ok = false;
+                                break;
+                            }
+                        }
+                    }
+                    if (!ok) ++frames_mismatched;
+                }
+            }
+            next += std::chrono::microseconds(16667);
+            std::this_thread::sleep_until(next);
+        }
+    });
+
+    std::vector<uint8_t> packet(CHANNEL_COUNT * SAMPLES_PER_PACKET * sizeof(float));
+    std::vector<double> latencies_us;
+    latencies_us.reserve(static_cast<size_t>(seconds * SAMPLE_RATE / SAMPLES_PER_PACKET * std::max(1.0, rate_multiplier) * 1.1) + 1024);
+
+    double packet_interval = rate_multiplier > 0 ? SAMPLES_PER_PACKET / (SAMPLE_RATE * rate_multiplier) : 0.0;
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    uint64_t sample_index = 0;
+    size_t packets = 0;
+
+    while (Clock::now() < deadline) {
+        fillPacket(packet, sample_index);
+
+        auto t0 = Clock::now();
+        manager.addBinaryPacket(packet);
+        auto t1 = Clock::now();
+        latencies_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+
+        sample_index += SAMPLES_PER_PACKET;
+        ++packets;
+
+        if (packet_interval > 0) {
+            auto next = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(packets * packet_interval));
+            while (Clock::now() < next) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    done = true;
+    ui.join();
+
+    // 写入停止后只改变通道范围（滚动通道列表）：显示线程仍须按新范围生成一帧
+    auto waitForRange = [&](size_t first, size_t count) {
+        manager.setDisplayChannels(first, count);
+        const auto range_deadline = Clock::now() + std::chrono::seconds(2);
+        while (Clock::now() < range_deadline) {
+            manager.requestDisplayFrame();
+            const DisplayFrame& frame = manager.acquireDisplayFrame();
+            if (frame.channel_first == first && frame.channel_count == count) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    };
+    const bool range_ok = waitForRange(0, 8) && waitForRange(16, 8) && waitForRange(16, 4);
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    std::printf("packets: %zu in %.2f s (%.0f packets/s, %.1fx stream rate), frame pacing: %s\n",
+                packets, elapsed, packets / elapsed,
+                packets / elapsed / (SAMPLE_RATE / SAMPLES_PER_PACKET), pacing ? "on" : "off");
+    std::printf("ingest latency (us): p50 %.2f  p90 %.2f  p99 %.2f  p99.9 %.2f  max %.2f\n",
+                percentile(latencies_us, 0.50), percentile(latencies_us, 0.90),
+                percentile(latencies_us, 0.99), percentile(latencies_us, 0.999),
+                latencies_us.empty() ? 0.0 : latencies_us.back());
+    std::printf("display frames: %zu seen, %zu checked, %zu mismatched; channel range changes without new data: %s\n",
+                frames_seen, frames_checked, frames_mismatched, range_ok ? "ok" : "no new frame");
+    return frames_mismatched == 0 && range_ok ? 0 : 1;
+}
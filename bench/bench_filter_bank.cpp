@@ -0,0 +1,424 @@
+// 多通道滤波链的校验与开销基准
+// - 系数：二阶节与模拟原型经双线性变换（预畸变）得到的参考系数比对，并在若干频率上检查幅频响应；
+//   FIR 的直流增益、对称性（线性相位）与阻带衰减
+// - 流式：100 个通道（不是组宽的整数倍）按随机大小的块经环形缓冲（含回绕）就地滤波，
+//   与逐通道的双精度参考实现比对，覆盖每个可用指令集、块之间的状态保留、NaN 缺口与 FIR 抽取相位
+// - 效果：50Hz 陷波的稳态衰减，直流隔离后的残余，抽取 FIR 插值后的误差；DataManager 写入路径上滤波生效
+// - 开销：128 通道每批 64 包时，每通道每样本的耗时与实时数据流占一个核心的比例
+// 校验失败时以非零退出码返回
+// 用法: bench_filter_bank [seconds，默认 4]
+#include "Core/ChannelFilterBank.h"
+#include "Core/ChannelRingStore.h"
+#include "Core/DataManager.h"
+#include "Core/StreamFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double SAMPLE_RATE = StreamFormat::SAMPLE_RATE;
+constexpr double PI = 3.14159265358979323846;
+
+using Clock = std::chrono::steady_clock;
+
+// 模拟原型 (n2 s² + n1 s + n0) / (d2 s² + d1 s + d0)（归一化到 ω = 1），
+// 经 s = K (1 - z⁻¹) / (1 + z⁻¹)，K = 1 / tan(w0 / 2) 变换
+BiquadCoefficients bilinearReference(FilterType type, double frequency, double q) {
+    double n2 = 0.0, n1 = 0.0, n0 = 0.0;
+    switch (type) {
+    case FilterType::LowPass: n0 = 1.0; break;
+    case FilterType::HighPass: n2 = 1.0; break;
+    case FilterType::BandPass: n1 = 1.0 / q; break;
+    case FilterType::Notch: n2 = 1.0; n0 = 1.0; break;
+    default: break;
+    }
+    const double d2 = 1.0, d1 = 1.0 / q, d0 = 1.0;
+    const double k = 1.0 / std::tan(PI * frequency / SAMPLE_RATE);
+    const double a0 = d2 * k * k + d1 * k + d0;
+    BiquadCoefficients c;
+    c.b0 = (n2 * k * k + n1 * k + n0) / a0;
+    c.b1 = 2.0 * (n0 - n2 * k * k) / a0;
+    c.b2 = (n2 * k * k - n1 * k + n0) / a0;
+    c.a1 = 2.0 * (d0 - d2 * k * k) / a0;
+    c.a2 = (d2 * k * k - d1 * k + d0) / a0;
+    return c;
+}
+
+double magnitude(const BiquadCoefficients& c, double frequency) {
+    const std::complex<double> z1 = std::polar(1.0, -2.0 * PI * frequency / SAMPLE_RATE);
+    const std::complex<double> z2 = z1 * z1;
+    return std::abs((c.b0 + c.b1 * z1 + c.b2 * z2) / (1.0 + c.a1 * z1 + c.a2 * z2));
+}
+
+double firMagnitude(const std::vector<double>& h, double frequency) {
+    std::complex<double> sum = 0.0;
+    for (size_t n = 0; n < h.size(); ++n) {
+        sum += h[n] * std::polar(1.0, -2.0 * PI * frequency * n / SAMPLE_RATE);
+    }
+    return std::abs(sum);
+}
+
+size_t checkCoefficients() {
+    size_t errors = 0;
+    double worst = 0.0;
+    const FilterType types[] = {FilterType::LowPass, FilterType::HighPass, FilterType::BandPass, FilterType::Notch};
+    const double frequencies[] = {5.0, 50.0, 1000.0, 9000.0};
+    const double qs[] = {0.5, 0.7071, 2.0, 30.0};
+    for (FilterType type : types) {
+        for (double frequency : frequencies) {
+            for (double q : qs) {
+                const BiquadCoefficients c = designBiquad(type, frequency, q, SAMPLE_RATE);
+                const BiquadCoefficients r = bilinearReference(type, frequency, q);
+                const double diffs[] = {c.b0 - r.b0, c.b1 - r.b1, c.b2 - r.b2, c.a1 - r.a1, c.a2 - r.a2};
+                for (double d : diffs) worst = std::max(worst, std::fabs(d));
+            }
+        }
+    }
+
+    // 幅频响应：高低通在截止频率处为 Q（Q = 0.7071 即 -3dB），带通中心为 1，陷波中心为 0，直流隔离直流为 0
+    struct Point { FilterType type; double frequency, q, at, expected, tolerance; };
+    const Point points[] = {
+        {FilterType::LowPass, 2000.0, 0.7071, 2000.0, 0.7071, 1e-9},
+        {FilterType::LowPass, 2000.0, 0.7071, 0.0, 1.0, 1e-12},
+        {FilterType::HighPass, 5.0, 0.7071, 5.0, 0.7071, 1e-9},
+        {FilterType::HighPass, 5.0, 0.7071, 0.0, 0.0, 1e-12},
+        {FilterType::BandPass, 1000.0, 2.0, 1000.0, 1.0, 1e-9},
+        {FilterType::Notch, 50.0, 30.0, 50.0, 0.0, 1e-9},
+        {FilterType::Notch, 50.0, 30.0, 1000.0, 1.0, 1e-3},
+        {FilterType::DcBlock, 0.5, 0.0, 0.0, 0.0, 1e-12},
+        {FilterType::DcBlock, 0.5, 0.0, 50.0, 1.0, 1e-3},
+    };
+    size_t response_errors = 0;
+    for (const Point& p : points) {
+        const double gain = magnitude(designBiquad(p.type, p.frequency, p.q, SAMPLE_RATE), p.at);
+        if (std::fabs(gain - p.expected) > p.tolerance) {
+            std::printf("coefficients: %s %.1f Hz: gain %.6f at %.1f Hz, expected %.6f\n",
+                        filterTypeName(p.type), p.frequency, gain, p.at, p.expected);
+            ++response_errors;
+        }
+    }
+
+    const std::vector<double> h = designLowPassFir(63, 1000.0, SAMPLE_RATE);
+    double asymmetry = 0.0;
+    for (size_t n = 0; n < h.size(); ++n) asymmetry = std::max(asymmetry, std::fabs(h[n] - h[h.size() - 1 - n]));
+    const double dc = firMagnitude(h, 0.0);
+    const double at_cutoff = firMagnitude(h, 1000.0);
+    double stopband = 0.0;
+    for (double f = 2600.0; f < SAMPLE_RATE / 2; f += 25.0) stopband = std::max(stopband, firMagnitude(h, f));
+
+    std::printf("coefficients: max |cookbook - bilinear reference| %.2e, %zu response errors; "
+                "FIR 63 taps: dc %.9f, cutoff %.3f, stopband %.1f dB, asymmetry %.1e\n",
+                worst, response_errors, dc, at_cutoff, 20.0 * std::log10(stopband), asymmetry);
+    errors += response_errors;
+    if (worst > 1e-12) ++errors;
+    if (std::fabs(dc - 1.0) > 1e-9 || std::fabs(at_cutoff - 0.5) > 0.02 || stopband > std::pow(10.0, -50.0 / 20.0) ||
+        asymmetry > 1e-15) {
+        ++errors;
+    }
+    return errors;
+}
+
+// 逐通道的双精度参考实现：与滤波链的约定相同（FIR 抽头取 float 量化后的值，NaN 按 0 送入状态并原样输出）
+struct ReferenceChain {
+    struct Stage {
+        bool fir = false;
+        std::vector<double> c;
+        size_t decimation = 1;
+        double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+        std::vector<double> history;
+        std::deque<double> lows;        // 抽取输出，front 最新
+        size_t phase = 0;
+    };
+    std::vector<Stage> stages;
+
+    ReferenceChain(const std::vector<FilterStage>& chain) {
+        for (const FilterStage& s : chain) {
+            Stage stage;
+            if (s.type == FilterType::DecimatingFir) {
+                stage.fir = true;
+                for (double tap : designLowPassFir(s.taps, s.frequency, SAMPLE_RATE)) stage.c.push_back(float(tap));
+                stage.decimation = s.decimation;
+                stage.history.assign(s.taps, 0.0);
+                stage.lows.assign(s.decimation > 1 ? (s.taps + s.decimation - 1) / s.decimation : 0, 0.0);
+            } else {
+                const BiquadCoefficients b = designBiquad(s.type, s.frequency, s.q, SAMPLE_RATE);
+                stage.c = {b.b0, b.b1, b.b2, b.a1, b.a2};
+            }
+            stages.push_back(stage);
+        }
+    }
+
+    double step(float input) {
+        double x = std::isnan(input) ? 0.0 : input;
+        for (Stage& s : stages) {
+            if (!s.fir) {
+                const double y = s.c[0] * x + s.c[1] * s.x1 + s.c[2] * s.x2 - s.c[3] * s.y1 - s.c[4] * s.y2;
+                s.x2 = s.x1; s.x1 = x; s.y2 = s.y1; s.y1 = y;
+                x = y;
+            } else {
+                std::rotate(s.history.rbegin(), s.history.rbegin() + 1, s.history.rend());
+                s.history[0] = x;
+                if (s.phase == 0) {
+                    double low = 0.0;
+                    for (size_t k = 0; k < s.c.size(); ++k) low += s.c[k] * s.history[k];
+                    if (s.lows.empty()) {
+                        x = low;
+                        continue;
+                    }
+                    s.lows.pop_back();
+                    s.lows.push_front(low);
+                }
+                // 补零上采样后以 D * h 插值：相位 p 的输出只用到 h[p + mD]
+                double y = 0.0;
+                for (size_t m = 0, k = s.phase; k < s.c.size(); ++m, k += s.decimation) {
+                    y += s.decimation * s.c[k] * s.lows[m];
+                }
+                s.phase = s.phase + 1 == s.decimation ? 0 : s.phase + 1;
+                x = y;
+            }
+        }
+        return std::isnan(input) ? input : x;
+    }
+};
+
+std::vector<FilterStage> fullChain() {
+    std::vector<FilterStage> chain(6);
+    chain[0].type = FilterType::DcBlock; chain[0].frequency = 0.5;
+    chain[1].type = FilterType::Notch; chain[1].frequency = 50.0; chain[1].q = 30.0;
+    chain[2].type = FilterType::HighPass; chain[2].frequency = 5.0;
+    chain[3].type = FilterType::LowPass; chain[3].frequency = 4000.0;
+    chain[4].type = FilterType::BandPass; chain[4].frequency = 1000.0; chain[4].q = 0.5;
+    chain[5].type = FilterType::DecimatingFir; chain[5].frequency = 2000.0; chain[5].taps = 63; chain[5].decimation = 4;
+    return chain;
+}
+
+float inputSample(uint64_t index, size_t channel) {
+    constexpr size_t GAP_CHANNEL = 17;
+    if (channel == GAP_CHANNEL && index >= 5000 && index < 5100) return std::nanf("");
+    const double t = index / SAMPLE_RATE;
+    const double noise = ((index * 2654435761u + channel * 40503u) % 1000) / 1000.0 - 0.5;
+    return static_cast<float>(1.5 + 0.1 * channel + 0.8 * std::sin(2.0 * PI * 50.0 * t) +
+                              0.3 * std::sin(2.0 * PI * (300.0 + 10.0 * channel) * t) + 0.1 * noise);
+}
+
+size_t checkStreaming(DecodeIsa isa, size_t total_samples) {
+    constexpr size_t CHANNELS = 100;
+    const std::vector<FilterStage> chain = fullChain();
+    ChannelFilterBank bank(CHANNELS, SAMPLE_RATE, isa);
+    bank.configure(chain);
+    ChannelRingStore store(CHANNELS, 4096);
+    std::vector<ReferenceChain> reference(CHANNELS, ReferenceChain(chain));
+
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<size_t> block_size(1, 500);
+    std::vector<float> block;
+    double worst = 0.0;
+    size_t nan_mismatches = 0;
+    uint64_t written = 0;
+    while (written < total_samples) {
+        const size_t count = std::min<size_t>(std::min(block_size(rng), store.maxCommitSamples()), total_samples - written);
+        block.resize(count);
+        const uint64_t first = store.pendingIndex();
+        for (size_t ch = 0; ch < CHANNELS; ++ch) {
+            for (size_t i = 0; i < count; ++i) block[i] = inputSample(written + i, ch);
+            store.writeChannel(ch, block.data(), count);
+        }
+        store.commit(count);
+        bank.process(store, first, count);
+        store.publish();
+
+        for (size_t ch = 0; ch < CHANNELS; ++ch) {
+            store.copyChannel(ch, first, count, block.data());
+            for (size_t i = 0; i < count; ++i) {
+                const double expected = reference[ch].step(inputSample(written + i, ch));
+                if (std::isnan(expected) || std::isnan(block[i])) {
+                    nan_mismatches += std::isnan(expected) != std::isnan(block[i]) ? 1 : 0;
+                    continue;
+                }
+                worst = std::max(worst, std::fabs(block[i] - expected));
+            }
+        }
+        written += count;
+    }
+    std::printf("streaming [%s, %zu channels per group]: %zu channels x %zu samples in random blocks, "
+                "max |error| vs double reference %.2e, %zu NaN mismatches\n",
+                PacketDecoder::isaName(bank.isa()), bank.groupWidth(), CHANNELS, total_samples, worst, nan_mismatches);
+    return (worst > 1e-5 ? 1 : 0) + (nan_mismatches ? 1 : 0);
+}
+
+// 跳过前 settle 个样本后输出的均值与 RMS（RMS 不含均值）
+void residual(const std::vector<FilterStage>& chain, double frequency, double offset, size_t settle, size_t total,
+              double& mean, double& rms) {
+    ChannelFilterBank bank(1, SAMPLE_RATE);
+    bank.configure(chain);
+    std::vector<float> samples(total);
+    for (size_t i = 0; i < total; ++i) {
+        samples[i] = static_cast<float>(offset + std::sin(2.0 * PI * frequency * i / SAMPLE_RATE));
+    }
+    bank.process(samples.data(), total, 0, total);
+    double sum = 0.0, squares = 0.0;
+    for (size_t i = settle; i < total; ++i) {
+        sum += samples[i];
+        squares += double(samples[i]) * samples[i];
+    }
+    mean = sum / (total - settle);
+    rms = std::sqrt(std::max(squares / (total - settle) - mean * mean, 0.0));
+}
+
+size_t checkEffect() {
+    size_t errors = 0;
+    std::vector<FilterStage> notch(1);
+    notch[0].type = FilterType::Notch;
+    notch[0].frequency = 50.0;
+    notch[0].q = 30.0;
+    const size_t total = static_cast<size_t>(4 * SAMPLE_RATE);
+    double mean = 0.0, rms = 0.0;
+    residual(notch, 50.0, 0.0, total / 2, total, mean, rms);
+    const double hum = rms / std::sqrt(0.5);
+    residual(notch, 1000.0, 0.0, total / 2, total, mean, rms);
+    const double pass = rms / std::sqrt(0.5);
+
+    // 0.5Hz 截止的直流隔离：4 秒（约 12 个时间常数）后 1.0 的偏置只剩均值残余，1kHz 正弦通过
+    std::vector<FilterStage> dc(1);
+    dc[0].type = FilterType::DcBlock;
+    dc[0].frequency = 0.5;
+    residual(dc, 1000.0, 1.0, total - 22500, total, mean, rms);
+    std::printf("effect: 50 Hz notch attenuates hum by %.1f dB, passes 1 kHz at %.4f; DC block leaves %.2e of a "
+                "1.0 offset, passes 1 kHz at %.4f\n",
+                -20.0 * std::log10(hum), pass, std::fabs(mean), rms / std::sqrt(0.5));
+    if (hum > 0.01 || std::fabs(pass - 1.0) > 0.01 || std::fabs(mean) > 1e-3 || std::fabs(rms / std::sqrt(0.5) - 1.0) > 0.01) {
+        ++errors;
+    }
+
+    // 抽取 FIR：200Hz 正弦经 4 倍抽取与插值后应为延迟 taps - 1 个样本的同一正弦（逐样本保持会留下 -20dB 左右的阶梯）
+    std::vector<FilterStage> fir(1);
+    fir[0].type = FilterType::DecimatingFir;
+    fir[0].frequency = 1000.0;
+    fir[0].taps = 63;
+    fir[0].decimation = 4;
+    {
+        ChannelFilterBank bank(1, SAMPLE_RATE);
+        bank.configure(fir);
+        std::vector<float> samples(total);
+        const double w = 2.0 * PI * 200.0 / SAMPLE_RATE;
+        for (size_t i = 0; i < total; ++i) samples[i] = static_cast<float>(std::sin(w * i));
+        bank.process(samples.data(), total, 0, total);
+        double error = 0.0;
+        for (size_t i = total / 2; i < total; ++i) {
+            const double d = samples[i] - std::sin(w * (double(i) - (fir[0].taps - 1)));
+            error += d * d;
+        }
+        error = std::sqrt(error / (total - total / 2)) / std::sqrt(0.5);
+        std::printf("effect: decimating FIR (63 taps, D = 4) reproduces a 200 Hz sine with %.1f dB error\n",
+                    20.0 * std::log10(error));
+        if (error > 0.01) ++errors;
+    }
+
+    // DataManager：设置滤波链后写入的数据已去掉直流
+    DataManager manager;
+    manager.setFilterChain(dc);
+    const size_t channels = manager.channelCount();
+    std::vector<std::vector<float>> chunk(channels, std::vector<float>(225, 3.0f));
+    for (int i = 0; i < 500; ++i) {     // 5 秒
+        manager.addChannelData(chunk, 0.0);
+    }
+    const HistoryRange range = manager.getHistoryRange();
+    std::vector<float> times(8192), values(8192);
+    const size_t points = manager.queryEnvelope(channels - 1, range.last_time - 0.1, range.last_time, times.size(),
+                                                times.data(), values.data());
+    float peak = 0.0f;
+    for (size_t i = 0; i < points; ++i) peak = std::max(peak, std::fabs(values[i]));
+    std::printf("effect: DataManager with %s chain, constant 3.0 input: %zu samples of the last 0.1 s peak at %.2e\n",
+                filterTypeName(manager.filterChain()[0].type), points, peak);
+    if (points == 0 || peak > 0.01f) ++errors;
+
+    // 数据包路径：一批远多于 maxCommitSamples() 的样本分多组提交并自动发布，
+    // 每组必须在发布前滤波，否则显示线程与包络金字塔会先看到未滤波的 3.0
+    DataManager packets;
+    packets.setFilterChain(dc);
+    const size_t batch_packets = static_cast<size_t>(SAMPLE_RATE) / StreamFormat::SAMPLES_PER_PACKET;   // 1 秒
+    const std::vector<float> constant(batch_packets * StreamFormat::PACKAGE_SIZE / sizeof(float), 3.0f);
+    PacketBatch batch;
+    batch.data = reinterpret_cast<const uint8_t*>(constant.data());
+    batch.packet_count = batch_packets;
+    batch.packet_size = StreamFormat::PACKAGE_SIZE;
+    for (int i = 0; i < 5; ++i) {
+        packets.addPacketBatch(batch);
+    }
+    const HistoryRange packet_range = packets.getHistoryRange();
+    const size_t coarse = packets.queryEnvelope(0, packet_range.last_time - 1.0, packet_range.last_time, 64,
+                                                times.data(), values.data());
+    float coarse_peak = 0.0f;
+    for (size_t i = 0; i < coarse; ++i) coarse_peak = std::max(coarse_peak, std::fabs(values[i]));
+    std::printf("effect: DataManager packet batches of %zu samples, envelope of the last 1 s peaks at %.2e\n",
+                batch_packets * StreamFormat::SAMPLES_PER_PACKET, coarse_peak);
+    if (coarse == 0 || coarse_peak > 0.01f) ++errors;
+    return errors;
+}
+
+void measureCost(DecodeIsa isa, const char* label, const std::vector<FilterStage>& chain, double seconds) {
+    constexpr size_t CHANNELS = StreamFormat::CHANNEL_COUNT;
+    constexpr size_t BATCH = 64 * StreamFormat::SAMPLES_PER_PACKET;
+    ChannelFilterBank bank(CHANNELS, SAMPLE_RATE, isa);
+    bank.configure(chain);
+    ChannelRingStore store(CHANNELS, 65536);
+    std::vector<float> block(BATCH);
+    for (size_t ch = 0; ch < CHANNELS; ++ch) {
+        for (size_t i = 0; i < BATCH; ++i) block[i] = inputSample(i, ch);
+        store.writeChannel(ch, block.data(), BATCH);
+    }
+    store.commit(BATCH);
+    store.publish();
+
+    // 同一批样本反复滤波（状态持续推进），只计滤波本身
+    size_t batches = 0;
+    const Clock::time_point start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        for (int i = 0; i < 16; ++i) bank.process(store, 0, BATCH);
+        batches += 16;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < seconds);
+    const double per_sample = elapsed * 1e9 / (double(batches) * BATCH * CHANNELS);
+    std::printf("cost [%-6s %-14s]: %.3f ns per sample per channel, %.2f%% of one core for %zu channels at %.0f Hz\n",
+                PacketDecoder::isaName(bank.isa()), label, per_sample,
+                100.0 * per_sample * 1e-9 * CHANNELS * SAMPLE_RATE, CHANNELS, SAMPLE_RATE);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 4.0;
+    size_t errors = checkCoefficients();
+
+    const DecodeIsa isas[] = {DecodeIsa::Scalar, DecodeIsa::Sse2, DecodeIsa::Avx2};
+    for (DecodeIsa isa : isas) {
+        if (!PacketDecoder::isSupported(isa)) {
+            std::printf("streaming [%s]: not supported on this CPU/build, skipped\n", PacketDecoder::isaName(isa));
+            continue;
+        }
+        errors += checkStreaming(isa, 40000);
+    }
+    errors += checkEffect();
+
+    const std::vector<FilterStage> full = fullChain();
+    const std::vector<FilterStage> hum_chain(full.begin(), full.begin() + 2);
+    const std::vector<FilterStage> biquads(full.begin(), full.begin() + 5);
+    const double share = seconds / 9.0;
+    for (DecodeIsa isa : isas) {
+        if (!PacketDecoder::isSupported(isa)) continue;
+        measureCost(isa, "dc+notch", hum_chain, share);
+        measureCost(isa, "5 biquads", biquads, share);
+        measureCost(isa, "5 biquads+fir", full, share);
+    }
+
+    std::printf("verification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
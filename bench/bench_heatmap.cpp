@@ -0,0 +1,168 @@
+// 通道 x 时间热图计算线程的校验与 CPU 开销基准
+// - 同步：写入确定性的多通道数据（含 NaN 缺口），按约 60Hz 的批量驱动 ChannelHeatmap::append()，
+//   逐列与按定义计算的 RMS/峰值比对（中途切换指标），统计每秒数据流的归约耗时
+// - 线程：按流速率的倍数写入环形缓冲，计算线程独立运行，统计其占用的 CPU 比例与落后丢失的列
+// 校验失败时以非零退出码返回
+// 用法: bench_heatmap [seconds，默认 10] [rate_multiplier，默认 10]
+#include "Core/ChannelHeatmap.h"
+#include "Core/ChannelRingStore.h"
+#include "Core/StreamFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t CHANNEL_COUNT = StreamFormat::CHANNEL_COUNT;
+constexpr size_t SAMPLES_PER_PACKET = StreamFormat::SAMPLES_PER_PACKET;
+constexpr double SAMPLE_RATE = StreamFormat::SAMPLE_RATE;
+constexpr size_t COLUMN_SAMPLES = 225;        // 10ms
+constexpr size_t HISTORY_SAMPLES = 65536;
+
+constexpr size_t NAN_CHANNEL = 5;
+constexpr uint64_t NAN_FIRST = 100000;        // 跨越若干整列及两端的部分列
+constexpr uint64_t NAN_LAST = NAN_FIRST + 3 * COLUMN_SAMPLES + 50;
+
+using Clock = std::chrono::steady_clock;
+
+float sampleValue(uint64_t index, size_t channel) {
+    if (channel == NAN_CHANNEL && index >= NAN_FIRST && index < NAN_LAST) {
+        return std::nanf("");
+    }
+    const double amplitude = 0.01 + 0.9 * channel / CHANNEL_COUNT;
+    return static_cast<float>(amplitude * std::sin(0.002 * index * (channel + 1)) + ((index * 7 + channel) % 13) * 1e-3);
+}
+
+void writePackets(ChannelRingStore& store, uint64_t& next_sample, size_t packets, std::vector<float>& packet) {
+    for (size_t p = 0; p < packets; ++p) {
+        for (size_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            for (size_t s = 0; s < SAMPLES_PER_PACKET; ++s) {
+                packet[ch * SAMPLES_PER_PACKET + s] = sampleValue(next_sample + s, ch);
+            }
+        }
+        store.writePacket(packet.data(), SAMPLES_PER_PACKET);
+        next_sample += SAMPLES_PER_PACKET;
+    }
+    store.publish();
+}
+
+// 按定义计算第 column 列：NaN 不计入，全部为 NaN 时为 NaN
+double referenceValue(uint64_t column, size_t channel, HeatmapMetric metric) {
+    double sum = 0.0, peak = 0.0;
+    size_t valid = 0;
+    for (uint64_t i = column * COLUMN_SAMPLES; i < (column + 1) * COLUMN_SAMPLES; ++i) {
+        const float value = sampleValue(i, channel);
+        if (std::isnan(value)) continue;
+        sum += double(value) * value;
+        peak = std::max(peak, std::fabs(double(value)));
+        ++valid;
+    }
+    if (valid == 0) return std::nan("");
+    return metric == HeatmapMetric::Peak ? peak : std::sqrt(sum / valid);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+    const double rate_multiplier = argc > 2 ? std::atof(argv[2]) : 10.0;
+    std::vector<float> packet(CHANNEL_COUNT * SAMPLES_PER_PACKET);
+    size_t errors = 0;
+
+    // ---- 同步：计算开销与逐列校验 ----
+    {
+        ChannelRingStore store(CHANNEL_COUNT, HISTORY_SAMPLES);
+        const size_t total_columns = static_cast<size_t>(seconds * SAMPLE_RATE / COLUMN_SAMPLES);
+        ChannelHeatmap heatmap(store, COLUMN_SAMPLES, total_columns + 1);
+        uint64_t next_sample = 0;
+        const size_t packets_per_frame = static_cast<size_t>(SAMPLE_RATE / 60.0 / SAMPLES_PER_PACKET);
+        uint64_t switch_column = 0;
+        bool switched = false;
+        while (heatmap.endColumn() < total_columns) {
+            writePackets(store, next_sample, packets_per_frame, packet);
+            heatmap.append(store.publishedCount());
+            if (!switched && heatmap.endColumn() >= total_columns / 2) {
+                heatmap.setMetric(HeatmapMetric::Peak);
+                switch_column = heatmap.endColumn();
+                switched = true;
+            }
+        }
+
+        const uint64_t first = heatmap.startColumn();
+        const uint64_t end = heatmap.endColumn();
+        std::vector<float> values(CHANNEL_COUNT * (end - first));
+        if (!heatmap.copyColumns(first, end - first, values.data())) {
+            std::printf("sync: copyColumns failed\n");
+            ++errors;
+        }
+        size_t mismatches = 0, nan_columns = 0;
+        for (uint64_t column = first; column < end; ++column) {
+            const HeatmapMetric metric = column < switch_column ? HeatmapMetric::Rms : HeatmapMetric::Peak;
+            for (size_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+                const double expected = referenceValue(column, ch, metric);
+                const float actual = values[ch * (end - first) + (column - first)];
+                if (std::isnan(expected) || std::isnan(actual)) {
+                    nan_columns += std::isnan(actual) ? 1 : 0;
+                    if (std::isnan(expected) != std::isnan(actual)) ++mismatches;
+                    continue;
+                }
+                if (std::fabs(actual - expected) > 1e-4 * std::max(1.0, std::fabs(expected))) ++mismatches;
+            }
+        }
+        HeatmapStats stats = heatmap.getStats();
+        const double stream_seconds = (end - first) * COLUMN_SAMPLES / SAMPLE_RATE;
+        std::printf("sync: %llu columns (%zu ch x %zu samples, rms then peak from column %llu), "
+                    "%zu NaN columns, %zu mismatches\n",
+                    static_cast<unsigned long long>(end - first), CHANNEL_COUNT, COLUMN_SAMPLES,
+                    static_cast<unsigned long long>(switch_column), nan_columns, mismatches);
+        std::printf("sync: %.3f ms of reduction per second of stream (%.3f%% of one core, %.2f ns/sample)\n",
+                    stats.busy_seconds * 1000.0 / stream_seconds, 100.0 * stats.busy_seconds / stream_seconds,
+                    stats.busy_seconds * 1e9 / ((end - first) * COLUMN_SAMPLES * CHANNEL_COUNT));
+        const size_t full_nan_columns = NAN_LAST / COLUMN_SAMPLES - (NAN_FIRST + COLUMN_SAMPLES - 1) / COLUMN_SAMPLES;
+        errors += mismatches + (nan_columns == full_nan_columns ? 0 : 1) + (stats.missed_columns ? 1 : 0);
+    }
+
+    // ---- 线程：写入与计算互不等待 ----
+    {
+        ChannelRingStore store(CHANNEL_COUNT, HISTORY_SAMPLES);
+        ChannelHeatmap heatmap(store, COLUMN_SAMPLES, 4096);
+        heatmap.start();
+        uint64_t next_sample = 0;
+        const double packets_per_second = SAMPLE_RATE / SAMPLES_PER_PACKET * rate_multiplier;
+        const double run_seconds = std::min(seconds, 3.0);
+        Clock::time_point start = Clock::now();
+        size_t written = 0;
+        while (true) {
+            const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            if (elapsed >= run_seconds) break;
+            const size_t due = static_cast<size_t>(elapsed * packets_per_second);
+            if (due > written) {
+                writePackets(store, next_sample, due - written, packet);
+                written = due;
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        }
+        // 等待计算线程处理完最后的完整列
+        const uint64_t expected_end = next_sample / COLUMN_SAMPLES;
+        for (int i = 0; i < 200 && heatmap.endColumn() < expected_end; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        heatmap.stop();
+        HeatmapStats stats = heatmap.getStats();
+        const double stream_seconds = next_sample / SAMPLE_RATE;
+        std::printf("threaded at %.0fx (%.1f MB/s): %llu columns computed, %llu missed, worker busy %.3f%% of "
+                    "wall time (%.3f%% of one core per real-time stream)\n",
+                    rate_multiplier, packets_per_second * SAMPLES_PER_PACKET * CHANNEL_COUNT * 4 / (1 << 20),
+                    static_cast<unsigned long long>(stats.columns), static_cast<unsigned long long>(stats.missed_columns),
+                    100.0 * stats.busy_seconds / run_seconds, 100.0 * stats.busy_seconds / stream_seconds);
+        if (heatmap.endColumn() != expected_end || stats.missed_columns != 0) ++errors;
+    }
+
+    std::printf("verification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
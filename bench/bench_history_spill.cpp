@@ -0,0 +1,314 @@
+// 历史溢写基准
+// - 溢写：以最快速度向环形缓冲写入确定性数据，后台线程压缩落盘；报告溢写吞吐和压缩比
+// - 查询：全范围（缩小视图，只用常驻摘要）、中等缩放（文件内摘要）和样本级（解压块）的查询延迟
+// - 校验：随机范围、随机缩放级别的查询结果与按相同分桶规则暴力计算的最小/最大值逐点比较
+// - DataManager：小容量溢写文件（触发循环覆盖）下，跨越磁盘/内存分界的包络查询覆盖完整范围且极值正确，
+//   点数很少（max_points 2~12）时查询也能返回
+// 任何校验失败都以非零退出码返回
+// 用法: bench_history_spill [数据秒数，默认 60] [目录，默认 /tmp]
+#include "Core/DataManager.h"
+#include "Core/HistorySpill.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 缓变的锯齿加少量噪声，量化到 1/4，接近实际传感器数据的可压缩程度
+float sampleValue(uint64_t index, size_t channel) {
+    int64_t ramp = static_cast<int64_t>(((index * (channel * 7 + 3)) >> 6) % 2048) - 1024;
+    uint32_t noise = static_cast<uint32_t>((index * 2654435761u) ^ (channel * 40503u)) >> 29;
+    return static_cast<float>(ramp + static_cast<int64_t>(noise)) * 0.25f;
+}
+
+void minMaxOf(size_t channel, uint64_t lo, uint64_t hi, float& min_value, float& max_value) {
+    min_value = max_value = sampleValue(lo, channel);
+    for (uint64_t i = lo + 1; i < hi; ++i) {
+        float value = sampleValue(i, channel);
+        min_value = std::min(min_value, value);
+        max_value = std::max(max_value, value);
+    }
+}
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 按 HistorySpill::query 的分桶规则暴力计算期望输出，返回不一致的点数
+size_t verifyQuery(HistorySpill& spill, size_t channel, uint64_t first, uint64_t last, size_t max_buckets,
+                   double period, std::vector<float>& xs, std::vector<float>& ys) {
+    size_t points = spill.query(channel, first, last, max_buckets, 0, period, xs.data(), ys.data());
+    first = std::max(first, spill.startIndex());
+    last = std::min(last, spill.endIndex());
+
+    std::vector<float> expect_x, expect_y;
+    uint64_t range = last - first;
+    if (range <= max_buckets * 2) {
+        for (uint64_t i = first; i < last; ++i) {
+            expect_x.push_back(static_cast<float>(i * period));
+            expect_y.push_back(sampleValue(i, channel));
+        }
+    } else {
+        size_t shift = 1;
+        while (shift < 63 && (range >> shift) != 0 && (range >> shift) + 2 > max_buckets) ++shift;
+        uint64_t bucket_size = uint64_t(1) << shift;
+        uint64_t output_lo = first;
+        for (uint64_t start = first & ~(bucket_size - 1); start < last; start += bucket_size) {
+            uint64_t lo = std::max(start, first);
+            uint64_t hi = std::min(start + bucket_size, last);
+            float min_value, max_value;
+            minMaxOf(channel, lo, hi, min_value, max_value);
+            if (expect_x.size() == 2 * max_buckets) {
+                // max_buckets < 3：多出的桶并入最后一个桶
+                expect_y[expect_y.size() - 2] = std::min(expect_y[expect_y.size() - 2], min_value);
+                expect_y.back() = std::max(expect_y.back(), max_value);
+                expect_x.back() = static_cast<float>((output_lo + (hi - output_lo) / 2) * period);
+                continue;
+            }
+            output_lo = lo;
+            expect_x.push_back(static_cast<float>(lo * period));
+            expect_y.push_back(min_value);
+            expect_x.push_back(static_cast<float>((lo + (hi - lo) / 2) * period));
+            expect_y.push_back(max_value);
+        }
+    }
+
+    if (points != expect_x.size()) {
+        std::printf("  query ch %zu [%lu, %lu) x%zu: %zu points, expected %zu\n", channel,
+                    static_cast<unsigned long>(first), static_cast<unsigned long>(last), max_buckets, points,
+                    expect_x.size());
+        return std::max<size_t>(1, points > expect_x.size() ? points - expect_x.size() : expect_x.size() - points);
+    }
+    size_t errors = 0;
+    for (size_t i = 0; i < points; ++i) {
+        if (xs[i] != expect_x[i] || ys[i] != expect_y[i]) {
+            if (errors == 0) {
+                std::printf("  query ch %zu point %zu: (%g, %g), expected (%g, %g)\n", channel, i, xs[i], ys[i],
+                            expect_x[i], expect_y[i]);
+            }
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+// 写入 [0, total) 的样本；溢写落后超过半个可读窗口时等待，保证不丢块
+void feed(ChannelRingStore& store, const HistorySpill& spill, uint64_t total) {
+    const size_t channels = store.channelCount();
+    const size_t chunk = 256;
+    std::vector<float> samples(chunk);
+    const uint64_t slack = store.readableWindow() / 2;
+    for (uint64_t first = 0; first < total; first += chunk) {
+        while (first > spill.endIndex() + slack) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        for (size_t ch = 0; ch < channels; ++ch) {
+            for (size_t i = 0; i < chunk; ++i) samples[i] = sampleValue(first + i, ch);
+            store.writeChannel(ch, samples.data(), chunk);
+        }
+        store.commit(chunk);
+        store.publish();
+    }
+}
+
+size_t runSpill(const StreamDescriptor& stream, double seconds, const std::string& dir) {
+    ChannelRingStore store(stream.channel_count, 50000);
+    HistorySpill spill(store);
+    if (!spill.open(dir)) return 1;
+
+    const uint64_t total = static_cast<uint64_t>(seconds * stream.sample_rate);
+    const uint64_t spilled_end = total / HistorySpill::BLOCK_SAMPLES * HistorySpill::BLOCK_SAMPLES;
+    Clock::time_point start = Clock::now();
+    feed(store, spill, total);
+    while (spill.endIndex() < spilled_end) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    double elapsed = millisecondsSince(start) / 1000.0;
+    HistorySpillStats stats = spill.getStats();
+
+    std::printf("spill    %.0f s of %zu channels: %lu blocks, %.1f MB raw -> %.1f MB on disk (%.2fx), "
+                "%.0f MB/s (producer and spill thread together)\n",
+                seconds, stream.channel_count, static_cast<unsigned long>(stats.blocks), stats.raw_bytes / 1e6,
+                stats.stored_bytes / 1e6, stats.stored_bytes ? double(stats.raw_bytes) / stats.stored_bytes : 0.0,
+                stats.raw_bytes / 1e6 / elapsed);
+
+    size_t errors = 0;
+    if (stats.missed_blocks != 0 || spill.startIndex() != 0 || spill.endIndex() != spilled_end) {
+        std::printf("  spill: range [%lu, %lu), %lu missed blocks; expected [0, %lu) without gaps\n",
+                    static_cast<unsigned long>(spill.startIndex()), static_cast<unsigned long>(spill.endIndex()),
+                    static_cast<unsigned long>(stats.missed_blocks), static_cast<unsigned long>(spilled_end));
+        ++errors;
+    }
+
+    // 查询延迟：全范围 / 约1秒 / 约400个样本（单个通道，UI 每帧对每个可见通道调用一次）
+    const double period = 1.0 / stream.sample_rate;
+    const size_t buckets = 1000;
+    std::vector<float> xs(buckets * 2), ys(buckets * 2);
+    struct View { const char* name; uint64_t first, last; };
+    const uint64_t middle = spilled_end / 2;
+    const View views[] = {
+        {"full", 0, spilled_end},
+        {"1 s", middle, middle + static_cast<uint64_t>(stream.sample_rate)},
+        {"400 samp", middle + 12345, middle + 12345 + 400},
+    };
+    for (const View& view : views) {
+        // 首次查询（解压缓存未命中）与重复查询（同一视图的下一帧）
+        Clock::time_point t0 = Clock::now();
+        size_t points = spill.query(7, view.first, view.last, buckets, 0, period, xs.data(), ys.data());
+        double cold = millisecondsSince(t0);
+        const int repeats = 50;
+        t0 = Clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            spill.query(7, view.first, view.last, buckets, 0, period, xs.data(), ys.data());
+        }
+        double warm = millisecondsSince(t0) / repeats;
+        std::printf("query    %-9s %10lu samples -> %5zu points: first %.3f ms, repeat %.3f ms\n", view.name,
+                    static_cast<unsigned long>(view.last - view.first), points, cold, warm);
+    }
+
+    // 随机范围、随机缩放级别校验
+    std::mt19937_64 rng(12345);
+    const int checks = 300;
+    size_t query_errors = 0;
+    for (int k = 0; k < checks; ++k) {
+        uint64_t length = std::max<uint64_t>(2, spilled_end >> (rng() % 20));
+        uint64_t first = rng() % (spilled_end - std::min(length, spilled_end - 1));
+        size_t channel = rng() % stream.channel_count;
+        size_t max_buckets = 50 + rng() % 1000;
+        query_errors += verifyQuery(spill, channel, first, first + length, max_buckets, period, xs, ys);
+        if (query_errors > 0) break;
+    }
+    // 桶数 1、2（无法按对齐桶划分）：全范围与随机范围
+    for (size_t max_buckets : {size_t(1), size_t(2)}) {
+        query_errors += verifyQuery(spill, 7, 0, spilled_end, max_buckets, period, xs, ys);
+        for (int k = 0; k < 20 && query_errors == 0; ++k) {
+            uint64_t first = rng() % (spilled_end / 2);
+            query_errors += verifyQuery(spill, rng() % stream.channel_count, first,
+                                        first + 5 + rng() % (spilled_end / 2), max_buckets, period, xs, ys);
+        }
+    }
+    std::printf("verify   %d random queries, %zu mismatched points\n", checks + 42, query_errors);
+    errors += query_errors;
+
+    spill.close();
+    return errors;
+}
+
+// DataManager 集成：溢写文件只有 max_bytes，旧块被循环覆盖；包络查询应覆盖磁盘与内存两部分
+size_t runDataManager(const StreamDescriptor& stream, double seconds, const std::string& dir) {
+    DataManager manager(stream);
+    manager.setFramePacing(false);
+    manager.setProcessingEnabled(true);
+    if (!manager.enableHistorySpill(dir, 32ull << 20)) return 1;
+
+    const uint64_t total = static_cast<uint64_t>(seconds * stream.sample_rate);
+    const uint64_t slack = 32768;
+    std::vector<uint8_t> packet(stream.packetSize());
+    float* samples = reinterpret_cast<float*>(packet.data());
+    PacketBatch batch;
+    batch.data = packet.data();
+    batch.packet_count = 1;
+    batch.packet_size = packet.size();
+    for (uint64_t first = 0; first < total; first += stream.samples_per_packet) {
+        while (true) {
+            HistorySpillStats stats = manager.getHistorySpillStats();
+            uint64_t spilled = (stats.blocks + stats.evicted_blocks) * HistorySpill::BLOCK_SAMPLES;
+            if (first <= spilled + slack) break;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        for (size_t ch = 0; ch < stream.channel_count; ++ch) {
+            for (size_t s = 0; s < stream.samples_per_packet; ++s) {
+                samples[ch * stream.samples_per_packet + s] = sampleValue(first + s, ch);
+            }
+        }
+        manager.addPacketBatch(batch);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));   // 显示线程补齐包络
+
+    HistorySpillStats stats = manager.getHistorySpillStats();
+    HistoryRange range = manager.getHistoryRange();
+    const uint64_t first_sample = static_cast<uint64_t>(std::llround(range.first_time * stream.sample_rate));
+    const uint64_t published = static_cast<uint64_t>(std::llround(range.last_time * stream.sample_rate)) + 1;
+
+    size_t errors = 0;
+    if (stats.evicted_blocks == 0 || stats.missed_blocks != 0 || published != total ||
+        first_sample % HistorySpill::BLOCK_SAMPLES != 0 || total - first_sample <= 65536) {
+        std::printf("  manager: range [%lu, %lu) of %lu, %lu evicted, %lu missed\n",
+                    static_cast<unsigned long>(first_sample), static_cast<unsigned long>(published),
+                    static_cast<unsigned long>(total), static_cast<unsigned long>(stats.evicted_blocks),
+                    static_cast<unsigned long>(stats.missed_blocks));
+        ++errors;
+    }
+
+    // 全范围与跨越分界的查询：时间单调，覆盖首尾，极值与暴力计算一致
+    const size_t max_points = 2000;
+    std::vector<float> times(max_points), values(max_points);
+    const double period = 1.0 / stream.sample_rate;
+    struct Span { uint64_t first, last; };
+    const Span spans[] = {{first_sample, published}, {published - 100000, published - 1000}};
+    for (const Span& span : spans) {
+        for (size_t channel : {size_t(0), stream.channel_count - 1}) {
+            size_t points = manager.queryEnvelope(channel, (span.first + 0.5) * period, (span.last - 1.5) * period, max_points,
+                                                  times.data(), values.data());
+            float min_value, max_value;
+            minMaxOf(channel, span.first, span.last, min_value, max_value);
+            bool ok = points > 0 && points <= max_points &&
+                      std::is_sorted(times.begin(), times.begin() + points) &&
+                      *std::min_element(values.begin(), values.begin() + points) == min_value &&
+                      *std::max_element(values.begin(), values.begin() + points) == max_value &&
+                      times[0] <= span.first * period + 1e-3;
+            if (!ok) {
+                std::printf("  manager: query ch %zu [%lu, %lu) returned %zu points with wrong coverage or extrema\n",
+                            channel, static_cast<unsigned long>(span.first), static_cast<unsigned long>(span.last),
+                            points);
+                ++errors;
+            }
+        }
+    }
+    // 很少的点数（时间窗口拉到最大、视图很窄）：查询必须返回；每部分至少 2 个桶时极值仍然完整
+    float span_min, span_max;
+    minMaxOf(0, first_sample, published, span_min, span_max);
+    for (size_t small_points : {size_t(2), size_t(4), size_t(6), size_t(8), size_t(12)}) {
+        size_t points = manager.queryEnvelope(0, (first_sample + 0.5) * period, (published - 1.5) * period,
+                                              small_points, times.data(), values.data());
+        bool ok = points > 0 && points <= small_points && std::is_sorted(times.begin(), times.begin() + points) &&
+                  *std::min_element(values.begin(), values.begin() + points) >= span_min &&
+                  *std::max_element(values.begin(), values.begin() + points) <= span_max;
+        if (ok && small_points >= 8) {
+            ok = *std::min_element(values.begin(), values.begin() + points) == span_min &&
+                 *std::max_element(values.begin(), values.begin() + points) == span_max;
+        }
+        if (!ok) {
+            std::printf("  manager: full-range query with max_points %zu returned %zu points with wrong extrema\n",
+                        small_points, points);
+            ++errors;
+        }
+    }
+    std::printf("manager  %.1f s browsable (%.1f s in memory), %lu blocks kept, %lu evicted, %zu errors\n",
+                range.last_time - range.first_time, 65536 / stream.sample_rate,
+                static_cast<unsigned long>(stats.blocks), static_cast<unsigned long>(stats.evicted_blocks), errors);
+    return errors;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 60.0;
+    std::string dir = argc > 2 ? argv[2] : "/tmp";
+
+    StreamDescriptor stream;
+    size_t errors = 0;
+    errors += runSpill(stream, seconds, dir);
+    errors += runDataManager(stream, 10.0, dir);
+
+    std::printf("\nverification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
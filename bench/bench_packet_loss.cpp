@@ -0,0 +1,309 @@
+// 包头与丢包处理基准
+// - 吞吐：同一数据流以无包头（原有 4096 字节数据包）与带包头两种方式写入 DataManager，比较每包开销
+// - 校验：按脚本注入丢包、重复、乱序、损坏包头与发送端重启，核对各计数器；
+//   逐样本检查环形缓冲：缺口处为 NaN，其余样本与发送端的全局样本索引一一对应（丢包后时间不偏移）
+// - 录制：带包头的数据流以各编码录制后读回，包头与样本逐字节还原
+// 任何校验失败都以非零退出码返回
+// 用法: bench_packet_loss [吞吐测试的包数，默认 200000] [目录，默认 /tmp]
+#include "Core/DataManager.h"
+#include "Core/PacketSequencer.h"
+#include "Storage/Recorder.h"
+#include "Storage/RecordingReader.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 样本值编码其全局索引与通道，读回时可以确定它来自哪个包
+float sampleValue(uint64_t index, size_t channel) {
+    return static_cast<float>((index % 100000) * 4 + channel % 4);
+}
+
+void fillPacket(uint8_t* packet, const StreamDescriptor& stream, uint64_t sequence, uint64_t first_sample) {
+    if (stream.packet_header) {
+        writePacketHeader(packet, stream, sequence, first_sample);
+    }
+    float* samples = reinterpret_cast<float*>(packet + stream.headerSize());
+    for (size_t ch = 0; ch < stream.channel_count; ++ch) {
+        for (size_t s = 0; s < stream.samples_per_packet; ++s) {
+            samples[ch * stream.samples_per_packet + s] = sampleValue(first_sample + s, ch);
+        }
+    }
+}
+
+double measureThroughput(const StreamDescriptor& stream, size_t packet_count) {
+    const size_t batch_packets = 64;
+    std::vector<uint8_t> data(batch_packets * stream.packetSize());
+    DataManager manager(stream);
+    PacketBatch batch;
+    batch.data = data.data();
+    batch.packet_count = batch_packets;
+    batch.packet_size = stream.packetSize();
+
+    double seconds = 0.0;
+    for (size_t first = 0; first < packet_count; first += batch_packets) {
+        for (size_t i = 0; i < batch_packets; ++i) {
+            fillPacket(data.data() + i * stream.packetSize(), stream, first + i, (first + i) * stream.samples_per_packet);
+        }
+        Clock::time_point start = Clock::now();
+        manager.addPacketBatch(batch);
+        seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    return seconds * 1e9 / packet_count;
+}
+
+// 发送脚本中的一步：发送序号 sequence 的包（first_sample 由序号推出，restart 后从0重新计数）
+struct Send {
+    uint64_t sequence;
+    bool corrupt = false;
+};
+
+struct Expected {
+    PacketLossStats stats;
+    std::vector<int64_t> timeline;    // 环形缓冲中每个样本对应的发送端包序号，-1 为 NaN 缺口
+};
+
+size_t verifySequencing(const StreamDescriptor& stream) {
+    const size_t spp = stream.samples_per_packet;
+    DataManager manager(stream);
+
+    // 脚本：正常 0..99；丢 100..104；105..125 中 110 迟到到 125 之后；重复 115 与 3；损坏包头一个；
+    // 丢 130，其余正常发送到 1299；然后发送端重启（序号与样本索引归零）发送 0..49
+    std::vector<Send> script;
+    for (uint64_t s = 0; s < 100; ++s) script.push_back({s});
+    for (uint64_t s = 105; s < 126; ++s) {
+        if (s == 110) continue;
+        script.push_back({s});
+        if (s == 115) script.push_back({115});
+    }
+    script.push_back({110});
+    script.push_back({3});
+    script.push_back({126, true});
+    for (uint64_t s = 126; s < 1300; ++s) {
+        if (s != 130) script.push_back({s});
+    }
+    const size_t restart_at = script.size();
+    for (uint64_t s = 0; s < 50; ++s) script.push_back({s});
+
+    Expected expected;
+    expected.stats.packets = 100 + 20 + 1173 + 50;
+    expected.stats.lost_packets = 5 + 1 + 1 - 1;     // 100..104、110、130，110 迟到后扣回
+    expected.stats.duplicate_packets = 2;
+    expected.stats.reordered_packets = 1;
+    expected.stats.invalid_packets = 1;
+    expected.stats.gaps = 3;
+    expected.stats.gap_samples = (5 + 1 + 1) * spp;
+    expected.stats.resyncs = 1;
+    for (int64_t s = 0; s < 1300; ++s) {
+        bool lost = (s >= 100 && s < 105) || s == 110 || s == 130;
+        for (size_t i = 0; i < spp; ++i) expected.timeline.push_back(lost ? -1 : s);
+    }
+    for (int64_t s = 0; s < 50; ++s) {
+        for (size_t i = 0; i < spp; ++i) expected.timeline.push_back(1000 + s);
+    }
+
+    // 以不同大小的批次送入，覆盖批内合并与批间衔接
+    std::vector<uint8_t> data(script.size() * stream.packetSize());
+    for (size_t i = 0; i < script.size(); ++i) {
+        uint8_t* packet = data.data() + i * stream.packetSize();
+        uint64_t sequence = script[i].sequence;
+        fillPacket(packet, stream, sequence, sequence * spp);
+        if (i >= restart_at) {
+            // 重启后的样本值用 1000 + 序号区分
+            float* samples = reinterpret_cast<float*>(packet + stream.headerSize());
+            for (size_t ch = 0; ch < stream.channel_count; ++ch) {
+                for (size_t s = 0; s < spp; ++s) samples[ch * spp + s] = sampleValue((1000 + sequence) * spp + s, ch);
+            }
+        }
+        if (script[i].corrupt) packet[0] ^= 0xFF;
+    }
+    const size_t batch_sizes[] = {1, 7, 32, 3};
+    for (size_t first = 0, k = 0; first < script.size(); ++k) {
+        PacketBatch batch;
+        batch.data = data.data() + first * stream.packetSize();
+        batch.packet_count = std::min(batch_sizes[k % 4], script.size() - first);
+        batch.packet_size = stream.packetSize();
+        manager.addPacketBatch(batch);
+        first += batch.packet_count;
+    }
+
+    size_t errors = 0;
+    PacketLossStats stats = manager.getPacketStats();
+    const uint64_t got[] = {stats.packets, stats.lost_packets, stats.duplicate_packets, stats.reordered_packets,
+                            stats.invalid_packets, stats.gaps, stats.gap_samples, stats.resyncs};
+    const uint64_t want[] = {expected.stats.packets, expected.stats.lost_packets, expected.stats.duplicate_packets,
+                             expected.stats.reordered_packets, expected.stats.invalid_packets, expected.stats.gaps,
+                             expected.stats.gap_samples, expected.stats.resyncs};
+    const char* names[] = {"packets", "lost", "duplicate", "out of order", "invalid", "gaps", "gap samples", "resyncs"};
+    for (size_t i = 0; i < 8; ++i) {
+        if (got[i] != want[i]) {
+            std::printf("  counter %-12s %lu, expected %lu\n", names[i], static_cast<unsigned long>(got[i]),
+                        static_cast<unsigned long>(want[i]));
+            ++errors;
+        }
+    }
+
+    // 全部样本仍在内存窗口内：按原始样本查询，逐样本对照时间轴；时间为样本索引 / 采样率
+    const size_t total = expected.timeline.size();
+    std::vector<float> times(total + 1), values(total + 1);
+    size_t sample_errors = 0;
+    for (size_t ch = 0; ch < stream.channel_count; ++ch) {
+        size_t points = manager.queryEnvelope(ch, 0.0, (total - 1) / stream.sample_rate, total, times.data(),
+                                              values.data());
+        if (points != total) {
+            std::printf("  ch %zu: %zu samples in the store, expected %zu\n", ch, points, total);
+            return errors + 1;
+        }
+        for (size_t i = 0; i < total; ++i) {
+            int64_t sequence = expected.timeline[i];
+            bool ok = times[i] == static_cast<float>(i / stream.sample_rate) &&
+                      (sequence < 0 ? std::isnan(values[i])
+                                    : values[i] == sampleValue(uint64_t(sequence) * spp + i % spp, ch));
+            if (!ok) {
+                if (sample_errors == 0) {
+                    std::printf("  ch %zu sample %zu: (%g, %g), expected %s\n", ch, i, times[i], values[i],
+                                sequence < 0 ? "NaN" : "packet data");
+                }
+                ++sample_errors;
+            }
+        }
+    }
+    errors += sample_errors;
+    std::printf("sequence %zu packets sent: %lu written, %lu lost, %lu duplicate, %lu out of order, %lu invalid, "
+                "%lu gaps, %lu resyncs, %zu sample errors\n",
+                script.size(), static_cast<unsigned long>(stats.packets), static_cast<unsigned long>(stats.lost_packets),
+                static_cast<unsigned long>(stats.duplicate_packets), static_cast<unsigned long>(stats.reordered_packets),
+                static_cast<unsigned long>(stats.invalid_packets), static_cast<unsigned long>(stats.gaps),
+                static_cast<unsigned long>(stats.resyncs), sample_errors);
+    return errors;
+}
+
+// 超过环形缓冲容量的缺口：索引推进整个缺口，可读窗口内全是 NaN，之后的包照常写入
+size_t verifyLongGap(const StreamDescriptor& stream) {
+    const size_t spp = stream.samples_per_packet;
+    DataManager manager(stream);
+    std::vector<uint8_t> packet(stream.packetSize());
+    PacketBatch batch;
+    batch.data = packet.data();
+    batch.packet_count = 1;
+    batch.packet_size = packet.size();
+
+    const uint64_t resume = static_cast<uint64_t>(10.0 * stream.sample_rate) / spp;   // 10 秒后恢复
+    for (uint64_t sequence : {uint64_t(0), uint64_t(1), resume, resume + 1}) {
+        fillPacket(packet.data(), stream, sequence, sequence * spp);
+        manager.addPacketBatch(batch);
+    }
+    manager.setFramePacing(false);
+    manager.setProcessingEnabled(true);
+    // 整环跳变后第一帧约需 100ms（显示线程要处理整个可读窗口），轮询而不是固定等待
+    const auto deadline = Clock::now() + std::chrono::seconds(10);
+    const DisplayFrame* latest = &manager.acquireDisplayFrame();
+    while (latest->generation == 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        latest = &manager.acquireDisplayFrame();
+    }
+    const DisplayFrame& frame = *latest;
+    HistoryRange range = manager.getHistoryRange();
+
+    size_t errors = 0;
+    const uint64_t end = (resume + 2) * spp;
+    if (frame.first_sample + frame.sample_count != end ||
+        std::fabs(range.last_time - (end - 1) / stream.sample_rate) > 1e-9) {
+        std::printf("  long gap: stream ends at %lu (%.6f s), expected %lu\n",
+                    static_cast<unsigned long>(frame.first_sample + frame.sample_count), range.last_time,
+                    static_cast<unsigned long>(end));
+        ++errors;
+    }
+    for (size_t i = 0; i < frame.sample_count && errors == 0; ++i) {
+        uint64_t index = frame.first_sample + i;
+        float value = frame.channel(5)[frame.physicalIndex(i)];
+        bool ok = index < resume * spp ? std::isnan(value) : value == sampleValue(index, 5);
+        if (!ok) {
+            std::printf("  long gap: sample %lu is %g\n", static_cast<unsigned long>(index), value);
+            ++errors;
+        }
+    }
+    std::printf("long gap %.1f s: %lu samples filled, %zu errors\n", (resume - 2) * spp / stream.sample_rate,
+                static_cast<unsigned long>(manager.getPacketStats().gap_samples), errors);
+    return errors;
+}
+
+// 带包头的数据流录制后读回
+size_t verifyRecording(const StreamDescriptor& stream, const std::string& path) {
+    const size_t packet_count = 3000;
+    std::vector<uint8_t> data(packet_count * stream.packetSize());
+    for (size_t p = 0; p < packet_count; ++p) {
+        fillPacket(data.data() + p * stream.packetSize(), stream, p, p * stream.samples_per_packet);
+    }
+
+    size_t errors = 0;
+    for (ChunkCodec codec : {ChunkCodec::Raw, ChunkCodec::ShuffleRle}) {
+        Recorder recorder;
+        if (!recorder.open(path, stream, Recorder::DEFAULT_CHUNK_SIZE, Recorder::DEFAULT_BUFFER_COUNT, codec)) {
+            return errors + 1;
+        }
+        for (size_t first = 0; first < packet_count; first += 100) {
+            PacketBatch batch;
+            batch.data = data.data() + first * stream.packetSize();
+            batch.packet_count = std::min<size_t>(100, packet_count - first);
+            batch.packet_size = stream.packetSize();
+            recorder.append(batch);
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+        recorder.close();
+
+        RecordingReader reader;
+        size_t read = 0;
+        bool ok = reader.open(path) && reader.stream() == stream;
+        std::vector<uint8_t> packets;
+        for (size_t chunk = 0; ok && chunk < reader.chunkCount(); ++chunk) {
+            ok = reader.decodeChunk(chunk, packets) &&
+                 std::memcmp(packets.data(), data.data() + read * stream.packetSize(), packets.size()) == 0;
+            read += reader.chunkInfo(chunk).packet_count;
+        }
+        if (!ok || read != packet_count) {
+            std::printf("  record %s: %zu of %zu packets read back intact\n", chunkCodecName(codec), read,
+                        packet_count);
+            ++errors;
+        }
+        std::printf("record   %-12s %zu packets with headers, %s\n", chunkCodecName(codec), read,
+                    ok ? "round-trip ok" : "MISMATCH");
+        unlink(path.c_str());
+    }
+    return errors;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t packet_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::string dir = argc > 2 ? argv[2] : "/tmp";
+
+    StreamDescriptor headerless;
+    StreamDescriptor headered;
+    headered.packet_header = true;
+
+    double plain_ns = measureThroughput(headerless, packet_count);
+    double header_ns = measureThroughput(headered, packet_count);
+    std::printf("ingest   headerless %zu B: %.0f ns/packet | with header %zu B: %.0f ns/packet (%+.1f%%)\n",
+                headerless.packetSize(), plain_ns, headered.packetSize(), header_ns,
+                (header_ns / plain_ns - 1.0) * 100.0);
+
+    size_t errors = 0;
+    errors += verifySequencing(headered);
+    errors += verifyLongGap(headered);
+    errors += verifyRecording(headered, dir + "/sensormonitor_bench_packet_loss.rec");
+
+    std::printf("\nverification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
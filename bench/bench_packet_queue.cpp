@@ -0,0 +1,229 @@
+// 接收线程与处理阶段之间的包队列基准
+// - 停顿隔离：模拟接收线程按流速率交付（每批约14个包），处理阶段（DataManager 解码）每隔一段时间停顿 30ms；
+//   比较直接在接收线程上处理与经过 PacketQueue 时接收线程单次交付的最长耗时，以及队列深度的高水位
+// - 吞吐：单个/多个生产者全速入队，处理线程只做校验，报告每秒入队的包数
+// - 策略校验：多个生产者全速入队、处理线程放慢，使队列持续溢出；核对各策略下
+//   交付数 + 丢弃数 == 入队数、每个生产者的包按序交付、Block 不丢包、单个生产者时 DropOldest 保留最后的包
+// 任何校验失败都以非零退出码返回
+// 用法: bench_packet_queue [每个生产者的包数，默认 50000] [生产者数，默认 4]
+#include "Core/DataManager.h"
+#include "Core/PacketQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t STREAM_BATCH = 14;             // 实测 TCP 接收每次 recv 约14个包
+constexpr double STALL_EVERY_SECONDS = 0.25;
+constexpr auto STALL = std::chrono::milliseconds(30);
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 按流速率交付 seconds 秒的数据，返回单次交付的最长耗时（毫秒）
+template <typename Deliver>
+double paceStream(const StreamDescriptor& stream, double seconds, Deliver deliver) {
+    std::vector<uint8_t> data(STREAM_BATCH * stream.packetSize(), 0);
+    PacketBatch batch;
+    batch.data = data.data();
+    batch.packet_count = STREAM_BATCH;
+    batch.packet_size = stream.packetSize();
+
+    const double batch_period = STREAM_BATCH / stream.packetsPerSecond();
+    const size_t batches = static_cast<size_t>(seconds / batch_period);
+    double worst = 0.0;
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < batches; ++i) {
+        std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+                                                  std::chrono::duration<double>(i * batch_period)));
+        Clock::time_point t0 = Clock::now();
+        deliver(batch);
+        worst = std::max(worst, secondsSince(t0) * 1e3);
+    }
+    return worst;
+}
+
+// 处理阶段：解码写入 DataManager，每 STALL_EVERY_SECONDS 停顿一次（模拟磁盘写满、锁竞争等）
+struct StallingStage {
+    DataManager& manager;
+    Clock::time_point last_stall = Clock::now();
+
+    void operator()(const PacketBatch& batch) {
+        manager.addPacketBatch(batch);
+        if (secondsSince(last_stall) >= STALL_EVERY_SECONDS) {
+            std::this_thread::sleep_for(STALL);
+            last_stall = Clock::now();
+        }
+    }
+};
+
+size_t runStallIsolation(const StreamDescriptor& stream) {
+    const double seconds = 2.0;
+    size_t errors = 0;
+
+    DataManager direct_manager(stream);
+    StallingStage direct_stage{direct_manager};
+    double direct_worst = paceStream(stream, seconds, [&](const PacketBatch& batch) { direct_stage(batch); });
+    std::printf("stall    direct:  longest delivery on the receive thread %6.2f ms\n", direct_worst);
+
+    DataManager queued_manager(stream);
+    StallingStage queued_stage{queued_manager};
+    PacketQueue queue(stream.packetSize(), PacketQueue::DEFAULT_SLOTS);
+    queue.start([&](const PacketBatch& batch) { queued_stage(batch); });
+    double queued_worst = paceStream(stream, seconds, [&](const PacketBatch& batch) { queue.push(batch); });
+    queue.stop();
+    PacketQueueStats stats = queue.getStats();
+    std::printf("stall    queued:  longest delivery on the receive thread %6.2f ms, high-water %zu slots "
+                "(%zu packets), %lu dropped\n",
+                queued_worst, stats.high_water_slots, stats.high_water_packets,
+                static_cast<unsigned long>(stats.dropped_newest + stats.dropped_oldest));
+
+    if (stats.delivered_packets != stats.pushed_packets || stats.dropped_newest + stats.dropped_oldest != 0 ||
+        queued_worst * 1e-3 >= std::chrono::duration<double>(STALL).count()) {
+        std::printf("  stall: the queue did not absorb the stalls\n");
+        ++errors;
+    }
+    return errors;
+}
+
+// 包的前16字节：生产者编号 + 序号
+void tagPacket(uint8_t* packet, uint64_t producer, uint64_t sequence) {
+    std::memcpy(packet, &producer, sizeof(producer));
+    std::memcpy(packet + sizeof(producer), &sequence, sizeof(sequence));
+}
+
+struct PolicyResult {
+    double packets_per_sec = 0.0;
+    size_t errors = 0;
+};
+
+// producers 个线程各全速入队 packets 个包；consumer_ns 为处理线程每个包额外的忙等时间
+PolicyResult runProducers(const StreamDescriptor& stream, OverflowPolicy policy, size_t producers, size_t packets,
+                          int consumer_ns, bool verbose) {
+    const size_t batch_packets = STREAM_BATCH;
+    PacketQueue queue(stream.packetSize(), 32, policy);
+
+    std::vector<uint64_t> next_expected(producers, 0);   // 每个生产者下一个不早于的序号
+    std::vector<uint64_t> delivered(producers, 0);
+    std::vector<uint64_t> last_seen(producers, UINT64_MAX);
+    size_t order_errors = 0;
+    queue.start([&](const PacketBatch& batch) {
+        for (size_t i = 0; i < batch.packet_count; ++i) {
+            uint64_t producer, sequence;
+            std::memcpy(&producer, batch.packet(i), sizeof(producer));
+            std::memcpy(&sequence, batch.packet(i) + sizeof(producer), sizeof(sequence));
+            if (producer >= producers || sequence < next_expected[producer]) {
+                ++order_errors;
+                continue;
+            }
+            next_expected[producer] = sequence + 1;
+            last_seen[producer] = sequence;
+            ++delivered[producer];
+        }
+        if (consumer_ns > 0) {
+            Clock::time_point until = Clock::now() + std::chrono::nanoseconds(consumer_ns * batch.packet_count);
+            while (Clock::now() < until) {
+            }
+        }
+    });
+
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::vector<uint8_t> data(batch_packets * stream.packetSize(), 0);
+            PacketBatch batch;
+            batch.data = data.data();
+            batch.packet_size = stream.packetSize();
+            for (size_t first = 0; first < packets; first += batch_packets) {
+                batch.packet_count = std::min(batch_packets, packets - first);
+                for (size_t i = 0; i < batch.packet_count; ++i) {
+                    tagPacket(data.data() + i * stream.packetSize(), p, first + i);
+                }
+                queue.push(batch);
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    double push_seconds = secondsSince(start);
+    queue.stop();
+    PacketQueueStats stats = queue.getStats();
+
+    PolicyResult result;
+    result.packets_per_sec = producers * packets / push_seconds;
+    const uint64_t sent = producers * packets;
+    uint64_t delivered_total = 0;
+    for (uint64_t count : delivered) delivered_total += count;
+    const uint64_t dropped = stats.dropped_newest + stats.dropped_oldest;
+
+    bool ok = order_errors == 0 && delivered_total == stats.delivered_packets && delivered_total + dropped == sent &&
+              stats.pushed_packets == sent - stats.dropped_newest && stats.depth_slots == 0 &&
+              stats.depth_packets == 0 && stats.high_water_slots <= stats.slot_count;
+    switch (policy) {
+    case OverflowPolicy::Block:
+        ok = ok && dropped == 0;
+        break;
+    case OverflowPolicy::DropOldest:
+        // 多个生产者时互相丢弃对方的槽，只有单个生产者能保证最后的包一定交付
+        ok = ok && stats.dropped_newest == 0 && (producers > 1 || last_seen[0] == packets - 1);
+        break;
+    case OverflowPolicy::DropNewest:
+        ok = ok && stats.dropped_oldest == 0;
+        break;
+    }
+    if (!ok) {
+        std::printf("  %s: sent %lu, delivered %lu (queue says %lu), dropped %lu newest + %lu oldest, "
+                    "%zu out of order, depth %zu\n",
+                    overflowPolicyName(policy), static_cast<unsigned long>(sent),
+                    static_cast<unsigned long>(delivered_total), static_cast<unsigned long>(stats.delivered_packets),
+                    static_cast<unsigned long>(stats.dropped_newest), static_cast<unsigned long>(stats.dropped_oldest),
+                    order_errors, stats.depth_slots);
+        ++result.errors;
+    }
+    if (verbose) {
+        std::printf("policy   %-11s %zu producers: %7.0f kpackets/s pushed, %5.1f%% delivered, high-water %zu/%zu "
+                    "slots, %lu blocked pushes%s\n",
+                    overflowPolicyName(policy), producers, result.packets_per_sec / 1e3,
+                    100.0 * delivered_total / sent, stats.high_water_slots, stats.slot_count,
+                    static_cast<unsigned long>(stats.blocked_pushes), ok ? "" : "  FAILED");
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t packets = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    size_t producers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    producers = std::max<size_t>(producers, 1);
+
+    StreamDescriptor stream;
+    size_t errors = 0;
+    errors += runStallIsolation(stream);
+
+    for (size_t threads : {size_t(1), producers}) {
+        PolicyResult result = runProducers(stream, OverflowPolicy::Block, threads, packets, 0, false);
+        errors += result.errors;
+        std::printf("throughput %zu producer%s: %.2f Mpackets/s (%.1f GB/s copied into the pool)\n", threads,
+                    threads > 1 ? "s" : " ", result.packets_per_sec / 1e6,
+                    result.packets_per_sec * stream.packetSize() / 1e9);
+    }
+
+    // 处理线程每包 2us，远慢于生产者，队列持续溢出
+    for (OverflowPolicy policy : {OverflowPolicy::Block, OverflowPolicy::DropOldest, OverflowPolicy::DropNewest}) {
+        errors += runProducers(stream, policy, producers, packets / 4, 2000, true).errors;
+    }
+    errors += runProducers(stream, OverflowPolicy::DropOldest, 1, packets / 4, 2000, true).errors;
+
+    std::printf("\nverification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
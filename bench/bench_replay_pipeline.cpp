@@ -0,0 +1,265 @@
+// 回放驱动的接收→显示流水线基准
+// 先用 Recorder 生成一段确定性的录制文件，再用 ReplaySubscriber 回放：
+// - 不限速：回放直接驱动 DataManager（显示线程持续出帧），报告整条流水线的吞吐，并校验最终显示帧的内容；
+//   未压缩与压缩（shuffle-rle，回放时逐块解码）的录制文件各一次
+// - 1x / 10x：报告定速精度（每批到达时刻相对应到时刻的延迟分位数，负值表示提前）
+// - 旧格式：写出 cached_samples.bin 并回放，逐包核对重排后的内容
+// 任何校验失败都以非零退出码返回
+// 用法: bench_replay_pipeline [录制秒数，默认 20] [定速阶段秒数，默认 2] [目录，默认 /tmp]
+#include "Core/DataManager.h"
+#include "IO/ReplaySubscriber.h"
+#include "Storage/Recorder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+float sampleValue(uint64_t sample_index, size_t channel) {
+    return static_cast<float>((sample_index * 131 + channel) % 4096);
+}
+
+void fillPacket(uint8_t* packet, const StreamDescriptor& stream, uint64_t first_sample) {
+    float* samples = reinterpret_cast<float*>(packet);
+    for (size_t ch = 0; ch < stream.channel_count; ++ch) {
+        for (size_t s = 0; s < stream.samples_per_packet; ++s) {
+            samples[ch * stream.samples_per_packet + s] = sampleValue(first_sample + s, ch);
+        }
+    }
+}
+
+bool checkPacket(const uint8_t* packet, const StreamDescriptor& stream, uint64_t first_sample) {
+    for (size_t ch = 0; ch < stream.channel_count; ++ch) {
+        for (size_t s = 0; s < stream.samples_per_packet; ++s) {
+            float value;
+            std::memcpy(&value, packet + (ch * stream.samples_per_packet + s) * sizeof(float), sizeof(value));
+            if (value != sampleValue(first_sample + s, ch)) return false;
+        }
+    }
+    return true;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+
+// 生成录制文件；按写线程的进度节流，保证不丢包
+bool writeRecording(const std::string& path, const StreamDescriptor& stream, uint64_t packet_count,
+                    ChunkCodec codec) {
+    Recorder recorder;
+    if (!recorder.open(path, stream, Recorder::DEFAULT_CHUNK_SIZE, Recorder::DEFAULT_BUFFER_COUNT, codec)) return false;
+    const size_t packets_per_chunk =
+        (Recorder::DEFAULT_CHUNK_SIZE - RecordingFormat::CHUNK_HEADER_SIZE) / stream.packetSize();
+
+    std::vector<uint8_t> data(64 * stream.packetSize());
+    uint64_t sequence = 0;
+    while (sequence < packet_count) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(64, packet_count - sequence));
+        for (size_t i = 0; i < count; ++i) {
+            fillPacket(data.data() + i * stream.packetSize(), stream, (sequence + i) * stream.samples_per_packet);
+        }
+        PacketBatch batch;
+        batch.data = data.data();
+        batch.packet_count = count;
+        batch.packet_size = stream.packetSize();
+        recorder.append(batch);
+        sequence += count;
+        while (sequence / packets_per_chunk > recorder.getStats().chunks_written + Recorder::DEFAULT_BUFFER_COUNT / 2) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    recorder.close();
+    return recorder.getStats().dropped_packets == 0;
+}
+
+// 不限速回放驱动 DataManager，返回错误数
+size_t runPipeline(const std::string& path, const StreamDescriptor& stream, uint64_t packet_count, const char* name) {
+    DataManager manager(stream);
+    manager.setFramePacing(false);
+    manager.setProcessingEnabled(true);
+
+    ReplaySubscriber replay(path, stream, 0.0);
+    Clock::time_point first_batch;
+    std::atomic<bool> started{false};
+    replay.startBatch([&](const PacketBatch& batch) {
+        if (!started.exchange(true)) first_batch = Clock::now();
+        manager.addPacketBatch(batch);
+    });
+    while (!replay.finished()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - first_batch).count();
+    SubscriberStats stats = replay.getStats();
+    replay.stop();
+
+    // 等显示线程追上，校验最终显示帧
+    const uint64_t total_samples = packet_count * stream.samples_per_packet;
+    const DisplayFrame* frame = nullptr;
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        manager.requestDisplayFrame();
+        frame = &manager.acquireDisplayFrame();
+        if (frame->first_sample + frame->sample_count == total_samples) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    size_t errors = 0;
+    if (frame->first_sample + frame->sample_count != total_samples || frame->sample_count == 0) {
+        std::printf("  pipeline: display frame ends at %lu, expected %lu\n",
+                    static_cast<unsigned long>(frame->first_sample + frame->sample_count),
+                    static_cast<unsigned long>(total_samples));
+        ++errors;
+    } else {
+        for (size_t ch = frame->channel_first; ch < frame->channel_first + frame->channel_count; ++ch) {
+            const float* values = frame->channel(ch);
+            for (size_t i = 0; i < frame->sample_count; ++i) {
+                if (values[frame->physicalIndex(i)] != sampleValue(frame->first_sample + i, ch)) {
+                    if (errors == 0) std::printf("  pipeline: display frame mismatch at ch %zu\n", ch);
+                    ++errors;
+                    break;
+                }
+            }
+        }
+    }
+    if (stats.packets != packet_count) {
+        std::printf("  pipeline: %lu packets delivered, expected %lu\n", static_cast<unsigned long>(stats.packets),
+                    static_cast<unsigned long>(packet_count));
+        ++errors;
+    }
+
+    double packets_per_sec = stats.packets / elapsed;
+    std::printf("%-8s %9lu packets %7.3f s  %10.0f packets/s (%6.1fx stream)  %6.2f GB/s  %5.1f packets/batch  %lu display frames\n",
+                name, static_cast<unsigned long>(stats.packets), elapsed, packets_per_sec,
+                packets_per_sec / stream.packetsPerSecond(), stats.bytes / elapsed / 1e9,
+                stats.batches ? double(stats.packets) / stats.batches : 0.0,
+                static_cast<unsigned long>(frame->generation));
+    return errors;
+}
+
+// 定速回放 seconds 秒，统计每批到达时刻相对应到时刻（最后一个样本的时刻）的延迟
+size_t runPaced(const std::string& path, const StreamDescriptor& stream, double speed, double seconds) {
+    std::vector<double> arrivals;
+    std::vector<uint64_t> delivered;
+    arrivals.reserve(1 << 20);
+    delivered.reserve(1 << 20);
+    uint64_t cumulative = 0;
+
+    ReplaySubscriber replay(path, stream, speed);
+    replay.startBatch([&](const PacketBatch& batch) {
+        if (arrivals.size() == arrivals.capacity()) return;
+        cumulative += batch.packet_count;
+        arrivals.push_back(std::chrono::duration<double>(Clock::now().time_since_epoch()).count());
+        delivered.push_back(cumulative);
+    });
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    replay.stop();
+
+    if (arrivals.size() < 2) {
+        std::printf("  paced %gx: no batches delivered\n", speed);
+        return 1;
+    }
+
+    // 以第一批为基准：第 k 批的应到时刻 = (累计包数 x 每包时长) 的差
+    const double packet_seconds = stream.samples_per_packet / (stream.sample_rate * speed);
+    std::vector<double> lateness_us;
+    for (size_t k = 1; k < arrivals.size(); ++k) {
+        double due = (delivered[k] - delivered[0]) * packet_seconds;
+        lateness_us.push_back((arrivals[k] - arrivals[0] - due) * 1e6);
+    }
+    double elapsed = arrivals.back() - arrivals.front();
+    double rate = (delivered.back() - delivered.front()) / elapsed;
+    std::sort(lateness_us.begin(), lateness_us.end());
+
+    char name[16];
+    std::snprintf(name, sizeof(name), "%gx", speed);
+    std::printf("%-8s %9lu packets %7.3f s  %10.0f packets/s (%6.2fx stream)  lateness us: min %.1f p50 %.1f p99 %.1f max %.1f\n",
+                name, static_cast<unsigned long>(delivered.back()), elapsed, rate,
+                rate / stream.packetsPerSecond(), lateness_us.front(), percentile(lateness_us, 0.5),
+                percentile(lateness_us, 0.99), lateness_us.back());
+
+    // 速率偏差超过 1% 视为定速失败
+    double expected = stream.packetsPerSecond() * speed;
+    if (std::abs(rate - expected) > expected * 0.01) {
+        std::printf("  paced %gx: rate off by more than 1%%\n", speed);
+        return 1;
+    }
+    return 0;
+}
+
+// 旧格式：[size_t 通道号][size_t 样本数][float32 x 样本数] 依次写出每个通道
+size_t runLegacy(const std::string& path, const StreamDescriptor& stream, size_t samples_per_channel) {
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::vector<float> samples(samples_per_channel);
+        for (size_t channel = 0; channel < stream.channel_count; ++channel) {
+            for (size_t i = 0; i < samples_per_channel; ++i) samples[i] = sampleValue(i, channel);
+            out.write(reinterpret_cast<const char*>(&channel), sizeof(channel));
+            out.write(reinterpret_cast<const char*>(&samples_per_channel), sizeof(samples_per_channel));
+            out.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(float));
+        }
+    }
+
+    size_t errors = 0;
+    uint64_t packets = 0;
+    ReplaySubscriber replay(path, stream, 0.0);
+    replay.startBatch([&](const PacketBatch& batch) {
+        for (size_t i = 0; i < batch.packet_count; ++i, ++packets) {
+            if (!checkPacket(batch.packet(i), stream, packets * stream.samples_per_packet)) ++errors;
+        }
+    });
+    while (!replay.finished()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    replay.stop();
+
+    uint64_t expected = samples_per_channel / stream.samples_per_packet;
+    std::printf("%-8s %9lu packets, %zu mismatched\n", "legacy", static_cast<unsigned long>(packets), errors);
+    if (packets != expected) {
+        std::printf("  legacy: expected %lu packets\n", static_cast<unsigned long>(expected));
+        ++errors;
+    }
+    return errors;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double recording_seconds = argc > 1 ? std::atof(argv[1]) : 20.0;
+    double paced_seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    std::string dir = argc > 3 ? argv[3] : "/tmp";
+
+    StreamDescriptor stream;
+    const std::string recording_path = dir + "/sensormonitor_bench_replay.rec";
+    const std::string compressed_path = dir + "/sensormonitor_bench_replay_compressed.rec";
+    const std::string legacy_path = dir + "/sensormonitor_bench_cached_samples.bin";
+    const uint64_t packet_count = static_cast<uint64_t>(recording_seconds * stream.packetsPerSecond());
+
+    if (!writeRecording(recording_path, stream, packet_count, ChunkCodec::Raw) ||
+        !writeRecording(compressed_path, stream, packet_count, ChunkCodec::ShuffleRle)) {
+        std::printf("failed to write the recordings without drops\n");
+        return 1;
+    }
+
+    size_t errors = 0;
+    errors += runPipeline(recording_path, stream, packet_count, "max");
+    errors += runPipeline(compressed_path, stream, packet_count, "max/rle");
+    errors += runPaced(recording_path, stream, 1.0, paced_seconds);
+    errors += runPaced(recording_path, stream, 10.0, paced_seconds);
+    errors += runLegacy(legacy_path, stream, 10000);
+
+    unlink(recording_path.c_str());
+    unlink(compressed_path.c_str());
+    unlink(legacy_path.c_str());
+    std::printf("\nverification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
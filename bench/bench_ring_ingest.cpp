@@ -0,0 +1,108 @@
+// 持续写入吞吐基准：旧版 vector 历史（满后 erase(begin())） vs ChannelRingStore
+// 用法: bench_ring_ingest [legacy_packets] [ring_packets]
+#include "Core/ChannelRingStore.h"
+#include "Core/DataManager.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr size_t CHANNEL_COUNT = StreamFormat::CHANNEL_COUNT;
+constexpr size_t SAMPLES_PER_PACKET = StreamFormat::SAMPLES_PER_PACKET;
+constexpr size_t HISTORY_SAMPLES = 50000;
+constexpr double SAMPLE_RATE = StreamFormat::SAMPLE_RATE;
+constexpr double STREAM_PACKETS_PER_SEC = SAMPLE_RATE / SAMPLES_PER_PACKET;
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<float> makePacket(size_t seed) {
+    std::vector<float> packet(CHANNEL_COUNT * SAMPLES_PER_PACKET);
+    for (size_t i = 0; i < packet.size(); ++i) {
+        packet[i] = static_cast<float>((seed * 31 + i) % 1000) * 0.001f;
+    }
+    return packet;
+}
+
+// 与旧版 DataManager::processBinaryPacket 相同的写入方式
+void legacyIngest(std::vector<std::vector<float>>& channels, const float* samples) {
+    for (size_t sample = 0; sample < SAMPLES_PER_PACKET; ++sample) {
+        for (size_t channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            size_t index = channel * SAMPLES_PER_PACKET + sample;
+            if (channels[channel].size() >= HISTORY_SAMPLES) {
+                channels[channel].erase(channels[channel].begin());
+            }
+            channels[channel].push_back(samples[index]);
+        }
+    }
+}
+
+void report(const char* name, size_t packets, double seconds) {
+    double pps = packets / seconds;
+    double samples_per_sec = pps * SAMPLES_PER_PACKET * CHANNEL_COUNT;
+    std::printf("%-28s %10zu packets  %9.3f s  %12.0f packets/s  %8.1f Msamples/s  %8.1fx stream rate\n",
+                name, packets, seconds, pps, samples_per_sec / 1e6, pps / STREAM_PACKETS_PER_SEC);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t legacy_packets = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50;
+    size_t ring_packets = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+
+    std::vector<std::vector<float>> packets;
+    for (size_t i = 0; i < 16; ++i) {
+        packets.push_back(makePacket(i));
+    }
+
+    // 旧实现：先填满到上限，测量稳态（每个样本一次 O(n) 搬移）
+    {
+        std::vector<std::vector<float>> channels(CHANNEL_COUNT);
+        for (auto& channel : channels) {
+            channel.assign(HISTORY_SAMPLES, 0.0f);
+        }
+        auto start = Clock::now();
+        for (size_t i = 0; i < legacy_packets; ++i) {
+            legacyIngest(channels, packets[i % packets.size()].data());
+        }
+        report("legacy vector erase", legacy_packets,
+               std::chrono::duration<double>(Clock::now() - start).count());
+    }
+
+    // 环形缓冲：同样从已写满状态开始
+    {
+        ChannelRingStore store(CHANNEL_COUNT, HISTORY_SAMPLES);
+        for (size_t i = 0; i < store.capacity() / SAMPLES_PER_PACKET; ++i) {
+            store.writePacket(packets[i % packets.size()].data(), SAMPLES_PER_PACKET);
+        }
+        store.publish();
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < ring_packets; ++i) {
+            store.writePacket(packets[i % packets.size()].data(), SAMPLES_PER_PACKET);
+            store.publish();
+        }
+        report("ChannelRingStore", ring_packets,
+               std::chrono::duration<double>(Clock::now() - start).count());
+    }
+
+    // 完整的 DataManager 写入路径（含包大小校验与加锁）
+    {
+        DataManager manager;
+        std::vector<std::vector<uint8_t>> raw_packets;
+        for (const auto& packet : packets) {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(packet.data());
+            raw_packets.emplace_back(bytes, bytes + packet.size() * sizeof(float));
+        }
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < ring_packets; ++i) {
+            manager.addBinaryPacket(raw_packets[i % raw_packets.size()]);
+        }
+        report("DataManager::addBinaryPacket", ring_packets,
+               std::chrono::duration<double>(Clock::now() - start).count());
+    }
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+// 共享内存传输与 TCP 回环的端到端对比
+// 每种传输各 fork 一个本机发送进程（模拟采集进程），接收端用 ShmSubscriber / SocketSubscriber：
+// - 延迟阶段：按流速率的 rate_mult 倍定速发送，包内携带发送时刻，接收回调中计算延迟分位数
+// - 吞吐阶段：发送端全速发送，报告持续吞吐相对 22.5kHz 流速率的倍数
+// 用法: bench_shm_transport [packets，默认 200000] [rate_mult，默认 4] [tcp_port，默认 5599]
+#include "Core/StreamFormat.h"
+#include "IO/ShmRingWriter.h"
+#include "IO/ShmSubscriber.h"
+#include "IO/SocketSubscriber.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr size_t PACKAGE_SIZE = StreamFormat::PACKAGE_SIZE;
+constexpr double STREAM_PACKETS_PER_SEC = StreamFormat::SAMPLE_RATE / StreamFormat::SAMPLES_PER_PACKET;
+constexpr size_t LATENCY_PACKETS = 20000;
+const char* SHM_NAME = "/sensormonitor_bench";
+
+using Clock = std::chrono::steady_clock;
+
+// steady_clock 在 Linux 上是 CLOCK_MONOTONIC，跨进程可比
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// 包头 16 字节：发送时刻 + 序号，其余为负载
+void stampPacket(uint8_t* packet, uint64_t sequence) {
+    int64_t stamp = nowNs();
+    std::memcpy(packet, &stamp, sizeof(stamp));
+    std::memcpy(packet + sizeof(stamp), &sequence, sizeof(sequence));
+}
+
+// 发送节奏：packets_per_sec <= 0 表示全速
+struct Pacer {
+    Clock::time_point start = Clock::now();
+    double packets_per_sec;
+
+    void wait(uint64_t sequence) const {
+        if (packets_per_sec > 0) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+                                                      std::chrono::duration<double>(sequence / packets_per_sec)));
+        }
+    }
+};
+
+int runShmProducer(size_t packets, double packets_per_sec) {
+    ShmRingWriter writer;
+    if (!writer.open(SHM_NAME, StreamDescriptor())) {
+        return 1;
+    }
+    // 等接收端完成连接，避免把连接等待计入延迟
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    Pacer pacer{Clock::now(), packets_per_sec};
+    for (uint64_t i = 0; i < packets; ++i) {
+        pacer.wait(i);
+        uint8_t* slot;
+        while ((slot = writer.acquireSlot()) == nullptr) {
+            std::this_thread::yield();   // 基准需要全部送达；真实采集端会直接丢弃
+        }
+        std::memset(slot + 16, 0x3f, PACKAGE_SIZE - 16);
+        stampPacket(slot, i);
+        writer.commitSlot();
+    }
+    // 等接收端读完再关闭，关闭会删除共享内存名
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    return 0;
+}
+
+int runTcpProducer(size_t packets, double packets_per_sec, int port) {
+    int sock = -1;
+    for (int attempt = 0; attempt < 50 && sock < 0; ++attempt) {
+        sock = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close(sock);
+            sock = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    if (sock < 0) {
+        std::fprintf(stderr, "connect 127.0.0.1:%d failed\n", port);
+        return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    std::vector<uint8_t> packet(PACKAGE_SIZE, 0x3f);
+    Pacer pacer{Clock::now(), packets_per_sec};
+    for (uint64_t i = 0; i < packets; ++i) {
+        pacer.wait(i);
+        stampPacket(packet.data(), i);
+        size_t sent = 0;
+        while (sent < packet.size()) {
+            ssize_t n = send(sock, packet.data() + sent, packet.size() - sent, 0);
+            if (n <= 0) {
+                close(sock);
+                return 1;
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+    close(sock);
+    return 0;
+}
+
+struct PhaseResult {
+    uint64_t received = 0;
+    double elapsed = 0.0;
+    SubscriberStats stats;
+    std::vector<int64_t> latencies;
+};
+
+// fork 发送进程并启动接收端，直到收齐或超时
+PhaseResult runPhase(ISubscriber& subscriber, size_t packets, double packets_per_sec, int port) {
+    // 先 fork（此时本进程还没有其他线程），发送进程自己等待接收端就绪
+    pid_t child = fork();
+    if (child == 0) {
+        _exit(port > 0 ? runTcpProducer(packets, packets_per_sec, port)
+                       : runShmProducer(packets, packets_per_sec));
+    }
+
+    PhaseResult result;
+    result.latencies.reserve(packets);
+    std::atomic<uint64_t> received{0};
+    Clock::time_point first_packet;
+
+    subscriber.startBatch([&](const PacketBatch& batch) {
+        int64_t now = nowNs();
+        if (received.load(std::memory_order_relaxed) == 0) {
+            first_packet = Clock::now();
+        }
+        for (size_t i = 0; i < batch.packet_count; ++i) {
+            int64_t stamp;
+            std::memcpy(&stamp, batch.packet(i), sizeof(stamp));
+            result.latencies.push_back(now - stamp);
+        }
+        received.fetch_add(batch.packet_count, std::memory_order_release);
+    });
+
+    auto deadline = Clock::now() + std::chrono::seconds(60);
+    while (received.load(std::memory_order_acquire) < packets && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    result.received = received.load(std::memory_order_acquire);
+    result.elapsed = result.received ? std::chrono::duration<double>(Clock::now() - first_packet).count() : 0.0;
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    subscriber.stop();
+    result.stats = subscriber.getStats();
+    return result;
+}
+
+void report(const char* transport, const PhaseResult& latency, const PhaseResult& throughput, size_t packets) {
+    std::vector<int64_t> sorted = latency.latencies;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) {
+        return sorted.empty() ? 0.0 : sorted[static_cast<size_t>(p * (sorted.size() - 1))] / 1000.0;
+    };
+
+    double pps = throughput.elapsed > 0 ? throughput.received / throughput.elapsed : 0.0;
+    std::printf("%s\n", transport);
+    std::printf("  latency (us): p50 %.1f  p99 %.1f  p99.9 %.1f  max %.1f  (%lu packets, %lu wakeups)\n",
+                percentile(0.5), percentile(0.99), percentile(0.999), percentile(1.0),
+                static_cast<unsigned long>(latency.received),
+                static_cast<unsigned long>(latency.stats.recv_calls));
+    std::printf("  throughput: %lu/%zu packets, %.0f packets/s, %.1f MB/s, %.1fx stream rate\n",
+                static_cast<unsigned long>(throughput.received), packets, pps,
+                pps * PACKAGE_SIZE / (1024.0 * 1024.0), pps / STREAM_PACKETS_PER_SEC);
+    std::printf("  batches: %lu (%.1f packets/batch), syscalls: %lu\n",
+                static_cast<unsigned long>(throughput.stats.batches),
+                throughput.stats.batches ? static_cast<double>(throughput.stats.packets) / throughput.stats.batches : 0.0,
+                static_cast<unsigned long>(throughput.stats.recv_calls));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t packets = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    double rate_mult = argc > 2 ? std::atof(argv[2]) : 4.0;
+    int port = argc > 3 ? std::atoi(argv[3]) : 5599;
+    double paced_rate = rate_mult * STREAM_PACKETS_PER_SEC;
+    size_t latency_packets = std::min(packets, LATENCY_PACKETS);
+
+    std::printf("latency phase: %zu packets at %.0f packets/s; throughput phase: %zu packets\n",
+                latency_packets, paced_rate, packets);
+
+    PhaseResult shm_latency, shm_throughput, tcp_latency, tcp_throughput;
+    {
+        ShmSubscriber subscriber(SHM_NAME);
+        shm_latency = runPhase(subscriber, latency_packets, paced_rate, 0);
+    }
+    {
+        ShmSubscriber subscriber(SHM_NAME);
+        shm_throughput = runPhase(subscriber, packets, 0.0, 0);
+    }
+    {
+        SocketSubscriber subscriber("127.0.0.1", port);
+        tcp_latency = runPhase(subscriber, latency_packets, paced_rate, port);
+    }
+    {
+        SocketSubscriber subscriber("127.0.0.1", port);
+        tcp_throughput = runPhase(subscriber, packets, 0.0, port);
+    }
+
+    report("shm", shm_latency, shm_throughput, packets);
+    report("tcp", tcp_latency, tcp_throughput, packets);
+    return shm_throughput.received == packets && tcp_throughput.received == packets ? 0 : 1;
+}
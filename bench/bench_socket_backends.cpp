@@ -0,0 +1,252 @@
+// TCP 接收后端对比：阻塞 recv、epoll、io_uring（multishot recv + 登记缓冲）
+// 每个阶段 fork 一个本机发送进程，接收端收到的每个包核对序号并计算延迟：
+// - 定速：按流速率的 rate_mult 倍逐包发送，报告每包系统调用数与延迟分位数
+// - 全速：报告吞吐与每包系统调用数
+// 阻塞后端即 epoll 之前的单连接实现（accept 后阻塞 recv），只在本基准中保留作对照
+// 校验：每个阶段收齐所有包且序号连续；任何校验失败都以非零退出码返回
+// 用法: bench_socket_backends [packets，默认 200000] [rate_mult，默认 4] [tcp_port，默认 5603]
+#include "Core/StreamFormat.h"
+#include "IO/SocketSubscriber.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t LATENCY_PACKETS = 20000;
+
+// steady_clock 在 Linux 上是 CLOCK_MONOTONIC，跨进程可比
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// 阻塞后端：只接受一个连接，阻塞 recv 直到有数据（每次读取一次系统调用，没有等待就绪的调用）
+class BlockingSubscriber : public ISubscriber {
+public:
+    BlockingSubscriber(int port, const StreamDescriptor& stream) : port(port), packet_size(stream.packetSize()) {}
+    ~BlockingSubscriber() override { stop(); }
+
+    void startBatch(BatchCallback cb) override {
+        server = socket(AF_INET, SOCK_STREAM, 0);
+        int opt = 1;
+        setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        if (bind(server, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(server, 1) != 0) {
+            std::fprintf(stderr, "blocking: bind/listen on %d failed\n", port);
+            return;
+        }
+        worker = std::thread([this, cb] {
+            int client = accept(server, nullptr, nullptr);
+            if (client < 0) return;
+            int rcvlowat = static_cast<int>(packet_size);
+            setsockopt(client, SOL_SOCKET, SO_RCVLOWAT, &rcvlowat, sizeof(rcvlowat));
+            std::vector<uint8_t> buffer(std::max<size_t>(SocketSubscriber::RECV_BUFFER_SIZE / packet_size, 1) *
+                                        packet_size);
+            size_t buffered = 0;
+            while (true) {
+                ssize_t n = recv(client, buffer.data() + buffered, buffer.size() - buffered, 0);
+                calls.fetch_add(1, std::memory_order_relaxed);
+                if (n <= 0) break;
+                buffered += static_cast<size_t>(n);
+                size_t count = buffered / packet_size;
+                if (count == 0) continue;
+                PacketBatch batch;
+                batch.data = buffer.data();
+                batch.packet_count = count;
+                batch.packet_size = packet_size;
+                cb(batch);
+                packets.fetch_add(count, std::memory_order_relaxed);
+                buffered -= count * packet_size;
+                std::memmove(buffer.data(), buffer.data() + count * packet_size, buffered);
+            }
+            close(client);
+        });
+    }
+
+    void stop() override {
+        if (server >= 0) {
+            shutdown(server, SHUT_RDWR);
+            close(server);
+            server = -1;
+        }
+        if (worker.joinable()) worker.join();
+    }
+
+    SubscriberStats getStats() const override {
+        SubscriberStats stats;
+        stats.packets = packets.load();
+        stats.recv_calls = stats.syscalls = calls.load();
+        return stats;
+    }
+    const char* name() const override { return "blocking"; }
+
+private:
+    int port;
+    size_t packet_size;
+    int server = -1;
+    std::thread worker;
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> calls{0};
+};
+
+int runSender(const StreamDescriptor& stream, size_t packets, double packets_per_sec, int port) {
+    int sock = -1;
+    for (int attempt = 0; attempt < 50 && sock < 0; ++attempt) {
+        sock = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close(sock);
+            sock = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    if (sock < 0) {
+        std::fprintf(stderr, "connect 127.0.0.1:%d failed\n", port);
+        return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // 包头 16 字节：发送时刻 + 序号
+    std::vector<uint8_t> packet(stream.packetSize(), 0x3f);
+    Clock::time_point start = Clock::now();
+    for (uint64_t i = 0; i < packets; ++i) {
+        if (packets_per_sec > 0) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+                                                      std::chrono::duration<double>(i / packets_per_sec)));
+        }
+        int64_t stamp = nowNs();
+        std::memcpy(packet.data(), &stamp, sizeof(stamp));
+        std::memcpy(packet.data() + sizeof(stamp), &i, sizeof(i));
+        size_t sent = 0;
+        while (sent < packet.size()) {
+            ssize_t n = send(sock, packet.data() + sent, packet.size() - sent, 0);
+            if (n <= 0) {
+                close(sock);
+                return 1;
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+    close(sock);
+    return 0;
+}
+
+struct PhaseResult {
+    double packets_per_sec = 0.0;
+    double syscalls_per_packet = 0.0;
+    std::vector<int64_t> latencies;
+    size_t errors = 0;
+};
+
+PhaseResult runPhase(ISubscriber& subscriber, const StreamDescriptor& stream, size_t packets,
+                     double packets_per_sec, int port) {
+    pid_t child = fork();
+    if (child == 0) {
+        _exit(runSender(stream, packets, packets_per_sec, port));
+    }
+
+    PhaseResult result;
+    result.latencies.reserve(packets);
+    std::atomic<uint64_t> received{0};
+    uint64_t next = 0, order_errors = 0;
+    Clock::time_point first_packet;
+    subscriber.startBatch([&](const PacketBatch& batch) {
+        int64_t now = nowNs();
+        if (next == 0) first_packet = Clock::now();
+        for (size_t i = 0; i < batch.packet_count; ++i) {
+            int64_t stamp;
+            uint64_t sequence;
+            std::memcpy(&stamp, batch.packet(i), sizeof(stamp));
+            std::memcpy(&sequence, batch.packet(i) + sizeof(stamp), sizeof(sequence));
+            if (sequence != next) ++order_errors;
+            next = sequence + 1;
+            result.latencies.push_back(now - stamp);
+        }
+        received.fetch_add(batch.packet_count, std::memory_order_release);
+    });
+
+    auto deadline = Clock::now() + std::chrono::seconds(60);
+    while (received.load(std::memory_order_acquire) < packets && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - first_packet).count();
+    int status = 0;
+    waitpid(child, &status, 0);
+    SubscriberStats stats = subscriber.getStats();
+    subscriber.stop();
+
+    const uint64_t total = received.load();
+    result.packets_per_sec = seconds > 0 ? total / seconds : 0.0;
+    result.syscalls_per_packet = total ? double(stats.syscalls) / total : 0.0;
+    if (total != packets || order_errors > 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::printf("  %s: received %lu/%zu packets, %lu out of order\n", subscriber.name(),
+                    static_cast<unsigned long>(total), packets, static_cast<unsigned long>(order_errors));
+        ++result.errors;
+    }
+    return result;
+}
+
+std::unique_ptr<ISubscriber> makeSubscriber(const std::string& backend, const StreamDescriptor& stream, int port) {
+    if (backend == "blocking") return std::make_unique<BlockingSubscriber>(port, stream);
+    SocketBackend socket_backend = SocketBackend::Epoll;
+    parseSocketBackend(backend, socket_backend);
+    return std::make_unique<SocketSubscriber>("127.0.0.1", port, stream, 1, 1, socket_backend);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t packets = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    double rate_mult = argc > 2 ? std::atof(argv[2]) : 4.0;
+    int port = argc > 3 ? std::atoi(argv[3]) : 5603;
+
+    StreamDescriptor stream;
+    const double paced_rate = rate_mult * stream.packetsPerSecond();
+    const size_t paced_packets = std::min(packets, LATENCY_PACKETS);
+    std::printf("paced: %zu packets at %.0f packets/s; full speed: %zu packets of %zu bytes\n\n", paced_packets,
+                paced_rate, packets, stream.packetSize());
+    std::printf("%-9s | %-44s | %s\n", "backend", "paced: syscalls/packet, latency p50/p99 (us)",
+                "full speed: packets/s, MB/s, syscalls/packet");
+
+    size_t errors = 0;
+    for (const char* backend : {"blocking", "epoll", "io_uring"}) {
+        auto paced_subscriber = makeSubscriber(backend, stream, port);
+        PhaseResult paced = runPhase(*paced_subscriber, stream, paced_packets, paced_rate, port);
+        auto full_subscriber = makeSubscriber(backend, stream, port);
+        PhaseResult full = runPhase(*full_subscriber, stream, packets, 0.0, port);
+        errors += paced.errors + full.errors;
+
+        std::sort(paced.latencies.begin(), paced.latencies.end());
+        auto percentile = [&](double p) {
+            return paced.latencies.empty()
+                       ? 0.0
+                       : paced.latencies[static_cast<size_t>(p * (paced.latencies.size() - 1))] / 1000.0;
+        };
+        std::printf("%-9s | %5.3f syscalls/packet, %7.1f / %7.1f us      | %8.0f, %7.1f, %5.3f\n", backend,
+                    paced.syscalls_per_packet, percentile(0.5), percentile(0.99), full.packets_per_sec,
+                    full.packets_per_sec * stream.packetSize() / (1024.0 * 1024.0), full.syscalls_per_packet);
+    }
+
+    std::printf("\nverification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
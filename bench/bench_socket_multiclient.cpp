@@ -0,0 +1,265 @@
+// 多发送端 TCP 接入的负载测试
+// - 扩展性：依次 fork 1、2、4 … N 个本机发送进程，每个全速发送 packets 个带标记的数据包（发送端编号 + 序号），
+//   SocketSubscriber 以 N 个流、min(N, CPU 核数) 个 epoll 线程接收，每个流解码写入各自的 DataManager；
+//   报告总吞吐、每个发送端的吞吐以及相对单个发送端的加速比，并以单线程 memcpy 带宽作为参照上限
+// - 接替：流数少于发送端时，多出的连接排队等待，先到的发送端断开后接替其流编号
+// 校验：每个流上的包来自同一个发送端且序号连续（接替时前一个发送端已发完、新的从 0 开始），
+// 所有包都送达，DataManager 写入的包数与接收数一致；任何校验失败都以非零退出码返回
+// 用法: bench_socket_multiclient [每个发送端的包数，默认 50000] [最多发送端数，默认 8] [tcp_port，默认 5601]
+#include "Core/DataManager.h"
+#include "Core/StreamFormat.h"
+#include "IO/SocketSubscriber.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t SEND_PACKETS = 64;   // 发送端每次 send 的包数
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 包的前16字节：发送端编号 + 序号，其余为 float 负载
+void tagPacket(uint8_t* packet, uint64_t sender, uint64_t sequence) {
+    std::memcpy(packet, &sender, sizeof(sender));
+    std::memcpy(packet + sizeof(sender), &sequence, sizeof(sequence));
+}
+
+int runSender(const StreamDescriptor& stream, uint64_t sender, size_t packets, int port) {
+    int sock = -1;
+    for (int attempt = 0; attempt < 50 && sock < 0; ++attempt) {
+        sock = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close(sock);
+            sock = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    if (sock < 0) {
+        std::fprintf(stderr, "connect 127.0.0.1:%d failed\n", port);
+        return 1;
+    }
+
+    const size_t packet_size = stream.packetSize();
+    std::vector<uint8_t> data(SEND_PACKETS * packet_size);
+    std::vector<float> payload(packet_size / sizeof(float));
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<float>(sender) + 0.001f * static_cast<float>(i % 1000);
+    }
+    for (size_t i = 0; i < SEND_PACKETS; ++i) {
+        std::memcpy(data.data() + i * packet_size, payload.data(), packet_size);
+    }
+
+    for (size_t first = 0; first < packets; first += SEND_PACKETS) {
+        size_t count = std::min(SEND_PACKETS, packets - first);
+        for (size_t i = 0; i < count; ++i) {
+            tagPacket(data.data() + i * packet_size, sender, first + i);
+        }
+        size_t bytes = count * packet_size, sent = 0;
+        while (sent < bytes) {
+            ssize_t n = send(sock, data.data() + sent, bytes - sent, 0);
+            if (n <= 0) {
+                close(sock);
+                return 1;
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+    close(sock);
+    return 0;
+}
+
+// 每个流的校验状态（同一个流的批次按序交付，但不同的流可能在不同线程上并发）
+struct StreamCheck {
+    uint64_t sender = UINT64_MAX;
+    uint64_t next = 0;
+    uint64_t received = 0;
+    uint64_t handovers = 0;
+    uint64_t errors = 0;
+};
+
+struct RunResult {
+    double seconds = 0.0;
+    uint64_t received = 0;
+    size_t errors = 0;
+    SubscriberStats stats;
+};
+
+// senders 个发送进程接入 streams 个流
+RunResult runSenders(const StreamDescriptor& stream, size_t senders, size_t streams, size_t threads,
+                     size_t packets, int port, bool decode) {
+    // 先 fork（此时本进程没有其他线程），发送进程自己重试连接直到接收端就绪
+    std::vector<pid_t> children;
+    for (size_t s = 0; s < senders; ++s) {
+        pid_t child = fork();
+        if (child == 0) {
+            _exit(runSender(stream, s, packets, port));
+        }
+        children.push_back(child);
+    }
+
+    std::vector<StreamCheck> checks(streams);
+    std::vector<std::unique_ptr<DataManager>> managers;
+    if (decode) {
+        for (size_t i = 0; i < streams; ++i) {
+            managers.push_back(std::make_unique<DataManager>(stream));
+        }
+    }
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> routing_errors{0};
+    std::atomic<bool> started{false};
+    Clock::time_point first_packet;
+    std::mutex first_mutex;
+
+    SocketSubscriber subscriber("127.0.0.1", port, stream, streams, threads);
+    subscriber.startBatch([&](const PacketBatch& batch) {
+        if (!started.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(first_mutex);
+            if (!started.load(std::memory_order_relaxed)) {
+                first_packet = Clock::now();
+                started.store(true, std::memory_order_release);
+            }
+        }
+        if (batch.source >= streams) {
+            routing_errors.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        StreamCheck& check = checks[batch.source];
+        for (size_t i = 0; i < batch.packet_count; ++i) {
+            uint64_t sender, sequence;
+            std::memcpy(&sender, batch.packet(i), sizeof(sender));
+            std::memcpy(&sequence, batch.packet(i) + sizeof(sender), sizeof(sequence));
+            if (sender != check.sender) {
+                // 接替：上一个发送端必须已发完，新的从 0 开始
+                if ((check.sender != UINT64_MAX && check.next != packets) || sequence != 0) {
+                    ++check.errors;
+                }
+                if (check.sender != UINT64_MAX) ++check.handovers;
+                check.sender = sender;
+                check.next = 0;
+            }
+            if (sequence != check.next) {
+                ++check.errors;
+            }
+            check.next = sequence + 1;
+        }
+        check.received += batch.packet_count;
+        if (decode) {
+            managers[batch.source]->addPacketBatch(batch);
+        }
+        received.fetch_add(batch.packet_count, std::memory_order_release);
+    });
+
+    const uint64_t expected = senders * packets;
+    auto deadline = Clock::now() + std::chrono::seconds(120);
+    while (received.load(std::memory_order_acquire) < expected && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    RunResult result;
+    result.received = received.load(std::memory_order_acquire);
+    result.seconds = started ? secondsSince(first_packet) : 0.0;
+    for (pid_t child : children) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ++result.errors;
+    }
+    subscriber.stop();
+    result.stats = subscriber.getStats();
+
+    uint64_t handovers = 0;
+    for (size_t i = 0; i < streams; ++i) {
+        result.errors += checks[i].errors;
+        handovers += checks[i].handovers;
+        if (decode && managers[i]->getPacketStats().packets != checks[i].received) {
+            ++result.errors;
+        }
+    }
+    result.errors += routing_errors.load();
+    if (result.received != expected || result.stats.packets != expected ||
+        handovers != senders - std::min(senders, streams)) {
+        ++result.errors;
+    }
+    if (result.errors > 0) {
+        std::printf("  %zu senders on %zu streams: received %lu/%lu packets, %lu handovers, %zu errors\n", senders,
+                    streams, static_cast<unsigned long>(result.received), static_cast<unsigned long>(expected),
+                    static_cast<unsigned long>(handovers), result.errors);
+    }
+    return result;
+}
+
+// 单线程 memcpy 带宽，作为每个接收线程吞吐的参照上限
+double memcpyBandwidth() {
+    const size_t bytes = 64u << 20;
+    std::vector<uint8_t> source(bytes, 1), target(bytes);
+    std::memcpy(target.data(), source.data(), bytes);
+    Clock::time_point start = Clock::now();
+    const int rounds = 8;
+    for (int i = 0; i < rounds; ++i) {
+        source[i] = static_cast<uint8_t>(i);
+        std::memcpy(target.data(), source.data(), bytes);
+    }
+    double seconds = secondsSince(start);
+    return target[rounds - 1] == rounds - 1 ? rounds * bytes / seconds : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t packets = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    size_t max_senders = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8;
+    int port = argc > 3 ? std::atoi(argv[3]) : 5601;
+    max_senders = std::max<size_t>(max_senders, 1);
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+    StreamDescriptor stream;
+    const double packet_bytes = static_cast<double>(stream.packetSize());
+    std::printf("%zu packets of %zu bytes per sender, %zu CPU%s, memcpy %.1f GB/s per thread\n", packets,
+                stream.packetSize(), cores, cores > 1 ? "s" : "", memcpyBandwidth() / 1e9);
+
+    size_t errors = 0;
+    double single_rate = 0.0;
+    for (size_t senders = 1; senders <= max_senders; senders *= 2) {
+        const size_t threads = std::min(senders, cores);
+        RunResult result = runSenders(stream, senders, senders, threads, packets, port, true);
+        errors += result.errors;
+        double rate = result.seconds > 0 ? result.received * packet_bytes / result.seconds : 0.0;
+        if (senders == 1) single_rate = rate;
+        std::printf("%2zu senders, %zu thread%s: %6.2f GB/s total, %6.2f GB/s per sender, %5.2fx vs 1 sender "
+                    "(%.1f packets/recv)%s\n",
+                    senders, threads, threads > 1 ? "s" : " ", rate / 1e9, rate / senders / 1e9,
+                    single_rate > 0 ? rate / single_rate : 0.0,
+                    result.stats.recv_calls ? double(result.stats.packets) / result.stats.recv_calls : 0.0,
+                    result.errors ? "  FAILED" : "");
+    }
+
+    // 4 个发送端争用 2 个流：后到的两个排队，前两个断开后接替
+    const size_t handover_senders = std::max<size_t>(max_senders / 2, 2);
+    RunResult handover = runSenders(stream, handover_senders, handover_senders / 2, 1, packets / 4, port, false);
+    errors += handover.errors;
+    std::printf("handover: %zu senders on %zu streams, %lu packets%s\n", handover_senders, handover_senders / 2,
+                static_cast<unsigned long>(handover.received), handover.errors ? "  FAILED" : "");
+
+    std::printf("\nverification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
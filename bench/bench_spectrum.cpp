@@ -0,0 +1,317 @@
+// 实数 FFT 与功率谱分析的校验与吞吐基准
+// - FFT：随机输入与双精度直接 DFT 逐频点比对（64..4096 点），Parseval 能量守恒（至 65536 点）；
+//   单线程每秒变换次数（1k..64k 点），即每个核心的吞吐
+// - 同步：正弦 + 白噪声通道按约 60Hz 的批量驱动 SpectrumAnalyzer::process()，校验正弦的峰值频点与
+//   积分功率（A²/2）、噪声的平均功率谱密度（2σ²/fs）、NaN 缺口不污染结果；中途切换窗函数、长度与重叠
+// - 线程：按流速率的倍数写入环形缓冲，计算线程独立运行，统计其占用的 CPU 比例与落后丢失的段（随负载变化，只报告），
+//   校验最终的功率谱
+// 校验失败时以非零退出码返回
+// 用法: bench_spectrum [seconds，默认 10] [rate_multiplier，默认 10] [channels，默认 16]
+#include "Core/ChannelRingStore.h"
+#include "Core/RealFft.h"
+#include "Core/SpectrumAnalyzer.h"
+#include "Core/StreamFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t CHANNEL_COUNT = StreamFormat::CHANNEL_COUNT;
+constexpr size_t SAMPLES_PER_PACKET = StreamFormat::SAMPLES_PER_PACKET;
+constexpr double SAMPLE_RATE = StreamFormat::SAMPLE_RATE;
+constexpr size_t HISTORY_SAMPLES = 65536;
+constexpr double PI = 3.14159265358979323846;
+
+constexpr size_t TONE_CHANNEL = 3;
+constexpr double TONE_HZ = 1000.0;
+constexpr double TONE_AMPLITUDE = 0.5;
+constexpr size_t NOISE_CHANNEL = 7;
+constexpr double NOISE_HALF_WIDTH = 0.2;      // 均匀分布 [-a, a]，方差 a²/3
+constexpr size_t GAP_CHANNEL = 9;             // 与 TONE_CHANNEL 相同的信号，含一段 NaN
+constexpr uint64_t GAP_FIRST = 300000;
+constexpr uint64_t GAP_LAST = GAP_FIRST + 40;
+
+using Clock = std::chrono::steady_clock;
+
+// 确定性的均匀噪声，与写入顺序无关
+float noise(uint64_t index, size_t channel) {
+    uint64_t x = index * 0x9E3779B97F4A7C15ull + channel * 0xBF58476D1CE4E5B9ull + 1;
+    x ^= x >> 31;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 29;
+    return static_cast<float>(((x >> 40) / double(1ull << 24) * 2.0 - 1.0) * NOISE_HALF_WIDTH);
+}
+
+float sampleValue(uint64_t index, size_t channel) {
+    if (channel == GAP_CHANNEL && index >= GAP_FIRST && index < GAP_LAST) {
+        return std::nanf("");
+    }
+    if (channel == TONE_CHANNEL || channel == GAP_CHANNEL) {
+        return static_cast<float>(TONE_AMPLITUDE * std::sin(2.0 * PI * TONE_HZ * index / SAMPLE_RATE));
+    }
+    return noise(index, channel);
+}
+
+void writePackets(ChannelRingStore& store, uint64_t& next_sample, size_t packets, std::vector<float>& packet) {
+    for (size_t p = 0; p < packets; ++p) {
+        for (size_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            for (size_t s = 0; s < SAMPLES_PER_PACKET; ++s) {
+                packet[ch * SAMPLES_PER_PACKET + s] = sampleValue(next_sample + s, ch);
+            }
+        }
+        store.writePacket(packet.data(), SAMPLES_PER_PACKET);
+        next_sample += SAMPLES_PER_PACKET;
+    }
+    store.publish();
+}
+
+// 与双精度直接 DFT 的最大误差，按 sqrt(N)（单位方差输入的频点幅度量级）归一化
+double dftError(size_t n, std::mt19937& rng) {
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    RealFft fft(n);
+    std::vector<float> input(n), re(fft.bins()), im(fft.bins());
+    for (float& value : input) value = uniform(rng);
+    fft.transform(input.data(), re.data(), im.data());
+    double max_error = 0.0;
+    for (size_t k = 0; k < fft.bins(); ++k) {
+        double sum_re = 0.0, sum_im = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            const double phase = -2.0 * PI * static_cast<double>((j * k) % n) / n;
+            sum_re += input[j] * std::cos(phase);
+            sum_im += input[j] * std::sin(phase);
+        }
+        max_error = std::max(max_error, std::hypot(sum_re - re[k], sum_im - im[k]));
+    }
+    return max_error / std::sqrt(double(n));
+}
+
+// Parseval：sum x² = (|X0|² + |X_{N/2}|² + 2 sum_{0<k<N/2} |Xk|²) / N，返回相对误差
+double parsevalError(size_t n, std::mt19937& rng) {
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    RealFft fft(n);
+    std::vector<float> input(n), re(fft.bins()), im(fft.bins());
+    double energy = 0.0;
+    for (float& value : input) {
+        value = uniform(rng);
+        energy += double(value) * value;
+    }
+    fft.transform(input.data(), re.data(), im.data());
+    double spectrum = 0.0;
+    for (size_t k = 0; k < fft.bins(); ++k) {
+        const double power = double(re[k]) * re[k] + double(im[k]) * im[k];
+        spectrum += (k == 0 || k == n / 2) ? power : 2.0 * power;
+    }
+    return std::fabs(spectrum / n - energy) / energy;
+}
+
+size_t findRow(const SpectrumSnapshot& snapshot, size_t channel) {
+    for (size_t i = 0; i < snapshot.channels.size(); ++i) {
+        if (snapshot.channels[i] == channel) return i;
+    }
+    return snapshot.channels.size();
+}
+
+double linear(float db) {
+    return std::pow(10.0, db / 10.0);
+}
+
+// 校验一个快照：返回错误数
+size_t checkSnapshot(const SpectrumSnapshot& snapshot, size_t expected_averages, const char* label) {
+    size_t errors = 0;
+    const size_t tone_row = findRow(snapshot, TONE_CHANNEL);
+    const size_t noise_row = findRow(snapshot, NOISE_CHANNEL);
+    const size_t gap_row = findRow(snapshot, GAP_CHANNEL);
+    if (tone_row == snapshot.channels.size() || noise_row == snapshot.channels.size() ||
+        gap_row == snapshot.channels.size() || snapshot.averaged != expected_averages) {
+        std::printf("%s: unexpected snapshot layout (%zu channels, %zu averaged)\n", label,
+                    snapshot.channels.size(), snapshot.averaged);
+        return 1;
+    }
+
+    // 正弦：峰值频点，以及峰值附近积分得到的功率
+    const float* tone = snapshot.channel(tone_row);
+    const size_t peak = static_cast<size_t>(std::max_element(tone, tone + snapshot.bins) - tone);
+    const double expected_bin = TONE_HZ / snapshot.bin_width;
+    double tone_power = 0.0;
+    for (size_t k = peak - 6; k <= peak + 6; ++k) {
+        tone_power += linear(tone[k]) * snapshot.bin_width;
+    }
+    const double expected_power = TONE_AMPLITUDE * TONE_AMPLITUDE / 2.0;
+
+    // 噪声：去掉两端后的平均功率谱密度
+    const float* flat = snapshot.channel(noise_row);
+    double noise_density = 0.0;
+    const size_t first = 8, last = snapshot.bins - 8;
+    for (size_t k = first; k < last; ++k) {
+        noise_density += linear(flat[k]);
+    }
+    noise_density /= static_cast<double>(last - first);
+    const double expected_density = 2.0 * NOISE_HALF_WIDTH * NOISE_HALF_WIDTH / 3.0 / SAMPLE_RATE;
+
+    // NaN 缺口：结果仍是有限值
+    size_t non_finite = 0;
+    const float* gap = snapshot.channel(gap_row);
+    for (size_t k = 0; k < snapshot.bins; ++k) {
+        non_finite += std::isfinite(gap[k]) ? 0 : 1;
+    }
+
+    std::printf("%s: %zu-point %s, %zu averaged, bin %.3f Hz: tone peak bin %zu (expected %.1f), power %.4f "
+                "(expected %.4f), noise %.3e /Hz (expected %.3e), %zu non-finite bins in gap channel\n",
+                label, snapshot.fft_size, spectrumWindowName(snapshot.window), snapshot.averaged,
+                snapshot.bin_width, peak, expected_bin, tone_power, expected_power, noise_density,
+                expected_density, non_finite);
+    if (std::fabs(double(peak) - expected_bin) > 1.0) ++errors;
+    if (std::fabs(tone_power - expected_power) > 0.03 * expected_power) ++errors;
+    if (std::fabs(noise_density - expected_density) > 0.1 * expected_density) ++errors;
+    if (non_finite != 0) ++errors;
+    return errors;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+    const double rate_multiplier = argc > 2 ? std::atof(argv[2]) : 10.0;
+    const size_t threaded_channels = argc > 3 ? std::min<size_t>(std::atoi(argv[3]), CHANNEL_COUNT) : 16;
+    std::vector<float> packet(CHANNEL_COUNT * SAMPLES_PER_PACKET);
+    size_t errors = 0;
+
+    // ---- FFT 正确性 ----
+    {
+        std::mt19937 rng(12345);
+        double worst_dft = 0.0, worst_parseval = 0.0;
+        for (size_t n = 64; n <= 4096; n *= 4) {
+            worst_dft = std::max(worst_dft, dftError(n, rng));
+        }
+        for (size_t n = 16; n <= 65536; n *= 2) {
+            worst_parseval = std::max(worst_parseval, parsevalError(n, rng));
+        }
+        std::printf("fft: max error vs double DFT %.2e (normalized), max Parseval error %.2e\n",
+                    worst_dft, worst_parseval);
+        if (worst_dft > 1e-6 || worst_parseval > 1e-5) ++errors;
+    }
+
+    // ---- FFT 吞吐：单线程，即每个核心 ----
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+        for (size_t n = 1024; n <= 65536; n *= 2) {
+            RealFft fft(n);
+            std::vector<float> input(n), re(fft.bins()), im(fft.bins());
+            for (float& value : input) value = uniform(rng);
+            size_t iterations = 0;
+            const Clock::time_point start = Clock::now();
+            double elapsed = 0.0;
+            do {
+                for (int i = 0; i < 16; ++i) {
+                    fft.transform(input.data(), re.data(), im.data());
+                }
+                iterations += 16;
+                elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            } while (elapsed < 0.2);
+            const double per_transform = elapsed / iterations;
+            // 实数 FFT 的常用计数 2.5 N log2 N
+            const double flops = 2.5 * n * std::log2(double(n)) / per_transform;
+            std::printf("fft %6zu points: %9.0f transforms/s per core, %8.2f us each, %6.0f MFLOPS "
+                        "(%.1f real-time channels at %.0f Hz, 50%% overlap)\n",
+                        n, 1.0 / per_transform, per_transform * 1e6, flops * 1e-6,
+                        (n / 2) / SAMPLE_RATE / per_transform, SAMPLE_RATE);
+        }
+    }
+
+    // ---- 同步：按配置逐段校验 ----
+    {
+        ChannelRingStore store(CHANNEL_COUNT, HISTORY_SAMPLES);
+        SpectrumAnalyzer analyzer(store, SAMPLE_RATE);
+        SpectrumConfig config;
+        config.fft_size = 4096;
+        config.window = SpectrumWindow::Hann;
+        config.overlap = 0.5;
+        config.averages = 16;
+        config.channels = {TONE_CHANNEL, NOISE_CHANNEL, GAP_CHANNEL};
+        analyzer.configure(config);
+
+        uint64_t next_sample = 0;
+        const size_t packets_per_frame = static_cast<size_t>(SAMPLE_RATE / 60.0 / SAMPLES_PER_PACKET);
+        const uint64_t switch_sample = static_cast<uint64_t>(seconds * SAMPLE_RATE / 2);
+        const uint64_t total_samples = static_cast<uint64_t>(seconds * SAMPLE_RATE);
+        bool switched = false;
+        while (next_sample < total_samples) {
+            writePackets(store, next_sample, packets_per_frame, packet);
+            analyzer.process(store.publishedCount());
+            if (!switched && next_sample >= switch_sample) {
+                errors += checkSnapshot(analyzer.acquireSnapshot(), config.averages, "sync hann");
+                config.fft_size = 16384;
+                config.window = SpectrumWindow::Blackman;
+                config.overlap = 0.75;
+                config.averages = 8;
+                analyzer.configure(config);
+                switched = true;
+            }
+        }
+        errors += checkSnapshot(analyzer.acquireSnapshot(), config.averages, "sync blackman");
+        SpectrumStats stats = analyzer.getStats();
+        std::printf("sync: %llu transforms, %.3f ms per second of stream for 3 channels\n",
+                    static_cast<unsigned long long>(stats.transforms), stats.busy_seconds * 1000.0 / seconds);
+        if (stats.missed_segments != 0) ++errors;
+    }
+
+    // ---- 线程：写入与计算互不等待 ----
+    {
+        ChannelRingStore store(CHANNEL_COUNT, HISTORY_SAMPLES);
+        SpectrumAnalyzer analyzer(store, SAMPLE_RATE);
+        SpectrumConfig config;
+        config.fft_size = 65536;
+        config.overlap = 0.75;
+        config.averages = 8;
+        config.channels.clear();
+        for (size_t ch = 0; ch < threaded_channels; ++ch) config.channels.push_back(ch);
+        analyzer.configure(config);
+        analyzer.start();
+
+        uint64_t next_sample = 0;
+        const double packets_per_second = SAMPLE_RATE / SAMPLES_PER_PACKET * rate_multiplier;
+        const double run_seconds = std::min(seconds, 3.0);
+        Clock::time_point start = Clock::now();
+        size_t written = 0;
+        uint64_t snapshots = 0;
+        while (true) {
+            const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            if (elapsed >= run_seconds) break;
+            const size_t due = static_cast<size_t>(elapsed * packets_per_second);
+            if (due > written) {
+                writePackets(store, next_sample, due - written, packet);
+                written = due;
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+            if (analyzer.hasUpdate()) {
+                snapshots = analyzer.acquireSnapshot().generation;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        analyzer.stop();
+        SpectrumStats stats = analyzer.getStats();
+        const double stream_seconds = next_sample / SAMPLE_RATE;
+        std::printf("threaded at %.0fx, %zu channels x 65536 points, 75%% overlap: %llu transforms, %llu snapshots "
+                    "seen, %llu missed segments, busy %.3f%% of wall time (%.3f%% per real-time stream)\n",
+                    rate_multiplier, threaded_channels, static_cast<unsigned long long>(stats.transforms),
+                    static_cast<unsigned long long>(snapshots), static_cast<unsigned long long>(stats.missed_segments),
+                    100.0 * stats.busy_seconds / run_seconds, 100.0 * stats.busy_seconds / stream_seconds);
+        // 落后丢失的段取决于机器负载，只报告；结果要求有变换，且平均满 averages 段时频谱正确
+        if (stats.transforms == 0) ++errors;
+        const SpectrumSnapshot& snapshot = analyzer.acquireSnapshot();
+        if (threaded_channels > GAP_CHANNEL && snapshot.averaged == config.averages) {
+            errors += checkSnapshot(snapshot, config.averages, "threaded");
+        }
+    }
+
+    std::printf("verification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+// 叠放波形图（每通道一道）的包络校验与开销基准
+// - 校验：写入带尖峰与噪声的多通道数据，对若干通道和时间窗口（整段历史、实时窗口、放大到样本比像素列少）
+//   比较 StripChart 的逐列包络与原始样本：每列区间不超出附近原始样本的范围，每个原始样本都落在所在列附近的区间内；
+//   另外单独校验 NaN 缺口不被连接
+// - 开销：可见道数 x 像素列数的每帧耗时，对比全部通道；每道的代价与时间窗口内的样本数无关
+// - 帧预算：视图每帧最多处理 StripChart::MAX_VISIBLE_LANES 道（最小道高、最大视图高度下的可见道），
+//   在列表开头、中间、末尾三个滚动位置测量最坏的一帧，超过 60 FPS 的 16.7ms 计为校验失败；
+//   全部通道一起计算只作对比（界面中不会出现：1024 道在 800 像素内不到 1 像素一道）
+// 校验失败时以非零退出码返回
+// 用法: bench_strip_chart [channels，默认 1024] [columns，默认 1600] [visible_lanes，默认 100]
+#include "Core/DataManager.h"
+#include "Core/SignalGenerator.h"
+#include "Core/StripChart.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 原始样本：样本数不多于 2 * 桶数时 queryEnvelope 直接输出原始样本
+size_t rawSamples(const DataManager& manager, size_t channel, double start_time, double end_time,
+                  std::vector<float>& times, std::vector<float>& values) {
+    const size_t capacity = static_cast<size_t>((end_time - start_time) * manager.sampleRate()) * 2 + 16;
+    times.resize(capacity);
+    values.resize(capacity);
+    return manager.queryEnvelope(channel, start_time, end_time, capacity, times.data(), values.data());
+}
+
+// 第 c 列附近（±reach 列）原始样本的范围，另含窗口两侧最近的样本（空列的插值端点）
+void nearbyRange(const std::vector<float>& times, const std::vector<float>& values, size_t count,
+                 double start_time, double column_width, long c, long reach, float& low, float& high) {
+    low = std::numeric_limits<float>::max();
+    high = std::numeric_limits<float>::lowest();
+    const double window_first = start_time + (c - reach) * column_width;
+    const double window_last = start_time + (c + reach + 1) * column_width;
+    long before = -1, after = -1;
+    for (size_t i = 0; i < count; ++i) {
+        if (times[i] < window_first) {
+            before = static_cast<long>(i);
+        } else if (times[i] >= window_last) {
+            if (after < 0) after = static_cast<long>(i);
+        } else {
+            low = std::min(low, values[i]);
+            high = std::max(high, values[i]);
+        }
+    }
+    for (long i : {before, after}) {
+        if (i < 0) continue;
+        low = std::min(low, values[i]);
+        high = std::max(high, values[i]);
+    }
+}
+
+size_t checkWindow(const DataManager& manager, StripChart& chart, size_t first_channel, size_t lanes,
+                   double start_time, double end_time, size_t columns) {
+    chart.update(manager, first_channel, lanes, start_time, end_time, columns);
+    const double column_width = (end_time - start_time) / columns;
+    const float tolerance = 1e-5f;
+    std::vector<float> times, values;
+    size_t errors = 0;
+    for (size_t lane = 0; lane < chart.laneCount(); ++lane) {
+        const size_t count = rawSamples(manager, first_channel + lane, start_time, end_time, times, values);
+        const float* mins = chart.laneMin(lane);
+        const float* maxs = chart.laneMax(lane);
+        size_t filled = 0;
+        for (size_t c = 0; c < columns; ++c) {
+            if (std::isnan(mins[c])) continue;
+            ++filled;
+            // 金字塔的桶最多跨两列，衔接再向左借一列
+            float low, high;
+            nearbyRange(times, values, count, start_time, column_width, static_cast<long>(c), 3, low, high);
+            if (mins[c] > maxs[c] || mins[c] < low - tolerance || maxs[c] > high + tolerance) ++errors;
+        }
+        // 每个原始样本都被所在列附近的区间覆盖（尖峰不丢失）
+        for (size_t i = 0; i < count; ++i) {
+            const long column = static_cast<long>(std::floor((times[i] - start_time) / column_width));
+            if (column < 0 || column >= static_cast<long>(columns)) continue;
+            bool covered = false;
+            for (long c = std::max(column - 2, 0L); c <= std::min(column + 2, long(columns) - 1) && !covered; ++c) {
+                covered = !std::isnan(mins[c]) && values[i] >= mins[c] - tolerance && values[i] <= maxs[c] + tolerance;
+            }
+            errors += covered ? 0 : 1;
+        }
+        if (count > 0 && filled == 0) ++errors;
+    }
+    return errors;
+}
+
+// NaN 缺口：缺口内的列为空，两侧各自成段
+size_t checkGap() {
+    const size_t columns = 20;
+    std::vector<float> times, values;
+    for (int i = 0; i < 100; ++i) {
+        times.push_back((i + 0.5f) * 0.01f);
+        values.push_back(i >= 40 && i < 60 ? std::nanf("") : static_cast<float>(i % 7));
+    }
+    std::vector<float> mins(columns), maxs(columns);
+    size_t filled = binColumns(times.data(), values.data(), times.size(), 0.0, 1.0, columns, mins.data(), maxs.data());
+    size_t errors = 0;
+    for (size_t c = 0; c < columns; ++c) {
+        const bool in_gap = c >= 8 && c < 12;
+        if (std::isnan(mins[c]) != in_gap) ++errors;
+    }
+    return errors + (filled == columns - 4 ? 0 : 1);
+}
+
+void waitForEnvelope(DataManager& manager) {
+    // 显示线程增量维护包络金字塔，等待其追上写入
+    HistoryRange range = manager.getHistoryRange();
+    std::vector<float> times(4), values(4);
+    for (int i = 0; i < 200; ++i) {
+        manager.requestDisplayFrame();
+        size_t points = manager.queryEnvelope(manager.channelCount() - 1, range.last_time - 0.001, range.last_time,
+                                              4, times.data(), values.data());
+        if (points > 0 && times[points - 1] >= range.last_time - 0.001) return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    StreamDescriptor stream;
+    stream.channel_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+    const size_t columns = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1600;
+    const size_t visible = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100;
+    if (!stream.isValid() || columns == 0) {
+        std::fprintf(stderr, "invalid arguments\n");
+        return 1;
+    }
+
+    DataManager manager(stream);
+    manager.setProcessingEnabled(true);
+    SignalConfig signal;
+    signal.pattern = SignalPattern::Spike;
+    signal.noise = 0.05;
+    SignalGenerator generator(stream, signal);
+    std::vector<uint8_t> packet(stream.packetSize());
+
+    // 写满约2秒的历史
+    const size_t packets = static_cast<size_t>(2.0 * stream.packetsPerSecond());
+    Clock::time_point fill_start = Clock::now();
+    for (size_t p = 0; p < packets; ++p) {
+        generator.nextPacket(packet.data());
+        manager.addBinaryPacket(packet);
+    }
+    waitForEnvelope(manager);
+    const double fill_seconds = std::chrono::duration<double>(Clock::now() - fill_start).count();
+    const HistoryRange history = manager.getHistoryRange();
+    std::printf("%zu channels, %.2f s of history written in %.2f s\n", stream.channel_count,
+                history.last_time - history.first_time, fill_seconds);
+
+    // 校验：整段历史、实时显示窗口、放大（样本数少于列数）
+    StripChart chart;
+    const double live_window = manager.displayWindowSamples() / manager.sampleRate();
+    const double zoomed = columns / 4 / manager.sampleRate();
+    struct Window { const char* name; double start; double end; };
+    const Window windows[] = {
+        {"full history", history.first_time, history.last_time},
+        {"live window", history.last_time - live_window, history.last_time},
+        {"zoomed in", history.last_time - 0.5 - zoomed, history.last_time - 0.5},
+    };
+    size_t errors = 0;
+    const size_t checked_lanes = std::min<size_t>(8, stream.channel_count);
+    for (const Window& window : windows) {
+        size_t window_errors = 0;
+        for (size_t first : {size_t(0), stream.channel_count - checked_lanes}) {
+            window_errors += checkWindow(manager, chart, first, checked_lanes, window.start, window.end, columns);
+        }
+        std::printf("%-13s %.4f s: %zu mismatches\n", window.name, window.end - window.start, window_errors);
+        errors += window_errors;
+    }
+    const size_t gap_errors = checkGap();
+    std::printf("NaN gap: %zu mismatches\n", gap_errors);
+    errors += gap_errors;
+
+    // 开销：可见道与全部通道，实时窗口与整段历史（每道代价应与窗口内样本数无关）
+    for (const Window& window : {windows[1], windows[0]}) {
+        for (size_t lanes : {std::min(visible, stream.channel_count), stream.channel_count}) {
+            const int repeats = 20;
+            Clock::time_point start = Clock::now();
+            for (int r = 0; r < repeats; ++r) {
+                chart.update(manager, stream.channel_count - lanes, lanes, window.start, window.end, columns);
+            }
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+            const double samples = (window.end - window.start) * manager.sampleRate() * lanes;
+            std::printf("%-13s %4zu lanes x %zu columns: %.3f ms/frame (%.0f samples in view, %.1f ns/column)\n",
+                        window.name, lanes, columns, ms, samples, ms * 1e6 / (lanes * columns));
+        }
+    }
+
+    // 帧预算：任意滚动位置上可见道的包络计算必须在一帧（60 FPS）内完成
+    const double budget_ms = 1000.0 / 60.0;
+    const size_t budget_lanes = std::min(StripChart::MAX_VISIBLE_LANES, stream.channel_count);
+    double worst_ms = 0.0;
+    for (const Window& window : {windows[1], windows[0]}) {
+        for (size_t first : {size_t(0), (stream.channel_count - budget_lanes) / 2, stream.channel_count - budget_lanes}) {
+            const int repeats = 20;
+            Clock::time_point start = Clock::now();
+            for (int r = 0; r < repeats; ++r) {
+                chart.update(manager, first, budget_lanes, window.start, window.end, columns);
+            }
+            worst_ms = std::max(worst_ms, std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats);
+        }
+    }
+    std::printf("frame budget: %zu of %zu channels visible at most (%.0f px lanes, %.0f px view): worst %.3f ms/frame "
+                "of %.1f ms (%s)\n",
+                budget_lanes, stream.channel_count, StripChart::MIN_LANE_HEIGHT, StripChart::MAX_VIEW_HEIGHT, worst_ms,
+                budget_ms, worst_ms <= budget_ms ? "ok" : "over budget");
+    if (worst_ms > budget_ms) ++errors;
+    manager.setProcessingEnabled(false);
+
+    std::printf("verification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
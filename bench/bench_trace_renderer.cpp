@@ -0,0 +1,410 @@
+// GPU 波形绘制的校验与开销基准
+// - 增量上传：DataManager 按带包头的数据流接收（随机批量、偶尔丢包产生 NaN 缺口、切换显示通道数、清除），
+//   每个显示帧交给 TraceUploader，把写入区段应用到模拟的 GPU 环后逐样本与显示帧比对（按位比较，含 NaN）
+// - 顶点：traceVertex()（着色器的 CPU 参考）与按 time_values 直接映射到绘图区的结果比对
+// - 开销：128 通道 x 1000 点，每帧增量转换的耗时，对比 CPU 上逐线段展开四边形（ImPlot 折线的做法）的耗时与顶点数
+// - 离屏（编译时找到 EGL 才有）：在无窗口的 EGL 上下文（如 Mesa llvmpipe）中用 TraceRenderer 绘制分道的测试帧，
+//   读回像素，检查每个顶点处是该通道的颜色、NaN 样本两侧的线段未被绘制
+// 校验失败时以非零退出码返回
+// 用法: bench_trace_renderer [frames，默认 2000]
+#include "Core/DataManager.h"
+#include "Core/SignalGenerator.h"
+#include "Core/TraceUpload.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#ifdef SENSORMONITOR_BENCH_HAS_EGL
+#include <glad/glad.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include "UI/TraceRenderer.h"
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool sameBits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// 把一帧的写入区段应用到模拟的 GPU 环，并逐样本与显示帧比对
+size_t applyAndCheck(TraceUploader& uploader, const DisplayFrame& frame, std::vector<float>& gpu) {
+    TraceUploadRange ranges[2];
+    bool whole = false;
+    size_t count = uploader.update(frame, ranges, whole);
+    if (whole) gpu.assign(uploader.bufferFloats(), -12345.0f);
+    for (size_t r = 0; r < count; ++r) {
+        std::memcpy(gpu.data() + ranges[r].slot_first * uploader.channelCount(), ranges[r].data,
+                    ranges[r].slot_count * uploader.channelCount() * sizeof(float));
+    }
+    if (frame.sample_count == 0) return 0;
+
+    size_t errors = 0;
+    const size_t channels = uploader.channelCount();
+    for (size_t c = 0; c < channels; ++c) {
+        const float* expected = frame.channel(uploader.channelFirst() + c);
+        for (size_t i = 0; i < uploader.sampleCount(); ++i) {
+            float uploaded = gpu[((uploader.startSlot() + i) % uploader.stride()) * channels + c];
+            if (!sameBits(uploaded, expected[frame.physicalIndex(i)])) ++errors;
+        }
+    }
+    return errors;
+}
+
+// traceVertex() 与按 time_values 直接映射的结果比对
+size_t checkVertices(const TraceUploader& uploader, const DisplayFrame& frame, double sample_rate) {
+    if (frame.sample_count < 2) return 0;
+    const double x_min = frame.time_values[frame.physicalIndex(0)];
+    const double x_max = frame.time_values[frame.physicalIndex(frame.sample_count - 1)];
+    const double y_min = -1.5, y_max = 1.5;
+    TraceTransform transform = TraceTransform::fromPlot(uploader.firstTime(), sample_rate, x_min, x_max, y_min, y_max);
+    TraceChannelStyle style;
+
+    size_t errors = 0;
+    const float* values = frame.channel(uploader.channelFirst());
+    for (size_t i = 0; i < frame.sample_count; ++i) {
+        const size_t phys = frame.physicalIndex(i);
+        TraceVertex vertex = traceVertex(transform, style, i, values[phys]);
+        double x_ref = 2.0 * (frame.time_values[phys] - x_min) / (x_max - x_min) - 1.0;
+        if (std::isnan(values[phys])) {
+            if (vertex.valid) ++errors;
+            continue;
+        }
+        double y_ref = 2.0 * (values[phys] - y_min) / (y_max - y_min) - 1.0;
+        if (!vertex.valid || std::fabs(vertex.x - x_ref) > 1e-3 || std::fabs(vertex.y - y_ref) > 1e-5) ++errors;
+    }
+    return errors;
+}
+
+// CPU 展开折线：每段按法线生成4个顶点（ImPlot 非抗锯齿折线的最小工作量）
+size_t expandLineStrips(const DisplayFrame& frame, size_t channels, std::vector<float>& vertices) {
+    size_t emitted = 0;
+    for (size_t c = 0; c < channels; ++c) {
+        const float* values = frame.channel(frame.channel_first + c);
+        for (size_t i = 0; i + 1 < frame.sample_count; ++i) {
+            float x0 = frame.time_values[frame.physicalIndex(i)], y0 = values[frame.physicalIndex(i)];
+            float x1 = frame.time_values[frame.physicalIndex(i + 1)], y1 = values[frame.physicalIndex(i + 1)];
+            float dx = x1 - x0, dy = y1 - y0;
+            float inv = 1.0f / std::sqrt(dx * dx + dy * dy + 1e-12f);
+            float nx = -dy * inv * 0.5f, ny = dx * inv * 0.5f;
+            float* out = vertices.data() + emitted * 2;
+            out[0] = x0 + nx; out[1] = y0 + ny;
+            out[2] = x1 + nx; out[3] = y1 + ny;
+            out[4] = x1 - nx; out[5] = y1 - ny;
+            out[6] = x0 - nx; out[7] = y0 - ny;
+            emitted += 4;
+        }
+    }
+    return emitted;
+}
+
+const DisplayFrame& waitForFrame(DataManager& manager, uint64_t last_generation) {
+    auto deadline = Clock::now() + std::chrono::milliseconds(200);
+    while (true) {
+        manager.requestDisplayFrame();
+        const DisplayFrame& frame = manager.acquireDisplayFrame();
+        if (frame.generation != last_generation || Clock::now() > deadline) return frame;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+#ifdef SENSORMONITOR_BENCH_HAS_EGL
+constexpr int FB_WIDTH = 1024;
+constexpr int FB_HEIGHT = 512;
+
+struct OffscreenContext {
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+
+    bool create() {
+        auto get_platform_display =
+            reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (get_platform_display) {
+            display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) return false;
+        if (!eglBindAPI(EGL_OPENGL_API)) return false;
+        const EGLint config_attribs[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+        EGLConfig config;
+        EGLint config_count = 0;
+        if (!eglChooseConfig(display, config_attribs, &config, 1, &config_count) || config_count == 0) return false;
+        const EGLint context_attribs[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+                                          EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                                          EGL_NONE};
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+        if (context == EGL_NO_CONTEXT) return false;
+        if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) return false;
+        return gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress)) != 0;
+    }
+
+    ~OffscreenContext() {
+        if (display != EGL_NO_DISPLAY) {
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+            eglTerminate(display);
+        }
+    }
+};
+
+// 分道测试帧（窗口已满）：通道 c 的曲线在 [c - 0.4, c + 0.4] 内，环形窗口从 offset 处回绕，通道0中间有一个 NaN 样本
+DisplayFrame makeLaneFrame(size_t channels, size_t stride, size_t offset, double sample_rate, size_t nan_index) {
+    const size_t count = stride;
+    DisplayFrame frame;
+    frame.generation = 1;
+    frame.first_sample = 5000;
+    frame.base_sample = 5000 - offset;     // 使首个样本的时间槽为 offset
+    frame.sample_count = count;
+    frame.sample_stride = stride;
+    frame.offset = offset;
+    frame.channel_first = 0;
+    frame.channel_count = channels;
+    frame.time_values.assign(stride, 0.0f);
+    frame.samples.assign(channels * stride, 0.0f);
+    for (size_t i = 0; i < count; ++i) {
+        const size_t phys = (offset + i) % stride;
+        frame.time_values[phys] = static_cast<float>((offset + i) / sample_rate);
+        for (size_t c = 0; c < channels; ++c) {
+            frame.samples[c * stride + phys] = static_cast<float>(0.4 * std::sin(0.05 * i + c));
+        }
+    }
+    frame.samples[(offset + nan_index) % stride] = std::nanf("");
+    return frame;
+}
+
+size_t runOffscreen(size_t frames) {
+    OffscreenContext egl;
+    if (!egl.create()) {
+        std::printf("offscreen: no EGL OpenGL 3.3 core context available, skipped\n");
+        return 0;
+    }
+    std::printf("offscreen: %s / %s\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+
+    GLuint fbo = 0, color = 0;
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, FB_WIDTH, FB_HEIGHT);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::printf("offscreen: framebuffer incomplete\n");
+        return 1;
+    }
+
+    TraceRenderer renderer;
+    if (!renderer.init()) {
+        std::printf("offscreen: TraceRenderer::init failed\n");
+        return 1;
+    }
+
+    // 分道绘制8个通道，各用一种纯色
+    const size_t channels = 8, stride = 256, count = stride, offset = 150, nan_index = 100;
+    const double sample_rate = 1000.0;
+    DisplayFrame frame = makeLaneFrame(channels, stride, offset, sample_rate, nan_index);
+    std::vector<TraceChannelStyle> styles(channels);
+    for (size_t c = 0; c < channels; ++c) {
+        styles[c].offset = static_cast<float>(c);
+        styles[c].color[0] = (c & 1) ? 1.0f : 0.0f;
+        styles[c].color[1] = (c & 2) ? 1.0f : 0.0f;
+        styles[c].color[2] = (c & 4) ? 1.0f : 0.5f;
+        styles[c].color[3] = 1.0f;
+    }
+    renderer.update(frame);
+    renderer.setChannelStyles(styles);
+    const double x_min = frame.time_values[frame.physicalIndex(0)];
+    const double x_max = frame.time_values[frame.physicalIndex(count - 1)];
+    const double y_min = -0.5, y_max = channels - 0.5;
+    TraceTransform transform = TraceTransform::fromPlot(renderer.uploader().firstTime(), sample_rate, x_min, x_max,
+                                                        y_min, y_max);
+
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (!renderer.prepare(transform)) {
+        std::printf("offscreen: nothing to draw\n");
+        return 1;
+    }
+    renderer.render(0, 0, FB_WIDTH, FB_HEIGHT);
+    std::vector<uint8_t> pixels(FB_WIDTH * FB_HEIGHT * 4);
+    glReadPixels(0, 0, FB_WIDTH, FB_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    auto pixelIs = [&](int px, int py, const TraceChannelStyle& style) {
+        if (px < 0 || py < 0 || px >= FB_WIDTH || py >= FB_HEIGHT) return false;
+        const uint8_t* p = pixels.data() + (py * FB_WIDTH + px) * 4;
+        for (int k = 0; k < 3; ++k) {
+            if (std::abs(p[k] - static_cast<int>(std::lround(style.color[k] * 255))) > 2) return false;
+        }
+        return true;
+    };
+    auto toPixel = [](float ndc, int size) { return static_cast<int>(std::floor((ndc + 1.0f) * 0.5f * size)); };
+
+    size_t errors = 0, checked = 0;
+    for (size_t c = 0; c < channels; ++c) {
+        const float* values = frame.channel(c);
+        for (size_t i = 1; i + 1 < count; ++i) {
+            const bool near_nan = c == 0 && i + 1 >= nan_index && i <= nan_index + 1;
+            TraceVertex vertex = traceVertex(transform, styles[c], i, values[frame.physicalIndex(i)]);
+            int px = toPixel(vertex.x, FB_WIDTH), py = toPixel(vertex.y, FB_HEIGHT);
+            if (near_nan) continue;
+            // 线段经过顶点所在像素或其相邻像素
+            bool found = false;
+            for (int dy = -1; dy <= 1 && !found; ++dy) {
+                for (int dx = -1; dx <= 1 && !found; ++dx) {
+                    found = pixelIs(px + dx, py + dy, styles[c]);
+                }
+            }
+            errors += found ? 0 : 1;
+            ++checked;
+        }
+    }
+    // NaN 样本两侧的线段整段丢弃：该列范围内通道0的道上没有通道0的颜色
+    size_t gap_pixels = 0;
+    const int gap_first = toPixel(traceVertex(transform, styles[0], nan_index - 1, 0.0f).x, FB_WIDTH) + 2;
+    const int gap_last = toPixel(traceVertex(transform, styles[0], nan_index + 1, 0.0f).x, FB_WIDTH) - 2;
+    const int lane_low = toPixel(traceVertex(transform, styles[0], 0, -0.5f).y, FB_HEIGHT);
+    const int lane_high = toPixel(traceVertex(transform, styles[0], 0, 0.5f).y, FB_HEIGHT);
+    for (int px = gap_first; px <= gap_last; ++px) {
+        for (int py = lane_low; py <= lane_high; ++py) {
+            gap_pixels += pixelIs(px, py, styles[0]) ? 1 : 0;
+        }
+    }
+    std::printf("offscreen: %zu/%zu vertices covered, %zu pixels drawn across the NaN gap\n", checked - errors,
+                checked, gap_pixels);
+
+    // llvmpipe 上的每帧开销：128 通道 x 1000 点，每帧追加 8 个样本
+    DataManager manager;
+    manager.setFramePacing(true);
+    manager.setProcessingEnabled(true);
+    manager.setDisplayChannels(0, manager.channelCount());
+    SignalGenerator generator(manager.streamDescriptor(), SignalConfig());
+    std::vector<uint8_t> packet(manager.streamDescriptor().packetSize());
+    std::vector<TraceChannelStyle> wide_styles(manager.channelCount());
+    TraceRenderer wide;
+    wide.init();
+    uint64_t generation = 0;
+    double gpu_ms = 0.0;
+    size_t drawn = 0;
+    for (size_t f = 0; f < frames / 10; ++f) {
+        for (int p = 0; p < 20; ++p) {
+            generator.nextPacket(packet.data());
+            manager.addBinaryPacket(packet);
+        }
+        const DisplayFrame& live = waitForFrame(manager, generation);
+        generation = live.generation;
+        Clock::time_point start = Clock::now();
+        wide.update(live);
+        wide.setChannelStyles(wide_styles);
+        if (wide.prepare(TraceTransform())) {
+            wide.render(0, 0, FB_WIDTH, FB_HEIGHT);
+            glFinish();
+            gpu_ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            ++drawn;
+        }
+    }
+    manager.setProcessingEnabled(false);
+    if (drawn) {
+        std::printf("offscreen: %zu frames of %zu vertices, %.3f ms/frame upload + draw + finish\n", drawn,
+                    wide.vertexCount(), gpu_ms / drawn);
+    }
+
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &color);
+    return errors + gap_pixels + (checked == 0 ? 1 : 0);
+}
+#endif
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+
+    StreamDescriptor stream;
+    stream.packet_header = true;
+    DataManager manager(stream);
+    manager.setFramePacing(true);
+    manager.setProcessingEnabled(true);
+
+    SignalConfig signal;
+    signal.pattern = SignalPattern::Sine;
+    signal.noise = 0.05;
+    SignalGenerator generator(stream, signal);
+    std::vector<uint8_t> packet(stream.packetSize());
+    std::mt19937 rng(42);
+
+    TraceUploader uploader;
+    std::vector<float> gpu;
+    std::vector<float> expanded(stream.channel_count * manager.displayWindowSamples() * 8);
+    uint64_t generation = 0;
+    size_t sample_errors = 0, vertex_errors = 0, rebuilds = 0, checked_frames = 0;
+    double upload_us = 0.0, expand_us = 0.0;
+    size_t timed_frames = 0, expanded_vertices = 0;
+    size_t display_channels = 16;
+    manager.setDisplayChannels(0, display_channels);
+
+    for (size_t f = 0; f < frames; ++f) {
+        // 随机批量；约 2% 的帧丢一个包（接收端填 NaN），偶尔切换显示通道数或清除
+        const size_t packets = std::uniform_int_distribution<size_t>(1, 160)(rng);
+        for (size_t p = 0; p < packets; ++p) {
+            generator.nextPacket(packet.data());
+            if (rng() % 50 == 0 && p > 0) continue;
+            manager.addBinaryPacket(packet);
+        }
+        if (rng() % 200 == 0) {
+            display_channels = rng() % 2 ? stream.channel_count : 16;
+            manager.setDisplayChannels(0, display_channels);
+        }
+        if (rng() % 500 == 0) manager.clear();
+
+        const DisplayFrame& frame = waitForFrame(manager, generation);
+        generation = frame.generation;
+
+        // 在副本上计时，校验用的 uploader 不受影响
+        TraceUploader timing = uploader;
+        TraceUploadRange ranges[2];
+        bool whole = false;
+        Clock::time_point start = Clock::now();
+        timing.update(frame, ranges, whole);
+        const double elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        rebuilds += whole ? 1 : 0;
+
+        sample_errors += applyAndCheck(uploader, frame, gpu);
+        vertex_errors += checkVertices(uploader, frame, stream.sample_rate);
+        ++checked_frames;
+
+        if (frame.channel_count == stream.channel_count && frame.sample_count == frame.sample_stride && !whole) {
+            upload_us += elapsed;
+            start = Clock::now();
+            expanded_vertices = expandLineStrips(frame, frame.channel_count, expanded);
+            expand_us += std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            ++timed_frames;
+        }
+    }
+    manager.setProcessingEnabled(false);
+    PacketLossStats loss = manager.getPacketStats();
+
+    std::printf("incremental upload: %zu frames checked, %zu rebuilds, %llu gaps filled with NaN, "
+                "%zu sample mismatches, %zu vertex mismatches\n",
+                checked_frames, rebuilds, static_cast<unsigned long long>(loss.gaps), sample_errors, vertex_errors);
+    if (timed_frames) {
+        std::printf("per frame at %zu channels x %zu points (%zu frames): upload %.2f us, "
+                    "CPU line expansion %.2f us and %zu vertices\n",
+                    stream.channel_count, manager.displayWindowSamples(), timed_frames, upload_us / timed_frames,
+                    expand_us / timed_frames, expanded_vertices);
+    }
+
+    size_t errors = sample_errors + vertex_errors;
+#ifdef SENSORMONITOR_BENCH_HAS_EGL
+    errors += runOffscreen(frames);
+#else
+    std::printf("offscreen: built without EGL, skipped\n");
+#endif
+    std::printf("verification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
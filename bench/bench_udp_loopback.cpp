@@ -0,0 +1,223 @@
+// UDP 回环接收基准：fork 本机发送进程，按带包头的数据流发送，UdpSubscriber 接收后解码写入 DataManager
+// - 定速：按流速率的 rate_mult 倍发送，要求不丢包
+// - 全速：比较每次 recvmmsg 取 1 个与 64 个数据报时的每秒包数、每包系统调用数与丢包（内核溢出 + 序号缺口）
+// - 乱序：发送端在每组 16 个包内两两交换顺序（交换的两个包可能分在两次 recvmmsg 中），要求经重排窗口后不丢包
+// - 组播：本机回环接口支持组播时，经 239.255.0.1 重复定速阶段
+// 校验：每批交付的包按序号递增，写入 + 缺口 + 迟到 == 已发送，定速与乱序阶段没有迟到丢弃的包；任何校验失败都以非零退出码返回
+// 用法: bench_udp_loopback [packets，默认 200000] [rate_mult，默认 4] [udp_port，默认 5602]
+#include "Core/DataManager.h"
+#include "Core/StreamFormat.h"
+#include "IO/UdpSubscriber.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t SEND_BURST = 16;             // 发送端每次 sendmmsg 的数据报数
+const char* MULTICAST_GROUP = "239.255.0.1";
+
+struct Phase {
+    const char* name;
+    size_t packets;
+    double packets_per_sec;    // <= 0 表示全速
+    size_t batch;              // 每次 recvmmsg 的数据报数
+    bool swap_pairs;           // 每组内两两交换发送顺序
+    bool multicast;
+    bool require_lossless;
+};
+
+int runSender(const StreamDescriptor& stream, const Phase& phase, int port) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr(phase.multicast ? MULTICAST_GROUP : "127.0.0.1");
+    if (phase.multicast) {
+        in_addr interface_addr{};
+        interface_addr.s_addr = inet_addr("127.0.0.1");
+        unsigned char loop = 1;
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &interface_addr, sizeof(interface_addr));
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+    if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::fprintf(stderr, "connect udp %d failed\n", port);
+        return 1;
+    }
+    // 等接收端绑定完成
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    const size_t packet_size = stream.packetSize();
+    std::vector<uint8_t> data(SEND_BURST * packet_size, 0);
+    std::vector<float> payload(stream.channel_count * stream.samples_per_packet);
+    std::vector<iovec> iovecs(SEND_BURST);
+    std::vector<mmsghdr> messages(SEND_BURST);
+
+    Clock::time_point start = Clock::now();
+    for (size_t first = 0; first < phase.packets; first += SEND_BURST) {
+        if (phase.packets_per_sec > 0) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+                                                      std::chrono::duration<double>(first / phase.packets_per_sec)));
+        }
+        const size_t count = std::min(SEND_BURST, phase.packets - first);
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t sequence = first + i;
+            if (phase.swap_pairs && count == SEND_BURST) sequence = first + (i ^ 1);
+            uint8_t* packet = data.data() + i * packet_size;
+            writePacketHeader(packet, stream, sequence, sequence * stream.samples_per_packet);
+            std::fill(payload.begin(), payload.end(), static_cast<float>(sequence % 1000));
+            std::memcpy(packet + stream.headerSize(), payload.data(), stream.payloadSize());
+            iovecs[i] = {packet, packet_size};
+            messages[i] = {};
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        size_t sent = 0;
+        while (sent < count) {
+            int n = sendmmsg(sock, messages.data() + sent, static_cast<unsigned int>(count - sent), 0);
+            if (n < 0) {
+                if (errno == ENOBUFS || errno == EAGAIN || errno == ECONNREFUSED) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                close(sock);
+                return 1;
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+    close(sock);
+    return 0;
+}
+
+// 本机是否能在回环接口上加入组播组
+bool multicastAvailable() {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    ip_mreq membership{};
+    membership.imr_multiaddr.s_addr = inet_addr(MULTICAST_GROUP);
+    membership.imr_interface.s_addr = inet_addr("127.0.0.1");
+    bool ok = setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) == 0;
+    close(sock);
+    return ok;
+}
+
+size_t runPhase(const StreamDescriptor& stream, const Phase& phase, int port) {
+    pid_t child = fork();
+    if (child == 0) {
+        _exit(runSender(stream, phase, port));
+    }
+
+    DataManager manager(stream);
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> unsorted_batches{0};
+    Clock::time_point first_packet, last_packet;
+
+    UdpSubscriber subscriber("127.0.0.1", port, stream, phase.multicast ? MULTICAST_GROUP : "", phase.batch);
+    subscriber.startBatch([&](const PacketBatch& batch) {
+        if (received.load(std::memory_order_relaxed) == 0) first_packet = Clock::now();
+        PacketHeader header;
+        uint64_t previous = 0;
+        for (size_t i = 0; i < batch.packet_count; ++i) {
+            if (readPacketHeader(batch.packet(i), stream, header)) {
+                if (i > 0 && header.sequence < previous) {
+                    unsorted_batches.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+                previous = header.sequence;
+            }
+        }
+        manager.addPacketBatch(batch);
+        last_packet = Clock::now();
+        received.fetch_add(batch.packet_count, std::memory_order_release);
+    });
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    // 发送端退出后，等到 200ms 内没有新的包
+    uint64_t seen = UINT64_MAX;
+    while (seen != received.load(std::memory_order_acquire)) {
+        seen = received.load(std::memory_order_acquire);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    subscriber.stop();
+    SubscriberStats stats = subscriber.getStats();
+    PacketLossStats loss = manager.getPacketStats();
+
+    const double seconds = seen ? std::chrono::duration<double>(last_packet - first_packet).count() : 0.0;
+    const double rate = seconds > 0 ? stats.packets / seconds : 0.0;
+    const uint64_t accounted = loss.packets + loss.lost_packets + loss.reordered_packets;
+    std::printf("%-22s %8.0f packets/s  %5.3f syscalls/packet  %6.2f%% lost (%lu kernel drops, %lu gaps)  "
+                "%lu reordered, %lu late\n",
+                phase.name, rate, stats.packets ? double(stats.recv_calls) / stats.packets : 0.0,
+                100.0 * (phase.packets - loss.packets) / phase.packets, static_cast<unsigned long>(stats.dropped),
+                static_cast<unsigned long>(loss.gaps), static_cast<unsigned long>(stats.reordered),
+                static_cast<unsigned long>(loss.reordered_packets));
+
+    size_t errors = 0;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::printf("  sender failed\n");
+        ++errors;
+    }
+    if (unsorted_batches.load() > 0 || stats.invalid > 0 || loss.invalid_packets > 0 || loss.resyncs > 0 ||
+        accounted > phase.packets) {
+        std::printf("  %lu unsorted batches, %lu invalid datagrams, %lu invalid headers, %lu resyncs, "
+                    "%lu accounted of %zu sent\n",
+                    static_cast<unsigned long>(unsorted_batches.load()), static_cast<unsigned long>(stats.invalid),
+                    static_cast<unsigned long>(loss.invalid_packets), static_cast<unsigned long>(loss.resyncs),
+                    static_cast<unsigned long>(accounted), phase.packets);
+        ++errors;
+    }
+    if (phase.require_lossless && (loss.packets != phase.packets || accounted != phase.packets)) {
+        std::printf("  expected all %zu packets, wrote %lu\n", phase.packets, static_cast<unsigned long>(loss.packets));
+        ++errors;
+    }
+    return errors;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t packets = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    double rate_mult = argc > 2 ? std::atof(argv[2]) : 4.0;
+    int port = argc > 3 ? std::atoi(argv[3]) : 5602;
+
+    StreamDescriptor stream;
+    stream.packet_header = true;
+    const double paced_rate = rate_mult * stream.packetsPerSecond();
+    const size_t paced_packets = std::min<size_t>(packets, static_cast<size_t>(paced_rate * 2));
+    std::printf("%zu-byte datagrams, paced at %.0f packets/s\n", stream.packetSize(), paced_rate);
+
+    const Phase phases[] = {
+        {"paced", paced_packets, paced_rate, UdpSubscriber::DEFAULT_BATCH_PACKETS, false, false, true},
+        {"full speed, batch 1", packets, 0.0, 1, false, false, false},
+        {"full speed, batch 64", packets, 0.0, UdpSubscriber::DEFAULT_BATCH_PACKETS, false, false, false},
+        {"paced, swapped pairs", paced_packets, paced_rate, UdpSubscriber::DEFAULT_BATCH_PACKETS, true, false, true},
+    };
+    size_t errors = 0;
+    for (const Phase& phase : phases) {
+        errors += runPhase(stream, phase, port);
+    }
+    if (multicastAvailable()) {
+        Phase multicast = {"paced, multicast", paced_packets, paced_rate, UdpSubscriber::DEFAULT_BATCH_PACKETS,
+                           false, true, true};
+        errors += runPhase(stream, multicast, port);
+    } else {
+        std::printf("multicast: loopback interface cannot join %s, skipped\n", MULTICAST_GROUP);
+    }
+
+    std::printf("\nverification: %zu errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+// ZeroMQSubscriber 回环吞吐基准
+// 本进程内的 PUSH 套接字以最快速度发送数据包，ZeroMQSubscriber 批量接收并计数，
+// 报告持续吞吐相对默认数据流速率的倍数（目标 >= 10x）
+// 用法: bench_zmq_loopback [packets] [endpoint，默认 ipc:///tmp/sensor_bench_zmq.ipc]
+#include "Core/StreamFormat.h"
+#include "IO/ZeroMQSubscriber.h"
+#include <zmq.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t PACKAGE_SIZE = StreamFormat::PACKAGE_SIZE;
+constexpr double STREAM_PACKETS_PER_SEC = StreamFormat::SAMPLE_RATE / StreamFormat::SAMPLES_PER_PACKET;
+
+using Clock = std::chrono::steady_clock;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t packet_target = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::string endpoint = argc > 2 ? argv[2] : "ipc:///tmp/sensor_bench_zmq.ipc";
+
+    std::atomic<uint64_t> received{0};
+    ZeroMQSubscriber subscriber(endpoint);
+    subscriber.startBatch([&](const PacketBatch& batch) {
+        received.fetch_add(batch.packet_count, std::memory_order_relaxed);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    void* context = zmq_ctx_new();
+    void* sender = zmq_socket(context, ZMQ_PUSH);
+    int hwm = 10000;
+    zmq_setsockopt(sender, ZMQ_SNDHWM, &hwm, sizeof(hwm));
+    if (zmq_connect(sender, endpoint.c_str()) != 0) {
+        std::fprintf(stderr, "connect %s failed: %s\n", endpoint.c_str(), zmq_strerror(errno));
+        return 1;
+    }
+
+    std::vector<uint8_t> packet(PACKAGE_SIZE, 0x3f);
+    auto start = Clock::now();
+    for (size_t i = 0; i < packet_target; ++i) {
+        zmq_send(sender, packet.data(), packet.size(), 0);
+    }
+    while (received.load() < packet_target &&
+           Clock::now() - start < std::chrono::seconds(60)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    subscriber.stop();
+    SubscriberStats stats = subscriber.getStats();
+    zmq_close(sender);
+    zmq_ctx_destroy(context);
+
+    double pps = stats.packets / elapsed;
+    std::printf("endpoint %s: %lu/%zu packets in %.3f s\n", endpoint.c_str(),
+                static_cast<unsigned long>(stats.packets), packet_target, elapsed);
+    std::printf("throughput: %.0f packets/s, %.1f MB/s, %.1fx stream rate\n",
+                pps, pps * PACKAGE_SIZE / (1024.0 * 1024.0), pps / STREAM_PACKETS_PER_SEC);
+    std::printf("batches: %lu (%.1f packets/batch), recv calls: %lu\n",
+                static_cast<unsigned long>(stats.batches),
+                stats.batches ? static_cast<double>(stats.packets) / stats.batches : 0.0,
+                static_cast<unsigned long>(stats.recv_calls));
+    return pps >= 10.0 * STREAM_PACKETS_PER_SEC ? 0 : 1;
+}
@@ -1,3 +1,4 @@
 #!/bin/bash
+# 构建合成负载发送端 sensor_sender（CMake 目标），用法见 sensor_sender --help
 
-g++ sender_socket.cpp -o sender -std=c++17 -lstdc++fs -pthread
+cmake -S . -B build && cmake --build build --target sensor_sender -j
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Core/ChannelRingStore.h"
+#include "Core/PacketDecoder.h"
+
+enum class FilterType : uint8_t {
+    DcBlock = 0,          // 一阶直流隔离：y = x - x[-1] + R y[-1]
+    Notch = 1,            // 二阶陷波（工频干扰）
+    HighPass = 2,
+    LowPass = 3,
+    BandPass = 4,         // 中心频率处增益 0dB
+    DecimatingFir = 5,    // 线性相位低通 FIR，按 decimation 抽取后插值回原采样率
+};
+
+const char* filterTypeName(FilterType type);
+
+struct FilterStage {
+    FilterType type = FilterType::DcBlock;
+    double frequency = 1.0;     // Hz：直流隔离/高低通/FIR 的截止频率，陷波/带通的中心频率
+    double q = 0.7071;          // 二阶滤波的品质因数（直流隔离与 FIR 不使用）
+    size_t taps = 63;           // FIR 抽头数
+    size_t decimation = 1;      // FIR 抽取因子
+};
+
+// 二阶节系数，a0 归一化为 1：y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]
+struct BiquadCoefficients {
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+};
+
+// 按 RBJ Audio EQ Cookbook 设计（双线性变换，预畸变到 frequency）；直流隔离为一阶节，R = exp(-2π f / fs)
+BiquadCoefficients designBiquad(FilterType type, double frequency, double q, double sample_rate);
+
+// Hamming 窗 sinc 低通，直流增益为 1
+std::vector<double> designLowPassFir(size_t taps, double cutoff, double sample_rate);
+
+struct FilterKernelStage;
+
+// 多通道滤波链：所有通道共用同一组系数、各自保存状态，状态跨数据包保留
+// - 按通道分组向量化（SSE2 每组8个通道、AVX2 每组16个通道，每个向量通道对应一个数据通道）：
+//   IIR 的递推在时间上是串行的，但通道之间相互独立
+// - 每组按 64 个样本的块转置为 时间 x 通道 的布局，依次经过各级滤波后转置写回
+// - 二阶节的递推以双精度计算（高 Q 陷波的极点紧靠单位圆，单精度的舍入误差会被放大），FIR 为单精度
+// - NaN 样本（丢包缺口）原样输出，送入滤波器状态时按 0 计，缺口之后不会一直输出 NaN
+// - 抽取 FIR 每 decimation 个样本计算一个低速率输出，再用同一原型多相插值回原采样率（两步各为全速率
+//   FIR 代价的 1/decimation），截止频率限制在 fs / (2 decimation) 以内；延迟为 taps - 1 个样本
+// 非线程安全：由持有 data_mutex 的写入方调用
+class ChannelFilterBank {
+public:
+    static constexpr size_t MAX_STAGES = 8;
+    static constexpr size_t MAX_FIR_TAPS = 255;
+    static constexpr size_t MAX_DECIMATION = 64;
+
+    ChannelFilterBank(size_t channel_count, double sample_rate, DecodeIsa isa = DecodeIsa::Auto);
+
+    // 替换滤波链并清零状态；超出 MAX_STAGES 的级忽略，参数限制在有效范围内
+    void configure(const std::vector<FilterStage>& stages);
+    const std::vector<FilterStage>& stages() const { return chain; }
+    bool empty() const { return chain.empty(); }
+
+    void reset();
+
+    // 就地滤波：通道 ch 的 count 个连续样本位于 data + ch * stride + offset
+    void process(float* data, size_t stride, size_t offset, size_t count);
+
+    // 环形缓冲中全局索引 [first, first + count) 的样本就地滤波（处理回绕）
+    void process(ChannelRingStore& store, uint64_t first, size_t count);
+
+    DecodeIsa isa() const { return selected_isa; }
+    size_t groupWidth() const { return group_width; }
+
+private:
+    using FilterFn = void (*)(float* data, size_t stride, size_t offset, size_t count, size_t channel_count,
+                              const FilterKernelStage* stages, size_t stage_count, float* scratch);
+
+    struct StageData {
+        std::vector<float> taps;            // FIR 的抽头
+        std::vector<double> biquad;         // 二阶节 b0 b1 b2 a1 a2
+        std::vector<float> history;         // FIR：每组 group_state 个 float
+        std::vector<double> feedback;       // 二阶节：每组 group_state 个 double
+        std::vector<uint32_t> phase;        // FIR：每组的抽取相位
+        size_t group_state = 0;
+        size_t decimation = 1;
+        bool fir = false;
+    };
+
+    size_t channel_count;
+    double sample_rate;
+    FilterFn filter_fn;
+    DecodeIsa selected_isa;
+    size_t group_width;
+    size_t group_count;
+    std::vector<FilterStage> chain;
+    std::vector<StageData> stage_data;
+    std::vector<float> scratch;
+};
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Core/ChannelRingStore.h"
+
+enum class HeatmapMetric : uint8_t {
+    Rms = 0,
+    Peak = 1,
+};
+
+const char* heatmapMetricName(HeatmapMetric metric);
+
+struct HeatmapStats {
+    uint64_t columns = 0;           // 已计算的列
+    uint64_t missed_columns = 0;    // 计算线程落后、样本已被环形缓冲覆盖而填 NaN 的列
+    double busy_seconds = 0.0;      // 计算线程用于归约的累计时间
+};
+
+// 通道 x 时间的幅度热图（每列每通道一个 RMS 或峰值），由后台线程增量计算
+// - 列号 k 覆盖全局样本 [k * columnSamples(), (k + 1) * columnSamples())；计算线程每当环形缓冲中
+//   攒够一列就归约所有通道，NaN 样本（丢包缺口）不计入，整列都是 NaN 时结果为 NaN
+// - 结果存放在 columnCapacity() 列的环中（2的幂），UI 线程无锁拷贝新列，计算与渲染线程互不等待；
+//   UI 只需把新列着色后作为纹理的子区域上传
+// - 启动时从环形缓冲中最旧的可读样本开始，随后只处理新样本
+class ChannelHeatmap {
+public:
+    ChannelHeatmap(const ChannelRingStore& store, size_t column_samples, size_t column_capacity,
+                   HeatmapMetric metric = HeatmapMetric::Rms);
+    ~ChannelHeatmap();
+
+    ChannelHeatmap(const ChannelHeatmap&) = delete;
+    ChannelHeatmap& operator=(const ChannelHeatmap&) = delete;
+
+    void start();
+    void stop();
+
+    // 之后计算的列使用新的指标（已计算的列不变）
+    void setMetric(HeatmapMetric metric) { current_metric = static_cast<uint8_t>(metric); }
+    HeatmapMetric metric() const { return static_cast<HeatmapMetric>(current_metric.load()); }
+
+    size_t channelCount() const { return channel_count; }
+    size_t columnSamples() const { return column_samples; }
+    size_t columnCapacity() const { return column_capacity; }
+
+    // ---- 生产者（计算线程；未 start() 时可由调用方直接驱动，用于测量计算开销） ----
+
+    // 计算全局索引 end 之前所有完整的列
+    void append(uint64_t end);
+
+    // ---- 消费者 ----
+
+    // 可读的列 [startColumn(), endColumn())
+    uint64_t startColumn() const;
+    uint64_t endColumn() const { return end_column.load(std::memory_order_acquire); }
+
+    // 拷贝列 [first, first + count) 到 out[channel * count + i]；读取期间被覆盖时返回 false
+    bool copyColumns(uint64_t first, size_t count, float* out) const;
+
+    HeatmapStats getStats() const;
+
+private:
+    void run();
+    void computeColumn(uint64_t column, HeatmapMetric metric);
+    void fillMissing(uint64_t column);
+
+    float* slot(size_t channel, uint64_t column) {
+        return values.data() + channel * column_capacity + (column & (column_capacity - 1));
+    }
+
+    const ChannelRingStore& store;
+    const size_t channel_count;
+    const size_t column_samples;
+    const size_t column_capacity;
+    std::atomic<uint8_t> current_metric;
+
+    std::vector<float> values;      // channel_count * column_capacity，通道优先
+
+    uint64_t next_column = 0;                   // 生产者私有
+    bool positioned = false;                    // 生产者私有：是否已确定起始列
+    std::atomic<uint64_t> first_column{0};      // 计算的第一列
+    std::atomic<uint64_t> end_column{0};
+
+    std::atomic<uint64_t> computed_columns{0};
+    std::atomic<uint64_t> missed_columns{0};
+    std::atomic<uint64_t> busy_ns{0};
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::mutex wait_mutex;
+    std::condition_variable wait_cv;
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 多通道环形历史缓冲（单生产者/单消费者，无锁）
+// - 每个通道一段连续的环形存储，容量向上取整为2的幂，写入为O(1)
+// - 生产者写完一批样本后调用 publish()，以 release 语义发布写索引
+// - 消费者以 acquire 语义读取写索引后直接拷贝数据，无需 data_mutex；
+//   拷贝结束后用 isRetained() 校验数据在读取期间未被覆盖
+class ChannelRingStore {
+public:
+    // 通道之间错开一个缓存行：容量为2的幂时各通道相同位置的地址会映射到同一组缓存，
+    // 按通道写入/转置时互相驱逐
+    static constexpr size_t CHANNEL_PADDING = 16;
+
+    ChannelRingStore(size_t channel_count, size_t min_capacity);
+
+    size_t channelCount() const { return channel_count; }
+    size_t capacity() const { return ring_capacity; }
+    size_t channelStride() const { return channel_stride; }
+
+    // 消费者可以安全读取的最大窗口（为生产者未发布的写入预留余量）
+    size_t readableWindow() const { return ring_capacity - write_guard; }
+
+    // ---- 生产者接口（只能由单个线程调用） ----
+
+    // 写入一个通道优先布局的数据包：samples[channel * samples_per_channel + i]
+    void writePacket(const float* samples, size_t samples_per_channel);
+
+    // 向单个通道写入 count 个样本，起始位置为当前未发布的写索引
+    void writeChannel(size_t channel, const float* samples, size_t count);
+
+    // 所有通道写完 count 个样本后推进写索引（尚未对消费者可见）
+    void commit(size_t count);
+
+    // 发布已提交的样本
+    void publish();
+
+    // 批量写入内核直接访问存储：通道 ch 的环位于 writeData() + ch * channelStride()，
+    // 下一个样本写在全局索引 pendingIndex() 处；每次 commit() 的样本数不得超过 maxCommitSamples()
+    float* writeData() { return data.data(); }
+    uint64_t pendingIndex() const { return pending_index; }
+    size_t maxCommitSamples() const { return write_guard / 2; }
+
+    // ---- 消费者接口 ----
+
+    // 已发布的样本总数（单调递增，即下一个样本的全局索引）
+    uint64_t publishedCount() const { return write_index.load(std::memory_order_acquire); }
+
+    // 拷贝通道 channel 中全局索引 [first, first + count) 的样本到 out
+    void copyChannel(size_t channel, uint64_t first, size_t count, float* out) const;
+
+    // 读取完成后调用：若 [first, ...) 的数据仍未被生产者覆盖则返回 true
+    bool isRetained(uint64_t first) const;
+
+    // 直接访问通道的环形存储（索引需与 mask() 按位与）
+    const float* channelData(size_t channel) const { return data.data() + channel * channel_stride; }
+    size_t mask() const { return ring_capacity - 1; }
+
+private:
+    size_t channel_count;
+    size_t ring_capacity;
+    size_t channel_stride;     // ring_capacity + CHANNEL_PADDING
+    size_t write_guard;
+
+    std::vector<float> data;   // channel_count * channel_stride，通道优先
+
+    uint64_t pending_index = 0;              // 生产者私有：已提交但未发布的写索引
+    std::atomic<uint64_t> write_index{0};    // 已发布的写索引
+};
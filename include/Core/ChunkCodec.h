@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 单通道样本块的无损编码（落盘的历史数据使用）
+// 编码结果只依赖样本的位模式，解码后逐位还原（含 NaN、负零）
+enum class ChunkCodec : uint8_t {
+    Raw = 0,        // 原样存放 float32
+    XorBytes = 1,   // 与前一个样本的位模式异或，只保存去掉首尾零字节后的有效字节；
+                    // 每两个样本一个控制字节（每个样本4位：首部零字节数、尾部零字节数）
+    Gorilla = 2,    // 异或后按位编码（Gorilla）：相同值1位，有效位落在上一个窗口内时2位+有效位，
+                    // 否则2位+5位首部零位数+5位有效位长度+有效位
+    ShuffleRle = 3, // 与前一个样本位模式的差值（zigzag）按字节拆成4个平面（同一字节位置的值连续存放），
+                    // 各平面做零字节游程编码；变化缓慢的数据高位平面几乎全零
+};
+
+// 编码 count 个样本所需的最大字节数（含编码器整字写入的余量）
+size_t chunkEncodeBound(ChunkCodec codec, size_t count);
+
+// 编码到 out（至少 chunkEncodeBound() 字节），返回实际字节数
+size_t chunkEncode(ChunkCodec codec, const float* samples, size_t count, uint8_t* out);
+
+// 解码 size 字节为 count 个样本；数据不完整或损坏时返回 false
+bool chunkDecode(ChunkCodec codec, const uint8_t* in, size_t size, float* samples, size_t count);
+
+// 名称："raw" "xor-bytes" "gorilla" "shuffle-rle"
+const char* chunkCodecName(ChunkCodec codec);
+bool parseChunkCodec(const std::string& text, ChunkCodec& codec);
@@ -0,0 +1,45 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 压缩工作线程池：parallelFor() 把 count 个相互独立的任务（通常每个通道一个）分给工作线程，
+// 调用线程同样参与执行，全部完成后返回
+// - 可被多个线程同时调用（录制写线程与历史溢写线程共用 shared()），各调用的任务按提交顺序领取
+// - 没有工作线程时退化为在调用线程上顺序执行
+class CodecPool {
+public:
+    explicit CodecPool(size_t worker_count);
+    ~CodecPool();
+
+    CodecPool(const CodecPool&) = delete;
+    CodecPool& operator=(const CodecPool&) = delete;
+
+    size_t workerCount() const { return workers.size(); }
+
+    void parallelFor(size_t count, const std::function<void(size_t)>& job);
+
+    // 进程共用的池：工作线程数为硬件线程数的一半（单核机器上没有工作线程）
+    static CodecPool& shared();
+
+private:
+    struct Task {
+        const std::function<void(size_t)>* job;
+        size_t count;
+        size_t next = 0;       // 下一个待领取的任务序号
+        size_t done = 0;       // 已完成的任务数
+    };
+
+    void run();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+    std::deque<Task*> tasks;     // 还有未领取任务的调用
+    bool stopping = false;
+};
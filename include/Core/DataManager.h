@@ -5,6 +5,20 @@
 #include <atomic>
 #include <thread>
 #include <cstdint>
+#include <condition_variable>
+#include <memory>
+#include <string>
+#include "Core/ChannelFilterBank.h"
+#include "Core/ChannelHeatmap.h"
+#include "Core/ChannelRingStore.h"
+#include "Core/HistorySpill.h"
+#include "Core/MinMaxPyramid.h"
+#include "Core/PacketBatch.h"
+#include "Core/PacketDecoder.h"
+#include "Core/PacketSequencer.h"
+#include "Core/SpectrumAnalyzer.h"
+#include "Core/StreamFormat.h"
+#include "Core/TripleBuffer.h"
 
 struct DataPoint {
     double timestamp;
@@ -24,9 +38,44 @@ struct BinaryPacket {
     size_t packet_size;
 };
 
+// 显示帧：由显示线程填充的只读快照，UI 线程直接使用其中的指针绘图
+// 每个通道占 sample_stride 个 float，只有 [channel_first, channel_first + channel_count) 范围内的通道被填充
+// 数据按环形窗口存放（只追加新样本），第 i 个样本位于 (offset + i) % sample_count，
+// 可直接作为 ImPlot::PlotLine 的 offset 参数
+struct DisplayFrame {
+    uint64_t generation = 0;       // 每发布一次递增
+    uint64_t first_sample = 0;     // 第一个样本的全局索引
+    uint64_t base_sample = 0;      // 生成该帧时的清除位置（时间轴零点）
+    size_t sample_count = 0;
+    size_t sample_stride = 0;
+    size_t offset = 0;
+    size_t channel_first = 0;
+    size_t channel_count = 0;
+    std::vector<float> time_values;
+    std::vector<float> samples;
+
+    bool hasChannel(size_t channel) const {
+        return channel >= channel_first && channel < channel_first + channel_count;
+    }
+    const float* channel(size_t channel) const {
+        return hasChannel(channel) ? samples.data() + channel * sample_stride : nullptr;
+    }
+    size_t physicalIndex(size_t i) const {
+        size_t index = offset + i;
+        return index >= sample_count ? index - sample_count : index;
+    }
+};
+
+// 当前可浏览的历史时间范围（秒，相对最近一次清除）
+struct HistoryRange {
+    double first_time = 0.0;
+    double last_time = 0.0;
+};
+
 class DataManager {
 public:
-    DataManager();
+    // 数据流描述决定通道数、采样率、数据包大小和解码内核；无效的描述回退到默认格式
+    explicit DataManager(const StreamDescriptor& stream = StreamDescriptor());
     ~DataManager();
     
     void addData(const DataPoint& point);
@@ -36,10 +85,54 @@ public:
     void addBinaryPacket(const std::vector<uint8_t>& packet_data);
     void processBinaryPacket(const std::vector<uint8_t>& packet_data);
     
+    // 批量写入：一次加锁、一次发布处理整批数据包（由接收线程直接传入其接收缓冲）
+    // 带包头的数据流按序号排序：丢包处填充 NaN，重复与迟到的包丢弃
+    void addPacketBatch(const PacketBatch& batch);
+    PacketLossStats getPacketStats() const;
+    
+    // 写入时的滤波链：之后写入的样本在发布前逐通道就地滤波（显示、历史、热图与功率谱都看到滤波后的数据，
+    // 录制不受影响）；已有的历史保持原样。空链表示不滤波
+    void setFilterChain(const std::vector<FilterStage>& stages);
+    std::vector<FilterStage> filterChain() const;
+    
     void clear();
     std::vector<DataPoint> getData();
-    std::vector<std::vector<float>> getChannelDisplayData(size_t max_samples = 1000);
-    std::vector<float> getTimeValues();
+    
+    // 显示快照（仅供单个UI线程调用）：返回的帧在下一次调用之前保持不变，无拷贝、无分配
+    const DisplayFrame& acquireDisplayFrame();
+    
+    // 只为指定范围的通道生成显示数据，减少显示线程的工作量
+    void setDisplayChannels(size_t first, size_t count);
+    size_t channelCount() const { return CHANNEL_COUNT; }
+    
+    // 历史浏览：基于最小/最大包络金字塔，任意缩放范围的绘制代价与历史长度无关
+    HistoryRange getHistoryRange() const;
+    // 生成 [start_time, end_time] 内通道的包络折线，最多 max_points 个点（每个桶2个点，保留尖峰）
+    size_t queryEnvelope(size_t channel, double start_time, double end_time, size_t max_points,
+                         float* times, float* values) const;
+    double sampleRate() const { return SAMPLE_RATE; }
+    
+    // 历史溢写：早于内存环形缓冲的样本压缩写入 directory 下的临时文件（最多 max_bytes），
+    // 历史浏览范围随之扩展到磁盘上保留的全部样本
+    bool enableHistorySpill(const std::string& directory, uint64_t max_bytes = HistorySpill::DEFAULT_MAX_BYTES,
+                            ChunkCodec codec = ChunkCodec::ShuffleRle);
+    bool isHistorySpillEnabled() const { return spill != nullptr; }
+    HistorySpillStats getHistorySpillStats() const;
+    const StreamDescriptor& streamDescriptor() const { return stream; }
+    
+    // 通道 x 时间的幅度热图：首次调用时创建并启动计算线程，之后返回同一实例（参数不再改变）
+    ChannelHeatmap* enableHeatmap(size_t column_samples, size_t column_capacity);
+    ChannelHeatmap* heatmap() const { return channel_heatmap.get(); }
+    // 功率谱分析：首次调用时创建并启动计算线程（初始为默认配置），之后通过 configure() 调整
+    SpectrumAnalyzer* enableSpectrum();
+    SpectrumAnalyzer* spectrum() const { return spectrum_analyzer.get(); }
+    // 全局样本索引对应的时间（秒，相对最近一次清除），与 getHistoryRange() 的时间轴一致
+    double sampleTime(uint64_t index) const;
+    size_t displayWindowSamples() const { return MAX_DISPLAY_SAMPLES; }
+    
+    // 帧节奏控制：开启后显示线程只在 UI 请求新帧且有新数据时更新
+    void setFramePacing(bool enabled);
+    void requestDisplayFrame();
     
     void setProcessingEnabled(bool enabled);
     bool isProcessingEnabled() const;
@@ -50,28 +143,66 @@ public:
 
 private:
     void processData();
-    void updateDisplayData();
+    bool updateDisplayData(uint64_t published);
+    bool waitForDisplayWork();
+    void notifyDisplay();
+    void wakeDisplay();
+    void ingestPackets(const PacketBatch& batch);
+    void fillGap(uint64_t count);
+    void filterUncommitted(size_t count);
     
+    static constexpr double MAX_GAP_SECONDS = 60.0;      // 更大的样本索引跳变视为发送端重启，不填充
+    static constexpr size_t MAX_HISTORY_SAMPLES = 50000; // 每通道历史样本上限（环形缓冲向上取整为2的幂）
+
+    const StreamDescriptor stream;
+    const size_t maxSize = 1000;
+    const size_t CHANNEL_COUNT = stream.channel_count;
+    const size_t SAMPLES_PER_PACKET = stream.samples_per_packet;
+    const size_t MAX_DISPLAY_SAMPLES = 1000;
+    const double SAMPLE_RATE = stream.sample_rate; // Hz
+    const size_t PACKAGE_SIZE = stream.packetSize();
+
     std::vector<DataPoint> buffer;
-    std::vector<std::vector<float>> channel_display_data;
-    std::vector<float> time_values;
-    std::vector<std::vector<float>> raw_channel_data;
     
-    std::mutex data_mutex;
-    std::mutex display_mutex;
+    // 显示帧三缓冲：显示线程写，UI线程读，互不阻塞
+    TripleBuffer<DisplayFrame> display_frames;
+    uint64_t display_generation = 0;
+    std::atomic<size_t> display_channel_first{0};
+    std::atomic<size_t> display_channel_count{0};
+    uint64_t processed_end = 0;    // 显示线程已处理到的写索引
+    
+    // 显示线程唤醒：写入线程发布新样本后仅在显示线程等待数据时通知
+    std::mutex display_wait_mutex;
+    std::condition_variable display_cv;
+    std::atomic<bool> waiting_for_data{false};
+    std::atomic<bool> display_dirty{true};     // 通道范围、清除、播放状态等变化
+    std::atomic<bool> frame_pacing{false};
+    std::atomic<bool> frame_requested{false};
+    
+    // 原始通道历史：无锁环形缓冲，写入O(1)，显示线程读取无需 data_mutex
+    ChannelRingStore raw_store;
+    PacketDecoder decoder;                 // 写入方持有 data_mutex 时使用
+    PacketSequencer sequencer;             // 同上
+    ChannelFilterBank filter_bank;         // 同上
+    std::vector<float> gap_fill;           // NaN，按 maxCommitSamples() 分段写入缺口
+    std::atomic<uint64_t> history_base{0}; // clear() 时的写索引，之前的样本视为已清除
+    
+    // 最小/最大包络金字塔，由显示线程增量维护
+    MinMaxPyramid envelope;
+    
+    // 可选的磁盘历史层，只在 enableHistorySpill() 成功后存在
+    std::unique_ptr<HistorySpill> spill;
+    
+    // 可选的热图计算线程，只在 enableHeatmap() 后存在；先于 raw_store 析构
+    std::unique_ptr<ChannelHeatmap> channel_heatmap;
+    
+    // 可选的功率谱计算线程，只在 enableSpectrum() 后存在；先于 raw_store 析构
+    std::unique_ptr<SpectrumAnalyzer> spectrum_analyzer;
+    
+    mutable std::mutex data_mutex;
     std::thread processing_thread;
     
     std::atomic<bool> processing_enabled{false};
     std::atomic<bool> should_stop{false};
     std::atomic<bool> is_playing{true};
-    
-    const size_t maxSize = 1000;
-    const size_t CHANNEL_COUNT = 128;
-    const size_t SAMPLES_PER_PACKET = 8;
-    const size_t MAX_DISPLAY_SAMPLES = 1000;
-    const double SAMPLE_RATE = 22500.0; // Hz - 更新为22.5kHz
-    const size_t PACKAGE_SIZE = 4 * CHANNEL_COUNT * SAMPLES_PER_PACKET; // 4096字节
-    
-    size_t total_samples_received = 0;
-    size_t display_samples_received = 0; // 用于播放控制的显示样本计数
 };
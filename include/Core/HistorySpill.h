@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Core/ChannelRingStore.h"
+#include "Core/ChunkCodec.h"
+
+struct HistorySpillStats {
+    uint64_t blocks = 0;            // 当前保留在磁盘上的块数
+    uint64_t raw_bytes = 0;         // 这些块未压缩的样本字节数
+    uint64_t stored_bytes = 0;      // 这些块在文件中占用的字节数（含磁盘摘要）
+    uint64_t evicted_blocks = 0;    // 文件写满后覆盖掉的最旧块
+    uint64_t missed_blocks = 0;     // 溢写线程落后、样本已被环形缓冲覆盖而丢失的块
+};
+
+// 历史数据的磁盘层：内存中的环形缓冲只保留最近的样本，更早的样本由后台线程
+// 按块（每通道 BLOCK_SAMPLES 个样本）压缩写入临时文件，读取时通过内存映射按需访问
+// - 三级最小/最大摘要：每 2^RESIDENT_LEVEL 个样本的摘要常驻内存，覆盖全部磁盘历史，
+//   缩小到小时级的视图只访问内存；每 2^DISK_LEVEL 个样本的摘要随块写在文件中（不压缩），
+//   只有放大到单个样本级别时才解压可见的块
+// - 各通道的摘要与编码在 CodecPool::shared() 上并行
+// - 文件大小有上限，写满后从头循环覆盖最旧的块
+// - 查询与溢写线程通过 mutex 互斥；查询只在 UI 线程调用
+class HistorySpill {
+public:
+    static constexpr size_t BLOCK_SHIFT = 14;
+    static constexpr size_t BLOCK_SAMPLES = size_t(1) << BLOCK_SHIFT;   // 默认采样率下约0.73秒
+    static constexpr size_t DISK_LEVEL = 6;          // 文件内摘要：每64个样本一个桶
+    static constexpr size_t RESIDENT_LEVEL = 11;     // 常驻摘要：每2048个样本一个桶
+    static constexpr uint64_t DEFAULT_MAX_BYTES = uint64_t(8) << 30;
+
+    explicit HistorySpill(const ChannelRingStore& store);
+    ~HistorySpill();
+
+    HistorySpill(const HistorySpill&) = delete;
+    HistorySpill& operator=(const HistorySpill&) = delete;
+
+    // 在 directory 下创建临时文件（创建后立即删除文件名，进程退出即释放）并启动溢写线程
+    bool open(const std::string& directory, uint64_t max_bytes = DEFAULT_MAX_BYTES,
+              ChunkCodec codec = ChunkCodec::ShuffleRle);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    // 磁盘上保留的样本范围 [startIndex(), endIndex())，中间可能因溢写落后而有缺口
+    uint64_t startIndex() const { return start_index.load(std::memory_order_acquire); }
+    uint64_t endIndex() const { return end_index.load(std::memory_order_acquire); }
+
+    // 与 MinMaxPyramid::query 相同的输出格式；没有数据的区间（缺口、已覆盖）不输出点
+    size_t query(size_t channel, uint64_t first, uint64_t last, size_t max_buckets,
+                 uint64_t time_origin, double sample_period, float* xs, float* ys);
+
+    HistorySpillStats getStats() const;
+
+private:
+    static constexpr size_t DISK_BUCKETS = BLOCK_SAMPLES >> DISK_LEVEL;
+    static constexpr size_t RESIDENT_BUCKETS = BLOCK_SAMPLES >> RESIDENT_LEVEL;
+    static constexpr size_t CACHE_ENTRIES = 16;
+
+    // 文件中的块：[磁盘摘要 channel_count x DISK_BUCKETS x (min,max)][各通道的编码数据]
+    struct Block {
+        uint64_t first_sample;              // BLOCK_SAMPLES 的整数倍
+        uint64_t file_offset;
+        uint64_t byte_size;
+        std::vector<uint32_t> channel_offsets;   // 各通道编码数据相对块起点的偏移，末尾为总长
+        std::vector<ChunkCodec> channel_codecs;  // 不可压缩的通道原样存放
+        std::vector<float> resident;             // channel_count x RESIDENT_BUCKETS x (min,max)
+    };
+
+    // 解压后的单通道块
+    struct CachedSamples {
+        uint64_t first_sample = UINT64_MAX;
+        size_t channel = 0;
+        uint64_t last_use = 0;
+        std::vector<float> samples;
+    };
+
+    void run();
+    bool spillBlock(uint64_t first);
+    bool writeBlock(Block& block, const uint8_t* data);
+
+    const Block* findBlock(uint64_t sample) const;
+    uint64_t nextBlockStart(uint64_t sample) const;
+    const float* blockSamples(const Block& block, size_t channel);
+    bool minMaxRange(size_t channel, uint64_t lo, uint64_t hi, float& min_value, float& max_value);
+
+    const ChannelRingStore& store;
+    const size_t channel_count;
+    ChunkCodec codec = ChunkCodec::ShuffleRle;
+
+    int fd = -1;
+    const uint8_t* mapping = nullptr;
+    uint64_t max_bytes = 0;
+    uint64_t write_offset = 0;
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::mutex wait_mutex;
+    std::condition_variable wait_cv;
+
+    // 块元数据与解压缓存（mutex 保护）
+    mutable std::mutex blocks_mutex;
+    std::deque<Block> blocks;
+    CachedSamples cache[CACHE_ENTRIES];
+    uint64_t cache_clock = 0;
+    HistorySpillStats stats;
+
+    // 溢写线程私有的缓冲
+    std::vector<float> block_samples;       // channel_count x BLOCK_SAMPLES
+    std::vector<uint8_t> block_data;        // 编码后的整块
+    std::vector<uint8_t> channel_encoded;   // 各通道并行编码的暂存槽
+    std::vector<size_t> encoded_sizes;
+
+    std::atomic<uint64_t> start_index{0};
+    std::atomic<uint64_t> end_index{0};
+};
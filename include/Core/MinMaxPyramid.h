@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Core/ChannelRingStore.h"
+
+// 多分辨率最小/最大值包络金字塔
+// - 第 k 层每个桶覆盖 2^k 个原始样本，记录桶内的最小值和最大值；每层都是环形存储，
+//   覆盖与原始环形缓冲相同的时间跨度
+// - 由显示线程从 ChannelRingStore 增量追加（每个样本摊还 O(1)），UI线程无锁读取
+// - 查询任意区间时选择合适的层，使输出桶数不超过指定值，同时保留尖峰
+class MinMaxPyramid {
+public:
+    static constexpr size_t MIN_LEVEL = 3;     // 更细的桶（2、4个样本）直接扫描原始数据
+    static constexpr size_t MIN_LEVEL_BUCKETS = 32;
+
+    MinMaxPyramid(size_t channel_count, size_t history_capacity);
+
+    size_t maxLevel() const { return max_level; }
+
+    // ---- 生产者（单线程） ----
+
+    // 从 store 追加样本直到全局索引 end（只处理完整的最细层桶）
+    // 若落后超过原始缓冲的可读窗口，则从可读的最旧样本重新开始
+    void append(const ChannelRingStore& store, uint64_t end);
+
+    // ---- 消费者 ----
+
+    // 已并入金字塔的样本范围 [startIndex(), publishedCount())
+    uint64_t startIndex() const { return start_index.load(std::memory_order_acquire); }
+    uint64_t publishedCount() const { return published_index.load(std::memory_order_acquire); }
+
+    // 生成通道 channel 在 [first, last) 内的包络，桶数不超过 max_buckets，xs/ys 需容纳 2 * max_buckets 个点
+    // 每个桶输出两个点：(桶起点, 最小值)、(桶中点, 最大值)；样本数不多于 2 * max_buckets 时直接输出原始样本
+    // max_buckets 为 1 或 2 时也成立（桶按 2 的幂对齐，末尾的桶可能合并了多个对齐桶）
+    // 横坐标为 (索引 - time_origin) * sample_period；返回点数，读取期间数据被覆盖时返回 0
+    size_t query(const ChannelRingStore& store, size_t channel, uint64_t first, uint64_t last,
+                 size_t max_buckets, uint64_t time_origin, double sample_period,
+                 float* xs, float* ys) const;
+
+private:
+    struct Level {
+        size_t capacity;            // 每通道桶数（2的幂）
+        std::vector<float> minmax;  // channel_count * capacity * 2，[min, max] 交错
+    };
+
+    float* bucketAt(size_t level, size_t channel, uint64_t bucket) {
+        Level& l = levels[level - MIN_LEVEL];
+        return l.minmax.data() + (channel * l.capacity + (bucket & (l.capacity - 1))) * 2;
+    }
+    const float* bucketAt(size_t level, size_t channel, uint64_t bucket) const {
+        const Level& l = levels[level - MIN_LEVEL];
+        return l.minmax.data() + (channel * l.capacity + (bucket & (l.capacity - 1))) * 2;
+    }
+
+    // 读取期间目标层的桶未被覆盖
+    bool isRetained(size_t level, uint64_t first_bucket) const;
+
+    size_t channel_count;
+    size_t max_level;
+    std::vector<Level> levels;
+
+    std::atomic<uint64_t> start_index{0};
+    std::atomic<uint64_t> published_index{0};
+};
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 一批连续存放的定长数据包
+// data 指向接收方的缓冲区，只在回调期间有效；接收方不需要为每个包单独拷贝或分配
+// source 为数据来源（多发送端接收时的流编号），单一来源的传输始终为0
+struct PacketBatch {
+    const uint8_t* data = nullptr;
+    size_t packet_count = 0;
+    size_t packet_size = 0;
+    uint32_t source = 0;
+
+    const uint8_t* packet(size_t index) const { return data + index * packet_size; }
+    size_t byteSize() const { return packet_count * packet_size; }
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Core/ChannelRingStore.h"
+#include "Core/PacketBatch.h"
+#include "Core/StreamFormat.h"
+
+class ChannelFilterBank;
+
+// 解码内核使用的指令集
+enum class DecodeIsa : uint8_t {
+    Auto,      // 运行期选择 CPU 支持的最宽指令集
+    Scalar,
+    Sse2,
+    Avx2,
+};
+
+// 数据包解码：把一批数据包转换为各通道的 float 样本写入环形缓冲（已提交，未发布）
+// - 构造时按样本类型、排列方式、每包样本数和指令集选择模板特化的内核，运行期每批只有一次间接调用
+// - 通道在外层循环：每个通道的样本以宽指令连续写入自己的环，不再逐包在128个通道间跳转
+// - 交错排列的数据包按 8x8（AVX2）/ 4x4（SSE2）块转置
+// 由持有 data_mutex 的写入方调用（内部的 scratch 不是线程安全的）
+class PacketDecoder {
+public:
+    explicit PacketDecoder(const StreamDescriptor& stream, DecodeIsa isa = DecodeIsa::Auto);
+
+    // 调用方保证 batch.packet_size == stream.packetSize()；带包头的数据流只解码包头之后的样本
+    // filter 非空时每组样本在提交前就地滤波：commit() 可能自动发布，读者不会看到未滤波的样本
+    void decode(const PacketBatch& batch, ChannelRingStore& store, ChannelFilterBank* filter = nullptr);
+
+    DecodeIsa isa() const { return selected_isa; }
+
+    static bool isSupported(DecodeIsa isa);
+    static const char* isaName(DecodeIsa isa);
+
+private:
+    using DecodeFn = void (*)(const uint8_t* packets, size_t packet_size, size_t packet_count,
+                              size_t channel_count, size_t samples_per_packet,
+                              float* ring, size_t stride, size_t capacity, uint64_t position,
+                              float* scratch);
+
+    DecodeFn decode_fn;
+    DecodeIsa selected_isa;
+    size_t channel_count;
+    size_t samples_per_packet;
+    size_t payload_offset;        // 包头长度
+    std::vector<float> scratch;   // 交错排列的整数格式：一组包解码后的样本
+};
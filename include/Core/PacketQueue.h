@@ -0,0 +1,123 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Core/PacketBatch.h"
+
+// 队列满时的处理方式
+enum class OverflowPolicy : uint8_t {
+    Block,        // 接收线程等待空闲槽（不丢包，积压传回内核缓冲/发送端）
+    DropOldest,   // 丢弃最早排队的槽，保证显示最新的数据
+    DropNewest,   // 丢弃新到的包
+};
+
+const char* overflowPolicyName(OverflowPolicy policy);
+bool parseOverflowPolicy(const std::string& text, OverflowPolicy& policy);
+
+struct PacketQueueStats {
+    uint64_t pushed_packets = 0;       // 进入队列的包
+    uint64_t delivered_packets = 0;    // 交给处理线程回调的包
+    uint64_t dropped_newest = 0;       // 队列满（或已停止）时丢弃的新包
+    uint64_t dropped_oldest = 0;       // 队列满时从队首丢弃的包
+    uint64_t blocked_pushes = 0;       // 队列满时接收线程等待的次数
+    size_t slot_count = 0;
+    size_t depth_slots = 0;            // 当前排队的槽
+    size_t depth_packets = 0;          // 当前排队的包
+    size_t high_water_slots = 0;       // 排队槽数的最大值（据此调整 slot_count）
+    size_t high_water_packets = 0;
+};
+
+// 接收线程与处理阶段之间的有界包队列
+// - 预分配 slot_count 个槽，每槽最多 SLOT_PACKETS 个同一来源的数据包；push() 把一批拷贝进空闲槽（超过一槽时拆分），
+//   处理线程按入队顺序逐槽回调，回调返回后槽归还空闲池，运行期不分配内存
+// - 就绪队列与空闲池都是无锁的有界 MPMC 索引队列：多个接收线程可以同时 push()，
+//   DropOldest 时生产者也从就绪队列取出最旧的槽
+// - 处理线程空闲时在条件变量上等待，生产者只在它等待时才通知；Block 策略下的生产者同理
+class PacketQueue {
+public:
+    using Handler = std::function<void(const PacketBatch&)>;
+    static constexpr size_t SLOT_PACKETS = 64;    // 与各接收端单批最多交付的包数一致
+    static constexpr size_t DEFAULT_SLOTS = 128;
+
+    PacketQueue(size_t packet_size, size_t slot_count, OverflowPolicy policy = OverflowPolicy::Block);
+    ~PacketQueue();
+
+    PacketQueue(const PacketQueue&) = delete;
+    PacketQueue& operator=(const PacketQueue&) = delete;
+
+    // 启动处理线程，handler 在该线程上依次调用
+    void start(Handler handler);
+    // 处理完已排队的包后停止处理线程；之后的 push() 计为丢弃
+    void stop();
+
+    // 可由多个线程同时调用；batch 只在调用期间被读取
+    void push(const PacketBatch& batch);
+
+    OverflowPolicy policy() const { return overflow_policy; }
+    PacketQueueStats getStats() const;
+
+private:
+    // 有界 MPMC 队列（每个单元带序号，入队/出队位置各自 CAS 推进），存放槽编号
+    class IndexQueue {
+    public:
+        explicit IndexQueue(size_t min_capacity);
+        bool push(uint32_t value);
+        bool pop(uint32_t& value);
+        bool readable() const;   // 队首是否已有数据（不出队）
+
+    private:
+        struct Cell {
+            std::atomic<uint64_t> sequence;
+            uint32_t value;
+        };
+        std::unique_ptr<Cell[]> cells;
+        size_t mask;
+        alignas(64) std::atomic<uint64_t> enqueue_pos{0};
+        alignas(64) std::atomic<uint64_t> dequeue_pos{0};
+    };
+
+    bool acquireSlot(uint32_t& slot);
+    uint8_t* slotData(uint32_t slot) { return storage.get() + slot * slot_bytes; }
+    void run();
+    void updateHighWater(std::atomic<size_t>& high_water, size_t value);
+
+    const size_t packet_size;
+    const size_t slot_count;
+    const size_t slot_bytes;
+    const OverflowPolicy overflow_policy;
+
+    std::unique_ptr<uint8_t[]> storage;          // slot_count x SLOT_PACKETS x packet_size（按需分页）
+    std::unique_ptr<uint32_t[]> slot_packets;    // 各槽的包数与来源，随槽编号经队列传递
+    std::unique_ptr<uint32_t[]> slot_sources;
+    IndexQueue free_slots;
+    IndexQueue ready_slots;
+
+    Handler handler;
+    std::thread worker;
+    std::atomic<bool> stopping{false};
+
+    // 处理线程等待数据
+    std::mutex wait_mutex;
+    std::condition_variable wait_cv;
+    std::atomic<bool> consumer_waiting{false};
+    // Block 策略的生产者等待空闲槽
+    std::mutex space_mutex;
+    std::condition_variable space_cv;
+    std::atomic<size_t> space_waiters{0};
+
+    std::atomic<uint64_t> pushed_packets{0};
+    std::atomic<uint64_t> delivered_packets{0};
+    std::atomic<uint64_t> dropped_newest{0};
+    std::atomic<uint64_t> dropped_oldest{0};
+    std::atomic<uint64_t> blocked_pushes{0};
+    std::atomic<size_t> depth_slots{0};
+    std::atomic<size_t> depth_packets{0};
+    std::atomic<size_t> high_water_slots{0};
+    std::atomic<size_t> high_water_packets{0};
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Core/StreamFormat.h"
+
+struct PacketLossStats {
+    uint64_t packets = 0;              // 写入环形缓冲的包
+    uint64_t lost_packets = 0;         // 序号缺口中的包（之后迟到的包会扣回）
+    uint64_t duplicate_packets = 0;    // 已写入过的序号
+    uint64_t reordered_packets = 0;    // 迟到的包：对应时段已填充 NaN，丢弃
+    uint64_t invalid_packets = 0;      // 包头校验失败
+    uint64_t gaps = 0;                 // 填充 NaN 的次数
+    uint64_t gap_samples = 0;          // 以 NaN 填充的样本数（每通道）
+    uint64_t resyncs = 0;              // 发送端重启或样本索引跳变过大，重新对齐
+};
+
+// 按包头把数据包排进连续的样本时间轴（只用于带 PacketHeader 的数据流）
+// - 按序到达：直接写入
+// - 序号前跳：缺失的样本以 NaN 填充后再写入，之后的样本时间与发送端保持一致
+// - 序号后退：窗口内已写入的序号计为重复，未写入的计为乱序（其时段已填充 NaN，丢弃）
+// - 序号后退超过窗口、样本索引后退或前跳超过 max_gap_samples：视为发送端重启，从该包重新对齐
+// 非线程安全，由持有 data_mutex 的写入方使用
+class PacketSequencer {
+public:
+    static constexpr size_t WINDOW = 1024;    // 重复检测的序号窗口（包）
+
+    PacketSequencer(const StreamDescriptor& stream, uint64_t max_gap_samples);
+
+    // 返回 true 表示应写入该包，且写入前先填充 gap_samples 个 NaN 样本；false 表示丢弃
+    bool accept(const uint8_t* packet, uint64_t& gap_samples);
+
+    // 无包头的数据流只统计包数
+    void countPackets(uint64_t count) { loss_stats.packets += count; }
+
+    const PacketLossStats& stats() const { return loss_stats; }
+
+private:
+    void restart(const PacketHeader& header);
+    bool received(uint64_t sequence) const { return (window[(sequence / 64) % WORDS] >> (sequence % 64)) & 1; }
+    void markReceived(uint64_t sequence) { window[(sequence / 64) % WORDS] |= uint64_t(1) << (sequence % 64); }
+    void clearReceived(uint64_t sequence) { window[(sequence / 64) % WORDS] &= ~(uint64_t(1) << (sequence % 64)); }
+
+    static constexpr size_t WORDS = WINDOW / 64;
+
+    const StreamDescriptor stream;
+    const uint64_t max_gap_samples;
+    bool started = false;
+    uint64_t highest_sequence = 0;     // 已写入的最大序号
+    uint64_t next_sample = 0;          // 下一个应写入样本的发送端索引
+    uint64_t window[WORDS] = {};       // 最近 WINDOW 个序号是否已写入
+    PacketLossStats loss_stats;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 实数 FFT（长度为2的幂，MIN_SIZE..MAX_SIZE）
+// - N 点实序列按偶/奇样本组成 N/2 点复序列，做迭代的 radix-2 复数 FFT，再拆分得到 N/2+1 个频点
+// - 复数按实部/虚部分开存放（SoA）：第三级起每次蝶形运算处理4个复数（SSE2，x86-64 的基线指令集），
+//   前两级的旋转因子为 1 和 -i，单独展开不做乘法
+// - 旋转因子与位反转表在构造时预计算；transform() 只使用调用方给出的输出缓冲，const 且可被多个线程同时调用
+class RealFft {
+public:
+    static constexpr size_t MIN_SIZE = 16;
+    static constexpr size_t MAX_SIZE = size_t(1) << 20;
+
+    // size 向上取整为2的幂并限制在 [MIN_SIZE, MAX_SIZE]
+    explicit RealFft(size_t size);
+
+    size_t size() const { return n; }
+    size_t bins() const { return n / 2 + 1; }
+
+    // input 为 size() 个实数；re/im 各需 bins() 个元素，输出 X[k] = sum x[j] e^{-2πijk/N}, k = 0..N/2
+    void transform(const float* input, float* re, float* im) const;
+
+private:
+    void butterflies(float* re, float* im) const;
+
+    size_t n;
+    size_t half;                          // 复数 FFT 的长度 N/2
+    std::vector<uint32_t> bit_reverse;    // half 项
+    std::vector<float> stage_re;          // 第 h 级（跨度 h）的旋转因子 e^{-iπj/h} 位于 [h - 1, 2h - 1)
+    std::vector<float> stage_im;
+    std::vector<float> split_re;          // 拆分用的 e^{-2πik/N}，k = 0..N/4
+    std::vector<float> split_im;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Core/StreamFormat.h"
+
+// 合成信号的波形
+enum class SignalPattern : uint8_t {
+    Sine,      // 正弦，各通道频率在 frequency..2*frequency 之间错开
+    Noise,     // 高斯白噪声，标准差为 amplitude / 3
+    Step,      // 方波（以 frequency 翻转），各通道相位错开
+    Spike,     // 每 1/frequency 秒一个单样本尖峰，各通道错开
+};
+
+const char* signalPatternName(SignalPattern pattern);
+bool parseSignalPattern(const std::string& text, SignalPattern& pattern);
+
+struct SignalConfig {
+    SignalPattern pattern = SignalPattern::Sine;
+    double frequency = 10.0;       // Hz
+    double amplitude = 0.5;        // 归一化满量程 [-1, 1) 内
+    double noise = 0.0;            // 叠加在任意波形上的噪声（标准差）
+    double offset = 0.0;           // 直流偏置
+    uint64_t seed = 1;
+};
+
+// 按数据流描述生成合成数据包（sensor_sender 与基准程序共用）
+// - 样本先按通道优先生成 float，再编码为流的样本类型与排列；整数格式饱和到满量程
+// - 正弦用逐样本旋转的复数振荡器，每包重新归一化，避免逐样本调用 sin
+// - 带包头的数据流每包写入递增的序号与首样本索引
+// 非线程安全，每个发送线程一个
+class SignalGenerator {
+public:
+    SignalGenerator(const StreamDescriptor& stream, const SignalConfig& config);
+
+    // 生成下一个数据包，写入 packet（stream.packetSize() 字节）
+    void nextPacket(uint8_t* packet);
+
+    uint64_t sequence() const { return next_sequence; }
+    uint64_t firstSample() const { return next_sequence * stream.samples_per_packet; }
+
+private:
+    void generate();
+    void encode(uint8_t* payload) const;
+    double gaussian();
+
+    const StreamDescriptor stream;
+    const SignalConfig config;
+    uint64_t next_sequence = 0;
+    uint64_t rng_state;
+
+    std::vector<float> block;            // 一个包的样本，通道优先
+    std::vector<double> osc_re, osc_im;  // 各通道振荡器的当前相量
+    std::vector<double> rot_re, rot_im;  // 各通道每样本的旋转量
+};
@@ -0,0 +1,142 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Core/ChannelRingStore.h"
+#include "Core/CodecPool.h"
+#include "Core/RealFft.h"
+#include "Core/TripleBuffer.h"
+
+enum class SpectrumWindow : uint8_t {
+    Hann = 0,
+    Blackman = 1,
+};
+
+const char* spectrumWindowName(SpectrumWindow window);
+
+struct SpectrumConfig {
+    size_t fft_size = 4096;                 // 向上取整为2的幂，[MIN_FFT_SIZE, MAX_FFT_SIZE]
+    SpectrumWindow window = SpectrumWindow::Hann;
+    double overlap = 0.5;                   // 相邻段的重叠比例，[0, MAX_OVERLAP]
+    size_t averages = 8;                    // Welch 平均的段数，[1, MAX_AVERAGES]
+    std::vector<size_t> channels{0};        // 计算的通道（超出范围的忽略）
+};
+
+// 一次发布的结果：每个通道 bins 个频点的单边功率谱密度
+struct SpectrumSnapshot {
+    uint64_t generation = 0;                // 每次发布递增；0 表示还没有结果
+    size_t fft_size = 0;
+    size_t bins = 0;                        // fft_size / 2 + 1，频点 k 对应 k * bin_width Hz
+    double bin_width = 0.0;                 // Hz
+    size_t averaged = 0;                    // 参与平均的段数：启动或重新配置后逐段增加到 averages
+    uint64_t end_sample = 0;                // 最新一段的结束位置（全局样本索引）
+    SpectrumWindow window = SpectrumWindow::Hann;
+    std::vector<size_t> channels;
+    std::vector<float> power_db;            // channels.size() * bins，10*log10(单位²/Hz)
+
+    const float* channel(size_t index) const { return power_db.data() + index * bins; }
+};
+
+struct SpectrumStats {
+    uint64_t transforms = 0;                // 已计算的 FFT（每段每通道一次）
+    uint64_t missed_segments = 0;           // 计算线程落后、样本已被环形缓冲覆盖而跳过的段
+    double busy_seconds = 0.0;              // 计算线程（含线程池中分摊的任务）的累计墙钟时间
+};
+
+// 功率谱分析（Welch 法），由后台线程增量计算
+// - 每个选中的通道在自己的历史中保留最近 fft_size 个样本（段长可以超过环形缓冲的可读窗口）；每攒够 hop = fft_size * (1 - overlap) 个新样本取一段，
+//   加窗后做实数 FFT，结果与最近 averages 段的功率谱取平均后发布。NaN 样本（丢包缺口）按 0 计
+// - 通道之间相互独立，同一批段按通道分给 CodecPool 的工作线程并行计算
+// - 结果通过三缓冲发布，UI 线程 acquireSnapshot() 无锁读取；configure() 可在任意线程调用，
+//   计算线程在下一轮应用新配置并重新开始平均
+// - 启动或重新配置时从环形缓冲中可读的样本开始，第一段最多等待 fft_size 个样本
+// 内存约为 通道数 x (averages + 3) x fft_size 个 float
+class SpectrumAnalyzer {
+public:
+    static constexpr size_t MIN_FFT_SIZE = 64;
+    static constexpr size_t MAX_FFT_SIZE = 65536;
+    static constexpr size_t MAX_AVERAGES = 64;
+    static constexpr double MAX_OVERLAP = 0.9;
+
+    SpectrumAnalyzer(const ChannelRingStore& store, double sample_rate, CodecPool& pool = CodecPool::shared());
+    ~SpectrumAnalyzer();
+
+    SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+    SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+
+    void start();
+    void stop();
+
+    void configure(const SpectrumConfig& config);
+    SpectrumConfig config() const;
+
+    // ---- 生产者（计算线程；未 start() 时可由调用方直接驱动，用于测量计算开销） ----
+
+    // 计算全局索引 end 之前所有完整的段，有新段时发布一次结果
+    void process(uint64_t end);
+
+    // ---- 消费者（单个读线程） ----
+
+    // 返回的快照在下一次调用之前保持不变
+    const SpectrumSnapshot& acquireSnapshot() { return snapshots.acquire(); }
+    bool hasUpdate() const { return snapshots.hasUpdate(); }
+
+    SpectrumStats getStats() const;
+
+private:
+    struct ChannelState {
+        size_t channel = 0;
+        std::vector<float> history;         // fft_size 个样本的环，全局索引 i 位于 i & (fft_size - 1)
+        std::vector<float> windowed;
+        std::vector<float> re;
+        std::vector<float> im;
+        std::vector<float> segments;        // 最近 averages 段的功率谱，averages * bins
+        std::vector<double> sum;            // 这些功率谱之和
+    };
+
+    void run();
+    void applyConfig(uint64_t end);
+    void restart(uint64_t end);
+    void copyHistory(ChannelState& state, uint64_t from, uint64_t to) const;
+    void processChannel(ChannelState& state, uint64_t read_from, uint64_t first_segment_end, size_t segment_total,
+                        float* power_db);
+    void publish();
+
+    const ChannelRingStore& store;
+    const double sample_rate;
+    CodecPool& pool;
+
+    mutable std::mutex config_mutex;
+    SpectrumConfig pending_config;
+    std::atomic<uint64_t> config_version{1};
+
+    // 以下为生产者私有
+    uint64_t applied_version = 0;
+    SpectrumConfig active;
+    std::unique_ptr<RealFft> fft;
+    std::vector<float> window;
+    double psd_scale = 0.0;                 // 1 / (sample_rate * sum(window²))
+    size_t hop = 0;
+    std::vector<ChannelState> states;
+    uint64_t read_end = 0;                  // 已拷贝进各通道 history 的样本
+    uint64_t next_segment_end = 0;
+    uint64_t segment_count = 0;             // 重新开始以来的段数；段 i 的功率谱在平均环的 i % averages 处
+    uint64_t first_valid = 0;               // 平均环中最早的有效段
+    uint64_t generation = 0;
+
+    TripleBuffer<SpectrumSnapshot> snapshots;
+
+    std::atomic<uint64_t> transforms{0};
+    std::atomic<uint64_t> missed_segments{0};
+    std::atomic<uint64_t> busy_ns{0};
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::mutex wait_mutex;
+    std::condition_variable wait_cv;
+};
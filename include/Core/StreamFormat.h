@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 数据流的默认包格式（发送端、各接收端与 DataManager 共用）
+// 数据包为通道优先布局：samples[channel * SAMPLES_PER_PACKET + sample]，float32
+namespace StreamFormat {
+
+constexpr size_t CHANNEL_COUNT = 128;
+constexpr size_t SAMPLES_PER_PACKET = 8;
+constexpr double SAMPLE_RATE = 22500.0; // Hz
+constexpr size_t PACKAGE_SIZE = sizeof(float) * CHANNEL_COUNT * SAMPLES_PER_PACKET; // 4096字节
+
+} // namespace StreamFormat
+
+// 样本编码：整数格式为小端有符号数，解码后归一化到 [-1, 1)
+enum class SampleType : uint8_t {
+    Float32 = 0,
+    Int16 = 1,
+    Int24 = 2,    // 每样本3字节紧密排列
+};
+
+// 包内样本排列
+enum class SampleLayout : uint8_t {
+    ChannelMajor = 0,   // samples[channel * samples_per_packet + sample]
+    Interleaved = 1,    // samples[sample * channel_count + channel]
+};
+
+// 可选的数据包头（小端，32字节）：启用时位于每个数据包开头，样本紧随其后
+// - sequence 每包加1，first_sample 为首个样本在发送端的全局索引，接收端据此发现丢包、重复与乱序
+// - version 与 header_size 标识包头格式，扩展字段时两者一起改变，接收端要求与自己一致
+// - 未启用时数据包只有样本（兼容原有的 4096 字节数据包）
+struct PacketHeader {
+    static constexpr uint32_t MAGIC = 0x4B504D53;   // "SMPK"
+    static constexpr uint16_t VERSION = 1;
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint64_t sequence;
+    uint64_t first_sample;
+    uint16_t channel_count;
+    uint16_t samples_per_packet;
+    uint8_t sample_type;            // SampleType
+    uint8_t sample_layout;          // SampleLayout
+    uint16_t reserved;
+};
+
+static_assert(sizeof(PacketHeader) == 32, "packet header size is part of the wire format");
+
+// 数据流描述：由配置或传输层的头部给出，决定所有缓冲的大小、数据包校验与解码内核
+struct StreamDescriptor {
+    static constexpr size_t MAX_CHANNELS = 4096;
+    static constexpr size_t MAX_SAMPLES_PER_PACKET = 4096;
+
+    size_t channel_count = StreamFormat::CHANNEL_COUNT;
+    size_t samples_per_packet = StreamFormat::SAMPLES_PER_PACKET;
+    double sample_rate = StreamFormat::SAMPLE_RATE;
+    SampleType sample_type = SampleType::Float32;
+    SampleLayout layout = SampleLayout::ChannelMajor;
+    bool packet_header = false;     // 数据包是否带 PacketHeader
+
+    size_t bytesPerSample() const {
+        switch (sample_type) {
+        case SampleType::Int16: return 2;
+        case SampleType::Int24: return 3;
+        default: return 4;
+        }
+    }
+    size_t headerSize() const { return packet_header ? sizeof(PacketHeader) : 0; }
+    size_t payloadSize() const { return bytesPerSample() * channel_count * samples_per_packet; }
+    size_t packetSize() const { return headerSize() + payloadSize(); }
+    double packetsPerSecond() const { return sample_rate / samples_per_packet; }
+
+    bool isValid() const {
+        return channel_count > 0 && channel_count <= MAX_CHANNELS &&
+               samples_per_packet > 0 && samples_per_packet <= MAX_SAMPLES_PER_PACKET &&
+               sample_rate > 0.0;
+    }
+
+    bool operator==(const StreamDescriptor& other) const {
+        return channel_count == other.channel_count && samples_per_packet == other.samples_per_packet &&
+               sample_rate == other.sample_rate && sample_type == other.sample_type && layout == other.layout &&
+               packet_header == other.packet_header;
+    }
+    bool operator!=(const StreamDescriptor& other) const { return !(*this == other); }
+};
+
+const char* sampleTypeName(SampleType type);
+bool parseSampleType(const std::string& text, SampleType& type);
+const char* sampleLayoutName(SampleLayout layout);
+bool parseSampleLayout(const std::string& text, SampleLayout& layout);
+
+// 发送端：在 packet 开头写入包头
+void writePacketHeader(uint8_t* packet, const StreamDescriptor& stream, uint64_t sequence, uint64_t first_sample);
+// 接收端：读出包头并校验魔数、版本与数据流描述是否一致
+bool readPacketHeader(const uint8_t* packet, const StreamDescriptor& stream, PacketHeader& header);
+
+// 可选的发送时间戳（sensor_sender --stamp）：位于负载开头（包头之后），覆盖最前面 16 字节的样本
+// - send_time_ns 为发送时刻的 steady_clock（Linux 上即 CLOCK_MONOTONIC，同机进程间可比）
+// - 不属于包格式，接收端不校验；只有约定了打戳的延迟测量才读取
+struct SendStamp {
+    int64_t send_time_ns;
+    uint64_t sequence;
+};
+
+static_assert(sizeof(SendStamp) == 16, "send stamp occupies the first 16 payload bytes");
+
+void writeSendStamp(uint8_t* packet, const StreamDescriptor& stream, const SendStamp& stamp);
+SendStamp readSendStamp(const uint8_t* packet, const StreamDescriptor& stream);
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Core/DataManager.h"
+
+// 把按时间排列的折线点合并为 columns 个像素列的最小/最大值（[start_time, end_time] 均分）
+// - NaN 点（丢包缺口）跳过，缺口两侧不连接
+// - 点比列稀疏时（放大），两点之间的空列按线性插值填充
+// - 相邻列的区间互相衔接（本列区间延伸到与前一列相交），逐列画竖线即为连续的波形
+// 没有数据的列为 NaN；返回有数据的列数
+size_t binColumns(const float* times, const float* values, size_t count, double start_time, double end_time,
+                  size_t columns, float* mins, float* maxs);
+
+// 叠放波形图（每个通道一道，脑电图式）的数据：每道按像素列的最小/最大包络
+// - 数据取自 DataManager::queryEnvelope（包络金字塔），每道代价 O(列数)，与采样率和时间窗口无关
+// - 只计算可见的道：界面滚动时给出可见的通道范围
+// - 每帧的代价上限：道高不小于 MIN_LANE_HEIGHT、视图高度不超过 MAX_VIEW_HEIGHT，可见道数不超过
+//   MAX_VISIBLE_LANES（含裁剪器在上下边缘多给的部分可见道），与通道总数无关；1024 通道时也只处理这么多道
+// 非线程安全，由 UI 线程使用
+class StripChart {
+public:
+    static constexpr float MIN_LANE_HEIGHT = 8.0f;
+    static constexpr float MAX_VIEW_HEIGHT = 800.0f;
+    static constexpr size_t MAX_VISIBLE_LANES = static_cast<size_t>(MAX_VIEW_HEIGHT / MIN_LANE_HEIGHT) + 2;
+
+    // 生成通道 [first_channel, first_channel + lane_count) 在 [start_time, end_time] 内的 columns 列包络
+    void update(const DataManager& manager, size_t first_channel, size_t lane_count, double start_time,
+                double end_time, size_t columns);
+
+    size_t firstChannel() const { return first_channel; }
+    size_t laneCount() const { return lane_count; }
+    size_t columns() const { return column_count; }
+
+    // 第 lane 道（通道 firstChannel() + lane）的逐列最小/最大值
+    const float* laneMin(size_t lane) const { return column_min.data() + lane * column_count; }
+    const float* laneMax(size_t lane) const { return column_max.data() + lane * column_count; }
+    // 道内的数值范围，没有数据时 low > high
+    float laneLow(size_t lane) const { return lane_low[lane]; }
+    float laneHigh(size_t lane) const { return lane_high[lane]; }
+
+private:
+    // queryEnvelope 的输出缓冲（每列最多2个点），各道复用
+    std::vector<float> point_times;
+    std::vector<float> point_values;
+
+    std::vector<float> column_min;     // lane_count * column_count
+    std::vector<float> column_max;
+    std::vector<float> lane_low;
+    std::vector<float> lane_high;
+    size_t first_channel = 0;
+    size_t lane_count = 0;
+    size_t column_count = 0;
+};
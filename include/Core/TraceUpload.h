@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Core/DataManager.h"
+
+// GPU 波形环的一段写入：时间槽 [slot_first, slot_first + slot_count)，data 为按时间槽排列的样本，
+// 每槽 channel_count 个 float（通道 channel_first 起）
+struct TraceUploadRange {
+    size_t slot_first = 0;
+    size_t slot_count = 0;
+    const float* data = nullptr;
+};
+
+// 每个通道的绘制参数：显示值 = 样本 * scale + offset，颜色为 RGBA
+struct TraceChannelStyle {
+    float offset = 0.0f;
+    float scale = 1.0f;
+    float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+};
+
+// 样本序号到标准化设备坐标的线性映射：x = i * x_scale + x_bias，y = 显示值 * y_scale + y_bias
+struct TraceTransform {
+    float x_scale = 1.0f;
+    float x_bias = 0.0f;
+    float y_scale = 1.0f;
+    float y_bias = 0.0f;
+
+    // 绘图区的坐标范围为 [x_min, x_max] x [y_min, y_max]；首个样本的时间为 first_time，采样间隔 1 / sample_rate
+    static TraceTransform fromPlot(double first_time, double sample_rate, double x_min, double x_max, double y_min,
+                                   double y_max);
+};
+
+struct TraceVertex {
+    float x = 0.0f;
+    float y = 0.0f;
+    bool valid = false;    // NaN 样本（丢包缺口）不绘制与之相连的线段
+};
+
+// 顶点着色器的 CPU 参考实现：第 index 个样本的顶点位置，与着色器逐项一致，用于无 GPU 的校验
+TraceVertex traceVertex(const TraceTransform& transform, const TraceChannelStyle& style, size_t index, float value);
+
+// 把显示帧增量转换为 GPU 波形环的写入（不依赖 OpenGL，GPU 端只需按返回的区段拷贝）
+// - GPU 环与显示帧同构：sample_stride 个时间槽，每槽为所显示通道在同一时刻的样本（按时间优先排列），
+//   新样本在环中总是连续的，每帧最多两段（环回绕时）写入
+// - 只转换上次之后新增的样本；通道范围、清除、窗口大小变化或落后超过一个窗口时重建（whole = true，
+//   GPU 端应先丢弃旧缓冲）
+// - 第 i 个显示样本位于时间槽 (startSlot() + i) % stride()
+// 非线程安全，由 UI 线程使用
+class TraceUploader {
+public:
+    // 返回本帧需要写入的区段数（0..2），区段数据在下一次 update() 之前有效
+    size_t update(const DisplayFrame& frame, TraceUploadRange ranges[2], bool& whole);
+    void reset();
+
+    size_t channelFirst() const { return channel_first; }
+    size_t channelCount() const { return channel_count; }
+    size_t stride() const { return slot_stride; }
+    size_t startSlot() const { return start_slot; }
+    size_t sampleCount() const { return sample_count; }
+    double firstTime() const { return first_time; }
+    size_t bufferFloats() const { return slot_stride * channel_count; }
+
+private:
+    std::vector<float> staging;        // 与 GPU 环同布局，只有本帧写入的区段有效
+    uint64_t generation = 0;
+    uint64_t uploaded_end = 0;         // 已写入 GPU 的样本的全局结束索引
+    uint64_t base_sample = 0;
+    size_t channel_first = 0;
+    size_t channel_count = 0;
+    size_t slot_stride = 0;
+    size_t start_slot = 0;
+    size_t sample_count = 0;
+    double first_time = 0.0;
+    bool valid = false;
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// 无锁三缓冲：一个写线程、一个读线程
+// - 写线程始终在自己的后台缓冲上写，publish() 时与中间缓冲交换
+// - 读线程 acquire() 时若有新数据则与中间缓冲交换，返回的缓冲在下一次 acquire() 之前保持不变
+// 三个缓冲都在初始化时分配好，交换只涉及下标，运行期无分配、无拷贝
+template <typename T>
+class TripleBuffer {
+public:
+    // 在读写线程启动之前对三个缓冲做预分配
+    template <typename Fn>
+    void initialize(Fn&& fn) {
+        for (auto& buffer : buffers) {
+            fn(buffer);
+        }
+    }
+
+    // ---- 写线程 ----
+    T& writeBuffer() { return buffers[back]; }
+
+    // 发布后台缓冲，并换回一个空闲缓冲继续写
+    void publish() {
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(back | DIRTY_BIT), std::memory_order_acq_rel);
+        back = previous & INDEX_MASK;
+    }
+
+    // ---- 读线程 ----
+    bool hasUpdate() const { return (middle.load(std::memory_order_relaxed) & DIRTY_BIT) != 0; }
+
+    const T& acquire() {
+        if (hasUpdate()) {
+            uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+            front = previous & INDEX_MASK;
+        }
+        return buffers[front];
+    }
+
+private:
+    static constexpr uint8_t DIRTY_BIT = 0x4;
+    static constexpr uint8_t INDEX_MASK = 0x3;
+
+    T buffers[3];
+    uint8_t back = 0;                 // 写线程私有
+    uint8_t front = 2;                // 读线程私有
+    std::atomic<uint8_t> middle{1};   // 共享：下标 | DIRTY_BIT
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include <functional>
+#include "Core/PacketBatch.h"
+#include "IO/SubscriberStats.h"
+
+// 数据接收端的统一接口：各传输方式（Socket、ZeroMQ等）在自己的线程中接收数据，
+// 并以批量回调的形式把完整的数据包交给调用方
+// 多线程接收的传输（socket 的多个 epoll 线程）可能从不同线程并发调用回调，但同一来源（batch.source）的批次
+// 总在同一线程上按序交付
+class ISubscriber {
+public:
+    using BatchCallback = std::function<void(const PacketBatch&)>;
+
+    virtual ~ISubscriber() = default;
+
+    virtual void startBatch(BatchCallback cb) = 0;
+    virtual void stop() = 0;
+
+    virtual SubscriberStats getStats() const = 0;
+    virtual const char* name() const = 0;
+};
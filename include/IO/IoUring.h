@@ -0,0 +1,85 @@
+#pragma once
+#include <linux/io_uring.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// io_uring 的最小封装（直接使用系统调用，不依赖 liburing），只由创建它的线程使用
+// - 提交队列与完成队列映射到用户态：准备请求、取完成结果都不进入内核，只有提交/等待时调用 io_uring_enter
+// - 优先以 DEFER_TASKRUN 创建：网络就绪后的接收工作推迟到等待的线程进入内核时统一执行，
+//   等待多个完成时内核攒够数量才唤醒（内核不支持时退回 COOP_TASKRUN / 默认模式）
+// - 提供缓冲环（provided buffer ring）：multishot recv 由内核从环中挑选缓冲写入，处理完后归还
+class IoUring {
+public:
+    IoUring() = default;
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    // 失败时（内核不支持、被 sysctl 禁用等）返回 false，error 给出原因
+    bool init(unsigned entries, std::string& error);
+    // 登记 count 个（2的幂）buffer_size 字节的接收缓冲，组号 group
+    bool registerBufferRing(uint16_t group, unsigned count, size_t buffer_size, std::string& error);
+
+    // 取一个清零的提交项；提交队列满时先提交已准备的请求，仍然满时返回 nullptr
+    io_uring_sqe* getSqe();
+    // 提交已准备的请求，并等待至少 wait_nr 个完成或 timeout_ns 超时（0 表示不限时）；返回 io_uring_enter 的结果（失败为 -errno）
+    int submitAndWait(unsigned wait_nr, uint64_t timeout_ns = 0);
+
+    // 依次处理已有的完成项（不进入内核），handler 收到完成项的副本，其中可以继续准备新的请求
+    template <typename Handler>
+    unsigned drainCompletions(Handler handler) {
+        unsigned handled = 0;
+        unsigned head = *cq_head;
+        while (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+            io_uring_cqe cqe = cqes[head & cq_mask];
+            __atomic_store_n(cq_head, ++head, __ATOMIC_RELEASE);
+            handler(cqe);
+            ++handled;
+        }
+        return handled;
+    }
+
+    uint8_t* buffer(uint16_t id) { return buffers.get() + id * buffer_size; }
+    size_t bufferSize() const { return buffer_size; }
+    // 归还缓冲：先记入环中，publishBuffers() 时统一对内核可见
+    void recycleBuffer(uint16_t id);
+    void publishBuffers();
+
+    uint64_t enterCalls() const { return enter_calls; }
+    const char* modeName() const;
+
+private:
+    int ring_fd = -1;
+    uint32_t setup_flags = 0;
+
+    void* sq_ring = nullptr;
+    size_t sq_ring_size = 0;
+    void* cq_ring = nullptr;          // 与 sq_ring 相同时为单次映射
+    size_t cq_ring_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_size = 0;
+
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_head = nullptr;
+    unsigned sq_mask = 0;
+    unsigned sq_entries = 0;
+    unsigned sqe_tail = 0;            // 已准备到的位置（提交时写入 sq_tail）
+    unsigned submitted = 0;
+
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    io_uring_buf_ring* buf_ring = nullptr;
+    size_t buf_ring_size = 0;
+    unsigned buf_mask = 0;
+    uint16_t buf_tail = 0;
+    size_t buffer_size = 0;
+    std::unique_ptr<uint8_t[]> buffers;
+
+    uint64_t enter_calls = 0;
+};
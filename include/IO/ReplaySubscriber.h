@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "IO/ISubscriber.h"
+#include "Storage/RecordingReader.h"
+
+// 回放录制文件的接收端：无需硬件即可复现现场问题、压测界面，也可作为整条接收→显示流水线的确定性基准
+// - 支持 Recorder 写出的分块录制文件，以及旧版程序退出时保存的 cached_samples.bin
+//   （每通道依次为 size_t 通道号、size_t 样本数、float32 样本）
+// - 录制文件映射到内存，数据包原地交付给回调，不做拷贝；压缩的录制文件在回放到某块时才解码该块；
+//   旧格式按通道存放，打开时一次性重排为数据包
+// - 按样本索引定速：speed 为 1 时按实时速率，N 为 N 倍速，0 为不限速；
+//   每个包在其最后一个样本的时刻到达后才交付，落后时连续交付以追上进度
+class ReplaySubscriber : public ISubscriber {
+public:
+    static constexpr size_t MAX_BATCH_PACKETS = 64;   // 单批最多交付的包数
+
+    // stream 必须与录制文件头中的描述一致；旧格式没有描述，按 stream 的通道数与每包样本数重排
+    ReplaySubscriber(const std::string& path, const StreamDescriptor& stream = StreamDescriptor(),
+                     double speed = 1.0, bool loop = false);
+    ~ReplaySubscriber() override;
+
+    void startBatch(BatchCallback cb) override;
+    void stop() override;
+
+    SubscriberStats getStats() const override;
+    const char* name() const override { return "replay"; }
+
+    // 非循环模式下已回放完整个文件
+    bool finished() const { return replay_finished; }
+
+private:
+    // 一段连续存放的数据包，first_sample 为第一个包首个样本的全局索引；
+    // data 为空时数据在压缩块 chunk 中，交付前解码到 chunk_packets
+    struct Segment {
+        const uint8_t* data;
+        size_t packet_count;
+        uint64_t first_sample;
+        size_t chunk;
+    };
+
+    void run();
+    bool load();
+    bool loadLegacy();
+
+    std::string file_path;
+    StreamDescriptor stream;
+    double speed;
+    bool loop;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<bool> replay_finished{false};
+    BatchCallback batch_callback;
+
+    RecordingReader reader;
+    std::vector<uint8_t> legacy_packets;   // 旧格式重排后的数据包
+    std::vector<uint8_t> chunk_packets;    // 当前压缩块解码后的数据包
+    std::vector<Segment> segments;
+
+    std::atomic<uint64_t> packets_received{0};
+    std::atomic<uint64_t> bytes_received{0};
+    std::atomic<uint64_t> recv_calls{0};        // 等待下一个包到期的次数
+    std::atomic<uint64_t> batches_delivered{0};
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "Core/StreamFormat.h"
+
+// 共享内存环形队列的内存布局（发送端 ShmRingWriter 与接收端 ShmSubscriber 共用）
+// [ShmRingHeader，占一页][槽 0][槽 1]...[槽 N-1]
+// - 单生产者/单消费者：生产者写满槽位后以 release 语义推进 write_index，
+//   消费者在槽内原地读取数据包，处理完后推进 read_index 归还槽位
+// - 快速路径上双方都不进入内核；消费者空闲时在 wake_seq 上 futex 等待，
+//   生产者只在 consumer_waiting 置位时才发起唤醒
+struct ShmRingHeader {
+    static constexpr uint32_t MAGIC = 0x474E5253;   // "SRNG"
+    static constexpr uint32_t VERSION = 2;
+    static constexpr size_t SLOT_OFFSET = 4096;     // 槽位从第二页开始，按页对齐
+
+    std::atomic<uint32_t> magic;            // 生产者初始化完成后最后写入
+    uint32_t version;
+    uint32_t slot_count;                    // 2的幂
+    uint32_t slot_size;                     // 每个槽一个数据包，槽之间紧密排列
+    std::atomic<uint32_t> producer_closed;  // 生产者退出时置位
+
+    // 数据流描述：接收端据此校验与自己的配置一致
+    uint32_t channel_count;
+    uint32_t samples_per_packet;
+    double sample_rate;
+    uint8_t sample_type;                    // SampleType
+    uint8_t sample_layout;                  // SampleLayout
+    uint8_t packet_header;                  // 数据包是否带 PacketHeader（旧的生产者为0）
+
+    alignas(64) std::atomic<uint64_t> write_index;   // 生产者写
+    std::atomic<uint64_t> dropped;                   // 队列满时生产者丢弃的包数
+    alignas(64) std::atomic<uint64_t> read_index;    // 消费者写
+    alignas(64) std::atomic<uint32_t> wake_seq;      // futex 字
+    std::atomic<uint32_t> consumer_waiting;
+};
+
+static_assert(sizeof(ShmRingHeader) <= ShmRingHeader::SLOT_OFFSET, "ShmRingHeader must fit in the first page");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory indices must be lock-free");
+
+inline StreamDescriptor shmRingStream(const ShmRingHeader& header) {
+    StreamDescriptor stream;
+    stream.channel_count = header.channel_count;
+    stream.samples_per_packet = header.samples_per_packet;
+    stream.sample_rate = header.sample_rate;
+    stream.sample_type = static_cast<SampleType>(header.sample_type);
+    stream.layout = static_cast<SampleLayout>(header.sample_layout);
+    stream.packet_header = header.packet_header != 0;
+    return stream;
+}
+
+inline size_t shmRingMappingSize(size_t slot_count, size_t slot_size) {
+    return ShmRingHeader::SLOT_OFFSET + slot_count * slot_size;
+}
+
+// 跨进程 futex（不带 FUTEX_PRIVATE_FLAG）：wake_seq 仍等于 expected 时睡眠，最多 timeout_ms
+inline void shmFutexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+    timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+inline void shmFutexWake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "IO/ShmRingLayout.h"
+
+// 共享内存环形队列的发送端（供同机的采集进程链接使用）
+// - open() 创建共享内存段并初始化布局；同名的旧段会先被删除，已连接的接收端会检测到并重新连接
+// - 零拷贝写入：acquireSlot() 取得下一个空闲槽直接写入数据包，再 commitSlot() 发布
+// - 队列满时不阻塞采集：acquireSlot() 返回 nullptr 并计入丢弃数
+class ShmRingWriter {
+public:
+    static constexpr size_t DEFAULT_SLOT_COUNT = 1024;   // 默认格式下约4MB，流速率下约0.36秒
+
+    ShmRingWriter() = default;
+    ~ShmRingWriter();
+
+    ShmRingWriter(const ShmRingWriter&) = delete;
+    ShmRingWriter& operator=(const ShmRingWriter&) = delete;
+
+    // name 为 POSIX 共享内存名（如 "/sensormonitor"），每个槽放一个 stream.packetSize() 字节的数据包，
+    // stream 写入头部供接收端校验；slot_count 会向上取整为2的幂
+    bool open(const std::string& name, const StreamDescriptor& stream, size_t slot_count = DEFAULT_SLOT_COUNT);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // 取得下一个空闲槽（slotSize() 字节）；队列满时返回 nullptr
+    uint8_t* acquireSlot();
+    // 发布 acquireSlot() 取得的槽，必要时唤醒接收端
+    void commitSlot();
+
+    // 拷贝写入一个数据包（size 不超过 slotSize()）；队列满时返回 false
+    bool write(const void* packet, size_t size);
+
+    size_t slotSize() const { return slot_size; }
+    uint64_t droppedCount() const;
+
+private:
+    std::string shm_name;
+    int fd = -1;
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+
+    ShmRingHeader* header = nullptr;
+    uint8_t* slots = nullptr;
+    size_t slot_size = 0;
+    size_t slot_count = 0;
+
+    uint64_t write_index = 0;          // 本地副本，只有本对象写 header->write_index
+    uint64_t cached_read_index = 0;    // 仅在看起来满时才重新读取共享的 read_index
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <thread>
+#include <sys/types.h>
+#include "IO/ISubscriber.h"
+#include "IO/ShmRingLayout.h"
+
+// 共享内存环形队列的接收端（同机采集进程通过 ShmRingWriter 写入）
+// - 数据包在共享内存的槽位中原地交付给回调，不做拷贝；回调返回后才归还槽位
+// - 有数据时不进入内核；队列空时在 futex 上等待（100ms 超时，用于响应 stop() 和检测发送端重启）
+// - 发送端未启动或退出后自动重试连接
+class ShmSubscriber : public ISubscriber {
+public:
+    static constexpr size_t MAX_BATCH_PACKETS = 64;   // 单批最多交付的包数，尽早归还槽位
+
+    // stream 必须与发送端写在共享内存头部的描述一致，否则拒绝连接
+    explicit ShmSubscriber(const std::string& name, const StreamDescriptor& stream = StreamDescriptor());
+    ~ShmSubscriber() override;
+
+    void startBatch(BatchCallback cb) override;
+    void stop() override;
+
+    SubscriberStats getStats() const override;
+    const char* name() const override { return "shm"; }
+
+private:
+    void run();
+    bool attach(bool& warned);
+    void detach();
+    // 共享内存名已被删除或指向了新的段（发送端重启）
+    bool isStale() const;
+
+    std::string shm_name;
+    StreamDescriptor stream;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    BatchCallback batch_callback;
+
+    // 当前映射（仅工作线程访问）
+    int fd = -1;
+    ino_t mapped_inode = 0;
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    ShmRingHeader* header = nullptr;
+
+    std::atomic<uint64_t> packets_received{0};
+    std::atomic<uint64_t> bytes_received{0};
+    std::atomic<uint64_t> recv_calls{0};        // futex 等待次数（唯一的系统调用）
+    std::atomic<uint64_t> batches_delivered{0};
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "Core/ChunkCodec.h"
+#include "Core/PacketQueue.h"
+#include "Core/StreamFormat.h"
+#include "IO/ISubscriber.h"
+#include "IO/SocketSubscriber.h"
+
+// 接收端配置：transport 选择传输方式，其余字段按传输方式取用；stream 为所有传输方式共用的数据流描述
+struct SubscriberConfig {
+    StreamDescriptor stream;
+    std::string transport = "socket";          // socket | udp | zmq | shm | replay
+    std::string host = "127.0.0.1";            // socket / udp（组播时为接收组播的本机接口地址）
+    int port = 5555;                           // socket / udp
+    size_t streams = 1;                        // socket：同时接入的发送端数，每个连接对应一个流
+    size_t socket_threads = 1;                 // socket：接收线程数
+    SocketBackend socket_backend = SocketBackend::Epoll;  // socket：epoll 或 io_uring（不可用时退回 epoll）
+    std::string multicast_group;               // udp：非空时加入该组播组
+    size_t udp_batch = 64;                     // udp：每次 recvmmsg 最多接收的数据报数
+    std::string endpoint = "tcp://*:5555";     // zmq
+    std::string shm_name = "/sensormonitor";   // shm：POSIX 共享内存名
+    std::string replay_path;                   // replay：录制文件或 cached_samples.bin
+    double replay_speed = 1.0;                 // replay：回放倍速，0 表示不限速
+    bool replay_loop = false;                  // replay：到达文件末尾后从头循环
+    std::string record_path;                   // 非空时把接收到的数据包录制到该文件
+    ChunkCodec record_codec = ChunkCodec::ShuffleRle;    // 录制文件的块压缩方式
+    std::string history_dir;                   // 非空时把超出内存窗口的历史压缩溢写到该目录
+    uint64_t history_max_mb = 8192;            // 溢写文件的大小上限（MB），写满后覆盖最旧的数据
+    ChunkCodec history_codec = ChunkCodec::ShuffleRle;   // 溢写块的压缩方式
+    size_t queue_slots = PacketQueue::DEFAULT_SLOTS;      // 接收与处理之间的队列槽数，0 表示在接收线程上直接处理
+    OverflowPolicy queue_policy = OverflowPolicy::Block;  // 队列满时的处理方式
+};
+
+// 按配置创建接收端；传输方式未知或未编译进来时返回 nullptr
+std::unique_ptr<ISubscriber> createSubscriber(const SubscriberConfig& config);
+
+// 从命令行解析接收端配置：--transport --host --port --streams --socket-threads --socket-backend --multicast-group --udp-batch --endpoint --shm-name --record
+// --record-codec --history-dir --history-max-mb --history-codec --queue-slots --queue-policy --replay-file --replay-speed --replay-loop，以及数据流描述 --channels --samples-per-packet --sample-rate
+// --sample-type --layout --packet-header；回放录制文件时数据流描述取自文件头
+// 遇到无法识别的参数时打印用法并返回 false
+bool parseSubscriberArgs(int argc, char** argv, SubscriberConfig& config);
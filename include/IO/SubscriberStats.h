@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+// 接收统计（累计值，调用方按时间差计算速率）
+struct SubscriberStats {
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint64_t recv_calls = 0;
+    uint64_t syscalls = 0;        // 接收线程的系统调用（recv、epoll_wait、io_uring_enter、futex 等待等）
+    uint64_t batches = 0;
+    uint64_t connections = 0;     // 当前连接的发送端（socket），其余传输为0
+    uint64_t waiting = 0;         // 已连接但没有空闲流、暂不读取的发送端
+    uint64_t dropped = 0;         // 内核接收缓冲溢出丢弃的数据报（udp）
+    uint64_t invalid = 0;         // 长度不是一个数据包的数据报（udp），丢弃
+    uint64_t reordered = 0;       // 按序号重排的包（udp）
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include "Core/StreamFormat.h"
+#include "IO/ISubscriber.h"
+
+// UDP（可选组播）接收端：每个数据报是一个完整的数据包
+// - 一次 recvmmsg 最多取出 batch_packets 个数据报，直接写入预先登记好的接收缓冲（iovec 指向缓冲中的各个包位置），
+//   有一个数据报到达即返回（MSG_WAITFORONE），整批交付给回调，不拷贝
+// - 没有 TCP 的重传与队头阻塞：丢失的包由带包头的数据流在 DataManager 中以 NaN 填充，
+//   乱序到达的包按包头序号重排后再交付：序号最大的 REORDER_WINDOW 个包留到下一批一起排序，
+//   跨越两批的乱序也能排回原位；留下的包在之后到达更多包、接收等待超时或 stop() 时交付
+// - 长度不等于数据包大小的数据报丢弃；内核接收缓冲溢出的丢包数由 SO_RXQ_OVFL 取得
+// - 接收等待带 100ms 超时，用于响应 stop()
+class UdpSubscriber : public ISubscriber {
+public:
+    static constexpr size_t DEFAULT_BATCH_PACKETS = 64;   // 与 PacketQueue 的槽大小一致
+    static constexpr int RECV_BUFFER_BYTES = 8 * 1024 * 1024;
+    // 重排窗口（包数）：数据持续到达时交付延迟这么多个包的间隔（默认流约 2.8ms）
+    static constexpr size_t REORDER_WINDOW = 8;
+
+    // host 为绑定地址；group 非空时加入该组播组，host 为接收组播的本机接口地址（0.0.0.0 由系统选择）
+    UdpSubscriber(const std::string& host, int port, const StreamDescriptor& stream = StreamDescriptor(),
+                  const std::string& group = "", size_t batch_packets = DEFAULT_BATCH_PACKETS);
+    ~UdpSubscriber() override;
+
+    void startBatch(BatchCallback cb) override;
+    void stop() override;
+
+    SubscriberStats getStats() const override;
+    const char* name() const override { return "udp"; }
+
+private:
+    bool openSocket();
+    void run();
+    // 按包头序号重排从 packets 开始的 count 个包（已有序时不做任何拷贝），返回排好序的数据；
+    // keep 为其末尾留到下一批的包数（发送端重启或没有包头时为 0）
+    const uint8_t* reorder(const uint8_t* packets, size_t count, size_t& keep);
+    void deliver(const uint8_t* data, size_t count);
+    // 交付留在重排窗口中的包
+    void flushHeld();
+
+    std::string host;
+    int port;
+    StreamDescriptor stream;
+    std::string group;
+    const size_t batch_packets;
+    const size_t packet_size;
+    int sock = -1;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    BatchCallback batch_callback;
+
+    // 接收缓冲与 recvmmsg 的消息描述只在启动时建立一次；
+    // 缓冲前 REORDER_WINDOW 个包位置存放重排窗口中留下的包，紧接其后是 recvmmsg 的接收位置，两者连续
+    std::vector<uint8_t> buffer;
+    size_t held_count = 0;
+    std::vector<uint8_t> sorted;                 // 重排后的数据
+    std::vector<struct mmsghdr> messages;
+    std::vector<struct iovec> iovecs;
+    std::vector<uint8_t> controls;               // 每个消息一份 SO_RXQ_OVFL 控制信息
+    std::vector<std::pair<uint64_t, uint32_t>> order;
+
+    std::atomic<uint64_t> packets_received{0};
+    std::atomic<uint64_t> bytes_received{0};
+    std::atomic<uint64_t> recv_calls{0};
+    std::atomic<uint64_t> batches_delivered{0};
+    std::atomic<uint64_t> kernel_drops{0};
+    std::atomic<uint64_t> invalid_datagrams{0};
+    std::atomic<uint64_t> reordered_packets{0};
+};
@@ -1,4 +1,3 @@
-
 #pragma once
 #include <thread>
 #include <atomic>
@@ -6,31 +5,48 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include "Core/StreamFormat.h"
+#include "IO/ISubscriber.h"
 
-class ZeroMQSubscriber {
+class ZeroMQSubscriber : public ISubscriber {
 public:
     // 更新回调函数以支持二进制数据
     using BinaryCallback = std::function<void(const std::vector<uint8_t>&)>;
     using StringCallback = std::function<void(const std::string&)>; // 保留向后兼容性
 
-    ZeroMQSubscriber(const std::string& endpoint);
-    ~ZeroMQSubscriber();
+    // 每次唤醒最多合并交付的消息数
+    static constexpr size_t MAX_BATCH_PACKETS = 64;
+
+    // stream 决定期望的消息大小，大小不符的消息被丢弃
+    ZeroMQSubscriber(const std::string& endpoint, const StreamDescriptor& stream = StreamDescriptor());
+    ~ZeroMQSubscriber() override;
 
-    // 新增：二进制数据回调
+    // 二进制数据逐包回调（兼容旧接口）
     void start(BinaryCallback cb);
+    // 批量回调：每次唤醒取出队列中所有消息，合并为一批交付
+    void startBatch(BatchCallback cb) override;
     // 保留原有的字符串回调（向后兼容）
     void startString(StringCallback cb);
     
-    void stop();
+    void stop() override;
+
+    SubscriberStats getStats() const override;
+    const char* name() const override { return "zmq"; }
 
 private:
     void run();
     void runString();
     
     std::string endpoint;
-    BinaryCallback binary_callback;
+    StreamDescriptor stream;
+    BatchCallback batch_callback;
     StringCallback string_callback;
     std::thread worker;
     std::atomic<bool> running{false};
     std::atomic<bool> use_binary_mode{true}; // 默认使用二进制模式
+
+    std::atomic<uint64_t> packets_received{0};
+    std::atomic<uint64_t> bytes_received{0};
+    std::atomic<uint64_t> recv_calls{0};
+    std::atomic<uint64_t> batches_delivered{0};
 };
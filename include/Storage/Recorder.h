@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Core/PacketBatch.h"
+#include "Storage/RecordingCodec.h"
+#include "Storage/RecordingFormat.h"
+
+struct RecorderStats {
+    uint64_t packets = 0;           // 已放入块缓冲的包数
+    uint64_t dropped_packets = 0;   // 缓冲池耗尽（磁盘跟不上）时丢弃的包数
+    uint64_t chunks_written = 0;
+    uint64_t bytes_written = 0;
+    uint64_t packet_bytes = 0;      // 已写入块中数据包的原始字节数（与 bytes_written 之比即压缩比）
+    size_t buffers_peak = 0;        // 同时等待写入的块数峰值
+    bool direct_io = false;         // 是否以 O_DIRECT 绕过页缓存写入
+    bool write_error = false;
+};
+
+// 流式录制：把接收到的原始数据包追加写入分块文件（格式见 RecordingFormat.h）
+// - append() 在接收线程调用，只把数据包拷贝进预先分配的块缓冲，不做系统调用；
+//   块写满后交给后台写线程，以整块、页对齐的 pwrite 写入
+// - 内存有界：缓冲池固定 buffer_count 块，写线程跟不上时丢弃新包并计数，不阻塞接收
+// - 写满的块立即落盘，异常退出最多丢失尚未写完的块；close() 写出未满的块和索引区
+// - 指定 codec 时写线程在落盘前压缩每块（各通道在 CodecPool::shared() 上并行编码）
+class Recorder {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;   // 1MB：默认格式下255个包，约0.09秒
+    static constexpr size_t DEFAULT_BUFFER_COUNT = 16;      // 最多16MB，可吸收约1.4秒的磁盘停顿
+
+    Recorder() = default;
+    ~Recorder();
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    // 创建（覆盖）录制文件；chunk_size 向上取整为页的整数倍，且至少容纳一个数据包
+    // 非 float32 的数据流不支持压缩，codec 退回 Raw
+    bool open(const std::string& path, const StreamDescriptor& stream,
+              size_t chunk_size = DEFAULT_CHUNK_SIZE, size_t buffer_count = DEFAULT_BUFFER_COUNT,
+              ChunkCodec codec = ChunkCodec::Raw);
+    // 写出未满的块与索引区并等待写线程结束；调用前应停止调用 append()
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    // 追加一批数据包（packet_size 必须与打开时的数据流一致）
+    void append(const PacketBatch& batch);
+
+    RecorderStats getStats() const;
+    const std::string& path() const { return file_path; }
+    ChunkCodec codec() const { return chunk_codec; }
+
+private:
+    struct PendingChunk {
+        uint8_t* buffer;
+        uint64_t chunk_index;
+    };
+
+    void run();
+    void sealChunk();
+    uint8_t* acquireBuffer();
+    bool writeAligned(const uint8_t* data, size_t size, uint64_t offset);
+    void writeIndex();
+    void releaseBuffers();
+
+    std::string file_path;
+    int fd = -1;
+    StreamDescriptor stream;
+    size_t packet_size = 0;
+    size_t chunk_size = 0;
+    size_t packets_per_chunk = 0;
+    ChunkCodec chunk_codec = ChunkCodec::Raw;
+
+    // 压缩（仅写线程访问）：压缩后的块写入 encoded_chunk，文件中的块依次排列
+    std::unique_ptr<RecordingChunkEncoder> encoder;
+    uint8_t* encoded_chunk = nullptr;
+    uint64_t write_offset = 0;
+
+    // 块缓冲池：open() 时一次性分配（页对齐），之后在接收线程与写线程之间循环使用
+    std::vector<uint8_t*> buffers;
+    std::vector<uint8_t*> free_buffers;
+    std::deque<PendingChunk> pending;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::thread writer;
+    bool stopping = false;
+
+    // 当前块（仅 append() 所在的线程访问）
+    uint8_t* current = nullptr;
+    size_t current_packets = 0;
+    uint64_t next_chunk_index = 0;
+    uint64_t next_sample = 0;
+
+    // 索引（仅写线程访问，close() 在写线程结束后写出）
+    std::vector<RecordingIndexEntry> index;
+
+    std::atomic<uint64_t> packets_recorded{0};
+    std::atomic<uint64_t> packets_dropped{0};
+    std::atomic<uint64_t> chunks_written{0};
+    std::atomic<uint64_t> bytes_written{0};
+    std::atomic<uint64_t> packet_bytes{0};
+    std::atomic<size_t> pending_peak{0};
+    std::atomic<bool> write_failed{false};
+    std::atomic<bool> direct_io{false};
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Core/ChunkCodec.h"
+#include "Core/CodecPool.h"
+#include "Core/StreamFormat.h"
+
+// 录制块的压缩负载（紧跟 RecordingChunkHeader）：
+// [uint32 channel_offsets[channel_count + 1]][uint8 channel_codecs[channel_count]，补零到4字节][各通道编码数据]
+// [带包头的数据流：各包的 PacketHeader 原样排列]
+// - 块内数据包按通道拆成连续的样本序列（跨包拼接），各通道独立编码，可在 CodecPool 上并行
+// - channel_offsets 相对负载起点，最后一项为通道数据的结尾；编码后不比原始数据小的通道以 Raw 存放
+// - 只支持 float32 样本，其他样本类型的数据流按 Raw 录制
+
+bool recordingCodecSupported(const StreamDescriptor& stream);
+
+// 编码器持有按最大块大小预分配的暂存区，只在单个线程（录制写线程）中使用
+class RecordingChunkEncoder {
+public:
+    RecordingChunkEncoder(const StreamDescriptor& stream, size_t max_packets, ChunkCodec codec);
+
+    size_t maxPayloadSize() const;
+
+    // 编码 packet_count 个数据包到 out（至少 maxPayloadSize() 字节），返回负载字节数
+    size_t encode(const uint8_t* packets, size_t packet_count, uint8_t* out, CodecPool& pool);
+
+private:
+    StreamDescriptor stream;
+    ChunkCodec codec;
+    size_t max_samples;                  // 每通道最多样本数
+    size_t channel_bound;
+    std::vector<float> series;           // channel_count x max_samples
+    std::vector<uint8_t> encoded;        // channel_count x channel_bound
+    std::vector<size_t> encoded_sizes;
+    std::vector<ChunkCodec> channel_codecs;
+};
+
+// 解码压缩负载为 packet_count 个数据包；负载损坏时返回 false。scratch 为每通道的解码暂存区
+bool decodeRecordingChunk(const StreamDescriptor& stream, const uint8_t* payload, size_t size, size_t packet_count,
+                          uint8_t* packets, std::vector<float>& scratch, CodecPool& pool);
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Core/ChunkCodec.h"
+#include "Core/StreamFormat.h"
+
+// 录制文件格式（Recorder 写入，RecordingReader 读取），字段均为本机字节序（小端）
+// [RecordingFileHeader，占一页][块 0][块 1]...[块 N-1][索引区]
+// - 块在内存中固定 chunk_size 字节：RecordingChunkHeader + 紧密排列的原始数据包
+// - 块依次追加写入，每块在文件中占 stored_size 字节（页的整数倍，块尾补零）：
+//   未压缩（codec 为 Raw）时即 chunk_size；压缩时块头之后为 RecordingCodec.h 描述的压缩负载
+// - 块头记录首个样本的全局索引与接收时刻，丢包时样本索引照常推进，读取端据此发现缺口
+// - 正常关闭时追加索引区：RecordingIndexEntry[chunk_count]，补零到页对齐，最后 sizeof(RecordingFooter) 字节为尾部
+// - 异常退出的文件没有索引区，读取端按 stored_size 顺序扫描块头恢复已写入的块
+// - 版本1（没有压缩，索引项不含偏移）仍可读取
+namespace RecordingFormat {
+
+constexpr uint32_t FILE_MAGIC = 0x43455253;    // "SREC"
+constexpr uint32_t CHUNK_MAGIC = 0x4B484353;   // "SCHK"
+constexpr uint32_t FOOTER_MAGIC = 0x58444953;  // "SIDX"
+constexpr uint32_t VERSION = 2;
+constexpr uint32_t MIN_VERSION = 1;            // 仍可读取的最早版本
+constexpr size_t ALIGNMENT = 4096;             // 所有写入的偏移与长度都按页对齐（满足 O_DIRECT）
+constexpr size_t HEADER_SIZE = ALIGNMENT;
+constexpr size_t CHUNK_HEADER_SIZE = 64;       // 数据包从块内此偏移开始
+constexpr uint8_t FLAG_PACKET_HEADER = 0x01;   // 数据包带 PacketHeader（RecordingFileHeader::flags）
+
+inline size_t alignUp(size_t size) {
+    return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+} // namespace RecordingFormat
+
+struct RecordingFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t chunk_size;
+    uint32_t packets_per_chunk;
+    uint32_t packet_size;
+
+    // 数据流描述
+    uint32_t channel_count;
+    uint32_t samples_per_packet;
+    uint8_t sample_type;            // SampleType
+    uint8_t sample_layout;          // SampleLayout
+    uint8_t codec;                  // ChunkCodec，整个文件的所有块相同（版本1为0，即 Raw）
+    uint8_t flags;                  // FLAG_*（版本1为0）
+    double sample_rate;
+
+    int64_t start_time_ns;          // 打开文件时的系统时间（Unix 纪元起的纳秒）
+};
+
+struct RecordingChunkHeader {
+    uint32_t magic;
+    uint32_t packet_count;
+    uint64_t chunk_index;
+    uint64_t first_sample;          // 首个包第一个样本的全局索引（含丢弃的包）
+    int64_t first_timestamp_ns;     // 首个包的接收时刻（系统时间）
+    int64_t last_timestamp_ns;      // 最后一个包的接收时刻
+    uint32_t stored_size;           // 块在文件中占用的字节数（版本1为0，即 chunk_size）
+    uint32_t payload_size;          // 块头之后的有效字节数（压缩负载或数据包）
+    uint64_t reserved[2];
+};
+
+struct RecordingIndexEntry {
+    uint64_t first_sample;
+    int64_t first_timestamp_ns;
+    uint32_t packet_count;
+    uint32_t stored_size;
+    uint64_t file_offset;           // 块头在文件中的偏移
+};
+
+// 版本1的索引项（块位于 HEADER_SIZE + i * chunk_size）
+struct RecordingIndexEntryV1 {
+    uint64_t first_sample;
+    int64_t first_timestamp_ns;
+    uint32_t packet_count;
+    uint32_t reserved;
+};
+
+struct RecordingFooter {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t chunk_count;
+    uint64_t index_offset;          // 索引区在文件中的偏移
+    uint64_t total_packets;         // 写入文件的包数
+    uint64_t dropped_packets;       // 缓冲池耗尽时丢弃的包数
+};
+
+static_assert(sizeof(RecordingFileHeader) <= RecordingFormat::HEADER_SIZE, "file header must fit in the first page");
+static_assert(sizeof(RecordingChunkHeader) == RecordingFormat::CHUNK_HEADER_SIZE, "chunk header size is part of the format");
+static_assert(sizeof(RecordingIndexEntry) == 32, "index entry size is part of the format");
+static_assert(sizeof(RecordingIndexEntryV1) == 24, "index entry size is part of the format");
+
+inline StreamDescriptor recordingStream(const RecordingFileHeader& header) {
+    StreamDescriptor stream;
+    stream.channel_count = header.channel_count;
+    stream.samples_per_packet = header.samples_per_packet;
+    stream.sample_rate = header.sample_rate;
+    stream.sample_type = static_cast<SampleType>(header.sample_type);
+    stream.layout = static_cast<SampleLayout>(header.sample_layout);
+    stream.packet_header = (header.flags & RecordingFormat::FLAG_PACKET_HEADER) != 0;
+    return stream;
+}
+
+// 容纳至少一个数据包的最小块大小（页对齐）
+inline size_t recordingMinChunkSize(size_t packet_size) {
+    return RecordingFormat::alignUp(RecordingFormat::CHUNK_HEADER_SIZE + packet_size);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Core/CodecPool.h"
+#include "Core/PacketBatch.h"
+#include "Storage/RecordingFormat.h"
+
+// 录制文件的只读访问：整个文件映射到内存，未压缩文件的数据包以 PacketBatch 的形式原地返回，不做拷贝；
+// 压缩文件的块通过 decodeChunk() 解码
+// - 正常关闭的文件直接使用尾部的索引区
+// - 没有索引区（录制进程异常退出）时按块大小顺序扫描块头，恢复到第一个无效的块为止
+class RecordingReader {
+public:
+    RecordingReader() = default;
+    ~RecordingReader();
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return mapping != nullptr; }
+
+    const StreamDescriptor& stream() const { return stream_descriptor; }
+    int64_t startTimeNs() const { return start_time_ns; }
+    size_t chunkSize() const { return chunk_size; }
+    ChunkCodec codec() const { return file_codec; }
+    bool compressed() const { return file_codec != ChunkCodec::Raw; }
+
+    size_t chunkCount() const { return chunks.size(); }
+    const RecordingIndexEntry& chunkInfo(size_t chunk) const { return chunks[chunk]; }
+    // 第 chunk 块中的数据包，指向映射的内存，在 close() 之前有效；压缩文件返回空批次
+    PacketBatch chunkPackets(size_t chunk) const;
+    // 把第 chunk 块的数据包解码（或拷贝）到 packets；块数据损坏时返回 false（使用内部暂存区，不可并发调用）
+    bool decodeChunk(size_t chunk, std::vector<uint8_t>& packets, CodecPool& pool = CodecPool::shared()) const;
+
+    // 第一个包含 sample 或位于其后的块；sample 超出录制范围时返回 chunkCount()
+    size_t findChunk(uint64_t sample) const;
+
+    uint64_t totalPackets() const { return total_packets; }
+    uint64_t droppedPackets() const { return dropped_packets; }   // 仅在有索引区时已知
+    bool recovered() const { return was_recovered; }               // 没有索引区，块信息由扫描得到
+
+private:
+    bool loadIndex();
+    void scanChunks();
+
+    int fd = -1;
+    const uint8_t* mapping = nullptr;
+    size_t mapping_size = 0;
+
+    StreamDescriptor stream_descriptor;
+    int64_t start_time_ns = 0;
+    size_t chunk_size = 0;
+    size_t packets_per_chunk = 0;
+    size_t packet_size = 0;
+    uint32_t version = 0;
+    ChunkCodec file_codec = ChunkCodec::Raw;
+    mutable std::vector<float> decode_scratch;
+
+    std::vector<RecordingIndexEntry> chunks;
+    uint64_t total_packets = 0;
+    uint64_t dropped_packets = 0;
+    bool was_recovered = false;
+};
+
+// 只读取文件头中的数据流描述（不映射整个文件）；不是录制文件时返回 false
+bool readRecordingStream(const std::string& path, StreamDescriptor& stream);
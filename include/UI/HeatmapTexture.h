@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+
+// 热图的环形纹理（OpenGL，RGBA8）：宽度为列数，高度为通道数
+// - 新列按纹理子区域（glTexSubImage2D）写入第 column % width() 列，回绕时分两段
+// - 水平方向 GL_REPEAT：显示任意连续的 width() 列只需一次绘制，纹理坐标 u = 列号 / width()，可以超过1
+// - 最近点采样，每个像素对应一个（列, 通道）的值
+class HeatmapTexture {
+public:
+    HeatmapTexture() = default;
+    // 纹理未释放时需要创建它的上下文仍为当前，否则先调用 release()
+    ~HeatmapTexture();
+
+    HeatmapTexture(const HeatmapTexture&) = delete;
+    HeatmapTexture& operator=(const HeatmapTexture&) = delete;
+
+    // 需要当前线程上有 OpenGL 上下文；尺寸不变时不重新分配
+    bool resize(int width, int height);
+
+    // 从列 column 起写入 count 列：pixels 为 height() 行，每行 count 个 RGBA8 像素（行 = 通道）
+    void uploadColumns(uint64_t column, int count, const uint32_t* pixels);
+
+    // 删除纹理（上下文必须为当前）；之后 resize() 会重新创建
+    void release();
+
+    unsigned int id() const { return texture; }
+    int width() const { return texture_width; }
+    int height() const { return texture_height; }
+
+private:
+    unsigned int texture = 0;
+    int texture_width = 0;
+    int texture_height = 0;
+};
@@ -1,10 +1,18 @@
 
 #pragma once
 #include "Core/DataManager.h"
-#include "IO/SocketSubscriber.h"
+#include "Core/StripChart.h"
+#include "IO/SubscriberFactory.h"
+#include "Storage/Recorder.h"
+#include "UI/HeatmapTexture.h"
+#include "UI/TraceRenderer.h"
+#include <memory>
+#include <string>
+#include <vector>
 
 class MainController {
 public:
+    explicit MainController(const SubscriberConfig& config);
     MainController(const std::string& host, int port);
     ~MainController();
 
@@ -12,12 +20,58 @@ public:
     void clear();
     void update();
     void drawUI();
+    // 释放 OpenGL 资源：必须在上下文仍为当前时（ImGui/GLFW 清理之前）调用，之后不再调用 drawUI()
+    void releaseGraphics();
     
     // 新增：播放控制
     void togglePlayback();
 
 private:
-    DataManager dataManager;
-    SocketSubscriber subscriber;
+    // 处理阶段：按来源写入对应的 DataManager，并在录制时把流 0 交给 Recorder（有队列时在队列的处理线程上，否则在接收线程上）
+    void onPacketBatch(const PacketBatch& batch);
+    void startSubscriber();
+    // 叠放视图：每个通道一道，按像素列绘制最小/最大包络，只处理滚动区域内可见的道
+    void drawStackedView(const DataManager& dataManager, double view_start, double view_end, float height,
+                         bool auto_scale);
+    // 热图视图：通道 x 时间的 RMS/峰值，由 DataManager 的计算线程产生，只上传新列
+    void drawHeatmapView(DataManager& dataManager, double view_start, double view_end, float height);
+    // 功率谱面板：选中通道的 Welch 平均功率谱，由 DataManager 的计算线程产生
+    void drawSpectrumPanel(DataManager& dataManager, float height, bool auto_scale);
+    // 滤波面板：控件变化时把同一条滤波链设置到所有数据流
+    void drawFilterPanel(double sample_rate);
+
+    // 每个发送端（batch.source）一个 DataManager；界面显示 active_stream
+    std::vector<std::unique_ptr<DataManager>> streams;
+    size_t active_stream = 0;
+    std::unique_ptr<Recorder> recorder;        // 未指定 --record 或打开失败时为空
+    std::unique_ptr<PacketQueue> queue;        // --queue-slots 0 时为空
+    std::unique_ptr<ISubscriber> subscriber;   // 创建失败时为空，界面照常运行
     bool running = false;
+    
+    // 包络绘制的复用缓冲（每通道 max_points 个点），避免每帧分配
+    std::vector<float> envelope_times;
+    std::vector<float> envelope_values;
+    std::vector<size_t> envelope_counts;
+    StripChart strip_chart;
+    
+    // 实时波形的 GPU 绘制：首次绘制时在 UI 线程的 GL 上下文中创建，初始化失败时回退到 ImPlot::PlotLine
+    std::unique_ptr<TraceRenderer> trace_renderer;
+    bool trace_renderer_failed = false;
+    std::vector<TraceChannelStyle> trace_styles;
+    
+    // 热图纹理与着色缓冲；纹理保留列 [heatmap_uploaded_start, heatmap_uploaded_end) 中最近的 width() 列
+    HeatmapTexture heatmap_texture;
+    const ChannelHeatmap* heatmap_source = nullptr;
+    uint64_t heatmap_uploaded_start = 0;
+    uint64_t heatmap_uploaded_end = 0;
+    std::vector<float> heatmap_values;
+    std::vector<uint32_t> heatmap_pixels;
+    std::vector<uint32_t> heatmap_lut;
+    
+    // 功率谱绘制：按像素列抽取后的点，以及上一帧的频率坐标范围
+    const SpectrumAnalyzer* spectrum_source = nullptr;
+    std::vector<float> spectrum_freqs;
+    std::vector<float> spectrum_values;
+    double spectrum_view_min = 1.0;
+    double spectrum_view_max = 11250.0;
 };
@@ -0,0 +1,58 @@
+#pragma once
+#include "Core/TraceUpload.h"
+#include <cstddef>
+#include <vector>
+
+// 多通道波形的 GPU 绘制（OpenGL 3.3 core，替代逐通道 ImPlot::PlotLine 在 CPU 上展开抗锯齿四边形）
+// - 样本存放在纹理缓冲（GL_TEXTURE_BUFFER, R32F）中，布局与 TraceUploader 的时间槽一致；
+//   每帧只写入新样本（glMapBufferRange 映射写入的区段），重建时先以 glBufferData(nullptr) 丢弃旧缓冲（orphaning），
+//   不等待上一帧的绘制
+// - 所有通道一次 glDrawArraysInstanced(GL_LINE_STRIP) 绘制：实例号为通道，顶点号为样本序号，
+//   顶点着色器从纹理缓冲取样本并套用该通道的 offset/scale 与颜色（第二个纹理缓冲）
+// - 不依赖 ImGui：界面在 ImPlot 绘图区内排入 ImDrawList 回调，回调中调用 render()；
+//   无窗口的 EGL 上下文也可直接调用，用于离屏校验
+// init() 失败（驱动不支持、着色器编译失败）时调用方回退到 ImPlot::PlotLine
+class TraceRenderer {
+public:
+    TraceRenderer() = default;
+    // 删除 GL 对象：创建时的上下文必须仍为当前（见 MainController::releaseGraphics）
+    ~TraceRenderer();
+
+    TraceRenderer(const TraceRenderer&) = delete;
+    TraceRenderer& operator=(const TraceRenderer&) = delete;
+
+    // 需要当前线程上有 OpenGL 3.3 上下文
+    bool init();
+    bool isReady() const { return program != 0; }
+
+    // 写入显示帧的新样本
+    void update(const DisplayFrame& frame);
+    // 绘制参数按通道（从 uploader 的 channelFirst() 起）给出，变化时才重新上传
+    void setChannelStyles(const std::vector<TraceChannelStyle>& styles);
+
+    // 记录本帧的坐标映射（UI 线程）；返回 false 表示没有可绘制的数据
+    bool prepare(const TraceTransform& transform);
+    // 在帧缓冲的 (x, y, width, height) 区域内绘制 prepare() 记录的数据，改变视口、裁剪、程序与纹理绑定
+    void render(int x, int y, int width, int height);
+
+    const TraceUploader& uploader() const { return trace_uploader; }
+    size_t vertexCount() const { return trace_uploader.sampleCount() * trace_uploader.channelCount(); }
+
+private:
+    TraceUploader trace_uploader;
+    std::vector<TraceChannelStyle> styles;
+    bool styles_dirty = true;
+
+    // prepare() 时记录，render() 时使用
+    TraceTransform pending_transform;
+    size_t pending_start = 0;
+    size_t pending_count = 0;
+
+    unsigned int program = 0;
+    unsigned int vao = 0;
+    unsigned int sample_buffer = 0;
+    unsigned int sample_texture = 0;
+    unsigned int style_buffer = 0;
+    unsigned int style_texture = 0;
+    int u_samples = -1, u_styles = -1, u_channels = -1, u_stride = -1, u_start = -1, u_transform = -1;
+};
@@ -0,0 +1,180 @@
+#include "Core/ChannelFilterBank.h"
+#include "FilterKernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+} // namespace
+
+const char* filterTypeName(FilterType type) {
+    switch (type) {
+    case FilterType::Notch: return "notch";
+    case FilterType::HighPass: return "high-pass";
+    case FilterType::LowPass: return "low-pass";
+    case FilterType::BandPass: return "band-pass";
+    case FilterType::DecimatingFir: return "decimating-fir";
+    default: return "dc-block";
+    }
+}
+
+BiquadCoefficients designBiquad(FilterType type, double frequency, double q, double sample_rate) {
+    BiquadCoefficients c;
+    const double w0 = 2.0 * PI * frequency / sample_rate;
+    if (type == FilterType::DcBlock) {
+        c.b0 = 1.0;
+        c.b1 = -1.0;
+        c.a1 = -std::exp(-w0);
+        return c;
+    }
+    const double cos_w0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0;
+    switch (type) {
+    case FilterType::Notch:
+        b0 = 1.0; b1 = -2.0 * cos_w0; b2 = 1.0;
+        break;
+    case FilterType::HighPass:
+        b0 = (1.0 + cos_w0) / 2.0; b1 = -(1.0 + cos_w0); b2 = b0;
+        break;
+    case FilterType::LowPass:
+        b0 = (1.0 - cos_w0) / 2.0; b1 = 1.0 - cos_w0; b2 = b0;
+        break;
+    case FilterType::BandPass:
+        b0 = alpha; b1 = 0.0; b2 = -alpha;
+        break;
+    default:
+        return c;
+    }
+    const double a0 = 1.0 + alpha;
+    c.b0 = b0 / a0;
+    c.b1 = b1 / a0;
+    c.b2 = b2 / a0;
+    c.a1 = -2.0 * cos_w0 / a0;
+    c.a2 = (1.0 - alpha) / a0;
+    return c;
+}
+
+std::vector<double> designLowPassFir(size_t taps, double cutoff, double sample_rate) {
+    std::vector<double> h(std::max<size_t>(taps, 1));
+    const double fc = cutoff / sample_rate;     // 归一化截止频率（周期/样本）
+    const double center = (h.size() - 1) / 2.0;
+    double sum = 0.0;
+    for (size_t n = 0; n < h.size(); ++n) {
+        const double m = n - center;
+        const double sinc = m == 0.0 ? 2.0 * fc : std::sin(2.0 * PI * fc * m) / (PI * m);
+        const double window = h.size() > 1 ? 0.54 - 0.46 * std::cos(2.0 * PI * n / (h.size() - 1)) : 1.0;
+        h[n] = sinc * window;
+        sum += h[n];
+    }
+    for (double& value : h) {
+        value /= sum;
+    }
+    return h;
+}
+
+ChannelFilterBank::ChannelFilterBank(size_t channel_count, double sample_rate, DecodeIsa isa)
+    : channel_count(channel_count), sample_rate(sample_rate) {
+    if (isa == DecodeIsa::Auto) {
+        isa = PacketDecoder::isSupported(DecodeIsa::Avx2) ? DecodeIsa::Avx2 :
+              PacketDecoder::isSupported(DecodeIsa::Sse2) ? DecodeIsa::Sse2 : DecodeIsa::Scalar;
+    } else if (!PacketDecoder::isSupported(isa)) {
+        isa = DecodeIsa::Scalar;
+    }
+    selected_isa = isa;
+
+    switch (isa) {
+#ifdef SENSORMONITOR_HAS_AVX2_KERNELS
+    case DecodeIsa::Avx2:
+        filter_fn = selectAvx2FilterKernel();
+        group_width = 16;
+        break;
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    case DecodeIsa::Sse2:
+        filter_fn = &filterChannels<Sse2Ops, 2>;
+        group_width = 8;
+        break;
+#endif
+    default:
+        filter_fn = &filterChannels<ScalarOps, 8>;
+        group_width = 8;
+        break;
+    }
+    group_count = (channel_count + group_width - 1) / group_width;
+    scratch.resize(filterScratchFloats(group_width));
+}
+
+void ChannelFilterBank::configure(const std::vector<FilterStage>& stages) {
+    chain.assign(stages.begin(), stages.begin() + std::min(stages.size(), MAX_STAGES));
+    stage_data.clear();
+    const double nyquist = sample_rate / 2.0;
+    for (FilterStage& stage : chain) {
+        stage.frequency = std::min(std::max(stage.frequency, nyquist * 1e-6), nyquist * 0.98);
+        stage.q = std::min(std::max(stage.q, 0.1), 100.0);
+        StageData data;
+        if (stage.type == FilterType::DecimatingFir) {
+            stage.taps = std::min(std::max<size_t>(stage.taps, 1), MAX_FIR_TAPS);
+            stage.decimation = std::min(std::max<size_t>(stage.decimation, 1), MAX_DECIMATION);
+            // 抽取后的奈奎斯特频率以上的分量会混叠，插值也无法恢复
+            stage.frequency = std::min(stage.frequency, sample_rate / (2.0 * stage.decimation));
+            for (double tap : designLowPassFir(stage.taps, stage.frequency, sample_rate)) {
+                data.taps.push_back(static_cast<float>(tap));
+            }
+            data.fir = true;
+            data.decimation = stage.decimation;
+            data.group_state = (stage.taps - 1 + firLowRateRows(stage.taps, stage.decimation)) * group_width;
+        } else {
+            const BiquadCoefficients c = designBiquad(stage.type, stage.frequency, stage.q, sample_rate);
+            data.biquad = {c.b0, c.b1, c.b2, c.a1, c.a2};
+            data.group_state = 4 * group_width;
+        }
+        stage_data.push_back(std::move(data));
+    }
+    reset();
+}
+
+void ChannelFilterBank::reset() {
+    for (StageData& data : stage_data) {
+        if (data.fir) {
+            data.history.assign(data.group_state * group_count, 0.0f);
+        } else {
+            data.feedback.assign(data.group_state * group_count, 0.0);
+        }
+        data.phase.assign(group_count, 0);
+    }
+}
+
+void ChannelFilterBank::process(float* data, size_t stride, size_t offset, size_t count) {
+    if (stage_data.empty() || count == 0) {
+        return;
+    }
+    FilterKernelStage stages[MAX_STAGES];
+    for (size_t i = 0; i < stage_data.size(); ++i) {
+        StageData& source = stage_data[i];
+        stages[i].taps = source.taps.data();
+        stages[i].biquad = source.biquad.data();
+        stages[i].tap_count = source.fir ? source.taps.size() : 0;
+        stages[i].decimation = source.decimation;
+        stages[i].history = source.history.data();
+        stages[i].feedback = source.feedback.data();
+        stages[i].group_state = source.group_state;
+        stages[i].phase = source.phase.data();
+    }
+    filter_fn(data, stride, offset, count, channel_count, stages, stage_data.size(), scratch.data());
+}
+
+void ChannelFilterBank::process(ChannelRingStore& store, uint64_t first, size_t count) {
+    if (count > store.capacity()) {
+        first += count - store.capacity();
+        count = store.capacity();
+    }
+    const size_t pos = static_cast<size_t>(first) & store.mask();
+    const size_t first_part = std::min(count, store.capacity() - pos);
+    process(store.writeData(), store.channelStride(), pos, first_part);
+    if (first_part < count) {
+        process(store.writeData(), store.channelStride(), 0, count - first_part);
+    }
+}
@@ -0,0 +1,10 @@
+// 以 AVX2 编译的滤波内核（CMake 只为这个文件加 -mavx2），由 ChannelFilterBank 在运行期检测 CPU 后选用
+#include "FilterKernels.h"
+
+#if !defined(__AVX2__)
+#error "ChannelFilterBankAvx2.cpp must be compiled with AVX2 enabled"
+#endif
+
+FilterKernelFn selectAvx2FilterKernel() {
+    return &filterChannels<Avx2Ops, 2>;
+}
@@ -0,0 +1,221 @@
+#include "Core/ChannelHeatmap.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+struct ColumnSums {
+    float sum_squares = 0.0f;
+    float peak = 0.0f;
+    float valid = 0.0f;     // float 计数，列长远小于 2^24，精确
+};
+
+// NaN samples are masked out of all three sums; SSE2 is part of the x86-64 baseline, so no dispatch is needed
+void accumulate(const float* samples, size_t count, ColumnSums& sums) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 one = _mm_set1_ps(1.0f);
+    // Two independent accumulator sets hide the add latency
+    __m128 squares[2] = {_mm_setzero_ps(), _mm_setzero_ps()};
+    __m128 peaks[2] = {_mm_setzero_ps(), _mm_setzero_ps()};
+    __m128 valid[2] = {_mm_setzero_ps(), _mm_setzero_ps()};
+    for (; i + 8 <= count; i += 8) {
+        for (int k = 0; k < 2; ++k) {
+            const __m128 value = _mm_loadu_ps(samples + i + 4 * k);
+            const __m128 ok = _mm_cmpord_ps(value, value);
+            const __m128 x = _mm_and_ps(value, ok);
+            squares[k] = _mm_add_ps(squares[k], _mm_mul_ps(x, x));
+            peaks[k] = _mm_max_ps(peaks[k], _mm_and_ps(x, abs_mask));
+            valid[k] = _mm_add_ps(valid[k], _mm_and_ps(ok, one));
+        }
+    }
+    alignas(16) float lanes[3][4];
+    _mm_store_ps(lanes[0], _mm_add_ps(squares[0], squares[1]));
+    _mm_store_ps(lanes[1], _mm_max_ps(peaks[0], peaks[1]));
+    _mm_store_ps(lanes[2], _mm_add_ps(valid[0], valid[1]));
+    for (int k = 0; k < 4; ++k) {
+        sums.sum_squares += lanes[0][k];
+        sums.peak = std::max(sums.peak, lanes[1][k]);
+        sums.valid += lanes[2][k];
+    }
+#endif
+    for (; i < count; ++i) {
+        const float value = samples[i];
+        if (std::isnan(value)) continue;
+        sums.sum_squares += value * value;
+        sums.peak = std::max(sums.peak, std::fabs(value));
+        sums.valid += 1.0f;
+    }
+}
+
+} // namespace
+
+const char* heatmapMetricName(HeatmapMetric metric) {
+    switch (metric) {
+    case HeatmapMetric::Peak: return "peak";
+    default: return "rms";
+    }
+}
+
+ChannelHeatmap::ChannelHeatmap(const ChannelRingStore& store, size_t column_samples, size_t column_capacity,
+                               HeatmapMetric metric)
+    : store(store),
+      channel_count(store.channelCount()),
+      column_samples(std::max<size_t>(column_samples, 1)),
+      column_capacity(roundUpPowerOfTwo(std::max<size_t>(column_capacity, 2))),
+      current_metric(static_cast<uint8_t>(metric)),
+      values(channel_count * this->column_capacity, std::numeric_limits<float>::quiet_NaN()) {}
+
+ChannelHeatmap::~ChannelHeatmap() {
+    stop();
+}
+
+void ChannelHeatmap::start() {
+    if (running) {
+        return;
+    }
+    running = true;
+    worker = std::thread(&ChannelHeatmap::run, this);
+}
+
+void ChannelHeatmap::stop() {
+    if (!running) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        running = false;
+    }
+    wait_cv.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+uint64_t ChannelHeatmap::startColumn() const {
+    const uint64_t end = end_column.load(std::memory_order_acquire);
+    const uint64_t first = first_column.load(std::memory_order_acquire);
+    // 计算线程可能正在写 end 列，它与 end - capacity 列共用存储
+    return std::max(first, end >= column_capacity ? end - column_capacity + 1 : 0);
+}
+
+bool ChannelHeatmap::copyColumns(uint64_t first, size_t count, float* out) const {
+    if (count == 0) {
+        return true;
+    }
+    if (first < startColumn() || first + count > endColumn()) {
+        return false;
+    }
+    const size_t pos = static_cast<size_t>(first & (column_capacity - 1));
+    const size_t first_part = std::min(count, column_capacity - pos);
+    for (size_t ch = 0; ch < channel_count; ++ch) {
+        const float* ring = values.data() + ch * column_capacity;
+        std::memcpy(out + ch * count, ring + pos, first_part * sizeof(float));
+        if (first_part < count) {
+            std::memcpy(out + ch * count + first_part, ring, (count - first_part) * sizeof(float));
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return first + column_capacity > end_column.load(std::memory_order_relaxed);
+}
+
+HeatmapStats ChannelHeatmap::getStats() const {
+    HeatmapStats stats;
+    stats.columns = computed_columns.load();
+    stats.missed_columns = missed_columns.load();
+    stats.busy_seconds = busy_ns.load() * 1e-9;
+    return stats;
+}
+
+void ChannelHeatmap::append(uint64_t end) {
+    const uint64_t window = store.readableWindow();
+    const uint64_t oldest = end > window ? end - window : 0;
+    const uint64_t oldest_column = (oldest + column_samples - 1) / column_samples;
+    if (!positioned) {
+        next_column = oldest_column;
+        first_column.store(next_column, std::memory_order_release);
+        end_column.store(next_column, std::memory_order_release);
+        positioned = true;
+    }
+
+    if (next_column + column_capacity < oldest_column) {
+        // 落后超过整个结果环：只需要填最后 capacity 列
+        missed_columns.fetch_add(oldest_column - column_capacity - next_column, std::memory_order_relaxed);
+        next_column = oldest_column - column_capacity;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    const HeatmapMetric metric = this->metric();
+    while ((next_column + 1) * column_samples <= end) {
+        if (next_column < oldest_column) {
+            // 落后超过环形缓冲的可读窗口：被覆盖的列填 NaN，列号保持连续
+            fillMissing(next_column);
+        } else {
+            computeColumn(next_column, metric);
+            if (!store.isRetained(next_column * column_samples)) {
+                fillMissing(next_column);
+            } else {
+                computed_columns.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        ++next_column;
+        end_column.store(next_column, std::memory_order_release);
+    }
+    busy_ns.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - started).count()),
+                      std::memory_order_relaxed);
+}
+
+void ChannelHeatmap::computeColumn(uint64_t column, HeatmapMetric metric) {
+    const uint64_t first = column * column_samples;
+    const size_t pos = static_cast<size_t>(first) & store.mask();
+    const size_t first_part = std::min(column_samples, store.capacity() - pos);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for (size_t ch = 0; ch < channel_count; ++ch) {
+        const float* ring = store.channelData(ch);
+        ColumnSums sums;
+        accumulate(ring + pos, first_part, sums);
+        if (first_part < column_samples) {
+            accumulate(ring, column_samples - first_part, sums);
+        }
+        float value = nan;
+        if (sums.valid > 0.0f) {
+            value = metric == HeatmapMetric::Peak ? sums.peak : std::sqrt(sums.sum_squares / sums.valid);
+        }
+        *slot(ch, column) = value;
+    }
+}
+
+void ChannelHeatmap::fillMissing(uint64_t column) {
+    for (size_t ch = 0; ch < channel_count; ++ch) {
+        *slot(ch, column) = std::numeric_limits<float>::quiet_NaN();
+    }
+    missed_columns.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 计算线程：一列的样本只需几毫秒就能攒够，按 5ms 的间隔检查；归约本身远小于间隔
+void ChannelHeatmap::run() {
+    while (running) {
+        const uint64_t published = store.publishedCount();
+        if (!positioned || published >= (next_column + 1) * column_samples) {
+            append(published);
+        }
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        wait_cv.wait_for(lock, std::chrono::milliseconds(5), [this] { return !running; });
+    }
+}
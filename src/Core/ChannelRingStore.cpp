@@ -0,0 +1,72 @@
+#include "Core/ChannelRingStore.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+ChannelRingStore::ChannelRingStore(size_t channel_count, size_t min_capacity)
+    : channel_count(channel_count),
+      ring_capacity(roundUpPowerOfTwo(std::max<size_t>(min_capacity, 64))),
+      channel_stride(ring_capacity + CHANNEL_PADDING),
+      write_guard(ring_capacity / 8),
+      data(channel_count * channel_stride, 0.0f) {
+}
+
+void ChannelRingStore::writePacket(const float* samples, size_t samples_per_channel) {
+    for (size_t ch = 0; ch < channel_count; ++ch) {
+        writeChannel(ch, samples + ch * samples_per_channel, samples_per_channel);
+    }
+    commit(samples_per_channel);
+}
+
+void ChannelRingStore::writeChannel(size_t channel, const float* samples, size_t count) {
+    float* ring = data.data() + channel * channel_stride;
+    size_t pos = static_cast<size_t>(pending_index) & mask();
+
+    // 环尾部分 + 回绕部分，各一次 memcpy
+    size_t first_part = std::min(count, ring_capacity - pos);
+    std::memcpy(ring + pos, samples, first_part * sizeof(float));
+    if (first_part < count) {
+        std::memcpy(ring, samples + first_part, (count - first_part) * sizeof(float));
+    }
+}
+
+void ChannelRingStore::commit(size_t count) {
+    pending_index += count;
+
+    // 未发布的数据不能超过预留余量，否则消费者的校验会失效
+    if (pending_index - write_index.load(std::memory_order_relaxed) >= write_guard / 2) {
+        publish();
+    }
+}
+
+void ChannelRingStore::publish() {
+    write_index.store(pending_index, std::memory_order_release);
+}
+
+void ChannelRingStore::copyChannel(size_t channel, uint64_t first, size_t count, float* out) const {
+    const float* ring = channelData(channel);
+    size_t pos = static_cast<size_t>(first) & mask();
+
+    size_t first_part = std::min(count, ring_capacity - pos);
+    std::memcpy(out, ring + pos, first_part * sizeof(float));
+    if (first_part < count) {
+        std::memcpy(out + first_part, ring, (count - first_part) * sizeof(float));
+    }
+}
+
+bool ChannelRingStore::isRetained(uint64_t first) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t latest = write_index.load(std::memory_order_relaxed);
+    return latest <= first || latest - first <= readableWindow();
+}
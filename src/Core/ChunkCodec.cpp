@@ -0,0 +1,411 @@
+#include "Core/ChunkCodec.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 非零 x 的首部/尾部零字节数，各自最多3
+inline uint32_t leadingZeroBytes(uint32_t x) {
+#if defined(__GNUC__)
+    uint32_t n = static_cast<uint32_t>(__builtin_clz(x)) >> 3;
+#else
+    uint32_t n = 0;
+    while (n < 3 && (x >> (24 - 8 * n)) == 0) ++n;
+#endif
+    return n > 3 ? 3 : n;
+}
+
+inline uint32_t trailingZeroBytes(uint32_t x) {
+#if defined(__GNUC__)
+    uint32_t n = static_cast<uint32_t>(__builtin_ctz(x)) >> 3;
+#else
+    uint32_t n = 0;
+    while (n < 3 && ((x >> (8 * n)) & 0xFF) == 0) ++n;
+#endif
+    return n > 3 ? 3 : n;
+}
+
+// 控制码：高2位首部零字节数，低2位尾部零字节数；0xF 表示与前一个样本相同
+constexpr uint8_t SAME_VALUE = 0xF;
+
+inline size_t significantBytes(uint8_t code) {
+    int lead = code >> 2;
+    int trail = code & 3;
+    return lead + trail >= 4 ? 0 : static_cast<size_t>(4 - lead - trail);
+}
+
+// 写入一个样本的有效字节：整字写入（out 预留了3字节余量），只推进有效字节数
+inline uint8_t encodeValue(uint32_t x, uint8_t*& out) {
+    if (x == 0) {
+        return SAME_VALUE;
+    }
+    uint32_t lead = leadingZeroBytes(x);
+    uint32_t trail = trailingZeroBytes(x);
+    uint32_t shifted = x >> (trail * 8);
+    std::memcpy(out, &shifted, sizeof(shifted));
+    out += 4 - lead - trail;
+    return static_cast<uint8_t>((lead << 2) | trail);
+}
+
+size_t encodeXorBytes(const float* samples, size_t count, uint8_t* out) {
+    uint8_t* begin = out;
+    uint32_t previous = 0;
+    for (size_t i = 0; i < count; i += 2) {
+        uint8_t* control = out++;
+        uint32_t bits;
+        std::memcpy(&bits, samples + i, sizeof(bits));
+        uint8_t code = encodeValue(bits ^ previous, out);
+        previous = bits;
+        if (i + 1 < count) {
+            std::memcpy(&bits, samples + i + 1, sizeof(bits));
+            code |= static_cast<uint8_t>(encodeValue(bits ^ previous, out) << 4);
+            previous = bits;
+        }
+        *control = code;
+    }
+    return static_cast<size_t>(out - begin);
+}
+
+inline bool decodeValue(uint8_t code, const uint8_t*& in, const uint8_t* end, uint32_t& previous) {
+    size_t n = significantBytes(code);
+    if (static_cast<size_t>(end - in) < n) {
+        return false;
+    }
+    static constexpr uint32_t MASKS[] = {0, 0xFF, 0xFFFF, 0xFFFFFF, 0xFFFFFFFF};
+    uint32_t shifted = 0;
+    if (end - in >= 4) {
+        std::memcpy(&shifted, in, sizeof(shifted));
+        shifted &= MASKS[n];
+    } else {
+        for (size_t k = 0; k < n; ++k) {
+            shifted |= static_cast<uint32_t>(in[k]) << (8 * k);
+        }
+    }
+    in += n;
+    previous ^= n == 0 ? 0 : shifted << ((code & 3) * 8);
+    return true;
+}
+
+bool decodeXorBytes(const uint8_t* in, size_t size, float* samples, size_t count) {
+    const uint8_t* end = in + size;
+    uint32_t previous = 0;
+    for (size_t i = 0; i < count; i += 2) {
+        if (in >= end) return false;
+        uint8_t control = *in++;
+        if (!decodeValue(control & 0xF, in, end, previous)) return false;
+        std::memcpy(samples + i, &previous, sizeof(previous));
+        if (i + 1 < count) {
+            if (!decodeValue(control >> 4, in, end, previous)) return false;
+            std::memcpy(samples + i + 1, &previous, sizeof(previous));
+        }
+    }
+    return in == end;
+}
+
+// ---- Gorilla：按位写入，低位在前 ----
+
+class BitWriter {
+public:
+    explicit BitWriter(uint8_t* out) : begin(out), out(out) {}
+
+    // bits 不超过32
+    void write(uint32_t value, unsigned bits) {
+        buffer |= static_cast<uint64_t>(value) << filled;
+        filled += bits;
+        if (filled >= 32) {
+            uint32_t word = static_cast<uint32_t>(buffer);
+            std::memcpy(out, &word, sizeof(word));
+            out += sizeof(word);
+            buffer >>= 32;
+            filled -= 32;
+        }
+    }
+
+    size_t finish() {
+        while (filled > 0) {
+            *out++ = static_cast<uint8_t>(buffer);
+            buffer >>= 8;
+            filled = filled > 8 ? filled - 8 : 0;
+        }
+        return static_cast<size_t>(out - begin);
+    }
+
+private:
+    uint8_t* begin;
+    uint8_t* out;
+    uint64_t buffer = 0;
+    unsigned filled = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* in, size_t size) : in(in), size(size) {}
+
+    // bits 不超过32；越界时返回 false
+    bool read(unsigned bits, uint32_t& value) {
+        if (position + bits > size * 8) return false;
+        size_t byte = position >> 3;
+        uint64_t word = 0;
+        if (byte + sizeof(word) <= size) {
+            std::memcpy(&word, in + byte, sizeof(word));
+        } else {
+            for (size_t k = 0; byte + k < size; ++k) word |= static_cast<uint64_t>(in[byte + k]) << (8 * k);
+        }
+        value = static_cast<uint32_t>((word >> (position & 7)) & ((uint64_t(1) << bits) - 1));
+        position += bits;
+        return true;
+    }
+
+    size_t bytesUsed() const { return (position + 7) >> 3; }
+
+private:
+    const uint8_t* in;
+    size_t size;
+    size_t position = 0;
+};
+
+inline uint32_t leadingZeroBits(uint32_t x) {
+#if defined(__GNUC__)
+    return static_cast<uint32_t>(__builtin_clz(x));
+#else
+    uint32_t n = 0;
+    while (!(x & 0x80000000u)) { x <<= 1; ++n; }
+    return n;
+#endif
+}
+
+inline uint32_t trailingZeroBits(uint32_t x) {
+#if defined(__GNUC__)
+    return static_cast<uint32_t>(__builtin_ctz(x));
+#else
+    uint32_t n = 0;
+    while (!(x & 1)) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+size_t encodeGorilla(const float* samples, size_t count, uint8_t* out) {
+    BitWriter writer(out);
+    uint32_t previous = 0;
+    uint32_t window_lead = 32, window_trail = 32;   // 初始没有可复用的窗口
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t bits;
+        std::memcpy(&bits, samples + i, sizeof(bits));
+        uint32_t x = bits ^ previous;
+        previous = bits;
+        if (x == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+        uint32_t lead = std::min<uint32_t>(leadingZeroBits(x), 31);
+        uint32_t trail = trailingZeroBits(x);
+        if (window_lead + window_trail < 32 && lead >= window_lead && trail >= window_trail) {
+            // 有效位落在上一个窗口内：控制位 1,0
+            writer.write(1, 2);
+            writer.write(x >> window_trail, 32 - window_lead - window_trail);
+        } else {
+            // 新窗口：控制位 1,1 + 首部零位数(5) + 有效位长度-1(5)
+            uint32_t length = 32 - lead - trail;
+            writer.write(3 | (lead << 2) | ((length - 1) << 7), 12);
+            writer.write(x >> trail, length);
+            window_lead = lead;
+            window_trail = trail;
+        }
+    }
+    return writer.finish();
+}
+
+bool decodeGorilla(const uint8_t* in, size_t size, float* samples, size_t count) {
+    BitReader reader(in, size);
+    uint32_t previous = 0;
+    uint32_t window_lead = 32, window_trail = 32;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t control;
+        if (!reader.read(1, control)) return false;
+        if (control) {
+            if (!reader.read(1, control)) return false;
+            if (control) {
+                uint32_t header;
+                if (!reader.read(10, header)) return false;
+                window_lead = header & 31;
+                uint32_t length = (header >> 5) + 1;
+                if (window_lead + length > 32) return false;
+                window_trail = 32 - window_lead - length;
+            } else if (window_lead + window_trail >= 32) {
+                return false;
+            }
+            uint32_t meaningful;
+            if (!reader.read(32 - window_lead - window_trail, meaningful)) return false;
+            previous ^= meaningful << window_trail;
+        }
+        std::memcpy(samples + i, &previous, sizeof(previous));
+    }
+    return reader.bytesUsed() == size;
+}
+
+// ---- ShuffleRle：字节平面 + 零字节游程 ----
+
+// 记号字节：最高位为1表示 (t & 0x7F) + 1 个零字节；否则后跟 t + 1 个原样字节
+constexpr size_t MAX_RUN = 128;
+
+uint8_t* encodeZeroRuns(const uint8_t* plane, size_t size, uint8_t* out) {
+    size_t i = 0;
+    while (i < size) {
+        if (plane[i] == 0) {
+            size_t run = 1;
+            while (run < MAX_RUN && i + run < size && plane[i + run] == 0) ++run;
+            *out++ = static_cast<uint8_t>(0x80 | (run - 1));
+            i += run;
+            continue;
+        }
+        // 原样字节一直延续到两个连续的零字节（单个零字节并入原样字节更省）
+        size_t run = 1;
+        while (run < MAX_RUN && i + run < size &&
+               !(plane[i + run] == 0 && (i + run + 1 >= size || plane[i + run + 1] == 0))) {
+            ++run;
+        }
+        *out++ = static_cast<uint8_t>(run - 1);
+        std::memcpy(out, plane + i, run);
+        out += run;
+        i += run;
+    }
+    return out;
+}
+
+const uint8_t* decodeZeroRuns(const uint8_t* in, const uint8_t* end, uint8_t* plane, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+        if (in >= end) return nullptr;
+        uint8_t token = *in++;
+        size_t run = (token & 0x7F) + 1u;
+        if (run > size - i) return nullptr;
+        if (token & 0x80) {
+            std::memset(plane + i, 0, run);
+        } else {
+            if (static_cast<size_t>(end - in) < run) return nullptr;
+            std::memcpy(plane + i, in, run);
+            in += run;
+        }
+        i += run;
+    }
+    return in;
+}
+
+// 平面暂存区：单个块的样本数有限，按块大小分段处理
+constexpr size_t SHUFFLE_SEGMENT = 4096;
+
+size_t encodeShuffleRle(const float* samples, size_t count, uint8_t* out) {
+    uint8_t* begin = out;
+    uint8_t planes[4][SHUFFLE_SEGMENT];
+    uint32_t previous = 0;
+    for (size_t first = 0; first < count; first += SHUFFLE_SEGMENT) {
+        size_t n = std::min(SHUFFLE_SEGMENT, count - first);
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t bits;
+            std::memcpy(&bits, samples + first + i, sizeof(bits));
+            // 位模式的差值（zigzag 编码）：同号同阶码的缓变数据只有低位字节非零
+            uint32_t delta = bits - previous;
+            uint32_t x = (delta << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(delta) >> 31);
+            previous = bits;
+            planes[0][i] = static_cast<uint8_t>(x);
+            planes[1][i] = static_cast<uint8_t>(x >> 8);
+            planes[2][i] = static_cast<uint8_t>(x >> 16);
+            planes[3][i] = static_cast<uint8_t>(x >> 24);
+        }
+        for (size_t k = 0; k < 4; ++k) {
+            out = encodeZeroRuns(planes[k], n, out);
+        }
+    }
+    return static_cast<size_t>(out - begin);
+}
+
+bool decodeShuffleRle(const uint8_t* in, size_t size, float* samples, size_t count) {
+    const uint8_t* end = in + size;
+    uint8_t planes[4][SHUFFLE_SEGMENT];
+    uint32_t previous = 0;
+    for (size_t first = 0; first < count; first += SHUFFLE_SEGMENT) {
+        size_t n = std::min(SHUFFLE_SEGMENT, count - first);
+        for (size_t k = 0; k < 4; ++k) {
+            in = decodeZeroRuns(in, end, planes[k], n);
+            if (!in) return false;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t x = uint32_t(planes[0][i]) | uint32_t(planes[1][i]) << 8 |
+                         uint32_t(planes[2][i]) << 16 | uint32_t(planes[3][i]) << 24;
+            previous += (x >> 1) ^ (0u - (x & 1));
+            std::memcpy(samples + first + i, &previous, sizeof(previous));
+        }
+    }
+    return in == end;
+}
+
+} // namespace
+
+size_t chunkEncodeBound(ChunkCodec codec, size_t count) {
+    switch (codec) {
+    case ChunkCodec::XorBytes:
+        return count * sizeof(float) + (count + 1) / 2 + 3;
+    case ChunkCodec::Gorilla:
+        return (count * 44 + 7) / 8 + 4;   // 每个样本最多 2+10+32 位，另加整字写入的余量
+    case ChunkCodec::ShuffleRle:
+        return count * sizeof(float) + (count * sizeof(float) + MAX_RUN - 1) / MAX_RUN + 4 * (count / SHUFFLE_SEGMENT + 1);
+    default:
+        return count * sizeof(float);
+    }
+}
+
+size_t chunkEncode(ChunkCodec codec, const float* samples, size_t count, uint8_t* out) {
+    switch (codec) {
+    case ChunkCodec::XorBytes:
+        return encodeXorBytes(samples, count, out);
+    case ChunkCodec::Gorilla:
+        return encodeGorilla(samples, count, out);
+    case ChunkCodec::ShuffleRle:
+        return encodeShuffleRle(samples, count, out);
+    default:
+        std::memcpy(out, samples, count * sizeof(float));
+        return count * sizeof(float);
+    }
+}
+
+bool chunkDecode(ChunkCodec codec, const uint8_t* in, size_t size, float* samples, size_t count) {
+    switch (codec) {
+    case ChunkCodec::XorBytes:
+        return decodeXorBytes(in, size, samples, count);
+    case ChunkCodec::Gorilla:
+        return decodeGorilla(in, size, samples, count);
+    case ChunkCodec::ShuffleRle:
+        return decodeShuffleRle(in, size, samples, count);
+    case ChunkCodec::Raw:
+        if (size != count * sizeof(float)) {
+            return false;
+        }
+        std::memcpy(samples, in, size);
+        return true;
+    }
+    return false;
+}
+
+const char* chunkCodecName(ChunkCodec codec) {
+    switch (codec) {
+    case ChunkCodec::XorBytes: return "xor-bytes";
+    case ChunkCodec::Gorilla: return "gorilla";
+    case ChunkCodec::ShuffleRle: return "shuffle-rle";
+    default: return "raw";
+    }
+}
+
+bool parseChunkCodec(const std::string& text, ChunkCodec& codec) {
+    if (text == "raw") {
+        codec = ChunkCodec::Raw;
+    } else if (text == "xor-bytes") {
+        codec = ChunkCodec::XorBytes;
+    } else if (text == "gorilla") {
+        codec = ChunkCodec::Gorilla;
+    } else if (text == "shuffle-rle") {
+        codec = ChunkCodec::ShuffleRle;
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#include "Core/CodecPool.h"
+#include <algorithm>
+
+CodecPool::CodecPool(size_t worker_count) {
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.emplace_back(&CodecPool::run, this);
+    }
+}
+
+CodecPool::~CodecPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_cv.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+CodecPool& CodecPool::shared() {
+    static CodecPool pool(std::min<size_t>(std::thread::hardware_concurrency() / 2, 8));
+    return pool;
+}
+
+void CodecPool::parallelFor(size_t count, const std::function<void(size_t)>& job) {
+    if (workers.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i) job(i);
+        return;
+    }
+
+    Task task;
+    task.job = &job;
+    task.count = count;
+    std::unique_lock<std::mutex> lock(mutex);
+    tasks.push_back(&task);
+    work_cv.notify_all();
+
+    // 调用线程也领取任务，直到全部领完
+    while (task.next < count) {
+        size_t index = task.next++;
+        if (task.next == count) {
+            tasks.erase(std::find(tasks.begin(), tasks.end(), &task));
+        }
+        lock.unlock();
+        job(index);
+        lock.lock();
+        ++task.done;
+    }
+    // 等待工作线程执行完已领取的任务；此后没有线程再引用 task
+    done_cv.wait(lock, [&task] { return task.done == task.count; });
+}
+
+void CodecPool::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if (stopping) return;
+
+        Task* task = tasks.front();
+        size_t index = task->next++;
+        if (task->next == task->count) {
+            tasks.pop_front();
+        }
+        lock.unlock();
+        (*task->job)(index);
+        lock.lock();
+        if (++task->done == task->count) {
+            done_cv.notify_all();
+        }
+    }
+}
@@ -2,27 +2,47 @@
 #include "Core/DataManager.h"
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
-DataManager::DataManager() {
-    raw_channel_data.resize(CHANNEL_COUNT);
-    channel_display_data.resize(CHANNEL_COUNT);
-    
-    for (auto& channel : raw_channel_data) {
-        channel.reserve(10000);
+namespace {
+
+StreamDescriptor validatedStream(const StreamDescriptor& stream) {
+    if (stream.isValid()) {
+        return stream;
     }
-    
-    for (auto& channel : channel_display_data) {
-        channel.reserve(MAX_DISPLAY_SAMPLES);
+    std::cerr << "Invalid stream descriptor (" << stream.channel_count << " channels, "
+              << stream.samples_per_packet << " samples/packet, " << stream.sample_rate
+              << " Hz), using defaults" << std::endl;
+    return StreamDescriptor();
+}
+
+} // namespace
+
+DataManager::DataManager(const StreamDescriptor& stream)
+    : stream(validatedStream(stream)),
+      raw_store(CHANNEL_COUNT, MAX_HISTORY_SAMPLES),
+      decoder(this->stream),
+      sequencer(this->stream, static_cast<uint64_t>(MAX_GAP_SECONDS * this->stream.sample_rate)),
+      filter_bank(this->stream.channel_count, this->stream.sample_rate),
+      envelope(CHANNEL_COUNT, raw_store.capacity()) {
+    display_frames.initialize([this](DisplayFrame& frame) {
+        frame.sample_stride = MAX_DISPLAY_SAMPLES;
+        frame.time_values.assign(MAX_DISPLAY_SAMPLES, 0.0f);
+        frame.samples.assign(CHANNEL_COUNT * MAX_DISPLAY_SAMPLES, 0.0f);
+    });
+    display_channel_count = CHANNEL_COUNT;
+    if (this->stream.packet_header) {
+        gap_fill.assign(raw_store.maxCommitSamples(), std::numeric_limits<float>::quiet_NaN());
     }
     
-    time_values.reserve(MAX_DISPLAY_SAMPLES);
-    
     processing_thread = std::thread(&DataManager::processData, this);
 }
 
 DataManager::~DataManager() {
     should_stop = true;
+    wakeDisplay();
     if (processing_thread.joinable()) {
         processing_thread.join();
     }
@@ -36,21 +56,29 @@ void DataManager::addData(const DataPoint& point) {
 }
 
 void DataManager::addChannelData(const std::vector<std::vector<float>>& channel_samples, double base_timestamp) {
+    // data_mutex 只用于串行化多个写入方，显示线程读取环形缓冲不再加锁
     std::lock_guard<std::mutex> lock(data_mutex);
     
     if (channel_samples.size() != CHANNEL_COUNT) return;
     
-    for (size_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
-        const auto& samples = channel_samples[ch];
-        for (const float sample : samples) {
-            if (raw_channel_data[ch].size() >= 50000) {
-                raw_channel_data[ch].erase(raw_channel_data[ch].begin());
-            }
-            raw_channel_data[ch].push_back(sample);
-        }
+    // 所有通道必须推进相同的样本数
+    size_t sample_count = channel_samples[0].size();
+    for (const auto& samples : channel_samples) {
+        if (samples.size() != sample_count) return;
     }
     
-    total_samples_received += (channel_samples.empty() ? 0 : channel_samples[0].size());
+    // 按 maxCommitSamples() 分段：每段写入、滤波后再提交，提交可能自动发布
+    for (size_t done = 0; done < sample_count;) {
+        size_t chunk = std::min(sample_count - done, raw_store.maxCommitSamples());
+        for (size_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            raw_store.writeChannel(ch, channel_samples[ch].data() + done, chunk);
+        }
+        filterUncommitted(chunk);
+        raw_store.commit(chunk);
+        done += chunk;
+    }
+    raw_store.publish();
+    notifyDisplay();
 }
 
 // 新增：处理二进制数据包
@@ -67,40 +95,116 @@ void DataManager::addBinaryPacket(const std::vector<uint8_t>& packet_data) {
 void DataManager::processBinaryPacket(const std::vector<uint8_t>& packet_data) {
     std::lock_guard<std::mutex> lock(data_mutex);
     
-    // 将字节数据转换为浮点数
-    const float* samples = reinterpret_cast<const float*>(packet_data.data());
-    size_t sample_count = PACKAGE_SIZE / sizeof(float); // 1024 floats
-    
-    // 按照main.cpp的方式处理数据：遍历每个采样点和通道
-    for (size_t sample = 0; sample < SAMPLES_PER_PACKET; ++sample) {
-        for (size_t channel = 0; channel < CHANNEL_COUNT; ++channel) {
-            size_t index = channel * SAMPLES_PER_PACKET + sample;
-            if (index < sample_count) {
-                // 保持通道缓存大小限制
-                if (raw_channel_data[channel].size() >= 50000) {
-                    raw_channel_data[channel].erase(raw_channel_data[channel].begin());
-                }
-                raw_channel_data[channel].push_back(samples[index]);
-            }
+    if (packet_data.size() < PACKAGE_SIZE) return;
+    
+    // 按数据流描述选择的内核解码并写入环形缓冲
+    PacketBatch batch;
+    batch.data = packet_data.data();
+    batch.packet_count = 1;
+    batch.packet_size = PACKAGE_SIZE;
+    ingestPackets(batch);
+    raw_store.publish();
+    notifyDisplay();
+}
+
+void DataManager::addPacketBatch(const PacketBatch& batch) {
+    if (batch.packet_size != PACKAGE_SIZE) {
+        std::cerr << "Invalid packet size: " << batch.packet_size 
+                  << " (expected " << PACKAGE_SIZE << ")" << std::endl;
+        return;
+    }
+    if (batch.packet_count == 0) return;
+    
+    std::lock_guard<std::mutex> lock(data_mutex);
+    ingestPackets(batch);
+    raw_store.publish();
+    notifyDisplay();
+}
+
+void DataManager::ingestPackets(const PacketBatch& batch) {
+    // 样本在提交前滤波（见 PacketDecoder::decode、fillGap）
+    ChannelFilterBank* filter = filter_bank.empty() ? nullptr : &filter_bank;
+    if (!stream.packet_header) {
+        decoder.decode(batch, raw_store, filter);
+        sequencer.countPackets(batch.packet_count);
+        return;
+    }
+    
+    // 连续按序的包合并为一段解码；遇到缺口先填充 NaN，被丢弃的包截断当前段
+    PacketBatch run = batch;
+    run.packet_count = 0;
+    for (size_t i = 0; i < batch.packet_count; ++i) {
+        uint64_t gap = 0;
+        bool accepted = sequencer.accept(batch.packet(i), gap);
+        if (accepted && gap == 0) {
+            if (run.packet_count == 0) run.data = batch.packet(i);
+            ++run.packet_count;
+            continue;
+        }
+        if (run.packet_count > 0) {
+            decoder.decode(run, raw_store, filter);
+            run.packet_count = 0;
+        }
+        if (accepted) {
+            fillGap(gap);
+            run.data = batch.packet(i);
+            run.packet_count = 1;
+        }
+    }
+    if (run.packet_count > 0) {
+        decoder.decode(run, raw_store, filter);
+    }
+}
+
+// 已写入、尚未提交的 count 个样本（全局索引从 pendingIndex() 起）就地滤波
+void DataManager::filterUncommitted(size_t count) {
+    if (!filter_bank.empty()) {
+        filter_bank.process(raw_store, raw_store.pendingIndex(), count);
+    }
+}
+
+void DataManager::setFilterChain(const std::vector<FilterStage>& stages) {
+    std::lock_guard<std::mutex> lock(data_mutex);
+    filter_bank.configure(stages);
+}
+
+std::vector<FilterStage> DataManager::filterChain() const {
+    std::lock_guard<std::mutex> lock(data_mutex);
+    return filter_bank.stages();
+}
+
+void DataManager::fillGap(uint64_t count) {
+    // 超过一圈的缺口：整个环写满 NaN 后，其余部分只推进索引（任意位置读到的都是 NaN）
+    const uint64_t written = std::min<uint64_t>(count, raw_store.capacity());
+    for (uint64_t done = 0; done < written;) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(gap_fill.size(), written - done));
+        for (size_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            raw_store.writeChannel(ch, gap_fill.data(), chunk);
         }
-        total_samples_received++;
+        filterUncommitted(chunk);
+        raw_store.commit(chunk);
+        done += chunk;
+    }
+    if (count > written) {
+        // 只推进索引的部分不经过滤波器：NaN 按 0 送入状态，这么长的一段 0 之后状态等同于清零
+        filter_bank.reset();
+        raw_store.commit(static_cast<size_t>(count - written));
     }
 }
 
+PacketLossStats DataManager::getPacketStats() const {
+    std::lock_guard<std::mutex> lock(data_mutex);
+    return sequencer.stats();
+}
+
 void DataManager::clear() {
     std::lock_guard<std::mutex> data_lock(data_mutex);
-    std::lock_guard<std::mutex> display_lock(display_mutex);
     
     buffer.clear();
-    for (auto& channel : raw_channel_data) {
-        channel.clear();
-    }
-    for (auto& channel : channel_display_data) {
-        channel.clear();
-    }
-    time_values.clear();
-    total_samples_received = 0;
-    display_samples_received = 0;
+    // 环形缓冲不搬移数据，只记录清除位置；显示线程下一轮会发布空帧
+    history_base = raw_store.publishedCount();
+    display_dirty = true;
+    wakeDisplay();
 }
 
 std::vector<DataPoint> DataManager::getData() {
@@ -108,18 +212,143 @@ std::vector<DataPoint> DataManager::getData() {
     return buffer;
 }
 
-std::vector<std::vector<float>> DataManager::getChannelDisplayData(size_t max_samples) {
-    std::lock_guard<std::mutex> lock(display_mutex);
-    return channel_display_data;
+const DisplayFrame& DataManager::acquireDisplayFrame() {
+    return display_frames.acquire();
+}
+
+void DataManager::setDisplayChannels(size_t first, size_t count) {
+    first = std::min(first, CHANNEL_COUNT);
+    count = std::min(count, CHANNEL_COUNT - first);
+    // 两个值都要交换，不能被 || 短路
+    const size_t previous_first = display_channel_first.exchange(first);
+    const size_t previous_count = display_channel_count.exchange(count);
+    if (previous_first != first || previous_count != count) {
+        display_dirty = true;
+        wakeDisplay();
+    }
+}
+
+HistoryRange DataManager::getHistoryRange() const {
+    uint64_t published = raw_store.publishedCount();
+    uint64_t base = history_base.load();
+    uint64_t window = raw_store.readableWindow();
+    uint64_t first = std::max(base, published > window ? published - window : 0);
+    if (spill && spill->endIndex() > spill->startIndex()) {
+        first = std::max(base, std::min(first, spill->startIndex()));
+    }
+    
+    HistoryRange range;
+    if (published > first) {
+        range.first_time = (first - base) / SAMPLE_RATE;
+        range.last_time = (published - 1 - base) / SAMPLE_RATE;
+    }
+    return range;
+}
+
+size_t DataManager::queryEnvelope(size_t channel, double start_time, double end_time, size_t max_points,
+                                  float* times, float* values) const {
+    if (channel >= CHANNEL_COUNT || end_time < start_time) {
+        return 0;
+    }
+    
+    // 时间范围转换为全局样本索引，并限制在可读的历史范围内
+    uint64_t published = raw_store.publishedCount();
+    uint64_t base = history_base.load();
+    uint64_t window = raw_store.readableWindow();
+    uint64_t oldest = std::max(base, published > window ? published - window : 0);
+    
+    double first_offset = std::max(0.0, std::floor(start_time * SAMPLE_RATE));
+    double last_offset = std::max(0.0, std::ceil(end_time * SAMPLE_RATE) + 1.0);
+    uint64_t first = base + static_cast<uint64_t>(first_offset);
+    uint64_t last = std::min(published, base + static_cast<uint64_t>(last_offset));
+    if (!spill || spill->endIndex() <= spill->startIndex()) {
+        first = std::max(oldest, first);
+    }
+    if (last <= first) {
+        return 0;
+    }
+    
+    // 早于内存窗口的部分由磁盘层回答，桶数按两部分的样本数比例分配，每部分至少 2 个桶；
+    // 桶数不够分时整个给样本多的一部分，另一部分不输出
+    size_t points = 0;
+    size_t buckets = max_points / 2;
+    if (first < oldest) {
+        uint64_t spill_last = std::min(last, oldest);
+        size_t spill_buckets = buckets;
+        if (last > oldest) {
+            const double spill_share = double(spill_last - first) / double(last - first);
+            if (buckets >= 4) {
+                spill_buckets = static_cast<size_t>(buckets * spill_share);
+                spill_buckets = std::max<size_t>(2, std::min(spill_buckets, buckets - 2));
+            } else if (spill_share < 0.5) {
+                spill_buckets = 0;
+            } else {
+                last = spill_last;
+            }
+        }
+        if (spill_buckets > 0) {
+            points = spill->query(channel, first, spill_last, spill_buckets, base, 1.0 / SAMPLE_RATE, times, values);
+        }
+        buckets -= spill_buckets;
+        first = spill_last;
+    }
+    if (last <= first || buckets == 0) {
+        return points;
+    }
+    
+    return points + envelope.query(raw_store, channel, first, last, buckets, base, 1.0 / SAMPLE_RATE,
+                                   times + points, values + points);
+}
+
+bool DataManager::enableHistorySpill(const std::string& directory, uint64_t max_bytes, ChunkCodec codec) {
+    if (spill) {
+        return true;
+    }
+    auto created = std::make_unique<HistorySpill>(raw_store);
+    if (!created->open(directory, max_bytes, codec)) {
+        return false;
+    }
+    spill = std::move(created);
+    return true;
+}
+
+ChannelHeatmap* DataManager::enableHeatmap(size_t column_samples, size_t column_capacity) {
+    if (!channel_heatmap) {
+        channel_heatmap = std::make_unique<ChannelHeatmap>(raw_store, column_samples, column_capacity);
+        channel_heatmap->start();
+    }
+    return channel_heatmap.get();
+}
+
+SpectrumAnalyzer* DataManager::enableSpectrum() {
+    if (!spectrum_analyzer) {
+        spectrum_analyzer = std::make_unique<SpectrumAnalyzer>(raw_store, SAMPLE_RATE);
+        spectrum_analyzer->start();
+    }
+    return spectrum_analyzer.get();
+}
+
+double DataManager::sampleTime(uint64_t index) const {
+    return (static_cast<double>(index) - static_cast<double>(history_base.load())) / SAMPLE_RATE;
+}
+
+HistorySpillStats DataManager::getHistorySpillStats() const {
+    return spill ? spill->getStats() : HistorySpillStats();
+}
+
+void DataManager::setFramePacing(bool enabled) {
+    frame_pacing = enabled;
+    wakeDisplay();
 }
 
-std::vector<float> DataManager::getTimeValues() {
-    std::lock_guard<std::mutex> lock(display_mutex);
-    return time_values;
+void DataManager::requestDisplayFrame() {
+    frame_requested = true;
+    wakeDisplay();
 }
 
 void DataManager::setProcessingEnabled(bool enabled) {
     processing_enabled = enabled;
+    wakeDisplay();
 }
 
 bool DataManager::isProcessingEnabled() const {
@@ -129,60 +358,118 @@ bool DataManager::isProcessingEnabled() const {
 // 新增：播放控制方法
 void DataManager::setPlayState(bool playing) {
     is_playing = playing;
+    display_dirty = true;
+    wakeDisplay();
 }
 
 bool DataManager::isPlaying() const {
     return is_playing;
 }
 
-void DataManager::processData() {
+// 写入线程调用：只有显示线程正在等待新数据时才加锁通知，其余情况仅一次原子读
+void DataManager::notifyDisplay() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_for_data.load(std::memory_order_relaxed) && waiting_for_data.exchange(false)) {
+        std::lock_guard<std::mutex> lock(display_wait_mutex);
+        display_cv.notify_one();
+    }
+}
+
+void DataManager::wakeDisplay() {
+    std::lock_guard<std::mutex> lock(display_wait_mutex);
+    display_cv.notify_one();
+}
+
+// 等待到有显示工作可做（或需要退出）；超时只用于兜底，不作为轮询节拍
+bool DataManager::waitForDisplayWork() {
+    std::unique_lock<std::mutex> lock(display_wait_mutex);
     while (!should_stop) {
-        if (processing_enabled) {
-            updateDisplayData();
+        bool ready_for_frame = processing_enabled && (!frame_pacing || frame_requested);
+        if (ready_for_frame && (display_dirty || raw_store.publishedCount() != processed_end)) {
+            return true;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(16)); // ~60 FPS
+        
+        // 先声明等待新数据，再复查写索引，避免与写入线程的通知错过
+        waiting_for_data = ready_for_frame;
+        if (ready_for_frame && raw_store.publishedCount() != processed_end) {
+            waiting_for_data = false;
+            return true;
+        }
+        display_cv.wait_for(lock, std::chrono::milliseconds(100));
+        waiting_for_data = false;
     }
+    return false;
 }
 
-void DataManager::updateDisplayData() {
-    std::lock_guard<std::mutex> data_lock(data_mutex);
-    std::lock_guard<std::mutex> display_lock(display_mutex);
-    
-    // 只有在播放状态时才更新显示数据
-    if (!is_playing) {
-        return;
+void DataManager::processData() {
+    while (waitForDisplayWork()) {
+        frame_requested = false;
+        display_dirty = false;
+        uint64_t published = raw_store.publishedCount();
+        
+        // 包络金字塔在暂停时也持续更新，以便暂停后浏览历史
+        envelope.append(raw_store, published);
+        
+        if (is_playing && !updateDisplayData(published)) {
+            // 读取的数据被覆盖，需要完整重建
+            display_dirty = true;
+        }
+        processed_end = published;
     }
+}
+
+// 增量更新显示帧：只追加该帧上次更新之后的新样本，代价与新样本数成正比
+// 通道范围变化、清除或落后超过一个窗口时才完整重建
+bool DataManager::updateDisplayData(uint64_t published) {
+    uint64_t base = history_base.load();
+    uint64_t window = raw_store.readableWindow();
+    uint64_t oldest = published > window ? published - window : 0;
+    uint64_t first_valid = std::max(base, oldest);
     
-    // 更新显示样本计数
-    if (display_samples_received < total_samples_received) {
-        display_samples_received = total_samples_received;
-    }
+    size_t display_samples = published > first_valid ?
+        static_cast<size_t>(std::min<uint64_t>(published - first_valid, MAX_DISPLAY_SAMPLES)) : 0;
+    uint64_t start_index = published - display_samples;
+    size_t channel_first = display_channel_first;
+    size_t channel_count = display_channel_count;
     
-    // 更新每个通道的显示数据
-    for (size_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
-        if (raw_channel_data[ch].empty()) continue;
-        
-        size_t samples_to_copy = std::min(raw_channel_data[ch].size(), MAX_DISPLAY_SAMPLES);
-        size_t start_idx = raw_channel_data[ch].size() - samples_to_copy;
-        
-        channel_display_data[ch].clear();
-        channel_display_data[ch].insert(
-            channel_display_data[ch].end(),
-            raw_channel_data[ch].begin() + start_idx,
-            raw_channel_data[ch].end()
-        );
-    }
-    
-    // 更新时间轴 - 实现滑动窗口
-    if (!raw_channel_data[0].empty()) {
-        size_t display_samples = std::min(raw_channel_data[0].size(), MAX_DISPLAY_SAMPLES);
-        size_t start_sample = display_samples_received > display_samples ? 
-                              display_samples_received - display_samples : 0;
-        
-        time_values.clear();
-        for (size_t i = 0; i < display_samples; ++i) {
-            double sample_time = (start_sample + i) / SAMPLE_RATE;
-            time_values.push_back(static_cast<float>(sample_time));
+    DisplayFrame& frame = display_frames.writeBuffer();
+    uint64_t frame_end = frame.first_sample + frame.sample_count;
+    bool rebuild = frame.sample_count == 0 ||
+                   frame.base_sample != base ||
+                   frame.channel_first != channel_first ||
+                   frame.channel_count != channel_count ||
+                   frame_end < start_index || frame_end > published;
+    
+    uint64_t copy_from = rebuild ? start_index : frame_end;
+    size_t stride = frame.sample_stride;
+    
+    // 把全局索引 [copy_from, published) 的样本写入环形窗口；位置相对清除点计算，
+    // 使窗口未满时数据从0开始连续存放
+    for (uint64_t index = copy_from; index < published;) {
+        size_t pos = static_cast<size_t>((index - base) % stride);
+        size_t run = static_cast<size_t>(std::min<uint64_t>(published - index, stride - pos));
+        for (size_t ch = channel_first; ch < channel_first + channel_count; ++ch) {
+            raw_store.copyChannel(ch, index, run, frame.samples.data() + ch * stride + pos);
+        }
+        for (size_t i = 0; i < run; ++i) {
+            frame.time_values[pos + i] = static_cast<float>((index - base + i) / SAMPLE_RATE);
         }
+        index += run;
     }
+    
+    // 读取期间被生产者覆盖（显示线程长时间停顿），作废该帧等待下一轮重建
+    if (!raw_store.isRetained(copy_from)) {
+        frame.sample_count = 0;
+        return false;
+    }
+    
+    frame.first_sample = start_index;
+    frame.base_sample = base;
+    frame.sample_count = display_samples;
+    frame.offset = display_samples == 0 ? 0 : static_cast<size_t>((start_index - base) % stride);
+    frame.channel_first = channel_first;
+    frame.channel_count = channel_count;
+    frame.generation = ++display_generation;
+    display_frames.publish();
+    return true;
 }
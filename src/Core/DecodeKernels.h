@@ -0,0 +1,312 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "Core/StreamFormat.h"
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// 数据包解码内核（PacketDecoder 内部使用）
+// 本文件被以不同指令集编译的翻译单元分别包含：PacketDecoder.cpp（基线，x86-64 上为 SSE2）
+// 和 PacketDecoderAvx2.cpp（-mavx2）。内核放在匿名命名空间里，各翻译单元得到互不相干的副本；
+// 内核只接收原始指针和整数，不调用其他头文件中的内联函数，避免以 AVX2 编译的副本被链接器选中
+
+// 把 packet_count 个连续数据包解码写入各通道的环形存储：
+// 通道 ch 的环位于 ring + ch * stride（capacity 为2的幂），写入从全局索引 position 开始
+// scratch 至少容纳 interleavedScratchSamples(channel_count * samples_per_packet) 个 float
+using DecodeKernelFn = void (*)(const uint8_t* packets, size_t packet_size, size_t packet_count,
+                                size_t channel_count, size_t samples_per_packet,
+                                float* ring, size_t stride, size_t capacity, uint64_t position,
+                                float* scratch);
+
+// 由 PacketDecoderAvx2.cpp 提供（CPU 支持 AVX2 时才可调用）
+DecodeKernelFn selectAvx2Kernel(SampleType type, SampleLayout layout, size_t samples_per_packet);
+
+namespace {
+
+template <SampleType TYPE>
+struct SampleCodec;
+
+template <>
+struct SampleCodec<SampleType::Float32> {
+    static constexpr size_t BYTES = 4;
+    static float load(const uint8_t* p) {
+        float value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+};
+
+template <>
+struct SampleCodec<SampleType::Int16> {
+    static constexpr size_t BYTES = 2;
+    static float load(const uint8_t* p) {
+        int16_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value * (1.0f / 32768.0f);
+    }
+};
+
+template <>
+struct SampleCodec<SampleType::Int24> {
+    static constexpr size_t BYTES = 3;
+    static float load(const uint8_t* p) {
+        // 小端3字节，左移到高位后算术右移完成符号扩展
+        int32_t value = static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 8 |
+                                             static_cast<uint32_t>(p[1]) << 16 |
+                                             static_cast<uint32_t>(p[2]) << 24) >> 8;
+        return value * (1.0f / 8388608.0f);
+    }
+};
+
+// 连续的 count 个样本解码为 float；WIDE 时使用本翻译单元可用的最宽指令集，尾部逐个处理
+// 向量路径与标量路径逐位一致（整数转换精确，乘以2的负幂也是精确的）
+template <SampleType TYPE, bool WIDE>
+inline void convertRun(float* dst, const uint8_t* src, size_t count) {
+    size_t i = 0;
+    if constexpr (WIDE) {
+#if defined(__AVX2__)
+        if constexpr (TYPE == SampleType::Float32) {
+            for (; i + 8 <= count; i += 8) {
+                _mm256_storeu_ps(dst + i, _mm256_loadu_ps(reinterpret_cast<const float*>(src) + i));
+            }
+        } else if constexpr (TYPE == SampleType::Int16) {
+            const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+            for (; i + 8 <= count; i += 8) {
+                __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+                __m256 value = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(raw));
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(value, scale));
+            }
+        } else {
+            // 8个样本共24字节：前4个取自 [0,16)，后4个取自 [8,24)，每个样本放到32位的高3字节后算术右移
+            const __m256i shuffle = _mm256_setr_epi8(
+                -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                -1, 4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15);
+            const __m256 scale = _mm256_set1_ps(1.0f / 8388608.0f);
+            for (; i + 8 <= count; i += 8) {
+                const uint8_t* p = src + i * 3;
+                __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8));
+                __m256i bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+                __m256i value = _mm256_srai_epi32(_mm256_shuffle_epi8(bytes, shuffle), 8);
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(value), scale));
+            }
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        if constexpr (TYPE == SampleType::Float32) {
+            for (; i + 4 <= count; i += 4) {
+                _mm_storeu_ps(dst + i, _mm_loadu_ps(reinterpret_cast<const float*>(src) + i));
+            }
+        } else if constexpr (TYPE == SampleType::Int16) {
+            const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+            for (; i + 8 <= count; i += 8) {
+                __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+                // SSE2 没有符号扩展指令：与自身交错后右移16位
+                __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+                __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16);
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+                _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+            }
+        }
+        // int24 需要字节重排（SSSE3），基线路径逐个处理
+#endif
+    }
+    for (; i < count; ++i) {
+        dst[i] = SampleCodec<TYPE>::load(src + i * SampleCodec<TYPE>::BYTES);
+    }
+}
+
+// 写入一个通道从全局索引 position 起的 count 个连续样本，处理环尾回绕
+template <SampleType TYPE, bool WIDE>
+inline void writeRun(float* ring, size_t capacity, uint64_t position, const uint8_t* src, size_t count) {
+    size_t pos = static_cast<size_t>(position) & (capacity - 1);
+    if (pos + count <= capacity) {
+        convertRun<TYPE, WIDE>(ring + pos, src, count);
+    } else {
+        size_t first = capacity - pos;
+        convertRun<TYPE, WIDE>(ring + pos, src, first);
+        convertRun<TYPE, WIDE>(ring, src + first * SampleCodec<TYPE>::BYTES, count - first);
+    }
+}
+
+// 通道优先：每个通道在包内的样本连续，通道在外层循环，使每个通道的目标是环内连续的一段
+template <SampleType TYPE, size_t SPP, bool WIDE>
+void decodeChannelMajor(const uint8_t* packets, size_t packet_size, size_t packet_count,
+                        size_t channel_count, size_t samples_per_packet,
+                        float* ring, size_t stride, size_t capacity, uint64_t position, float*) {
+    const size_t spp = SPP ? SPP : samples_per_packet;
+    const size_t run_bytes = spp * SampleCodec<TYPE>::BYTES;
+
+    for (size_t ch = 0; ch < channel_count; ++ch) {
+        float* channel_ring = ring + ch * stride;
+        const uint8_t* src = packets + ch * run_bytes;
+        for (size_t p = 0; p < packet_count; ++p) {
+            writeRun<TYPE, WIDE>(channel_ring, capacity, position + p * spp, src + p * packet_size, spp);
+        }
+    }
+}
+
+#if defined(__AVX2__)
+// 8x8 转置：rows[k] 为第 k 个样本的8个通道，返回后 rows[j] 为第 j 个通道的8个样本
+inline void transpose8x8(__m256 rows[8]) {
+    __m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+    __m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+    __m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+    __m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+    __m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+    __m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+    __m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+    __m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    rows[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+    rows[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+    rows[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+    rows[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+    rows[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+    rows[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+    rows[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+    rows[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+#endif
+
+// 交错排列的样本块转置写入各通道：第 p 个包的样本为 src[p * packet_stride + sample * channel_count + channel]
+// 向量路径按通道块在外层、包在内层，使每个通道的写入在环内连续；标量路径按源数据顺序读取
+template <bool WIDE>
+inline void transposePackets(const float* src, size_t packet_stride, size_t packet_count,
+                             size_t channel_count, size_t spp,
+                             float* ring, size_t stride, size_t capacity, uint64_t position) {
+    const size_t mask = capacity - 1;
+    size_t ch = 0;
+
+    if constexpr (WIDE) {
+#if defined(__AVX2__)
+        constexpr size_t BLOCK = 8;
+#elif defined(__SSE2__) || defined(_M_X64)
+        constexpr size_t BLOCK = 4;
+#else
+        constexpr size_t BLOCK = 0;
+#endif
+        if (BLOCK != 0 && spp % BLOCK == 0) {
+            for (; ch + BLOCK <= channel_count; ch += BLOCK) {
+                for (size_t p = 0; p < packet_count; ++p) {
+                    const float* packet = src + p * packet_stride;
+                    const size_t pos = static_cast<size_t>(position + p * spp) & mask;
+                    if (pos + spp > capacity) {
+                        // 跨越环尾的包逐个样本写入
+                        for (size_t i = 0; i < spp; ++i) {
+                            for (size_t c = ch; c < ch + BLOCK; ++c) {
+                                ring[c * stride + ((pos + i) & mask)] = packet[i * channel_count + c];
+                            }
+                        }
+                        continue;
+                    }
+                    for (size_t i = 0; i < spp; i += BLOCK) {
+#if defined(__AVX2__)
+                        __m256 rows[8];
+                        for (size_t k = 0; k < 8; ++k) {
+                            rows[k] = _mm256_loadu_ps(packet + (i + k) * channel_count + ch);
+                        }
+                        transpose8x8(rows);
+                        for (size_t j = 0; j < 8; ++j) {
+                            _mm256_storeu_ps(ring + (ch + j) * stride + pos + i, rows[j]);
+                        }
+#elif defined(__SSE2__) || defined(_M_X64)
+                        __m128 r0 = _mm_loadu_ps(packet + (i + 0) * channel_count + ch);
+                        __m128 r1 = _mm_loadu_ps(packet + (i + 1) * channel_count + ch);
+                        __m128 r2 = _mm_loadu_ps(packet + (i + 2) * channel_count + ch);
+                        __m128 r3 = _mm_loadu_ps(packet + (i + 3) * channel_count + ch);
+                        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                        _mm_storeu_ps(ring + (ch + 0) * stride + pos + i, r0);
+                        _mm_storeu_ps(ring + (ch + 1) * stride + pos + i, r1);
+                        _mm_storeu_ps(ring + (ch + 2) * stride + pos + i, r2);
+                        _mm_storeu_ps(ring + (ch + 3) * stride + pos + i, r3);
+#endif
+                    }
+                }
+            }
+        }
+    }
+
+    // 剩余通道（或样本数不是块大小的倍数时的全部通道）
+    if (ch < channel_count) {
+        for (size_t p = 0; p < packet_count; ++p) {
+            const float* packet = src + p * packet_stride;
+            const uint64_t first = position + p * spp;
+            for (size_t i = 0; i < spp; ++i) {
+                const size_t index = static_cast<size_t>(first + i) & mask;
+                const float* row = packet + i * channel_count;
+                for (size_t c = ch; c < channel_count; ++c) {
+                    ring[c * stride + index] = row[c];
+                }
+            }
+        }
+    }
+}
+
+// 交错排列：float32 直接在包内转置；整数格式每次把一组包解码到 scratch 后再转置（包之间没有包头时整组一次转换）
+// scratch 容纳 INTERLEAVED_SCRATCH_SAMPLES 个样本（至少一个包）：每组的包越多，每个通道在环内连续写入的段越长
+constexpr size_t INTERLEAVED_SCRATCH_SAMPLES = 64 * 1024;
+
+inline size_t interleavedScratchSamples(size_t packet_samples) {
+    return packet_samples > INTERLEAVED_SCRATCH_SAMPLES ? packet_samples : INTERLEAVED_SCRATCH_SAMPLES;
+}
+
+template <SampleType TYPE, size_t SPP, bool WIDE>
+void decodeInterleaved(const uint8_t* packets, size_t packet_size, size_t packet_count,
+                       size_t channel_count, size_t samples_per_packet,
+                       float* ring, size_t stride, size_t capacity, uint64_t position, float* scratch) {
+    const size_t spp = SPP ? SPP : samples_per_packet;
+    const size_t packet_samples = channel_count * spp;
+    const size_t block = interleavedScratchSamples(packet_samples) / packet_samples;
+
+    if constexpr (TYPE == SampleType::Float32) {
+        transposePackets<WIDE>(reinterpret_cast<const float*>(packets), packet_size / sizeof(float), packet_count,
+                               channel_count, spp, ring, stride, capacity, position);
+    } else {
+        for (size_t first = 0; first < packet_count; first += block) {
+            size_t count = packet_count - first < block ? packet_count - first : block;
+            const uint8_t* run = packets + first * packet_size;
+            if (packet_size == packet_samples * SampleCodec<TYPE>::BYTES) {
+                convertRun<TYPE, WIDE>(scratch, run, count * packet_samples);
+            } else {
+                // 包之间隔着包头：逐包转换
+                for (size_t p = 0; p < count; ++p) {
+                    convertRun<TYPE, WIDE>(scratch + p * packet_samples, run + p * packet_size, packet_samples);
+                }
+            }
+            transposePackets<WIDE>(scratch, packet_samples, count, channel_count, spp,
+                                   ring, stride, capacity, position + first * spp);
+        }
+    }
+}
+
+template <SampleType TYPE, bool WIDE>
+DecodeKernelFn selectKernel(SampleLayout layout, size_t samples_per_packet) {
+    // 默认的每包8个样本使用编译期常量，内层循环可完全展开
+    const bool fixed = samples_per_packet == StreamFormat::SAMPLES_PER_PACKET;
+    if (layout == SampleLayout::Interleaved) {
+        return fixed ? &decodeInterleaved<TYPE, StreamFormat::SAMPLES_PER_PACKET, WIDE>
+                     : &decodeInterleaved<TYPE, 0, WIDE>;
+    }
+    return fixed ? &decodeChannelMajor<TYPE, StreamFormat::SAMPLES_PER_PACKET, WIDE>
+                 : &decodeChannelMajor<TYPE, 0, WIDE>;
+}
+
+template <bool WIDE>
+DecodeKernelFn selectKernel(SampleType type, SampleLayout layout, size_t samples_per_packet) {
+    switch (type) {
+    case SampleType::Int16: return selectKernel<SampleType::Int16, WIDE>(layout, samples_per_packet);
+    case SampleType::Int24: return selectKernel<SampleType::Int24, WIDE>(layout, samples_per_packet);
+    default: return selectKernel<SampleType::Float32, WIDE>(layout, samples_per_packet);
+    }
+}
+
+} // namespace
@@ -0,0 +1,271 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// 多通道滤波内核（ChannelFilterBank 内部使用）
+// 与 DecodeKernels.h 相同：本文件被 ChannelFilterBank.cpp（基线，x86-64 上为 SSE2）和
+// ChannelFilterBankAvx2.cpp（-mavx2）分别包含，内核位于匿名命名空间，只接收原始指针和整数
+
+// 一级滤波的系数与状态
+struct FilterKernelStage {
+    const float* taps;            // FIR：tap_count 个抽头
+    const double* biquad;         // 二阶节：b0 b1 b2 a1 a2
+    size_t tap_count;             // 0 表示二阶节
+    size_t decimation;            // FIR 的抽取因子
+    float* history;               // FIR：通道组 g 的状态位于 history + g * group_state
+    double* feedback;             // 二阶节：通道组 g 的状态位于 feedback + g * group_state
+    size_t group_state;           // 二阶节 4 * G 个 double；FIR (tap_count - 1) * G 个历史样本 + firLowRateRows() * G 个抽取输出
+    uint32_t* phase;              // FIR：每组的抽取相位
+};
+
+// 就地滤波：通道 ch 的 count 个连续样本位于 data + ch * stride + offset
+// scratch 至少容纳 filterScratchFloats(组宽) 个 float
+using FilterKernelFn = void (*)(float* data, size_t stride, size_t offset, size_t count, size_t channel_count,
+                                const FilterKernelStage* stages, size_t stage_count, float* scratch);
+
+constexpr size_t FILTER_BLOCK_SAMPLES = 64;
+constexpr size_t FILTER_MAX_TAPS = 255;
+
+constexpr size_t filterScratchFloats(size_t group_width) {
+    return (2 * FILTER_BLOCK_SAMPLES + FILTER_MAX_TAPS - 1 + FILTER_BLOCK_SAMPLES) * group_width;
+}
+
+// 插值所需的抽取输出历史行数；不抽取时为 0
+constexpr size_t firLowRateRows(size_t tap_count, size_t decimation) {
+    return decimation > 1 ? (tap_count + decimation - 1) / decimation : 0;
+}
+
+// 由 ChannelFilterBankAvx2.cpp 提供（CPU 支持 AVX2 时才可调用），组宽 16
+FilterKernelFn selectAvx2FilterKernel();
+
+namespace {
+
+struct ScalarOps {
+    using V = float;
+    static constexpr size_t WIDTH = 1;
+    static V load(const float* p) { return *p; }
+    static void store(float* p, V v) { *p = v; }
+    static V set1(float v) { return v; }
+    static V zero() { return 0.0f; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V clean(V raw) { return raw == raw ? raw : 0.0f; }
+    static V restore(V raw, V filtered) { return raw == raw ? filtered : raw; }
+
+    using D = double;
+    static constexpr size_t DWIDTH = 1;
+    static D widen(const float* p) { return *p; }
+    static void narrow(float* p, D v) { *p = static_cast<float>(v); }
+    static D loadd(const double* p) { return *p; }
+    static void stored(double* p, D v) { *p = v; }
+    static D set1d(double v) { return v; }
+    static D addd(D a, D b) { return a + b; }
+    static D subd(D a, D b) { return a - b; }
+    static D muld(D a, D b) { return a * b; }
+};
+
+#if defined(__SSE2__) || defined(_M_X64)
+struct Sse2Ops {
+    using V = __m128;
+    static constexpr size_t WIDTH = 4;
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V set1(float v) { return _mm_set1_ps(v); }
+    static V zero() { return _mm_setzero_ps(); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V clean(V raw) { return _mm_and_ps(raw, _mm_cmpord_ps(raw, raw)); }
+    static V restore(V raw, V filtered) {
+        const V nan = _mm_cmpunord_ps(raw, raw);
+        return _mm_or_ps(_mm_and_ps(nan, raw), _mm_andnot_ps(nan, filtered));
+    }
+
+    using D = __m128d;
+    static constexpr size_t DWIDTH = 2;
+    static D widen(const float* p) {
+        return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+    }
+    static void narrow(float* p, D v) { _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_castps_si128(_mm_cvtpd_ps(v))); }
+    static D loadd(const double* p) { return _mm_loadu_pd(p); }
+    static void stored(double* p, D v) { _mm_storeu_pd(p, v); }
+    static D set1d(double v) { return _mm_set1_pd(v); }
+    static D addd(D a, D b) { return _mm_add_pd(a, b); }
+    static D subd(D a, D b) { return _mm_sub_pd(a, b); }
+    static D muld(D a, D b) { return _mm_mul_pd(a, b); }
+};
+#endif
+
+#if defined(__AVX2__)
+struct Avx2Ops {
+    using V = __m256;
+    static constexpr size_t WIDTH = 8;
+    static V load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V set1(float v) { return _mm256_set1_ps(v); }
+    static V zero() { return _mm256_setzero_ps(); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V clean(V raw) { return _mm256_and_ps(raw, _mm256_cmp_ps(raw, raw, _CMP_ORD_Q)); }
+    static V restore(V raw, V filtered) { return _mm256_blendv_ps(filtered, raw, _mm256_cmp_ps(raw, raw, _CMP_UNORD_Q)); }
+
+    using D = __m256d;
+    static constexpr size_t DWIDTH = 4;
+    static D widen(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+    static void narrow(float* p, D v) { _mm_storeu_ps(p, _mm256_cvtpd_ps(v)); }
+    static D loadd(const double* p) { return _mm256_loadu_pd(p); }
+    static void stored(double* p, D v) { _mm256_storeu_pd(p, v); }
+    static D set1d(double v) { return _mm256_set1_pd(v); }
+    static D addd(D a, D b) { return _mm256_add_pd(a, b); }
+    static D subd(D a, D b) { return _mm256_sub_pd(a, b); }
+    static D muld(D a, D b) { return _mm256_mul_pd(a, b); }
+};
+#endif
+
+// 二阶节（直接 I 型），状态与运算为双精度：高 Q 陷波、低截止频率的极点紧靠单位圆，
+// 单精度递推每步的舍入误差会被放大上千倍（50Hz、Q = 30 的陷波约 5e-4），双精度下可忽略
+// 每行的 G 个通道拆成 G / DWIDTH 个相互独立的向量交错执行，掩盖递推的延迟
+template <typename Ops, size_t N>
+void biquadRows(float* rows, size_t row_count, const double* c, double* state) {
+    using D = typename Ops::D;
+    constexpr size_t G = N * Ops::WIDTH;
+    constexpr size_t W = Ops::DWIDTH;
+    constexpr size_t M = G / W;
+    const D b0 = Ops::set1d(c[0]), b1 = Ops::set1d(c[1]), b2 = Ops::set1d(c[2]);
+    const D a1 = Ops::set1d(c[3]), a2 = Ops::set1d(c[4]);
+    D x1[M], x2[M], y1[M], y2[M];
+    for (size_t j = 0; j < M; ++j) {
+        x1[j] = Ops::loadd(state + j * W);
+        x2[j] = Ops::loadd(state + G + j * W);
+        y1[j] = Ops::loadd(state + 2 * G + j * W);
+        y2[j] = Ops::loadd(state + 3 * G + j * W);
+    }
+    for (size_t t = 0; t < row_count; ++t) {
+        float* row = rows + t * G;
+        for (size_t j = 0; j < M; ++j) {
+            const D x = Ops::widen(row + j * W);
+            // 前馈部分与递推无关，只有最后两次乘减在关键路径上
+            const D forward = Ops::addd(Ops::addd(Ops::muld(b0, x), Ops::muld(b1, x1[j])), Ops::muld(b2, x2[j]));
+            const D y = Ops::subd(Ops::subd(forward, Ops::muld(a2, y2[j])), Ops::muld(a1, y1[j]));
+            x2[j] = x1[j];
+            x1[j] = x;
+            y2[j] = y1[j];
+            y1[j] = y;
+            Ops::narrow(row + j * W, y);
+        }
+    }
+    for (size_t j = 0; j < M; ++j) {
+        Ops::stored(state + j * W, x1[j]);
+        Ops::stored(state + G + j * W, x2[j]);
+        Ops::stored(state + 2 * G + j * W, y1[j]);
+        Ops::stored(state + 3 * G + j * W, y2[j]);
+    }
+}
+
+// 抽取 FIR：历史样本与本块拼接到 work 中，只在相位为 0 的行计算抽取输出 u[k]（代价为全速率的 1/D）；
+// 再以同一原型 D * h 做多相插值恢复原采样率：相位 p 的输出为 Σ D h[p + mD] u[k - m]（代价同为 1/D）
+template <typename Ops, size_t N>
+void firRows(float* rows, size_t row_count, const FilterKernelStage& stage, float* state, uint32_t& phase,
+             float* work) {
+    using V = typename Ops::V;
+    constexpr size_t G = N * Ops::WIDTH;
+    const size_t history = stage.tap_count - 1;
+    const size_t decimation = stage.decimation;
+    const size_t low_rows = firLowRateRows(stage.tap_count, decimation);
+    float* lows = state + history * G;        // 抽取输出，第 0 行最新
+    std::memcpy(work, state, history * G * sizeof(float));
+    std::memcpy(work + history * G, rows, row_count * G * sizeof(float));
+    const float* taps = stage.taps;
+    const float gain = static_cast<float>(decimation);
+    for (size_t t = 0; t < row_count; ++t) {
+        float* out = rows + t * G;
+        if (phase == 0) {
+            // work 中第 t + history 行是当前样本，往前第 k 行乘 taps[k]
+            const float* newest = work + (t + history) * G;
+            V acc[N];
+            for (size_t j = 0; j < N; ++j) acc[j] = Ops::zero();
+            for (size_t k = 0; k < stage.tap_count; ++k) {
+                const V h = Ops::set1(taps[k]);
+                const float* x = newest - k * G;
+                for (size_t j = 0; j < N; ++j) {
+                    acc[j] = Ops::add(acc[j], Ops::mul(h, Ops::load(x + j * Ops::WIDTH)));
+                }
+            }
+            if (low_rows == 0) {
+                for (size_t j = 0; j < N; ++j) Ops::store(out + j * Ops::WIDTH, acc[j]);
+                continue;
+            }
+            std::memmove(lows + G, lows, (low_rows - 1) * G * sizeof(float));
+            for (size_t j = 0; j < N; ++j) Ops::store(lows + j * Ops::WIDTH, acc[j]);
+        }
+        V acc[N];
+        for (size_t j = 0; j < N; ++j) acc[j] = Ops::zero();
+        for (size_t m = 0, k = phase; k < stage.tap_count; ++m, k += decimation) {
+            const V h = Ops::set1(gain * taps[k]);
+            const float* u = lows + m * G;
+            for (size_t j = 0; j < N; ++j) {
+                acc[j] = Ops::add(acc[j], Ops::mul(h, Ops::load(u + j * Ops::WIDTH)));
+            }
+        }
+        for (size_t j = 0; j < N; ++j) Ops::store(out + j * Ops::WIDTH, acc[j]);
+        phase = phase + 1 == decimation ? 0 : phase + 1;
+    }
+    std::memcpy(state, work + row_count * G, history * G * sizeof(float));
+}
+
+template <typename Ops, size_t N>
+void filterChannels(float* data, size_t stride, size_t offset, size_t count, size_t channel_count,
+                    const FilterKernelStage* stages, size_t stage_count, float* scratch) {
+    using V = typename Ops::V;
+    constexpr size_t G = N * Ops::WIDTH;
+    constexpr size_t T = FILTER_BLOCK_SAMPLES;
+    float* raw = scratch;              // T x G：转置后的原始样本（恢复 NaN 用）
+    float* rows = raw + T * G;         // T x G：滤波中的样本
+    float* work = rows + T * G;        // FIR 的历史 + 本块
+
+    for (size_t first_channel = 0, group = 0; first_channel < channel_count; first_channel += G, ++group) {
+        const size_t lanes = channel_count - first_channel < G ? channel_count - first_channel : G;
+        float* base = data + first_channel * stride + offset;
+        for (size_t start = 0; start < count; start += T) {
+            const size_t n = count - start < T ? count - start : T;
+            // 转置读入；不足一组的通道补 0
+            for (size_t l = 0; l < G; ++l) {
+                if (l < lanes) {
+                    const float* src = base + l * stride + start;
+                    for (size_t t = 0; t < n; ++t) raw[t * G + l] = src[t];
+                } else {
+                    for (size_t t = 0; t < n; ++t) raw[t * G + l] = 0.0f;
+                }
+            }
+            for (size_t i = 0; i < n * G; i += Ops::WIDTH) {
+                Ops::store(rows + i, Ops::clean(Ops::load(raw + i)));
+            }
+
+            for (size_t s = 0; s < stage_count; ++s) {
+                const FilterKernelStage& stage = stages[s];
+                if (stage.tap_count == 0) {
+                    biquadRows<Ops, N>(rows, n, stage.biquad, stage.feedback + group * stage.group_state);
+                } else {
+                    firRows<Ops, N>(rows, n, stage, stage.history + group * stage.group_state, stage.phase[group], work);
+                }
+            }
+
+            for (size_t i = 0; i < n * G; i += Ops::WIDTH) {
+                const V value = Ops::restore(Ops::load(raw + i), Ops::load(rows + i));
+                Ops::store(rows + i, value);
+            }
+            for (size_t l = 0; l < lanes; ++l) {
+                float* dst = base + l * stride + start;
+                for (size_t t = 0; t < n; ++t) dst[t] = rows[t * G + l];
+            }
+        }
+    }
+}
+
+} // namespace
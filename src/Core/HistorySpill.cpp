@@ -0,0 +1,400 @@
+#include "Core/HistorySpill.h"
+#include "Core/CodecPool.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t BLOCK_ALIGNMENT = 64;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+HistorySpill::HistorySpill(const ChannelRingStore& store)
+    : store(store), channel_count(store.channelCount()) {}
+
+HistorySpill::~HistorySpill() {
+    close();
+}
+
+bool HistorySpill::open(const std::string& directory, uint64_t requested_max_bytes, ChunkCodec codec) {
+    close();
+    this->codec = codec;
+
+    // 单块最坏情况：磁盘摘要 + 全部通道不可压缩
+    const size_t summary_bytes = channel_count * DISK_BUCKETS * 2 * sizeof(float);
+    const size_t worst_block = alignUp(summary_bytes + channel_count * BLOCK_SAMPLES * sizeof(float), BLOCK_ALIGNMENT);
+    max_bytes = std::max<uint64_t>(requested_max_bytes, 4 * worst_block);
+
+    std::string path = directory + "/sensormonitor-history-XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    fd = mkstemp(name.data());
+    if (fd < 0) {
+        std::cerr << "HistorySpill: cannot create a file in " << directory << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    unlink(name.data());
+
+    // 映射整个上限范围的地址空间，只访问已写入的部分
+    void* address = mmap(nullptr, max_bytes, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        std::cerr << "HistorySpill: mmap failed: " << strerror(errno) << std::endl;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    mapping = static_cast<const uint8_t*>(address);
+
+    block_samples.assign(channel_count * BLOCK_SAMPLES, 0.0f);
+    block_data.assign(summary_bytes + channel_count * BLOCK_SAMPLES * sizeof(float) + BLOCK_ALIGNMENT, 0);
+    channel_encoded.assign(channel_count * chunkEncodeBound(codec, BLOCK_SAMPLES), 0);
+    encoded_sizes.assign(channel_count, 0);
+    write_offset = 0;
+    stats = HistorySpillStats();
+    start_index = 0;
+    end_index = 0;
+
+    running = true;
+    worker = std::thread(&HistorySpill::run, this);
+
+    std::cout << "HistorySpill: spilling history to " << directory << " (up to " << (max_bytes >> 20)
+              << " MB, " << chunkCodecName(codec) << ")" << std::endl;
+    return true;
+}
+
+void HistorySpill::close() {
+    if (running) {
+        {
+            std::lock_guard<std::mutex> lock(wait_mutex);
+            running = false;
+        }
+        wait_cv.notify_one();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(blocks_mutex);
+    if (mapping) {
+        munmap(const_cast<uint8_t*>(mapping), max_bytes);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    blocks.clear();
+    for (CachedSamples& entry : cache) {
+        entry.first_sample = UINT64_MAX;
+    }
+    start_index = 0;
+    end_index = 0;
+}
+
+HistorySpillStats HistorySpill::getStats() const {
+    std::lock_guard<std::mutex> lock(blocks_mutex);
+    return stats;
+}
+
+// 溢写线程：每当环形缓冲中攒够一个完整的块就压缩写出；块在环中保留约数秒，
+// 因此按 50ms 的间隔检查即可，不需要写入线程通知
+void HistorySpill::run() {
+    const uint64_t window = store.readableWindow();
+    uint64_t published = store.publishedCount();
+    uint64_t next = alignUp(published > window ? published - window : 0, BLOCK_SAMPLES);
+
+    while (running) {
+        published = store.publishedCount();
+        if (published >= next + BLOCK_SAMPLES) {
+            uint64_t oldest = published > window ? published - window : 0;
+            if (next < oldest || !spillBlock(next)) {
+                // 落后超过环形缓冲的可读窗口：跳过已被覆盖的块
+                uint64_t resume = std::max(next + BLOCK_SAMPLES, alignUp(oldest, BLOCK_SAMPLES));
+                std::lock_guard<std::mutex> lock(blocks_mutex);
+                stats.missed_blocks += (resume - next) / BLOCK_SAMPLES;
+                next = resume;
+                continue;
+            }
+            next += BLOCK_SAMPLES;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        wait_cv.wait_for(lock, std::chrono::milliseconds(50), [this] { return !running; });
+    }
+}
+
+bool HistorySpill::spillBlock(uint64_t first) {
+    Block block;
+    block.first_sample = first;
+    block.channel_offsets.resize(channel_count + 1);
+    block.channel_codecs.resize(channel_count);
+    block.resident.resize(channel_count * RESIDENT_BUCKETS * 2);
+
+    // 各通道互不相关：拷贝、两级摘要（磁盘摘要写在块首，常驻摘要由磁盘摘要合并）和编码在工作线程上并行
+    float* disk_summary = reinterpret_cast<float*>(block_data.data());
+    const size_t summary_bytes = channel_count * DISK_BUCKETS * 2 * sizeof(float);
+    const size_t merge = size_t(1) << (RESIDENT_LEVEL - DISK_LEVEL);
+    const size_t channel_bound = chunkEncodeBound(codec, BLOCK_SAMPLES);
+    CodecPool::shared().parallelFor(channel_count, [&](size_t ch) {
+        float* samples = block_samples.data() + ch * BLOCK_SAMPLES;
+        store.copyChannel(ch, first, BLOCK_SAMPLES, samples);
+
+        float* disk = disk_summary + ch * DISK_BUCKETS * 2;
+        for (size_t b = 0; b < DISK_BUCKETS; ++b) {
+            const float* src = samples + (b << DISK_LEVEL);
+            float min_value = src[0];
+            float max_value = src[0];
+            for (size_t i = 1; i < (size_t(1) << DISK_LEVEL); ++i) {
+                min_value = std::fmin(min_value, src[i]);
+                max_value = std::fmax(max_value, src[i]);
+            }
+            disk[b * 2] = min_value;
+            disk[b * 2 + 1] = max_value;
+        }
+        float* resident = block.resident.data() + ch * RESIDENT_BUCKETS * 2;
+        for (size_t r = 0; r < RESIDENT_BUCKETS; ++r) {
+            float min_value = disk[r * merge * 2];
+            float max_value = disk[r * merge * 2 + 1];
+            for (size_t b = r * merge + 1; b < (r + 1) * merge; ++b) {
+                min_value = std::fmin(min_value, disk[b * 2]);
+                max_value = std::fmax(max_value, disk[b * 2 + 1]);
+            }
+            resident[r * 2] = min_value;
+            resident[r * 2 + 1] = max_value;
+        }
+
+        // 编码后不比原始数据小的通道原样存放
+        uint8_t* slot = channel_encoded.data() + ch * channel_bound;
+        size_t size = chunkEncode(codec, samples, BLOCK_SAMPLES, slot);
+        block.channel_codecs[ch] = codec;
+        if (size >= BLOCK_SAMPLES * sizeof(float)) {
+            size = chunkEncode(ChunkCodec::Raw, samples, BLOCK_SAMPLES, slot);
+            block.channel_codecs[ch] = ChunkCodec::Raw;
+        }
+        encoded_sizes[ch] = size;
+    });
+    if (!store.isRetained(first)) {
+        return false;
+    }
+
+    size_t offset = summary_bytes;
+    for (size_t ch = 0; ch < channel_count; ++ch) {
+        block.channel_offsets[ch] = static_cast<uint32_t>(offset);
+        std::memcpy(block_data.data() + offset, channel_encoded.data() + ch * channel_bound, encoded_sizes[ch]);
+        offset += encoded_sizes[ch];
+    }
+    block.channel_offsets[channel_count] = static_cast<uint32_t>(offset);
+    block.byte_size = alignUp(offset, BLOCK_ALIGNMENT);
+
+    return writeBlock(block, block_data.data());
+}
+
+bool HistorySpill::writeBlock(Block& block, const uint8_t* data) {
+    uint64_t offset;
+    {
+        // 先淘汰将被覆盖的最旧块，查询此后不会再访问这段文件
+        std::lock_guard<std::mutex> lock(blocks_mutex);
+        if (write_offset + block.byte_size > max_bytes) {
+            write_offset = 0;
+        }
+        offset = write_offset;
+        while (!blocks.empty() && blocks.front().file_offset < offset + block.byte_size &&
+               offset < blocks.front().file_offset + blocks.front().byte_size) {
+            const Block& oldest = blocks.front();
+            for (CachedSamples& entry : cache) {
+                if (entry.first_sample == oldest.first_sample) entry.first_sample = UINT64_MAX;
+            }
+            stats.blocks -= 1;
+            stats.raw_bytes -= channel_count * BLOCK_SAMPLES * sizeof(float);
+            stats.stored_bytes -= oldest.byte_size;
+            stats.evicted_blocks += 1;
+            blocks.pop_front();
+        }
+        start_index = blocks.empty() ? block.first_sample : blocks.front().first_sample;
+    }
+
+    size_t done = 0;
+    while (done < block.byte_size) {
+        ssize_t n = pwrite(fd, data + done, block.byte_size - done, static_cast<off_t>(offset + done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "HistorySpill: write failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+
+    std::lock_guard<std::mutex> lock(blocks_mutex);
+    block.file_offset = offset;
+    write_offset = offset + block.byte_size;
+    stats.blocks += 1;
+    stats.raw_bytes += channel_count * BLOCK_SAMPLES * sizeof(float);
+    stats.stored_bytes += block.byte_size;
+    blocks.push_back(std::move(block));
+    start_index = blocks.front().first_sample;
+    end_index = blocks.back().first_sample + BLOCK_SAMPLES;
+    return true;
+}
+
+const HistorySpill::Block* HistorySpill::findBlock(uint64_t sample) const {
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), sample,
+                               [](uint64_t value, const Block& block) { return value < block.first_sample; });
+    if (it == blocks.begin()) return nullptr;
+    --it;
+    return sample < it->first_sample + BLOCK_SAMPLES ? &*it : nullptr;
+}
+
+uint64_t HistorySpill::nextBlockStart(uint64_t sample) const {
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), sample,
+                               [](uint64_t value, const Block& block) { return value < block.first_sample; });
+    return it == blocks.end() ? UINT64_MAX : it->first_sample;
+}
+
+// 解压单个通道的块，结果放入按最近使用淘汰的小缓存
+const float* HistorySpill::blockSamples(const Block& block, size_t channel) {
+    CachedSamples* victim = &cache[0];
+    for (CachedSamples& entry : cache) {
+        if (entry.first_sample == block.first_sample && entry.channel == channel) {
+            entry.last_use = ++cache_clock;
+            return entry.samples.data();
+        }
+        if (entry.last_use < victim->last_use) victim = &entry;
+    }
+
+    victim->samples.resize(BLOCK_SAMPLES);
+    const uint8_t* data = mapping + block.file_offset + block.channel_offsets[channel];
+    size_t size = block.channel_offsets[channel + 1] - block.channel_offsets[channel];
+    if (!chunkDecode(block.channel_codecs[channel], data, size, victim->samples.data(), BLOCK_SAMPLES)) {
+        victim->first_sample = UINT64_MAX;
+        return nullptr;
+    }
+    victim->first_sample = block.first_sample;
+    victim->channel = channel;
+    victim->last_use = ++cache_clock;
+    return victim->samples.data();
+}
+
+// [lo, hi) 的最小/最大值：对齐的大段用常驻摘要，其次用文件内摘要，只有两端不足一个摘要桶的部分解压原始样本
+bool HistorySpill::minMaxRange(size_t channel, uint64_t lo, uint64_t hi, float& min_value, float& max_value) {
+    const uint64_t resident_size = uint64_t(1) << RESIDENT_LEVEL;
+    const uint64_t disk_size = uint64_t(1) << DISK_LEVEL;
+    bool found = false;
+
+    auto merge = [&](float block_min, float block_max) {
+        min_value = found ? std::fmin(min_value, block_min) : block_min;
+        max_value = found ? std::fmax(max_value, block_max) : block_max;
+        found = true;
+    };
+
+    while (lo < hi) {
+        const Block* block = findBlock(lo);
+        if (!block) {
+            lo = std::min(hi, nextBlockStart(lo));
+            continue;
+        }
+        const uint64_t stop = std::min(hi, block->first_sample + BLOCK_SAMPLES);
+        const float* resident = block->resident.data() + channel * RESIDENT_BUCKETS * 2;
+        const float* disk = reinterpret_cast<const float*>(mapping + block->file_offset) + channel * DISK_BUCKETS * 2;
+
+        while (lo < stop) {
+            uint64_t offset = lo - block->first_sample;
+            if ((lo & (resident_size - 1)) == 0 && stop - lo >= resident_size) {
+                const float* entry = resident + (offset >> RESIDENT_LEVEL) * 2;
+                merge(entry[0], entry[1]);
+                lo += resident_size;
+            } else if ((lo & (disk_size - 1)) == 0 && stop - lo >= disk_size) {
+                const float* entry = disk + (offset >> DISK_LEVEL) * 2;
+                merge(entry[0], entry[1]);
+                lo += disk_size;
+            } else {
+                uint64_t run_end = std::min(stop, (lo + disk_size) & ~(disk_size - 1));
+                const float* samples = blockSamples(*block, channel);
+                if (samples) {
+                    for (uint64_t index = lo; index < run_end; ++index) {
+                        float value = samples[index - block->first_sample];
+                        merge(value, value);
+                    }
+                }
+                lo = run_end;
+            }
+        }
+    }
+    return found;
+}
+
+size_t HistorySpill::query(size_t channel, uint64_t first, uint64_t last, size_t max_buckets,
+                           uint64_t time_origin, double sample_period, float* xs, float* ys) {
+    std::lock_guard<std::mutex> lock(blocks_mutex);
+    if (blocks.empty() || channel >= channel_count || max_buckets == 0) {
+        return 0;
+    }
+    first = std::max(first, blocks.front().first_sample);
+    last = std::min(last, blocks.back().first_sample + BLOCK_SAMPLES);
+    if (last <= first) {
+        return 0;
+    }
+
+    uint64_t range = last - first;
+    size_t points = 0;
+
+    // 样本数不超过桶数：直接输出原始样本
+    if (range <= max_buckets * 2) {
+        for (uint64_t index = first; index < last;) {
+            const Block* block = findBlock(index);
+            if (!block) {
+                index = std::min(last, nextBlockStart(index));
+                continue;
+            }
+            uint64_t stop = std::min(last, block->first_sample + BLOCK_SAMPLES);
+            const float* samples = blockSamples(*block, channel);
+            for (; samples && index < stop; ++index) {
+                xs[points] = static_cast<float>((index - time_origin) * sample_period);
+                ys[points] = samples[index - block->first_sample];
+                ++points;
+            }
+            index = stop;
+        }
+        return points;
+    }
+
+    // 与 MinMaxPyramid::query 相同的桶划分（含 max_buckets < 3 时的合并）
+    size_t shift = 1;
+    while (shift < 63 && (range >> shift) != 0 && (range >> shift) + 2 > max_buckets) {
+        ++shift;
+    }
+    const uint64_t bucket_size = uint64_t(1) << shift;
+    uint64_t output_lo = first;
+    for (uint64_t bucket_start = first & ~(bucket_size - 1); bucket_start < last; bucket_start += bucket_size) {
+        uint64_t lo = std::max(bucket_start, first);
+        uint64_t hi = std::min(bucket_start + bucket_size, last);
+        float min_value, max_value;
+        if (!minMaxRange(channel, lo, hi, min_value, max_value)) {
+            continue;
+        }
+        if (points == 2 * max_buckets) {
+            ys[points - 2] = std::fmin(ys[points - 2], min_value);
+            ys[points - 1] = std::fmax(ys[points - 1], max_value);
+            xs[points - 1] = static_cast<float>((output_lo + (hi - output_lo) / 2 - time_origin) * sample_period);
+            continue;
+        }
+        output_lo = lo;
+        xs[points] = static_cast<float>((lo - time_origin) * sample_period);
+        ys[points] = min_value;
+        xs[points + 1] = static_cast<float>((lo + (hi - lo) / 2 - time_origin) * sample_period);
+        ys[points + 1] = max_value;
+        points += 2;
+    }
+    return points;
+}
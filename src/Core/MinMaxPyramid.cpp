@@ -0,0 +1,166 @@
+#include "Core/MinMaxPyramid.h"
+#include <algorithm>
+#include <cmath>
+
+MinMaxPyramid::MinMaxPyramid(size_t channel_count, size_t history_capacity)
+    : channel_count(channel_count), max_level(MIN_LEVEL) {
+    for (size_t level = MIN_LEVEL; (history_capacity >> level) >= MIN_LEVEL_BUCKETS; ++level) {
+        Level l;
+        l.capacity = history_capacity >> level;
+        l.minmax.assign(channel_count * l.capacity * 2, 0.0f);
+        levels.push_back(std::move(l));
+        max_level = level;
+    }
+}
+
+void MinMaxPyramid::append(const ChannelRingStore& store, uint64_t end) {
+    const uint64_t fine_bucket = uint64_t(1) << MIN_LEVEL;
+    uint64_t begin = published_index.load(std::memory_order_relaxed);
+    uint64_t stop = end & ~(fine_bucket - 1);
+
+    // 落后超过原始缓冲的可读窗口：从最旧的可读样本重新开始，对齐到最顶层桶
+    uint64_t window = store.readableWindow();
+    if (end > window && begin < end - window) {
+        uint64_t top_bucket = uint64_t(1) << max_level;
+        begin = (end - window + top_bucket - 1) & ~(top_bucket - 1);
+        start_index.store(begin, std::memory_order_release);
+        published_index.store(begin, std::memory_order_release);
+    }
+    if (stop <= begin) {
+        return;
+    }
+
+    const size_t mask = store.mask();
+    const uint64_t chunk = std::max<uint64_t>(store.capacity() / 16, fine_bucket);
+
+    // 分块处理并逐块发布，保证未发布的写入不超过读者校验预留的余量
+    for (uint64_t chunk_begin = begin; chunk_begin < stop; chunk_begin += chunk) {
+        uint64_t chunk_end = std::min(stop, chunk_begin + chunk);
+
+        for (size_t ch = 0; ch < channel_count; ++ch) {
+            const float* ring = store.channelData(ch);
+
+            for (uint64_t bucket = chunk_begin >> MIN_LEVEL; bucket < (chunk_end >> MIN_LEVEL); ++bucket) {
+                // 容量是桶大小的整数倍，最细层的桶在环内不会回绕
+                const float* src = ring + ((bucket << MIN_LEVEL) & mask);
+                float min_value = src[0];
+                float max_value = src[0];
+                for (uint64_t i = 1; i < fine_bucket; ++i) {
+                    min_value = std::fmin(min_value, src[i]);
+                    max_value = std::fmax(max_value, src[i]);
+                }
+                float* dst = bucketAt(MIN_LEVEL, ch, bucket);
+                dst[0] = min_value;
+                dst[1] = max_value;
+
+                // 右孩子完成时向上合并
+                uint64_t b = bucket;
+                for (size_t level = MIN_LEVEL; level < max_level && (b & 1); ++level) {
+                    const float* left = bucketAt(level, ch, b - 1);
+                    const float* right = bucketAt(level, ch, b);
+                    float* parent = bucketAt(level + 1, ch, b >> 1);
+                    parent[0] = std::fmin(left[0], right[0]);
+                    parent[1] = std::fmax(left[1], right[1]);
+                    b >>= 1;
+                }
+            }
+        }
+
+        published_index.store(chunk_end, std::memory_order_release);
+    }
+}
+
+bool MinMaxPyramid::isRetained(size_t level, uint64_t first_bucket) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const Level& l = levels[level - MIN_LEVEL];
+    uint64_t latest = published_index.load(std::memory_order_relaxed) >> level;
+    // 生产者未发布的写入最多一个分块（容量的1/16）
+    return latest <= first_bucket || latest - first_bucket < l.capacity - l.capacity / 16;
+}
+
+size_t MinMaxPyramid::query(const ChannelRingStore& store, size_t channel, uint64_t first, uint64_t last,
+                            size_t max_buckets, uint64_t time_origin, double sample_period,
+                            float* xs, float* ys) const {
+    if (last <= first || max_buckets == 0) {
+        return 0;
+    }
+
+    const float* ring = store.channelData(channel);
+    const size_t mask = store.mask();
+    uint64_t range = last - first;
+    size_t points = 0;
+
+    // 样本数不超过桶数：直接输出原始样本
+    if (range <= max_buckets * 2) {
+        for (uint64_t index = first; index < last; ++index) {
+            xs[points] = static_cast<float>((index - time_origin) * sample_period);
+            ys[points] = ring[index & mask];
+            ++points;
+        }
+        return store.isRetained(first) ? points : 0;
+    }
+
+    // 选择桶大小 2^shift，使对齐后的桶数（两端可能多出的部分桶）不超过 max_buckets；
+    // max_buckets < 3 时做不到，桶取到不小于 range 为止，多出的桶在输出时并入前一个桶
+    size_t shift = 1;
+    while (shift < 63 && (range >> shift) != 0 && (range >> shift) + 2 > max_buckets) {
+        ++shift;
+    }
+    const uint64_t bucket_size = uint64_t(1) << shift;
+    const size_t level = std::min(shift, max_level);
+    const uint64_t pyramid_start = startIndex();
+    const uint64_t pyramid_end = publishedCount();
+    uint64_t output_lo = first;    // 最后输出的桶的起点
+
+    for (uint64_t bucket_start = first & ~(bucket_size - 1); bucket_start < last; bucket_start += bucket_size) {
+        uint64_t lo = std::max(bucket_start, first);
+        uint64_t hi = std::min(bucket_start + bucket_size, last);
+        float min_value;
+        float max_value;
+
+        if (shift >= MIN_LEVEL && lo == bucket_start && hi == bucket_start + bucket_size &&
+            lo >= pyramid_start && hi <= pyramid_end) {
+            // 完整且已并入金字塔的桶：合并对应层的 2^(shift - level) 个桶
+            uint64_t level_first = lo >> level;
+            uint64_t level_last = hi >> level;
+            const float* entry = bucketAt(level, channel, level_first);
+            min_value = entry[0];
+            max_value = entry[1];
+            for (uint64_t b = level_first + 1; b < level_last; ++b) {
+                entry = bucketAt(level, channel, b);
+                min_value = std::fmin(min_value, entry[0]);
+                max_value = std::fmax(max_value, entry[1]);
+            }
+        } else {
+            // 区间两端的部分桶、尚未并入金字塔的尾部：扫描原始样本
+            min_value = ring[lo & mask];
+            max_value = min_value;
+            for (uint64_t index = lo + 1; index < hi; ++index) {
+                float value = ring[index & mask];
+                min_value = std::fmin(min_value, value);
+                max_value = std::fmax(max_value, value);
+            }
+        }
+
+        if (points == 2 * max_buckets) {
+            ys[points - 2] = std::fmin(ys[points - 2], min_value);
+            ys[points - 1] = std::fmax(ys[points - 1], max_value);
+            xs[points - 1] = static_cast<float>((output_lo + (hi - output_lo) / 2 - time_origin) * sample_period);
+            continue;
+        }
+        output_lo = lo;
+        xs[points] = static_cast<float>((lo - time_origin) * sample_period);
+        ys[points] = min_value;
+        xs[points + 1] = static_cast<float>((lo + (hi - lo) / 2 - time_origin) * sample_period);
+        ys[points + 1] = max_value;
+        points += 2;
+    }
+
+    if (!store.isRetained(first)) {
+        return 0;
+    }
+    if (shift >= MIN_LEVEL && !isRetained(level, first >> level)) {
+        return 0;
+    }
+    return points;
+}
@@ -0,0 +1,80 @@
+#include "Core/PacketDecoder.h"
+#include "Core/ChannelFilterBank.h"
+#include "DecodeKernels.h"
+#include <algorithm>
+
+bool PacketDecoder::isSupported(DecodeIsa isa) {
+    switch (isa) {
+    case DecodeIsa::Auto:
+    case DecodeIsa::Scalar:
+        return true;
+    case DecodeIsa::Sse2:
+#if defined(__SSE2__) || defined(_M_X64)
+        return true;
+#else
+        return false;
+#endif
+    case DecodeIsa::Avx2:
+#if defined(SENSORMONITOR_HAS_AVX2_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+const char* PacketDecoder::isaName(DecodeIsa isa) {
+    switch (isa) {
+    case DecodeIsa::Scalar: return "scalar";
+    case DecodeIsa::Sse2: return "sse2";
+    case DecodeIsa::Avx2: return "avx2";
+    default: return "auto";
+    }
+}
+
+PacketDecoder::PacketDecoder(const StreamDescriptor& stream, DecodeIsa isa)
+    : channel_count(stream.channel_count),
+      samples_per_packet(stream.samples_per_packet),
+      payload_offset(stream.headerSize()) {
+    if (isa == DecodeIsa::Auto) {
+        isa = isSupported(DecodeIsa::Avx2) ? DecodeIsa::Avx2 :
+              isSupported(DecodeIsa::Sse2) ? DecodeIsa::Sse2 : DecodeIsa::Scalar;
+    } else if (!isSupported(isa)) {
+        isa = DecodeIsa::Scalar;
+    }
+    selected_isa = isa;
+
+    switch (isa) {
+#ifdef SENSORMONITOR_HAS_AVX2_KERNELS
+    case DecodeIsa::Avx2:
+        decode_fn = selectAvx2Kernel(stream.sample_type, stream.layout, samples_per_packet);
+        break;
+#endif
+    case DecodeIsa::Sse2:
+        decode_fn = selectKernel<true>(stream.sample_type, stream.layout, samples_per_packet);
+        break;
+    default:
+        decode_fn = selectKernel<false>(stream.sample_type, stream.layout, samples_per_packet);
+        break;
+    }
+
+    if (stream.layout == SampleLayout::Interleaved && stream.sample_type != SampleType::Float32) {
+        scratch.assign(interleavedScratchSamples(channel_count * samples_per_packet), 0.0f);
+    }
+}
+
+void PacketDecoder::decode(const PacketBatch& batch, ChannelRingStore& store, ChannelFilterBank* filter) {
+    // 分组提交，使未发布的写入不超过环形缓冲为读者预留的余量
+    const size_t group = std::max<size_t>(store.maxCommitSamples() / samples_per_packet, 1);
+
+    for (size_t first = 0; first < batch.packet_count; first += group) {
+        size_t count = std::min(group, batch.packet_count - first);
+        decode_fn(batch.packet(first) + payload_offset, batch.packet_size, count, channel_count, samples_per_packet,
+                  store.writeData(), store.channelStride(), store.capacity(), store.pendingIndex(), scratch.data());
+        if (filter) {
+            filter->process(store, store.pendingIndex(), count * samples_per_packet);
+        }
+        store.commit(count * samples_per_packet);
+    }
+}
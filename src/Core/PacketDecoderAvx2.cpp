@@ -0,0 +1,10 @@
+// 以 AVX2 编译的解码内核（CMake 只为这个文件加 -mavx2），由 PacketDecoder 在运行期检测 CPU 后选用
+#include "DecodeKernels.h"
+
+#if !defined(__AVX2__)
+#error "PacketDecoderAvx2.cpp must be compiled with AVX2 enabled"
+#endif
+
+DecodeKernelFn selectAvx2Kernel(SampleType type, SampleLayout layout, size_t samples_per_packet) {
+    return selectKernel<true>(type, layout, samples_per_packet);
+}
@@ -0,0 +1,255 @@
+#include "Core/PacketQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+const char* overflowPolicyName(OverflowPolicy policy) {
+    switch (policy) {
+    case OverflowPolicy::DropOldest: return "drop-oldest";
+    case OverflowPolicy::DropNewest: return "drop-newest";
+    default: return "block";
+    }
+}
+
+bool parseOverflowPolicy(const std::string& text, OverflowPolicy& policy) {
+    if (text == "block") {
+        policy = OverflowPolicy::Block;
+    } else if (text == "drop-oldest") {
+        policy = OverflowPolicy::DropOldest;
+    } else if (text == "drop-newest") {
+        policy = OverflowPolicy::DropNewest;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+PacketQueue::IndexQueue::IndexQueue(size_t min_capacity) {
+    size_t capacity = 1;
+    while (capacity < min_capacity) capacity <<= 1;
+    cells.reset(new Cell[capacity]);
+    mask = capacity - 1;
+    for (size_t i = 0; i < capacity; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool PacketQueue::IndexQueue::push(uint32_t value) {
+    uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & mask];
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence - pos);
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;   // 满
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->value = value;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool PacketQueue::IndexQueue::pop(uint32_t& value) {
+    uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & mask];
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence - (pos + 1));
+        if (diff == 0) {
+            if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;   // 空
+        } else {
+            pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    value = cell->value;
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+bool PacketQueue::IndexQueue::readable() const {
+    uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    return cells[pos & mask].sequence.load(std::memory_order_acquire) == pos + 1;
+}
+
+PacketQueue::PacketQueue(size_t packet_size, size_t slot_count, OverflowPolicy policy)
+    : packet_size(packet_size),
+      slot_count(std::max<size_t>(slot_count, 2)),
+      slot_bytes(packet_size * SLOT_PACKETS),
+      overflow_policy(policy),
+      storage(new uint8_t[this->slot_count * slot_bytes]),
+      slot_packets(new uint32_t[this->slot_count]()),
+      slot_sources(new uint32_t[this->slot_count]()),
+      free_slots(this->slot_count),
+      ready_slots(this->slot_count) {
+    for (size_t slot = 0; slot < this->slot_count; ++slot) {
+        free_slots.push(static_cast<uint32_t>(slot));
+    }
+}
+
+PacketQueue::~PacketQueue() {
+    stop();
+}
+
+void PacketQueue::start(Handler handler) {
+    if (worker.joinable()) return;
+    this->handler = std::move(handler);
+    stopping = false;
+    worker = std::thread(&PacketQueue::run, this);
+}
+
+void PacketQueue::stop() {
+    stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+    }
+    wait_cv.notify_one();
+    {
+        std::lock_guard<std::mutex> lock(space_mutex);
+    }
+    space_cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void PacketQueue::updateHighWater(std::atomic<size_t>& high_water, size_t value) {
+    size_t current = high_water.load(std::memory_order_relaxed);
+    while (value > current && !high_water.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+bool PacketQueue::acquireSlot(uint32_t& slot) {
+    if (free_slots.pop(slot)) return true;
+
+    switch (overflow_policy) {
+    case OverflowPolicy::DropNewest:
+        return false;
+
+    case OverflowPolicy::DropOldest:
+        // 空闲池为空时所有槽都在排队、处理中或正被其他生产者填充；取走队首的槽重新使用
+        while (!stopping) {
+            if (ready_slots.pop(slot)) {
+                uint32_t packets = slot_packets[slot];
+                dropped_oldest.fetch_add(packets, std::memory_order_relaxed);
+                depth_packets.fetch_sub(packets, std::memory_order_relaxed);
+                depth_slots.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (free_slots.pop(slot)) return true;
+            std::this_thread::yield();
+        }
+        return false;
+
+    case OverflowPolicy::Block: {
+        blocked_pushes.fetch_add(1, std::memory_order_relaxed);
+        space_waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::unique_lock<std::mutex> lock(space_mutex);
+        bool acquired = false;
+        while (!(acquired = free_slots.pop(slot)) && !stopping) {
+            space_cv.wait(lock);
+        }
+        space_waiters.fetch_sub(1);
+        return acquired;
+    }
+    }
+    return false;
+}
+
+void PacketQueue::push(const PacketBatch& batch) {
+    if (batch.packet_size != packet_size) {
+        std::cerr << "PacketQueue: invalid packet size " << batch.packet_size << " (expected " << packet_size << ")"
+                  << std::endl;
+        return;
+    }
+
+    for (size_t first = 0; first < batch.packet_count;) {
+        uint32_t slot;
+        if (stopping || !acquireSlot(slot)) {
+            dropped_newest.fetch_add(batch.packet_count - first, std::memory_order_relaxed);
+            return;
+        }
+        size_t count = std::min(SLOT_PACKETS, batch.packet_count - first);
+        std::memcpy(slotData(slot), batch.packet(first), count * packet_size);
+        slot_packets[slot] = static_cast<uint32_t>(count);
+        slot_sources[slot] = batch.source;
+        first += count;
+
+        // 先计入深度再入队，处理线程减去时不会下溢
+        pushed_packets.fetch_add(count, std::memory_order_relaxed);
+        updateHighWater(high_water_packets, depth_packets.fetch_add(count, std::memory_order_relaxed) + count);
+        updateHighWater(high_water_slots, depth_slots.fetch_add(1, std::memory_order_relaxed) + 1);
+        ready_slots.push(slot);
+
+        // 与处理线程的 consumer_waiting 写入配对，保证不会漏掉唤醒
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer_waiting.load(std::memory_order_relaxed)) {
+            {
+                std::lock_guard<std::mutex> lock(wait_mutex);
+            }
+            wait_cv.notify_one();
+        }
+    }
+}
+
+void PacketQueue::run() {
+    while (true) {
+        uint32_t slot;
+        if (ready_slots.pop(slot)) {
+            const uint32_t packets = slot_packets[slot];
+            PacketBatch batch;
+            batch.data = slotData(slot);
+            batch.packet_count = packets;
+            batch.packet_size = packet_size;
+            batch.source = slot_sources[slot];
+            handler(batch);
+
+            delivered_packets.fetch_add(packets, std::memory_order_relaxed);
+            depth_packets.fetch_sub(packets, std::memory_order_relaxed);
+            depth_slots.fetch_sub(1, std::memory_order_relaxed);
+            free_slots.push(slot);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (space_waiters.load(std::memory_order_relaxed) > 0) {
+                {
+                    std::lock_guard<std::mutex> lock(space_mutex);
+                }
+                space_cv.notify_one();
+            }
+            continue;
+        }
+        // 停止时先排空已排队的槽
+        if (stopping) break;
+
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        consumer_waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready_slots.readable() && !stopping) {
+            wait_cv.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        consumer_waiting.store(false, std::memory_order_relaxed);
+    }
+}
+
+PacketQueueStats PacketQueue::getStats() const {
+    PacketQueueStats stats;
+    stats.pushed_packets = pushed_packets.load(std::memory_order_relaxed);
+    stats.delivered_packets = delivered_packets.load(std::memory_order_relaxed);
+    stats.dropped_newest = dropped_newest.load(std::memory_order_relaxed);
+    stats.dropped_oldest = dropped_oldest.load(std::memory_order_relaxed);
+    stats.blocked_pushes = blocked_pushes.load(std::memory_order_relaxed);
+    stats.slot_count = slot_count;
+    stats.depth_slots = depth_slots.load(std::memory_order_relaxed);
+    stats.depth_packets = depth_packets.load(std::memory_order_relaxed);
+    stats.high_water_slots = high_water_slots.load(std::memory_order_relaxed);
+    stats.high_water_packets = high_water_packets.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,68 @@
+#include "Core/PacketSequencer.h"
+#include <algorithm>
+
+PacketSequencer::PacketSequencer(const StreamDescriptor& stream, uint64_t max_gap_samples)
+    : stream(stream), max_gap_samples(max_gap_samples) {}
+
+void PacketSequencer::restart(const PacketHeader& header) {
+    std::fill(window, window + WORDS, 0);
+    started = true;
+    highest_sequence = header.sequence;
+    next_sample = header.first_sample + stream.samples_per_packet;
+    markReceived(header.sequence);
+    ++loss_stats.packets;
+}
+
+bool PacketSequencer::accept(const uint8_t* packet, uint64_t& gap_samples) {
+    gap_samples = 0;
+    PacketHeader header;
+    if (!readPacketHeader(packet, stream, header)) {
+        ++loss_stats.invalid_packets;
+        return false;
+    }
+    if (!started) {
+        restart(header);
+        return true;
+    }
+
+    if (header.sequence <= highest_sequence) {
+        // 窗口内的旧序号：对应时段已写入（或已填充 NaN），只计数
+        if (highest_sequence - header.sequence < WINDOW && header.first_sample < next_sample) {
+            if (received(header.sequence)) {
+                ++loss_stats.duplicate_packets;
+            } else {
+                markReceived(header.sequence);
+                ++loss_stats.reordered_packets;
+                if (loss_stats.lost_packets > 0) --loss_stats.lost_packets;
+            }
+            return false;
+        }
+        ++loss_stats.resyncs;
+        restart(header);
+        return true;
+    }
+
+    if (header.first_sample < next_sample || header.first_sample - next_sample > max_gap_samples) {
+        ++loss_stats.resyncs;
+        restart(header);
+        return true;
+    }
+
+    // 跳过的序号在窗口中可能还留着上一圈的标记
+    const uint64_t skipped = header.sequence - highest_sequence - 1;
+    for (uint64_t i = 0; i < std::min<uint64_t>(skipped, WINDOW); ++i) {
+        clearReceived(header.sequence - 1 - i);
+    }
+    markReceived(header.sequence);
+    loss_stats.lost_packets += skipped;
+
+    gap_samples = header.first_sample - next_sample;
+    if (gap_samples > 0) {
+        ++loss_stats.gaps;
+        loss_stats.gap_samples += gap_samples;
+    }
+    highest_sequence = header.sequence;
+    next_sample = header.first_sample + stream.samples_per_packet;
+    ++loss_stats.packets;
+    return true;
+}
@@ -0,0 +1,148 @@
+#include "Core/RealFft.h"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+RealFft::RealFft(size_t size)
+    : n(roundUpPowerOfTwo(std::min(std::max(size, MIN_SIZE), MAX_SIZE))), half(n / 2) {
+    size_t bits = 0;
+    while ((size_t(1) << bits) < half) {
+        ++bits;
+    }
+    bit_reverse.resize(half);
+    for (size_t i = 0; i < half; ++i) {
+        uint32_t reversed = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            reversed |= static_cast<uint32_t>(((i >> b) & 1) << (bits - 1 - b));
+        }
+        bit_reverse[i] = reversed;
+    }
+
+    // Twiddles are computed in double so the largest sizes keep full float precision
+    const double pi = 3.14159265358979323846;
+    stage_re.resize(half);
+    stage_im.resize(half);
+    for (size_t h = 1; h < half; h <<= 1) {
+        for (size_t j = 0; j < h; ++j) {
+            stage_re[h - 1 + j] = static_cast<float>(std::cos(-pi * j / h));
+            stage_im[h - 1 + j] = static_cast<float>(std::sin(-pi * j / h));
+        }
+    }
+    split_re.resize(half / 2 + 1);
+    split_im.resize(half / 2 + 1);
+    for (size_t k = 0; k <= half / 2; ++k) {
+        split_re[k] = static_cast<float>(std::cos(-2.0 * pi * k / n));
+        split_im[k] = static_cast<float>(std::sin(-2.0 * pi * k / n));
+    }
+}
+
+void RealFft::transform(const float* input, float* re, float* im) const {
+    // z[k] = x[2k] + i x[2k+1], loaded in bit-reversed order for the in-place decimation-in-time passes
+    for (size_t k = 0; k < half; ++k) {
+        const uint32_t target = bit_reverse[k];
+        re[target] = input[2 * k];
+        im[target] = input[2 * k + 1];
+    }
+    butterflies(re, im);
+
+    // Split Z into the spectrum of the real input: with F_e = (Z[k] + conj Z[M-k]) / 2 and
+    // F_o = (Z[k] - conj Z[M-k]) / 2i, X[k] = F_e + W^k F_o and X[M-k] = conj(F_e - W^k F_o)
+    const float z0_re = re[0], z0_im = im[0];
+    re[0] = z0_re + z0_im;
+    im[0] = 0.0f;
+    re[half] = z0_re - z0_im;
+    im[half] = 0.0f;
+    for (size_t k = 1; k <= half / 2; ++k) {
+        const size_t m = half - k;
+        const float a_re = re[k], a_im = im[k];
+        const float b_re = re[m], b_im = im[m];
+        const float even_re = 0.5f * (a_re + b_re);
+        const float even_im = 0.5f * (a_im - b_im);
+        const float odd_re = 0.5f * (a_im + b_im);
+        const float odd_im = -0.5f * (a_re - b_re);
+        const float w_re = split_re[k], w_im = split_im[k];
+        const float t_re = w_re * odd_re - w_im * odd_im;
+        const float t_im = w_re * odd_im + w_im * odd_re;
+        re[k] = even_re + t_re;
+        im[k] = even_im + t_im;
+        re[m] = even_re - t_re;
+        im[m] = -(even_im - t_im);
+    }
+}
+
+void RealFft::butterflies(float* re, float* im) const {
+    // Spans 1 and 2 together: twiddles are 1 and -i
+    for (size_t s = 0; s + 4 <= half; s += 4) {
+        const float r0 = re[s] + re[s + 1], i0 = im[s] + im[s + 1];
+        const float r1 = re[s] - re[s + 1], i1 = im[s] - im[s + 1];
+        const float r2 = re[s + 2] + re[s + 3], i2 = im[s + 2] + im[s + 3];
+        const float r3 = re[s + 2] - re[s + 3], i3 = im[s + 2] - im[s + 3];
+        re[s] = r0 + r2;
+        im[s] = i0 + i2;
+        re[s + 2] = r0 - r2;
+        im[s + 2] = i0 - i2;
+        // (r3 + i i3) * -i = i3 - i r3
+        re[s + 1] = r1 + i3;
+        im[s + 1] = i1 - r3;
+        re[s + 3] = r1 - i3;
+        im[s + 3] = i1 + r3;
+    }
+    if (half == 2) {
+        const float r0 = re[0], i0 = im[0];
+        re[0] = r0 + re[1];
+        im[0] = i0 + im[1];
+        re[1] = r0 - re[1];
+        im[1] = i0 - im[1];
+        return;
+    }
+
+    for (size_t h = 4; h < half; h <<= 1) {
+        const float* w_re = stage_re.data() + h - 1;
+        const float* w_im = stage_im.data() + h - 1;
+        for (size_t s = 0; s < half; s += 2 * h) {
+            float* a_re = re + s;
+            float* a_im = im + s;
+            float* b_re = re + s + h;
+            float* b_im = im + s + h;
+#if defined(__SSE2__)
+            for (size_t j = 0; j < h; j += 4) {
+                const __m128 wr = _mm_loadu_ps(w_re + j);
+                const __m128 wi = _mm_loadu_ps(w_im + j);
+                const __m128 br = _mm_loadu_ps(b_re + j);
+                const __m128 bi = _mm_loadu_ps(b_im + j);
+                const __m128 tr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+                const __m128 ti = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+                const __m128 ar = _mm_loadu_ps(a_re + j);
+                const __m128 ai = _mm_loadu_ps(a_im + j);
+                _mm_storeu_ps(a_re + j, _mm_add_ps(ar, tr));
+                _mm_storeu_ps(a_im + j, _mm_add_ps(ai, ti));
+                _mm_storeu_ps(b_re + j, _mm_sub_ps(ar, tr));
+                _mm_storeu_ps(b_im + j, _mm_sub_ps(ai, ti));
+            }
+#else
+            for (size_t j = 0; j < h; ++j) {
+                const float tr = b_re[j] * w_re[j] - b_im[j] * w_im[j];
+                const float ti = b_re[j] * w_im[j] + b_im[j] * w_re[j];
+                b_re[j] = a_re[j] - tr;
+                b_im[j] = a_im[j] - ti;
+                a_re[j] += tr;
+                a_im[j] += ti;
+            }
+#endif
+        }
+    }
+}
@@ -0,0 +1,166 @@
+#include "Core/SignalGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr double TWO_PI = 6.283185307179586;
+
+template <typename T>
+T saturate(float value, double full_scale) {
+    double scaled = std::nearbyint(value * full_scale);
+    return static_cast<T>(std::min(std::max(scaled, -full_scale), full_scale - 1.0));
+}
+
+} // namespace
+
+const char* signalPatternName(SignalPattern pattern) {
+    switch (pattern) {
+    case SignalPattern::Noise: return "noise";
+    case SignalPattern::Step: return "step";
+    case SignalPattern::Spike: return "spike";
+    default: return "sine";
+    }
+}
+
+bool parseSignalPattern(const std::string& text, SignalPattern& pattern) {
+    for (SignalPattern candidate : {SignalPattern::Sine, SignalPattern::Noise, SignalPattern::Step,
+                                    SignalPattern::Spike}) {
+        if (text == signalPatternName(candidate)) {
+            pattern = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+SignalGenerator::SignalGenerator(const StreamDescriptor& stream, const SignalConfig& config)
+    : stream(stream), config(config), rng_state(config.seed ? config.seed : 1),
+      block(stream.channel_count * stream.samples_per_packet, 0.0f),
+      osc_re(stream.channel_count), osc_im(stream.channel_count),
+      rot_re(stream.channel_count), rot_im(stream.channel_count) {
+    for (size_t c = 0; c < stream.channel_count; ++c) {
+        double frequency = config.frequency * (1.0 + static_cast<double>(c) / stream.channel_count);
+        double step = TWO_PI * frequency / stream.sample_rate;
+        double phase = 0.7 * static_cast<double>(c);
+        osc_re[c] = std::cos(phase);
+        osc_im[c] = std::sin(phase);
+        rot_re[c] = std::cos(step);
+        rot_im[c] = std::sin(step);
+    }
+}
+
+void SignalGenerator::nextPacket(uint8_t* packet) {
+    generate();
+    if (stream.packet_header) {
+        writePacketHeader(packet, stream, next_sequence, firstSample());
+    }
+    encode(packet + stream.headerSize());
+    ++next_sequence;
+}
+
+double SignalGenerator::gaussian() {
+    // xorshift64* 的两个均匀数经 Box-Muller 变换
+    auto uniform = [this] {
+        rng_state ^= rng_state >> 12;
+        rng_state ^= rng_state << 25;
+        rng_state ^= rng_state >> 27;
+        return ((rng_state * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / 9007199254740992.0);
+    };
+    double u1 = std::max(uniform(), 1e-300);
+    double u2 = uniform();
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(TWO_PI * u2);
+}
+
+void SignalGenerator::generate() {
+    const size_t spp = stream.samples_per_packet;
+    const uint64_t first = firstSample();
+    const double samples_per_cycle = config.frequency > 0.0 ? stream.sample_rate / config.frequency : 0.0;
+
+    for (size_t c = 0; c < stream.channel_count; ++c) {
+        float* out = block.data() + c * spp;
+        switch (config.pattern) {
+        case SignalPattern::Sine: {
+            double re = osc_re[c], im = osc_im[c];
+            for (size_t s = 0; s < spp; ++s) {
+                out[s] = static_cast<float>(config.amplitude * im);
+                double next_re = re * rot_re[c] - im * rot_im[c];
+                im = re * rot_im[c] + im * rot_re[c];
+                re = next_re;
+            }
+            // 每包归一化一次，抵消旋转累积的幅度误差
+            double norm = 1.0 / std::sqrt(re * re + im * im);
+            osc_re[c] = re * norm;
+            osc_im[c] = im * norm;
+            break;
+        }
+        case SignalPattern::Noise:
+            for (size_t s = 0; s < spp; ++s) {
+                out[s] = static_cast<float>(config.amplitude / 3.0 * gaussian());
+            }
+            break;
+        case SignalPattern::Step:
+            for (size_t s = 0; s < spp; ++s) {
+                double cycle = samples_per_cycle > 0.0
+                                   ? (first + s) / samples_per_cycle + static_cast<double>(c) / stream.channel_count
+                                   : 0.0;
+                out[s] = static_cast<float>(cycle - std::floor(cycle) < 0.5 ? config.amplitude : -config.amplitude);
+            }
+            break;
+        case SignalPattern::Spike: {
+            const uint64_t period = std::max<uint64_t>(static_cast<uint64_t>(samples_per_cycle), 1);
+            const uint64_t shift = c * period / stream.channel_count;
+            for (size_t s = 0; s < spp; ++s) {
+                out[s] = (first + s + shift) % period == 0 ? static_cast<float>(config.amplitude) : 0.0f;
+            }
+            break;
+        }
+        }
+        if (config.noise > 0.0) {
+            for (size_t s = 0; s < spp; ++s) {
+                out[s] += static_cast<float>(config.noise * gaussian());
+            }
+        }
+        if (config.offset != 0.0) {
+            for (size_t s = 0; s < spp; ++s) {
+                out[s] += static_cast<float>(config.offset);
+            }
+        }
+    }
+}
+
+void SignalGenerator::encode(uint8_t* payload) const {
+    const size_t channels = stream.channel_count;
+    const size_t spp = stream.samples_per_packet;
+    const size_t width = stream.bytesPerSample();
+
+    if (stream.sample_type == SampleType::Float32 && stream.layout == SampleLayout::ChannelMajor) {
+        std::memcpy(payload, block.data(), block.size() * sizeof(float));
+        return;
+    }
+    for (size_t c = 0; c < channels; ++c) {
+        for (size_t s = 0; s < spp; ++s) {
+            const float value = block[c * spp + s];
+            const size_t index = stream.layout == SampleLayout::Interleaved ? s * channels + c : c * spp + s;
+            uint8_t* dst = payload + index * width;
+            switch (stream.sample_type) {
+            case SampleType::Int16: {
+                int16_t v = saturate<int16_t>(value, 32768.0);
+                std::memcpy(dst, &v, sizeof(v));
+                break;
+            }
+            case SampleType::Int24: {
+                int32_t v = saturate<int32_t>(value, 8388608.0);
+                dst[0] = static_cast<uint8_t>(v);
+                dst[1] = static_cast<uint8_t>(v >> 8);
+                dst[2] = static_cast<uint8_t>(v >> 16);
+                break;
+            }
+            default:
+                std::memcpy(dst, &value, sizeof(value));
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,294 @@
+#include "Core/SpectrumAnalyzer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+const char* spectrumWindowName(SpectrumWindow window) {
+    switch (window) {
+    case SpectrumWindow::Blackman: return "blackman";
+    default: return "hann";
+    }
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer(const ChannelRingStore& store, double sample_rate, CodecPool& pool)
+    : store(store), sample_rate(sample_rate), pool(pool) {}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    stop();
+}
+
+void SpectrumAnalyzer::start() {
+    if (running) {
+        return;
+    }
+    running = true;
+    worker = std::thread(&SpectrumAnalyzer::run, this);
+}
+
+void SpectrumAnalyzer::stop() {
+    if (!running) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        running = false;
+    }
+    wait_cv.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void SpectrumAnalyzer::configure(const SpectrumConfig& config) {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    pending_config = config;
+    config_version.fetch_add(1, std::memory_order_release);
+}
+
+SpectrumConfig SpectrumAnalyzer::config() const {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    return pending_config;
+}
+
+SpectrumStats SpectrumAnalyzer::getStats() const {
+    SpectrumStats stats;
+    stats.transforms = transforms.load();
+    stats.missed_segments = missed_segments.load();
+    stats.busy_seconds = busy_ns.load() * 1e-9;
+    return stats;
+}
+
+void SpectrumAnalyzer::applyConfig(uint64_t end) {
+    {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        active = pending_config;
+        applied_version = config_version.load(std::memory_order_acquire);
+    }
+    active.overlap = std::min(std::max(active.overlap, 0.0), MAX_OVERLAP);
+    active.averages = std::min(std::max<size_t>(active.averages, 1), MAX_AVERAGES);
+    const size_t requested = std::min(std::max(active.fft_size, MIN_FFT_SIZE), MAX_FFT_SIZE);
+    if (!fft || fft->size() < requested || fft->size() / 2 >= requested) {
+        fft = std::make_unique<RealFft>(requested);
+    }
+    const size_t n = fft->size();
+    const size_t bins = fft->bins();
+    active.fft_size = n;
+
+    // Periodic windows: the usual choice for overlapped Welch segments
+    const double pi = 3.14159265358979323846;
+    window.resize(n);
+    double energy = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double phase = 2.0 * pi * i / n;
+        double w = 0.5 - 0.5 * std::cos(phase);
+        if (active.window == SpectrumWindow::Blackman) {
+            w = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        }
+        window[i] = static_cast<float>(w);
+        energy += w * w;
+    }
+    psd_scale = 1.0 / (sample_rate * energy);
+    hop = std::max<size_t>(1, n - static_cast<size_t>(std::lround(n * active.overlap)));
+
+    std::vector<size_t> channels;
+    for (size_t channel : active.channels) {
+        if (channel < store.channelCount() && std::find(channels.begin(), channels.end(), channel) == channels.end()) {
+            channels.push_back(channel);
+        }
+    }
+    active.channels = channels;
+    states.resize(channels.size());
+    for (size_t i = 0; i < channels.size(); ++i) {
+        ChannelState& state = states[i];
+        state.channel = channels[i];
+        state.history.assign(n, 0.0f);
+        state.windowed.resize(n);
+        state.re.resize(bins);
+        state.im.resize(bins);
+        state.segments.resize(active.averages * bins);
+        state.sum.resize(bins);
+    }
+    restart(end);
+}
+
+// 从可读的最旧样本重新开始：历史足够时第一次 process() 就能得到完整的平均
+void SpectrumAnalyzer::restart(uint64_t end) {
+    const uint64_t window_samples = store.readableWindow();
+    read_end = end > window_samples ? end - window_samples : 0;
+    next_segment_end = read_end + fft->size();
+    segment_count = 0;
+    first_valid = 0;
+    for (ChannelState& state : states) {
+        std::fill(state.sum.begin(), state.sum.end(), 0.0);
+    }
+}
+
+void SpectrumAnalyzer::process(uint64_t end) {
+    if (applied_version != config_version.load(std::memory_order_acquire)) {
+        applyConfig(end);
+    }
+    if (states.empty()) {
+        return;
+    }
+
+    const uint64_t window_samples = store.readableWindow();
+    const uint64_t oldest = end > window_samples ? end - window_samples : 0;
+    if (read_end < oldest) {
+        // 落后超过环形缓冲的可读窗口：历史不再连续，从可读的最旧样本重新攒一段（平均保留）
+        const uint64_t resumed_end = oldest + fft->size();
+        if (resumed_end > next_segment_end) {
+            missed_segments.fetch_add((resumed_end - next_segment_end + hop - 1) / hop, std::memory_order_relaxed);
+        }
+        read_end = oldest;
+        next_segment_end = resumed_end;
+    }
+    if (next_segment_end > end) {
+        // 还不够一段：先把新样本拷入通道历史，段长超过环形缓冲的可读窗口时也不会丢
+        if (end > read_end) {
+            for (ChannelState& state : states) {
+                copyHistory(state, read_end, end);
+            }
+            if (store.isRetained(read_end)) {
+                read_end = end;
+            }
+        }
+        return;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    uint64_t pending = (end - next_segment_end) / hop + 1;
+    uint64_t first_end = next_segment_end;
+    if (pending > active.averages) {
+        // 较早的段会被同一批中较新的段挤出平均，不必计算；这一批填满整个平均环
+        first_end += (pending - active.averages) * hop;
+        segment_count += pending - active.averages;
+        pending = active.averages;
+        first_valid = segment_count;
+        for (ChannelState& state : states) {
+            std::fill(state.sum.begin(), state.sum.end(), 0.0);
+        }
+    }
+    const uint64_t read_from = std::max(read_end, first_end - fft->size());
+    const uint64_t last_end = first_end + (pending - 1) * hop;
+
+    const size_t bins = fft->bins();
+    SpectrumSnapshot& snapshot = snapshots.writeBuffer();
+    snapshot.bins = bins;
+    snapshot.power_db.resize(states.size() * bins);
+    float* rows = snapshot.power_db.data();
+    pool.parallelFor(states.size(), [&](size_t i) {
+        processChannel(states[i], read_from, first_end, static_cast<size_t>(pending), rows + i * bins);
+    });
+
+    if (!store.isRetained(read_from)) {
+        // 拷贝期间样本被覆盖：这一批的功率谱不可信，丢弃平均重新开始
+        missed_segments.fetch_add(pending, std::memory_order_relaxed);
+        restart(end);
+    } else {
+        transforms.fetch_add(pending * states.size(), std::memory_order_relaxed);
+        segment_count += pending;
+        read_end = last_end;
+        next_segment_end = last_end + hop;
+        publish();
+    }
+    busy_ns.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - started).count()),
+                      std::memory_order_relaxed);
+}
+
+// 样本 [from, to) 拷入通道历史，NaN 按 0 计（两个环各自可能回绕）
+void SpectrumAnalyzer::copyHistory(ChannelState& state, uint64_t from, uint64_t to) const {
+    const size_t n = state.history.size();
+    const float* ring = store.channelData(state.channel);
+    while (from < to) {
+        const size_t ring_pos = static_cast<size_t>(from) & store.mask();
+        const size_t history_pos = static_cast<size_t>(from) & (n - 1);
+        const size_t chunk = static_cast<size_t>(
+            std::min<uint64_t>(to - from, std::min(store.capacity() - ring_pos, n - history_pos)));
+        const float* src = ring + ring_pos;
+        float* dst = state.history.data() + history_pos;
+        for (size_t i = 0; i < chunk; ++i) {
+            const float value = src[i];
+            dst[i] = value == value ? value : 0.0f;
+        }
+        from += chunk;
+    }
+}
+
+void SpectrumAnalyzer::processChannel(ChannelState& state, uint64_t read_from, uint64_t first_segment_end,
+                                      size_t segment_total, float* power_db) {
+    const size_t n = fft->size();
+    const size_t bins = fft->bins();
+    const size_t history_mask = n - 1;
+    const size_t averages = active.averages;
+    const float scale = static_cast<float>(psd_scale);
+
+    uint64_t read = read_from;
+    for (size_t s = 0; s < segment_total; ++s) {
+        const uint64_t segment_end = first_segment_end + s * hop;
+        copyHistory(state, read, segment_end);
+        read = segment_end;
+
+        // 段 [segment_end - n, segment_end) 在历史中从 segment_end & mask 开始
+        const size_t pos = static_cast<size_t>(segment_end) & history_mask;
+        const size_t first_part = n - pos;
+        const float* history = state.history.data();
+        float* windowed = state.windowed.data();
+        for (size_t i = 0; i < first_part; ++i) {
+            windowed[i] = history[pos + i] * window[i];
+        }
+        for (size_t i = first_part; i < n; ++i) {
+            windowed[i] = history[i - first_part] * window[i];
+        }
+        fft->transform(windowed, state.re.data(), state.im.data());
+
+        // 单边功率谱密度：除直流与 Nyquist 外能量翻倍
+        const uint64_t index = segment_count + s;
+        float* power = state.segments.data() + (index % averages) * bins;
+        const float* re = state.re.data();
+        const float* im = state.im.data();
+        double* sum = state.sum.data();
+        if (index >= first_valid + averages) {
+            for (size_t k = 0; k < bins; ++k) {
+                sum[k] -= power[k];
+            }
+        }
+        for (size_t k = 0; k < bins; ++k) {
+            power[k] = (re[k] * re[k] + im[k] * im[k]) * (2.0f * scale);
+        }
+        power[0] *= 0.5f;
+        power[bins - 1] *= 0.5f;
+        for (size_t k = 0; k < bins; ++k) {
+            sum[k] += power[k];
+        }
+    }
+
+    // 本通道的结果行：dB 转换与 FFT 一样按通道并行
+    const uint64_t averaged = std::min<uint64_t>(segment_count + segment_total - first_valid, averages);
+    const double inverse = 1.0 / static_cast<double>(averaged);
+    for (size_t k = 0; k < bins; ++k) {
+        // 减法累计的舍入可能使和略小于 0
+        power_db[k] = static_cast<float>(10.0 * std::log10(std::max(state.sum[k] * inverse, 1e-20)));
+    }
+}
+
+void SpectrumAnalyzer::publish() {
+    SpectrumSnapshot& snapshot = snapshots.writeBuffer();
+    snapshot.generation = ++generation;
+    snapshot.fft_size = fft->size();
+    snapshot.bin_width = sample_rate / static_cast<double>(fft->size());
+    snapshot.averaged = static_cast<size_t>(std::min<uint64_t>(segment_count - first_valid, active.averages));
+    snapshot.end_sample = read_end;
+    snapshot.window = active.window;
+    snapshot.channels = active.channels;
+    snapshots.publish();
+}
+
+// 计算线程：以 10ms 间隔检查新样本；每段只在攒够 hop 个新样本后计算
+void SpectrumAnalyzer::run() {
+    while (running) {
+        process(store.publishedCount());
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        wait_cv.wait_for(lock, std::chrono::milliseconds(10), [this] { return !running; });
+    }
+}
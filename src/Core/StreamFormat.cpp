@@ -0,0 +1,72 @@
+#include "Core/StreamFormat.h"
+#include <cstring>
+
+const char* sampleTypeName(SampleType type) {
+    switch (type) {
+    case SampleType::Int16: return "int16";
+    case SampleType::Int24: return "int24";
+    default: return "float32";
+    }
+}
+
+bool parseSampleType(const std::string& text, SampleType& type) {
+    if (text == "float32" || text == "f32") {
+        type = SampleType::Float32;
+    } else if (text == "int16" || text == "i16") {
+        type = SampleType::Int16;
+    } else if (text == "int24" || text == "i24") {
+        type = SampleType::Int24;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* sampleLayoutName(SampleLayout layout) {
+    return layout == SampleLayout::Interleaved ? "interleaved" : "channel-major";
+}
+
+bool parseSampleLayout(const std::string& text, SampleLayout& layout) {
+    if (text == "channel-major") {
+        layout = SampleLayout::ChannelMajor;
+    } else if (text == "interleaved") {
+        layout = SampleLayout::Interleaved;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void writePacketHeader(uint8_t* packet, const StreamDescriptor& stream, uint64_t sequence, uint64_t first_sample) {
+    PacketHeader header = {};
+    header.magic = PacketHeader::MAGIC;
+    header.version = PacketHeader::VERSION;
+    header.header_size = sizeof(PacketHeader);
+    header.sequence = sequence;
+    header.first_sample = first_sample;
+    header.channel_count = static_cast<uint16_t>(stream.channel_count);
+    header.samples_per_packet = static_cast<uint16_t>(stream.samples_per_packet);
+    header.sample_type = static_cast<uint8_t>(stream.sample_type);
+    header.sample_layout = static_cast<uint8_t>(stream.layout);
+    std::memcpy(packet, &header, sizeof(header));
+}
+
+bool readPacketHeader(const uint8_t* packet, const StreamDescriptor& stream, PacketHeader& header) {
+    // 包头可能不对齐（数据包紧密排列在接收缓冲中）
+    std::memcpy(&header, packet, sizeof(header));
+    return header.magic == PacketHeader::MAGIC && header.version == PacketHeader::VERSION &&
+           header.header_size == sizeof(PacketHeader) && header.channel_count == stream.channel_count &&
+           header.samples_per_packet == stream.samples_per_packet &&
+           header.sample_type == static_cast<uint8_t>(stream.sample_type) &&
+           header.sample_layout == static_cast<uint8_t>(stream.layout);
+}
+
+void writeSendStamp(uint8_t* packet, const StreamDescriptor& stream, const SendStamp& stamp) {
+    std::memcpy(packet + stream.headerSize(), &stamp, sizeof(stamp));
+}
+
+SendStamp readSendStamp(const uint8_t* packet, const StreamDescriptor& stream) {
+    SendStamp stamp;
+    std::memcpy(&stamp, packet + stream.headerSize(), sizeof(stamp));
+    return stamp;
+}
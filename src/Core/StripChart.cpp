@@ -0,0 +1,114 @@
+#include "Core/StripChart.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+size_t binColumns(const float* times, const float* values, size_t count, double start_time, double end_time,
+                  size_t columns, float* mins, float* maxs) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::fill(mins, mins + columns, nan);
+    std::fill(maxs, maxs + columns, nan);
+    if (columns == 0 || !(end_time > start_time)) {
+        return 0;
+    }
+
+    // Points arrive in time order: accumulate the open column in registers and store it when the column changes
+    const double scale = columns / (end_time - start_time);
+    const long last_column = static_cast<long>(columns) - 1;
+    long open_column = -1;
+    float open_min = 0.0f, open_max = 0.0f;
+    bool have_previous = false;
+    double previous_x = 0.0;
+    float previous_value = 0.0f;
+    long previous_column = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const float value = values[i];
+        if (std::isnan(value)) {
+            have_previous = false;
+            continue;
+        }
+        // Points just outside the range are kept as interpolation anchors for the edge columns
+        const double x = (times[i] - start_time) * scale;
+        const long column = x < 0.0 ? -1 : static_cast<long>(x);
+        if (column == open_column) {
+            open_min = std::min(open_min, value);
+            open_max = std::max(open_max, value);
+        } else {
+            if (open_column >= 0) {
+                mins[open_column] = open_min;
+                maxs[open_column] = open_max;
+            }
+            open_column = -1;
+            if (have_previous && column > previous_column + 1) {
+                const long fill_first = std::max(previous_column + 1, 0L);
+                const long fill_last = std::min(column - 1, last_column);
+                const double slope = (value - previous_value) / (x - previous_x);
+                double interpolated = previous_value + (fill_first + 0.5 - previous_x) * slope;
+                for (long c = fill_first; c <= fill_last; ++c, interpolated += slope) {
+                    mins[c] = static_cast<float>(interpolated);
+                    maxs[c] = static_cast<float>(interpolated);
+                }
+            }
+            if (column >= 0 && column <= last_column) {
+                open_column = column;
+                open_min = value;
+                open_max = value;
+            }
+        }
+        have_previous = true;
+        previous_x = x;
+        previous_value = value;
+        previous_column = column;
+    }
+    if (open_column >= 0) {
+        mins[open_column] = open_min;
+        maxs[open_column] = open_max;
+    }
+
+    // Stretch each column to meet its left neighbour's original range so the vertical strokes join up
+    size_t filled = 0;
+    float left_min = nan, left_max = nan;
+    for (size_t c = 0; c < columns; ++c) {
+        const float own_min = mins[c], own_max = maxs[c];
+        if (std::isnan(own_min)) {
+            left_min = left_max = nan;
+            continue;
+        }
+        ++filled;
+        if (!std::isnan(left_min)) {
+            if (own_min > left_max) mins[c] = left_max;
+            if (own_max < left_min) maxs[c] = left_min;
+        }
+        left_min = own_min;
+        left_max = own_max;
+    }
+    return filled;
+}
+
+void StripChart::update(const DataManager& manager, size_t first, size_t lanes, double start_time, double end_time,
+                        size_t columns) {
+    first_channel = std::min(first, manager.channelCount());
+    lane_count = std::min(lanes, manager.channelCount() - first_channel);
+    column_count = columns;
+    column_min.resize(lane_count * column_count);
+    column_max.resize(lane_count * column_count);
+    lane_low.assign(lane_count, std::numeric_limits<float>::max());
+    lane_high.assign(lane_count, std::numeric_limits<float>::lowest());
+
+    // 每列最多2个点：包络金字塔选出的桶不少于列宽，开销只与列数有关
+    const size_t max_points = 2 * column_count;
+    point_times.resize(max_points);
+    point_values.resize(max_points);
+    for (size_t lane = 0; lane < lane_count; ++lane) {
+        const size_t points = manager.queryEnvelope(first_channel + lane, start_time, end_time, max_points,
+                                                    point_times.data(), point_values.data());
+        float* mins = column_min.data() + lane * column_count;
+        float* maxs = column_max.data() + lane * column_count;
+        binColumns(point_times.data(), point_values.data(), points, start_time, end_time, column_count, mins, maxs);
+        for (size_t c = 0; c < column_count; ++c) {
+            if (std::isnan(mins[c])) continue;
+            lane_low[lane] = std::min(lane_low[lane], mins[c]);
+            lane_high[lane] = std::max(lane_high[lane], maxs[c]);
+        }
+    }
+}
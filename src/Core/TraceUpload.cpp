@@ -0,0 +1,76 @@
+#include "Core/TraceUpload.h"
+#include <algorithm>
+#include <cmath>
+
+TraceTransform TraceTransform::fromPlot(double first_time, double sample_rate, double x_min, double x_max,
+                                        double y_min, double y_max) {
+    TraceTransform transform;
+    const double x_span = x_max > x_min ? x_max - x_min : 1.0;
+    const double y_span = y_max > y_min ? y_max - y_min : 1.0;
+    transform.x_scale = static_cast<float>(2.0 / (sample_rate * x_span));
+    transform.x_bias = static_cast<float>(2.0 * (first_time - x_min) / x_span - 1.0);
+    transform.y_scale = static_cast<float>(2.0 / y_span);
+    transform.y_bias = static_cast<float>(-2.0 * y_min / y_span - 1.0);
+    return transform;
+}
+
+TraceVertex traceVertex(const TraceTransform& transform, const TraceChannelStyle& style, size_t index, float value) {
+    TraceVertex vertex;
+    vertex.valid = !std::isnan(value);
+    const float shown = vertex.valid ? value * style.scale + style.offset : 0.0f;
+    vertex.x = static_cast<float>(index) * transform.x_scale + transform.x_bias;
+    vertex.y = shown * transform.y_scale + transform.y_bias;
+    return vertex;
+}
+
+void TraceUploader::reset() {
+    valid = false;
+    sample_count = 0;
+}
+
+size_t TraceUploader::update(const DisplayFrame& frame, TraceUploadRange ranges[2], bool& whole) {
+    whole = false;
+    if (valid && frame.generation == generation) return 0;
+    generation = frame.generation;
+    if (frame.sample_count == 0 || frame.sample_stride == 0) {
+        sample_count = 0;
+        valid = false;
+        return 0;
+    }
+
+    const uint64_t end = frame.first_sample + frame.sample_count;
+    whole = !valid || frame.base_sample != base_sample || frame.channel_first != channel_first ||
+            frame.channel_count != channel_count || frame.sample_stride != slot_stride || end < uploaded_end ||
+            end - uploaded_end >= frame.sample_stride || uploaded_end < frame.first_sample;
+    if (whole) {
+        base_sample = frame.base_sample;
+        channel_first = frame.channel_first;
+        channel_count = frame.channel_count;
+        slot_stride = frame.sample_stride;
+        staging.assign(bufferFloats(), 0.0f);
+    }
+    const uint64_t copy_from = whole ? frame.first_sample : uploaded_end;
+
+    // Transpose the new samples from the frame's per-channel rings into time-major slots
+    size_t range_count = 0;
+    for (uint64_t index = copy_from; index < end;) {
+        const size_t slot = static_cast<size_t>((index - base_sample) % slot_stride);
+        const size_t run = static_cast<size_t>(std::min<uint64_t>(end - index, slot_stride - slot));
+        float* dst = staging.data() + slot * channel_count;
+        for (size_t c = 0; c < channel_count; ++c) {
+            const float* src = frame.samples.data() + (channel_first + c) * slot_stride + slot;
+            for (size_t i = 0; i < run; ++i) {
+                dst[i * channel_count + c] = src[i];
+            }
+        }
+        ranges[range_count++] = {slot, run, dst};
+        index += run;
+    }
+
+    uploaded_end = end;
+    start_slot = frame.offset;
+    sample_count = frame.sample_count;
+    first_time = frame.time_values[frame.physicalIndex(0)];
+    valid = true;
+    return range_count;
+}
@@ -0,0 +1,208 @@
+#include "IO/IoUring.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, const void* arg,
+                 size_t arg_size) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T>
+T* ringField(void* ring, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<uint8_t*>(ring) + offset);
+}
+
+} // namespace
+
+IoUring::~IoUring() {
+    // 先关闭 io_uring（取消所有未完成的请求），再释放映射与缓冲
+    if (ring_fd >= 0) close(ring_fd);
+    if (sqes) munmap(sqes, sqes_size);
+    if (cq_ring && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+    if (sq_ring) munmap(sq_ring, sq_ring_size);
+    if (buf_ring) munmap(buf_ring, buf_ring_size);
+}
+
+bool IoUring::init(unsigned entries, std::string& error) {
+    // 完成队列放大：multishot 请求一次提交会产生多个完成
+    const uint32_t candidates[] = {
+        IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN,
+        IORING_SETUP_COOP_TASKRUN,
+        0,
+    };
+    io_uring_params params;
+    for (uint32_t flags : candidates) {
+        std::memset(&params, 0, sizeof(params));
+        params.flags = flags | IORING_SETUP_CQSIZE;
+        params.cq_entries = entries * 8;
+        ring_fd = ioUringSetup(entries, &params);
+        if (ring_fd >= 0) {
+            setup_flags = flags;
+            break;
+        }
+        if (errno != EINVAL) break;
+    }
+    if (ring_fd < 0) {
+        error = std::string("io_uring_setup: ") + strerror(errno);
+        return false;
+    }
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    }
+    sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                   IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+        sq_ring = nullptr;
+        error = std::string("mmap SQ ring: ") + strerror(errno);
+        return false;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        cq_ring = sq_ring;
+    } else {
+        cq_ring = mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                       IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED) {
+            cq_ring = nullptr;
+            error = std::string("mmap CQ ring: ") + strerror(errno);
+            return false;
+        }
+    }
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqe_mapping = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                             IORING_OFF_SQES);
+    if (sqe_mapping == MAP_FAILED) {
+        error = std::string("mmap SQEs: ") + strerror(errno);
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqe_mapping);
+
+    sq_head = ringField<unsigned>(sq_ring, params.sq_off.head);
+    sq_tail = ringField<unsigned>(sq_ring, params.sq_off.tail);
+    sq_mask = *ringField<unsigned>(sq_ring, params.sq_off.ring_mask);
+    sq_entries = *ringField<unsigned>(sq_ring, params.sq_off.ring_entries);
+    // 提交项与提交队列一一对应
+    unsigned* sq_array = ringField<unsigned>(sq_ring, params.sq_off.array);
+    for (unsigned i = 0; i < sq_entries; ++i) {
+        sq_array[i] = i;
+    }
+    sqe_tail = submitted = *sq_tail;
+
+    cq_head = ringField<unsigned>(cq_ring, params.cq_off.head);
+    cq_tail = ringField<unsigned>(cq_ring, params.cq_off.tail);
+    cq_mask = *ringField<unsigned>(cq_ring, params.cq_off.ring_mask);
+    cqes = ringField<io_uring_cqe>(cq_ring, params.cq_off.cqes);
+    return true;
+}
+
+bool IoUring::registerBufferRing(uint16_t group, unsigned count, size_t size, std::string& error) {
+    if (count == 0 || (count & (count - 1)) != 0 || count > 32768) {
+        error = "buffer count must be a power of two up to 32768";
+        return false;
+    }
+    buf_ring_size = count * sizeof(io_uring_buf);
+    void* mapping = mmap(nullptr, buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        error = std::string("mmap buffer ring: ") + strerror(errno);
+        return false;
+    }
+    buf_ring = static_cast<io_uring_buf_ring*>(mapping);
+
+    io_uring_buf_reg registration;
+    std::memset(&registration, 0, sizeof(registration));
+    registration.ring_addr = reinterpret_cast<uint64_t>(buf_ring);
+    registration.ring_entries = count;
+    registration.bgid = group;
+    if (ioUringRegister(ring_fd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+        error = std::string("IORING_REGISTER_PBUF_RING: ") + strerror(errno);
+        munmap(buf_ring, buf_ring_size);
+        buf_ring = nullptr;
+        return false;
+    }
+
+    buf_mask = count - 1;
+    buffer_size = size;
+    buffers.reset(new uint8_t[count * size]);
+    for (unsigned i = 0; i < count; ++i) {
+        recycleBuffer(static_cast<uint16_t>(i));
+    }
+    publishBuffers();
+    return true;
+}
+
+io_uring_sqe* IoUring::getSqe() {
+    if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+        submitAndWait(0);
+        if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+            return nullptr;
+        }
+    }
+    io_uring_sqe* sqe = &sqes[sqe_tail & sq_mask];
+    ++sqe_tail;
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+int IoUring::submitAndWait(unsigned wait_nr, uint64_t timeout_ns) {
+    const unsigned to_submit = sqe_tail - submitted;
+    __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+    submitted = sqe_tail;
+
+    // GETEVENTS 总是带上：DEFER_TASKRUN 模式下只有这时才执行推迟的接收工作
+    __kernel_timespec timeout = {};
+    io_uring_getevents_arg arg;
+    std::memset(&arg, 0, sizeof(arg));
+    unsigned flags = IORING_ENTER_GETEVENTS;
+    const void* arg_ptr = nullptr;
+    size_t arg_size = 0;
+    if (timeout_ns > 0) {
+        timeout.tv_sec = static_cast<long long>(timeout_ns / 1000000000ull);
+        timeout.tv_nsec = static_cast<long long>(timeout_ns % 1000000000ull);
+        arg.ts = reinterpret_cast<uint64_t>(&timeout);
+        flags |= IORING_ENTER_EXT_ARG;
+        arg_ptr = &arg;
+        arg_size = sizeof(arg);
+    }
+    ++enter_calls;
+    int result = ioUringEnter(ring_fd, to_submit, wait_nr, flags, arg_ptr, arg_size);
+    return result < 0 ? -errno : result;
+}
+
+void IoUring::recycleBuffer(uint16_t id) {
+    // 只写 addr/len/bid：第0项的 resv 与环的 tail 重叠
+    // 不用 buf_ring->bufs：内核头文件的柔性数组在 C++ 中因空结构体占1字节而偏移到第8字节
+    io_uring_buf* entry = reinterpret_cast<io_uring_buf*>(buf_ring) + (buf_tail & buf_mask);
+    entry->addr = reinterpret_cast<uint64_t>(buffer(id));
+    entry->len = static_cast<uint32_t>(buffer_size);
+    entry->bid = id;
+    ++buf_tail;
+}
+
+void IoUring::publishBuffers() {
+    if (buf_ring) {
+        __atomic_store_n(&buf_ring->tail, buf_tail, __ATOMIC_RELEASE);
+    }
+}
+
+const char* IoUring::modeName() const {
+    if (setup_flags & IORING_SETUP_DEFER_TASKRUN) return "defer-taskrun";
+    if (setup_flags & IORING_SETUP_COOP_TASKRUN) return "coop-taskrun";
+    return "default";
+}
@@ -0,0 +1,260 @@
+#include "IO/ReplaySubscriber.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 最长单次睡眠，保证 stop() 能及时生效
+constexpr auto MAX_SLEEP = std::chrono::milliseconds(100);
+
+} // namespace
+
+ReplaySubscriber::ReplaySubscriber(const std::string& path, const StreamDescriptor& stream, double speed, bool loop)
+    : file_path(path), stream(stream), speed(std::max(speed, 0.0)), loop(loop) {}
+
+ReplaySubscriber::~ReplaySubscriber() {
+    stop();
+}
+
+void ReplaySubscriber::startBatch(BatchCallback cb) {
+    if (running) return;
+    batch_callback = cb;
+    running = true;
+    replay_finished = false;
+    worker = std::thread(&ReplaySubscriber::run, this);
+}
+
+void ReplaySubscriber::stop() {
+    if (!running) return;
+    running = false;
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+SubscriberStats ReplaySubscriber::getStats() const {
+    SubscriberStats stats;
+    stats.packets = packets_received.load(std::memory_order_relaxed);
+    stats.bytes = bytes_received.load(std::memory_order_relaxed);
+    stats.recv_calls = recv_calls.load(std::memory_order_relaxed);
+    stats.batches = batches_delivered.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool ReplaySubscriber::load() {
+    segments.clear();
+    legacy_packets.clear();
+    reader.close();
+
+    StreamDescriptor recorded;
+    if (readRecordingStream(file_path, recorded)) {
+        if (recorded != stream) {
+            std::cerr << "ReplaySubscriber: " << file_path << " was recorded as " << recorded.channel_count
+                      << " channels x " << recorded.samples_per_packet << " samples "
+                      << sampleTypeName(recorded.sample_type) << " @ " << recorded.sample_rate
+                      << " Hz, expected " << stream.channel_count << " x " << stream.samples_per_packet << " "
+                      << sampleTypeName(stream.sample_type) << " @ " << stream.sample_rate << " Hz" << std::endl;
+            return false;
+        }
+        if (!reader.open(file_path)) {
+            return false;
+        }
+        for (size_t chunk = 0; chunk < reader.chunkCount(); ++chunk) {
+            const RecordingIndexEntry& info = reader.chunkInfo(chunk);
+            if (info.packet_count > 0) {
+                segments.push_back({reader.chunkPackets(chunk).data, info.packet_count, info.first_sample, chunk});
+            }
+        }
+    } else if (!loadLegacy()) {
+        return false;
+    }
+
+    if (segments.empty()) {
+        std::cerr << "ReplaySubscriber: " << file_path << " contains no packets" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 旧格式按通道存放，且可能不是8字节对齐：读取时逐段 memcpy，按数据流描述重排为完整的数据包
+bool ReplaySubscriber::loadLegacy() {
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "ReplaySubscriber: open(" << file_path << ") failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        std::cerr << "ReplaySubscriber: " << file_path << " is empty" << std::endl;
+        return false;
+    }
+    const size_t file_size = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "ReplaySubscriber: mmap(" << file_path << ") failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    madvise(mapping, file_size, MADV_SEQUENTIAL);
+    const uint8_t* data = static_cast<const uint8_t*>(mapping);
+
+    // 通道块：[size_t 通道号][size_t 样本数][float32 x 样本数]，通道号从0开始连续
+    std::vector<const uint8_t*> channel_samples;
+    size_t sample_count = SIZE_MAX;
+    size_t offset = 0;
+    bool valid = true;
+    while (offset < file_size) {
+        size_t channel, count;
+        if (file_size - offset < 2 * sizeof(size_t)) {
+            valid = false;
+            break;
+        }
+        std::memcpy(&channel, data + offset, sizeof(channel));
+        std::memcpy(&count, data + offset + sizeof(channel), sizeof(count));
+        offset += 2 * sizeof(size_t);
+        if (channel != channel_samples.size() || count > (file_size - offset) / sizeof(float)) {
+            valid = false;
+            break;
+        }
+        channel_samples.push_back(data + offset);
+        sample_count = std::min(sample_count, count);
+        offset += count * sizeof(float);
+    }
+
+    if (!valid || channel_samples.size() != stream.channel_count || stream.sample_type != SampleType::Float32) {
+        std::cerr << "ReplaySubscriber: " << file_path << " is neither a recording nor a cached_samples.bin file with "
+                  << stream.channel_count << " float32 channels" << std::endl;
+        munmap(mapping, file_size);
+        return false;
+    }
+
+    const size_t spp = stream.samples_per_packet;
+    const size_t packet_count = sample_count / spp;
+    const size_t packet_size = stream.packetSize();
+    legacy_packets.resize(packet_count * packet_size);
+    const size_t header_size = stream.headerSize();
+    for (size_t ch = 0; ch < channel_samples.size(); ++ch) {
+        const uint8_t* src = channel_samples[ch];
+        for (size_t p = 0; p < packet_count; ++p) {
+            uint8_t* packet = legacy_packets.data() + p * packet_size + header_size;
+            if (stream.layout == SampleLayout::ChannelMajor) {
+                std::memcpy(packet + ch * spp * sizeof(float), src + p * spp * sizeof(float), spp * sizeof(float));
+            } else {
+                for (size_t s = 0; s < spp; ++s) {
+                    std::memcpy(packet + (s * stream.channel_count + ch) * sizeof(float),
+                                src + (p * spp + s) * sizeof(float), sizeof(float));
+                }
+            }
+        }
+    }
+    // 旧缓存没有包头：按包的顺序补上序号与样本索引
+    if (stream.packet_header) {
+        for (size_t p = 0; p < packet_count; ++p) {
+            writePacketHeader(legacy_packets.data() + p * packet_size, stream, p, p * spp);
+        }
+    }
+    munmap(mapping, file_size);
+
+    if (packet_count > 0) {
+        segments.push_back({legacy_packets.data(), packet_count, 0, 0});
+    }
+    std::cout << "ReplaySubscriber: " << file_path << " is a legacy sample cache, " << sample_count
+              << " samples per channel" << std::endl;
+    return true;
+}
+
+void ReplaySubscriber::run() {
+    if (!load()) {
+        return;
+    }
+
+    const size_t packet_size = stream.packetSize();
+    const size_t spp = stream.samples_per_packet;
+    const double samples_per_sec = stream.sample_rate * speed;   // 0 表示不限速
+    const uint64_t origin = segments.front().first_sample;
+    const uint64_t span = segments.back().first_sample + segments.back().packet_count * spp - origin;
+
+    uint64_t total_packets = 0;
+    for (const Segment& segment : segments) {
+        total_packets += segment.packet_count;
+    }
+    std::cout << "ReplaySubscriber: replaying " << file_path << " (" << total_packets << " packets, "
+              << span / stream.sample_rate << " s) at ";
+    if (samples_per_sec > 0) {
+        std::cout << speed << "x";
+    } else {
+        std::cout << "maximum speed";
+    }
+    std::cout << (loop ? ", looping" : "") << std::endl;
+
+    // 交付时刻按样本索引相对起点计算；循环回放时 loop_base 累加整个文件的时长，时间轴保持连续
+    uint64_t loop_base = 0;
+    const auto start = Clock::now();
+    while (running) {
+        for (const Segment& segment : segments) {
+            // 样本索引的缺口（录制时丢包）在回放时同样表现为没有数据的时间段
+            const uint64_t segment_base = loop_base + segment.first_sample - origin;
+            const uint8_t* data = segment.data;
+            if (!data) {
+                if (!reader.decodeChunk(segment.chunk, chunk_packets)) {
+                    std::cerr << "ReplaySubscriber: chunk " << segment.chunk << " of " << file_path
+                              << " is corrupt, skipped" << std::endl;
+                    continue;
+                }
+                data = chunk_packets.data();
+            }
+            size_t index = 0;
+            while (index < segment.packet_count && running) {
+                size_t count = std::min(MAX_BATCH_PACKETS, segment.packet_count - index);
+
+                if (samples_per_sec > 0) {
+                    double elapsed_samples =
+                        std::chrono::duration<double>(Clock::now() - start).count() * samples_per_sec;
+                    double due_packets = (elapsed_samples - static_cast<double>(segment_base)) / spp;
+                    if (due_packets < static_cast<double>(index + 1)) {
+                        // 下一个包尚未到期：睡到它最后一个样本的时刻
+                        double due_seconds = (segment_base + (index + 1) * spp) / samples_per_sec;
+                        auto due = start + std::chrono::duration_cast<Clock::duration>(
+                                               std::chrono::duration<double>(due_seconds));
+                        std::this_thread::sleep_until(std::min(due, Clock::now() + MAX_SLEEP));
+                        recv_calls.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    count = std::min(count, static_cast<size_t>(due_packets) - index);
+                }
+
+                PacketBatch batch;
+                batch.data = data + index * packet_size;
+                batch.packet_count = count;
+                batch.packet_size = packet_size;
+                if (batch_callback) {
+                    batch_callback(batch);
+                }
+                packets_received.fetch_add(count, std::memory_order_relaxed);
+                bytes_received.fetch_add(batch.byteSize(), std::memory_order_relaxed);
+                batches_delivered.fetch_add(1, std::memory_order_relaxed);
+                index += count;
+            }
+            if (!running) break;
+        }
+        if (!loop) break;
+        loop_base += span;
+    }
+
+    if (running) {
+        replay_finished = true;
+        std::cout << "ReplaySubscriber: finished " << file_path << std::endl;
+    }
+}
@@ -0,0 +1,132 @@
+#include "IO/ShmRingWriter.h"
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+ShmRingWriter::~ShmRingWriter() {
+    close();
+}
+
+bool ShmRingWriter::open(const std::string& name, const StreamDescriptor& stream, size_t requested_slots) {
+    close();
+
+    if (!stream.isValid()) {
+        std::cerr << "ShmRingWriter: invalid stream descriptor" << std::endl;
+        return false;
+    }
+    const size_t packet_size = stream.packetSize();
+
+    size_t count = 1;
+    while (count < requested_slots) {
+        count <<= 1;
+    }
+
+    // 删除同名旧段：仍映射旧段的接收端会发现名字指向了新段并重新连接
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "shm_open(" << name << ") failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    mapping_size = shmRingMappingSize(count, packet_size);
+    if (ftruncate(fd, static_cast<off_t>(mapping_size)) != 0) {
+        std::cerr << "ftruncate(" << name << ") failed: " << strerror(errno) << std::endl;
+        ::close(fd);
+        fd = -1;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "mmap(" << name << ") failed: " << strerror(errno) << std::endl;
+        mapping = nullptr;
+        ::close(fd);
+        fd = -1;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // ftruncate 得到的内存已清零，原子变量的初始值即为0
+    shm_name = name;
+    slot_size = packet_size;
+    slot_count = count;
+    write_index = 0;
+    cached_read_index = 0;
+    header = static_cast<ShmRingHeader*>(mapping);
+    slots = static_cast<uint8_t*>(mapping) + ShmRingHeader::SLOT_OFFSET;
+
+    header->version = ShmRingHeader::VERSION;
+    header->slot_count = static_cast<uint32_t>(slot_count);
+    header->slot_size = static_cast<uint32_t>(slot_size);
+    header->channel_count = static_cast<uint32_t>(stream.channel_count);
+    header->samples_per_packet = static_cast<uint32_t>(stream.samples_per_packet);
+    header->sample_rate = stream.sample_rate;
+    header->sample_type = static_cast<uint8_t>(stream.sample_type);
+    header->sample_layout = static_cast<uint8_t>(stream.layout);
+    header->packet_header = stream.packet_header ? 1 : 0;
+    header->magic.store(ShmRingHeader::MAGIC, std::memory_order_release);
+    return true;
+}
+
+void ShmRingWriter::close() {
+    if (header) {
+        header->producer_closed.store(1, std::memory_order_release);
+        header->wake_seq.fetch_add(1, std::memory_order_release);
+        shmFutexWake(&header->wake_seq);
+    }
+    if (mapping) {
+        munmap(mapping, mapping_size);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+        shm_unlink(shm_name.c_str());
+    }
+    header = nullptr;
+    slots = nullptr;
+}
+
+uint8_t* ShmRingWriter::acquireSlot() {
+    if (!header) return nullptr;
+
+    if (write_index - cached_read_index >= slot_count) {
+        cached_read_index = header->read_index.load(std::memory_order_acquire);
+        if (write_index - cached_read_index >= slot_count) {
+            header->dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    }
+    return slots + (write_index & (slot_count - 1)) * slot_size;
+}
+
+void ShmRingWriter::commitSlot() {
+    ++write_index;
+
+    // 与接收端的 consumer_waiting/write_index 构成 Dekker 式同步：
+    // 要么接收端睡眠前看到新的 write_index，要么这里看到 consumer_waiting 并唤醒它
+    header->write_index.store(write_index, std::memory_order_seq_cst);
+    if (header->consumer_waiting.load(std::memory_order_seq_cst)) {
+        header->wake_seq.fetch_add(1, std::memory_order_release);
+        shmFutexWake(&header->wake_seq);
+    }
+}
+
+bool ShmRingWriter::write(const void* packet, size_t size) {
+    if (size > slot_size) return false;
+
+    uint8_t* slot = acquireSlot();
+    if (!slot) return false;
+
+    std::memcpy(slot, packet, size);
+    commitSlot();
+    return true;
+}
+
+uint64_t ShmRingWriter::droppedCount() const {
+    return header ? header->dropped.load(std::memory_order_relaxed) : 0;
+}
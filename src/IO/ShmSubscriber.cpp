@@ -0,0 +1,187 @@
+#include "IO/ShmSubscriber.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+ShmSubscriber::ShmSubscriber(const std::string& name, const StreamDescriptor& stream)
+    : shm_name(name), stream(stream) {}
+
+ShmSubscriber::~ShmSubscriber() {
+    stop();
+}
+
+void ShmSubscriber::startBatch(BatchCallback cb) {
+    if (running) return;
+    batch_callback = cb;
+    running = true;
+    worker = std::thread(&ShmSubscriber::run, this);
+}
+
+void ShmSubscriber::stop() {
+    if (!running) return;
+    running = false;
+
+    // 工作线程的 futex 等待最多 100ms 后返回并检查 running
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+SubscriberStats ShmSubscriber::getStats() const {
+    SubscriberStats stats;
+    stats.packets = packets_received.load(std::memory_order_relaxed);
+    stats.bytes = bytes_received.load(std::memory_order_relaxed);
+    stats.recv_calls = recv_calls.load(std::memory_order_relaxed);
+    stats.syscalls = stats.recv_calls;
+    stats.batches = batches_delivered.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool ShmSubscriber::attach(bool& warned) {
+    fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < ShmRingHeader::SLOT_OFFSET) {
+        detach();
+        return false;
+    }
+    mapped_inode = st.st_ino;
+    mapping_size = static_cast<size_t>(st.st_size);
+    mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        detach();
+        return false;
+    }
+    header = static_cast<ShmRingHeader*>(mapping);
+
+    // 发送端尚未初始化完成
+    if (header->magic.load(std::memory_order_acquire) != ShmRingHeader::MAGIC) {
+        detach();
+        return false;
+    }
+
+    // 校验布局与数据流描述
+    const size_t slot_count = header->slot_count;
+    const size_t slot_size = header->slot_size;
+    bool valid = header->version == ShmRingHeader::VERSION &&
+                 slot_count != 0 && (slot_count & (slot_count - 1)) == 0 &&
+                 slot_size == stream.packetSize() && shmRingStream(*header) == stream &&
+                 shmRingMappingSize(slot_count, slot_size) <= mapping_size;
+    if (!valid) {
+        if (!warned) {
+            StreamDescriptor remote = shmRingStream(*header);
+            std::cerr << "ShmSubscriber: incompatible ring " << shm_name << " (version " << header->version
+                      << ", " << remote.channel_count << " channels x " << remote.samples_per_packet
+                      << " samples " << sampleTypeName(remote.sample_type) << " @ " << remote.sample_rate
+                      << " Hz, expected " << stream.channel_count << " x " << stream.samples_per_packet << " "
+                      << sampleTypeName(stream.sample_type) << " @ " << stream.sample_rate << " Hz)" << std::endl;
+            warned = true;
+        }
+        detach();
+        return false;
+    }
+
+    warned = false;
+    std::cout << "ShmSubscriber attached to " << shm_name << " (" << slot_count << " slots)" << std::endl;
+    return true;
+}
+
+void ShmSubscriber::detach() {
+    if (mapping) {
+        munmap(mapping, mapping_size);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+    header = nullptr;
+}
+
+bool ShmSubscriber::isStale() const {
+    int current = shm_open(shm_name.c_str(), O_RDONLY, 0);
+    if (current < 0) {
+        return true;
+    }
+    struct stat st;
+    bool stale = fstat(current, &st) != 0 || st.st_ino != mapped_inode;
+    close(current);
+    return stale;
+}
+
+void ShmSubscriber::run() {
+    std::cout << "ShmSubscriber started, waiting for " << shm_name << std::endl;
+    bool warned = false;
+
+    while (running) {
+        if (!attach(warned)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        const uint64_t slot_count = header->slot_count;
+        const size_t slot_size = header->slot_size;
+        const uint8_t* slots = static_cast<const uint8_t*>(mapping) + ShmRingHeader::SLOT_OFFSET;
+        uint64_t read_index = header->read_index.load(std::memory_order_relaxed);
+
+        while (running) {
+            uint64_t write_index = header->write_index.load(std::memory_order_acquire);
+
+            if (write_index == read_index) {
+                if (header->producer_closed.load(std::memory_order_acquire)) {
+                    std::cout << "ShmSubscriber: producer closed " << shm_name << std::endl;
+                    break;
+                }
+
+                // 先登记等待再复查 write_index，与发送端的 commitSlot() 配对，避免丢失唤醒
+                uint32_t seq = header->wake_seq.load(std::memory_order_acquire);
+                header->consumer_waiting.store(1, std::memory_order_seq_cst);
+                if (header->write_index.load(std::memory_order_seq_cst) == read_index) {
+                    shmFutexWait(&header->wake_seq, seq, 100);
+                    recv_calls.fetch_add(1, std::memory_order_relaxed);
+                }
+                header->consumer_waiting.store(0, std::memory_order_relaxed);
+
+                // 长时间无数据：确认发送端没有换成新的共享内存段
+                if (header->write_index.load(std::memory_order_acquire) == read_index &&
+                    header->wake_seq.load(std::memory_order_relaxed) == seq && isStale()) {
+                    std::cout << "ShmSubscriber: " << shm_name << " was recreated, reattaching" << std::endl;
+                    break;
+                }
+                continue;
+            }
+
+            // 交付到环尾为止的连续槽位：数据包在共享内存中原地交给回调
+            uint64_t position = read_index & (slot_count - 1);
+            size_t packet_count = static_cast<size_t>(
+                std::min<uint64_t>({write_index - read_index, slot_count - position, MAX_BATCH_PACKETS}));
+
+            PacketBatch batch;
+            batch.data = slots + position * slot_size;
+            batch.packet_count = packet_count;
+            batch.packet_size = slot_size;
+            if (batch_callback) {
+                batch_callback(batch);
+            }
+            packets_received.fetch_add(packet_count, std::memory_order_relaxed);
+            bytes_received.fetch_add(batch.byteSize(), std::memory_order_relaxed);
+            batches_delivered.fetch_add(1, std::memory_order_relaxed);
+
+            // 回调返回后归还槽位
+            read_index += packet_count;
+            header->read_index.store(read_index, std::memory_order_release);
+        }
+
+        detach();
+    }
+
+    std::cout << "ShmSubscriber stopped" << std::endl;
+}
@@ -1,52 +1,164 @@
 #include "IO/SocketSubscriber.h"
 #include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <poll.h>
 #include <unistd.h>
+#include <cerrno>
 #include <cstring>
-#include <thread>
-#include <chrono>
+#include <algorithm>
 
-SocketSubscriber::SocketSubscriber(const std::string& host, int port) : host(host), port(port) {}
+namespace {
+
+// Tags for the non-connection descriptors in epoll_event::data.ptr / io_uring user_data
+char listener_tag;
+char wake_tag;
+
+constexpr int MAX_EVENTS = 64;
+constexpr uint16_t BUFFER_GROUP = 0;
+
+} // namespace
+
+const char* socketBackendName(SocketBackend backend) {
+    switch (backend) {
+    case SocketBackend::Epoll: return "epoll";
+    case SocketBackend::IoUring: return "io_uring";
+    }
+    return "unknown";
+}
+
+bool parseSocketBackend(const std::string& text, SocketBackend& backend) {
+    for (SocketBackend candidate : {SocketBackend::Epoll, SocketBackend::IoUring}) {
+        if (text == socketBackendName(candidate)) {
+            backend = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+SocketSubscriber::SocketSubscriber(const std::string& host, int port, const StreamDescriptor& stream,
+                                   size_t max_streams, size_t thread_count, SocketBackend backend)
+    : host(host), port(port), stream(stream),
+      max_streams(std::max<size_t>(max_streams, 1)),
+      thread_count(std::max<size_t>(thread_count, 1)),
+      packet_size(stream.packetSize()),
+      backend(backend) {}
 
 SocketSubscriber::~SocketSubscriber() {
     stop();
 }
 
 void SocketSubscriber::start(BinaryCallback cb) {
+    // Legacy per-packet delivery on top of the batch path
+    auto packet = std::make_shared<std::vector<uint8_t>>();
+    startBatch([cb, packet](const PacketBatch& batch) {
+        for (size_t i = 0; i < batch.packet_count; ++i) {
+            packet->assign(batch.packet(i), batch.packet(i) + batch.packet_size);
+            cb(*packet);
+        }
+    });
+}
+
+void SocketSubscriber::startBatch(BatchCallback cb) {
     if (running) return;
-    binary_callback = cb;
+    batch_callback = cb;
+    if (!openListener()) return;
+
+    // Probe io_uring once up front; kernels without it (or with it disabled) use epoll
+    use_ring = false;
+    if (backend == SocketBackend::IoUring) {
+        IoUring probe;
+        std::string error;
+        use_ring = probe.init(8, error) && probe.registerBufferRing(BUFFER_GROUP, 8, packet_size, error);
+        if (!use_ring) {
+            std::cerr << "io_uring unavailable (" << error << "), falling back to epoll" << std::endl;
+        }
+    }
+
+    stream_busy.assign(max_streams, false);
+    for (size_t i = 0; i < thread_count; ++i) {
+        loops.push_back(std::make_unique<Loop>());
+    }
+
     running = true;
-    worker = std::thread(&SocketSubscriber::run, this);
+    for (auto& loop : loops) {
+        Loop* target = loop.get();
+        // The io_uring is created on its own thread (single issuer); if that fails the thread uses epoll
+        loop->thread = std::thread([this, target] {
+            if (use_ring && runRing(*target)) return;
+            if (watchEpoll(*target)) run(*target);
+        });
+    }
+    std::cout << "SocketSubscriber started, listening on " << host << ":" << port << " (" << max_streams
+              << " stream" << (max_streams > 1 ? "s" : "") << ", " << loops.size() << " "
+              << socketBackendName(use_ring ? SocketBackend::IoUring : SocketBackend::Epoll) << " thread"
+              << (loops.size() > 1 ? "s" : "") << ")" << std::endl;
+}
+
+SubscriberStats SocketSubscriber::getStats() const {
+    SubscriberStats stats;
+    stats.packets = packets_received.load(std::memory_order_relaxed);
+    stats.bytes = bytes_received.load(std::memory_order_relaxed);
+    stats.recv_calls = recv_calls.load(std::memory_order_relaxed);
+    stats.syscalls = syscalls.load(std::memory_order_relaxed);
+    stats.batches = batches_delivered.load(std::memory_order_relaxed);
+    stats.connections = connection_count.load(std::memory_order_relaxed);
+    stats.waiting = waiting_count.load(std::memory_order_relaxed);
+    return stats;
 }
 
 void SocketSubscriber::stop() {
     if (!running) return;
     running = false;
 
-    // Close sockets to unblock the worker thread
-    if (client_socket != -1) {
-        shutdown(client_socket, SHUT_RDWR);
-        close(client_socket);
-        client_socket = -1;
+    // The eventfd stays readable, so every loop wakes up and sees running == false
+    uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) < 0) {
+        std::cerr << "Failed to wake socket threads: " << strerror(errno) << std::endl;
+    }
+    for (auto& loop : loops) {
+        if (loop->thread.joinable()) {
+            loop->thread.join();
+        }
     }
-    if (server_socket != -1) {
+
+    // io_uring's multishot accept holds its own reference to the listener and ring teardown is
+    // asynchronous, so close() alone can leave the port bound; shutdown() stops listening right away
+    if (server_socket >= 0) {
         shutdown(server_socket, SHUT_RDWR);
-        close(server_socket);
-        server_socket = -1;
     }
 
-    if (worker.joinable()) {
-        worker.join();
+    for (auto& loop : loops) {
+        // Tear the ring down first: it cancels the requests that still reference the connections
+        loop->ring.reset();
+        for (auto& connection : loop->connections) {
+            close(connection->fd);
+        }
+        if (loop->epoll_fd >= 0) close(loop->epoll_fd);
     }
+    loops.clear();
+    for (const PendingConnection& pending : waiting) {
+        close(pending.fd);
+    }
+    waiting.clear();
+    connection_count = 0;
+    waiting_count = 0;
+
+    close(server_socket);
+    close(wake_fd);
+    server_socket = wake_fd = -1;
+    std::cout << "SocketSubscriber stopped" << std::endl;
 }
 
-void SocketSubscriber::run() {
-    server_socket = socket(AF_INET, SOCK_STREAM, 0);
+bool SocketSubscriber::openListener() {
+    server_socket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (server_socket == -1) {
         std::cerr << "Failed to create socket" << std::endl;
-        return;
+        return false;
     }
 
     // Allow address reuse
@@ -54,10 +166,11 @@ void SocketSubscriber::run() {
     if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
         std::cerr << "setsockopt(SO_REUSEADDR) failed" << std::endl;
         close(server_socket);
-        return;
+        server_socket = -1;
+        return false;
     }
 
-    sockaddr_in server_addr;
+    sockaddr_in server_addr = {};
     server_addr.sin_family = AF_INET;
     server_addr.sin_port = htons(port);
     server_addr.sin_addr.s_addr = inet_addr(host.c_str());
@@ -65,78 +178,349 @@ void SocketSubscriber::run() {
     if (bind(server_socket, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
         std::cerr << "Failed to bind socket to " << host << ":" << port << " - " << strerror(errno) << std::endl;
         close(server_socket);
-        return;
+        server_socket = -1;
+        return false;
     }
 
-    if (listen(server_socket, 1) < 0) {
+    if (listen(server_socket, SOMAXCONN) < 0) {
         std::cerr << "Failed to listen on socket" << std::endl;
         close(server_socket);
+        server_socket = -1;
+        return false;
+    }
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        std::cerr << "eventfd failed: " << strerror(errno) << std::endl;
+        close(server_socket);
+        server_socket = -1;
+        return false;
+    }
+    return true;
+}
+
+void SocketSubscriber::acceptConnections(Loop& loop) {
+    while (true) {
+        int fd = accept4(server_socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "Failed to accept connection: " << strerror(errno) << std::endl;
+            }
+            return;
+        }
+        admit(loop, fd);
+    }
+}
+
+void SocketSubscriber::admit(Loop& loop, int fd) {
+    sockaddr_in client_addr = {};
+    socklen_t client_len = sizeof(client_addr);
+    getpeername(fd, (struct sockaddr*)&client_addr, &client_len);
+    char client_ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+    std::string peer = std::string(client_ip) + ":" + std::to_string(ntohs(client_addr.sin_port));
+
+    // Larger kernel buffer to absorb bursts while a batch is being processed
+    int rcvbuf = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    // Don't wake up for less than one packet, so reads never return a lone fragment
+    int rcvlowat = static_cast<int>(packet_size);
+    setsockopt(fd, SOL_SOCKET, SO_RCVLOWAT, &rcvlowat, sizeof(rcvlowat));
+
+    std::unique_lock<std::mutex> lock(streams_mutex);
+    auto free_stream = std::find(stream_busy.begin(), stream_busy.end(), false);
+    if (free_stream == stream_busy.end()) {
+        // Not read until a stream frees up; the sender is held back by TCP flow control
+        waiting.push_back({fd, peer});
+        waiting_count = waiting.size();
+        lock.unlock();
+        std::cout << "Client connected from " << peer << ", waiting for a free stream" << std::endl;
         return;
     }
+    *free_stream = true;
+    uint32_t source = static_cast<uint32_t>(free_stream - stream_busy.begin());
+    lock.unlock();
+    attach(loop, fd, peer, source);
+}
 
-    std::cout << "SocketSubscriber started, listening on " << host << ":" << port << std::endl;
+void SocketSubscriber::attach(Loop& loop, int fd, const std::string& peer, uint32_t source) {
+    auto connection = std::make_unique<Connection>();
+    connection->fd = fd;
+    connection->source = source;
+    connection->peer = peer;
 
-    const size_t CHANNEL_COUNT = 128;
-    const size_t SAMPLES_PER_PACKET = 8;
-    const size_t PACKAGE_SIZE = 4 * CHANNEL_COUNT * SAMPLES_PER_PACKET; // 4096 bytes
+    bool watching;
+    if (loop.ring) {
+        // Complete packets are delivered straight from the ring buffers; only a packet split
+        // across two buffers is stitched together here
+        connection->buffer.resize(packet_size);
+        watching = armRecv(loop, *connection);
+    } else {
+        // Receive buffer is a whole number of packets (at least one) so a full read never splits the last one
+        connection->buffer.resize(std::max<size_t>(RECV_BUFFER_SIZE / packet_size, 1) * packet_size);
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.ptr = connection.get();
+        watching = epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+    if (!watching) {
+        std::cerr << "Failed to watch connection from " << peer << ": " << strerror(errno) << std::endl;
+        close(fd);
+        std::lock_guard<std::mutex> lock(streams_mutex);
+        stream_busy[source] = false;
+        return;
+    }
+    loop.connections.push_back(std::move(connection));
+    connection_count.fetch_add(1, std::memory_order_relaxed);
+    std::cout << "Client connected from " << peer << " (stream " << source << ")" << std::endl;
+}
 
+void SocketSubscriber::closeConnection(Loop& loop, Connection* connection) {
+    if (!loop.ring) {
+        epoll_ctl(loop.epoll_fd, EPOLL_CTL_DEL, connection->fd, nullptr);
+    }
+    close(connection->fd);
+    const uint32_t source = connection->source;
+    loop.connections.erase(std::find_if(loop.connections.begin(), loop.connections.end(),
+                                        [connection](const std::unique_ptr<Connection>& c) {
+                                            return c.get() == connection;
+                                        }));
+    connection_count.fetch_sub(1, std::memory_order_relaxed);
+
+    // The oldest waiting sender takes over the stream
+    std::unique_lock<std::mutex> lock(streams_mutex);
+    if (waiting.empty()) {
+        stream_busy[source] = false;
+        return;
+    }
+    PendingConnection pending = waiting.front();
+    waiting.pop_front();
+    waiting_count = waiting.size();
+    lock.unlock();
+    attach(loop, pending.fd, pending.peer, source);
+}
+
+void SocketSubscriber::deliver(Connection& connection, const uint8_t* data, size_t packet_count) {
+    PacketBatch batch;
+    batch.data = data;
+    batch.packet_count = packet_count;
+    batch.packet_size = packet_size;
+    batch.source = connection.source;
+    if (batch_callback) {
+        batch_callback(batch);
+    }
+    packets_received.fetch_add(packet_count, std::memory_order_relaxed);
+    batches_delivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool SocketSubscriber::watchEpoll(Loop& loop) {
+    loop.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop.epoll_fd < 0) {
+        std::cerr << "epoll_create1 failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    // The listener wakes only one loop per connection; the wake eventfd wakes all of them
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLEXCLUSIVE;
+    event.data.ptr = &listener_tag;
+    epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, server_socket, &event);
+    event.events = EPOLLIN;
+    event.data.ptr = &wake_tag;
+    epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+    return true;
+}
+
+void SocketSubscriber::run(Loop& loop) {
+    epoll_event events[MAX_EVENTS];
     while (running) {
-        sockaddr_in client_addr;
-        socklen_t client_len = sizeof(client_addr);
-        client_socket = accept(server_socket, (struct sockaddr*)&client_addr, &client_len);
-
-        if (client_socket < 0) {
-            if (!running) break; // Shutdown requested
-            std::cerr << "Failed to accept connection" << std::endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
+        int count = epoll_wait(loop.epoll_fd, events, MAX_EVENTS, -1);
+        syscalls.fetch_add(1, std::memory_order_relaxed);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+            break;
         }
-
-        char client_ip[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
-        std::cout << "Client connected from " << client_ip << ":" << ntohs(client_addr.sin_port) << std::endl;
-
-        std::vector<uint8_t> buffer(PACKAGE_SIZE);
-        while (running) {
-            ssize_t total_bytes_read = 0;
-            while (total_bytes_read < PACKAGE_SIZE) {
-                ssize_t bytes_read = recv(client_socket, buffer.data() + total_bytes_read, PACKAGE_SIZE - total_bytes_read, 0);
-                if (bytes_read > 0) {
-                    total_bytes_read += bytes_read;
-                } else if (bytes_read == 0) {
-                    // Connection closed by client
-                    std::cout << "Client disconnected." << std::endl;
-                    break;
-                } else {
-                    // Error
-                    if (errno != EWOULDBLOCK && errno != EAGAIN) {
-                        std::cerr << "Recv error: " << strerror(errno) << std::endl;
-                        break;
-                    }
-                    // No data available right now, sleep a bit
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                }
+        for (int i = 0; i < count && running; ++i) {
+            void* tag = events[i].data.ptr;
+            if (tag == &wake_tag) continue;
+            if (tag == &listener_tag) {
+                acceptConnections(loop);
+                continue;
             }
-
-            if (total_bytes_read == PACKAGE_SIZE) {
-                if (binary_callback) {
-                    binary_callback(buffer);
-                }
-            } else {
-                // Connection was closed or an error occurred
-                break;
+            // Level-triggered, one recv per wakeup: busy senders cannot starve the others
+            Connection* connection = static_cast<Connection*>(tag);
+            if (!readConnection(*connection)) {
+                closeConnection(loop, connection);
             }
         }
+    }
+}
+
+bool SocketSubscriber::readConnection(Connection& connection) {
+    // Read as much as is available in one call, deliver every complete packet
+    // in place as one batch and carry the partial tail over to the next read
+    ssize_t bytes_read = recv(connection.fd, connection.buffer.data() + connection.buffered,
+                              connection.buffer.size() - connection.buffered, 0);
+    recv_calls.fetch_add(1, std::memory_order_relaxed);
+    syscalls.fetch_add(1, std::memory_order_relaxed);
+
+    if (bytes_read == 0) {
+        // Connection closed by client
+        std::cout << "Client " << connection.peer << " disconnected (stream " << connection.source << ")"
+                  << std::endl;
+        return false;
+    }
+    if (bytes_read < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) return true;
+        std::cerr << "Recv error from " << connection.peer << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    connection.buffered += static_cast<size_t>(bytes_read);
+    bytes_received.fetch_add(static_cast<uint64_t>(bytes_read), std::memory_order_relaxed);
+
+    size_t packet_count = connection.buffered / packet_size;
+    if (packet_count == 0) return true;
+    deliver(connection, connection.buffer.data(), packet_count);
+
+    size_t consumed = packet_count * packet_size;
+    connection.buffered -= consumed;
+    if (connection.buffered > 0) {
+        std::memmove(connection.buffer.data(), connection.buffer.data() + consumed, connection.buffered);
+    }
+    return true;
+}
+
+bool SocketSubscriber::runRing(Loop& loop) {
+    loop.ring = std::make_unique<IoUring>();
+    IoUring& ring = *loop.ring;
+    std::string error;
+    // Ring buffers hold whole packets so a buffer filled to the brim ends on a packet boundary
+    const size_t buffer_bytes = std::max<size_t>(RING_BUFFER_BYTES / packet_size, 1) * packet_size;
+    if (!ring.init(RING_ENTRIES, error) || !ring.registerBufferRing(BUFFER_GROUP, RING_BUFFERS, buffer_bytes, error) ||
+        !armAccept(loop) || !armWake(loop)) {
+        std::cerr << "io_uring setup failed (" << error << "), falling back to epoll" << std::endl;
+        loop.ring.reset();
+        return false;
+    }
+
+    while (running) {
+        // Submits re-armed requests and sleeps until enough completions pile up or the timeout expires
+        int result = ring.submitAndWait(RING_WAIT_COMPLETIONS, RING_WAIT_TIMEOUT_NS);
+        syscalls.fetch_add(1, std::memory_order_relaxed);
+        if (result < 0 && result != -EINTR && result != -ETIME && result != -EAGAIN && result != -EBUSY) {
+            std::cerr << "io_uring_enter failed: " << strerror(-result) << std::endl;
+            break;
+        }
+        ring.drainCompletions([&](const io_uring_cqe& cqe) {
+            handleCompletion(loop, cqe);
+        });
+        ring.publishBuffers();
+    }
+    return true;
+}
+
+bool SocketSubscriber::armAccept(Loop& loop) {
+    io_uring_sqe* sqe = loop.ring->getSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = server_socket;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = reinterpret_cast<uint64_t>(&listener_tag);
+    return true;
+}
+
+bool SocketSubscriber::armWake(Loop& loop) {
+    io_uring_sqe* sqe = loop.ring->getSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = wake_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = reinterpret_cast<uint64_t>(&wake_tag);
+    return true;
+}
+
+bool SocketSubscriber::armRecv(Loop& loop, Connection& connection) {
+    io_uring_sqe* sqe = loop.ring->getSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = connection.fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->ioprio = connection.multishot ? IORING_RECV_MULTISHOT : 0;
+    sqe->user_data = reinterpret_cast<uint64_t>(&connection);
+    return true;
+}
 
-        if (client_socket != -1) {
-            close(client_socket);
-            client_socket = -1;
+void SocketSubscriber::handleCompletion(Loop& loop, const io_uring_cqe& cqe) {
+    void* tag = reinterpret_cast<void*>(cqe.user_data);
+    const bool more = cqe.flags & IORING_CQE_F_MORE;
+    if (tag == &wake_tag) return;
+    if (tag == &listener_tag) {
+        if (cqe.res >= 0) {
+            admit(loop, cqe.res);
+        } else if (cqe.res != -EAGAIN && cqe.res != -EINTR) {
+            std::cerr << "Failed to accept connection: " << strerror(-cqe.res) << std::endl;
         }
+        if (!more && running) armAccept(loop);
+        return;
     }
 
-    if (server_socket != -1) {
-        close(server_socket);
-        server_socket = -1;
+    Connection& connection = *static_cast<Connection*>(tag);
+    recv_calls.fetch_add(1, std::memory_order_relaxed);
+    if (cqe.res > 0) {
+        const uint16_t id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        consume(connection, loop.ring->buffer(id), static_cast<size_t>(cqe.res));
+        loop.ring->recycleBuffer(id);
+        if (!more && !armRecv(loop, connection)) {
+            std::cerr << "Failed to re-arm receive for " << connection.peer << std::endl;
+        }
+        return;
     }
-    std::cout << "SocketSubscriber stopped" << std::endl;
+    if (more) return;
+
+    if (cqe.res == -ENOBUFS || cqe.res == -EINTR || cqe.res == -EAGAIN) {
+        // All ring buffers were in use; they are returned before the next wait
+        armRecv(loop, connection);
+        return;
+    }
+    if (cqe.res == -EINVAL && connection.multishot) {
+        // Kernel without multishot recv: fall back to one request per read
+        connection.multishot = false;
+        armRecv(loop, connection);
+        return;
+    }
+    if (cqe.res == 0) {
+        // Connection closed by client
+        std::cout << "Client " << connection.peer << " disconnected (stream " << connection.source << ")"
+                  << std::endl;
+    } else {
+        std::cerr << "Recv error from " << connection.peer << ": " << strerror(-cqe.res) << std::endl;
+    }
+    closeConnection(loop, &connection);
+}
+
+void SocketSubscriber::consume(Connection& connection, const uint8_t* data, size_t size) {
+    bytes_received.fetch_add(size, std::memory_order_relaxed);
+
+    // Finish the packet that straddles the previous buffer
+    if (connection.buffered > 0) {
+        size_t take = std::min(packet_size - connection.buffered, size);
+        std::memcpy(connection.buffer.data() + connection.buffered, data, take);
+        connection.buffered += take;
+        data += take;
+        size -= take;
+        if (connection.buffered < packet_size) return;
+        deliver(connection, connection.buffer.data(), 1);
+        connection.buffered = 0;
+    }
+
+    size_t packet_count = size / packet_size;
+    if (packet_count > 0) {
+        deliver(connection, data, packet_count);
+    }
+    connection.buffered = size - packet_count * packet_size;
+    std::memcpy(connection.buffer.data(), data + packet_count * packet_size, connection.buffered);
 }
@@ -0,0 +1,198 @@
+#include "IO/SubscriberFactory.h"
+#include "IO/SocketSubscriber.h"
+#ifdef SENSORMONITOR_HAS_ZMQ
+#include "IO/ZeroMQSubscriber.h"
+#endif
+#ifdef SENSORMONITOR_HAS_SHM
+#include "IO/ShmSubscriber.h"
+#endif
+#ifdef SENSORMONITOR_HAS_UDP
+#include "IO/UdpSubscriber.h"
+#endif
+#include "IO/ReplaySubscriber.h"
+#include "Storage/RecordingReader.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+std::unique_ptr<ISubscriber> createSubscriber(const SubscriberConfig& config) {
+    if (config.transport == "socket") {
+        return std::make_unique<SocketSubscriber>(config.host, config.port, config.stream, config.streams,
+                                                  config.socket_threads, config.socket_backend);
+    }
+    if (config.transport == "udp") {
+#ifdef SENSORMONITOR_HAS_UDP
+        return std::make_unique<UdpSubscriber>(config.host, config.port, config.stream, config.multicast_group,
+                                               config.udp_batch);
+#else
+        std::cerr << "UDP transport is not available in this build" << std::endl;
+        return nullptr;
+#endif
+    }
+    if (config.transport == "zmq") {
+#ifdef SENSORMONITOR_HAS_ZMQ
+        return std::make_unique<ZeroMQSubscriber>(config.endpoint, config.stream);
+#else
+        std::cerr << "ZeroMQ transport is not available in this build" << std::endl;
+        return nullptr;
+#endif
+    }
+    if (config.transport == "shm") {
+#ifdef SENSORMONITOR_HAS_SHM
+        return std::make_unique<ShmSubscriber>(config.shm_name, config.stream);
+#else
+        std::cerr << "Shared-memory transport is not available in this build" << std::endl;
+        return nullptr;
+#endif
+    }
+    if (config.transport == "replay") {
+        return std::make_unique<ReplaySubscriber>(config.replay_path, config.stream, config.replay_speed,
+                                                  config.replay_loop);
+    }
+    std::cerr << "Unknown transport: " << config.transport << std::endl;
+    return nullptr;
+}
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --transport <socket|udp|zmq|shm|replay>\n"
+              << "                                data transport (default: socket)\n"
+              << "  --host <address>              socket/udp: listen address, udp multicast: interface address\n"
+              << "                                (default: 127.0.0.1)\n"
+              << "  --port <port>                 socket/udp: listen port (default: 5555)\n"
+              << "  --streams <n>                 socket: concurrent senders, each shown as its own stream (default: 1)\n"
+              << "  --socket-threads <n>          socket: receive threads (default: 1)\n"
+              << "  --socket-backend <backend>    socket: epoll | io_uring, io_uring falls back to epoll when\n"
+              << "                                the kernel lacks it (default: epoll)\n"
+              << "  --multicast-group <address>   udp: join this multicast group\n"
+              << "  --udp-batch <n>               udp: datagrams per recvmmsg call (default: 64)\n"
+              << "  --endpoint <endpoint>         zmq: bind endpoint (default: tcp://*:5555)\n"
+              << "  --shm-name <name>             shm: shared-memory ring name (default: /sensormonitor)\n"
+              << "  --replay-file <file>          replay: recording or cached_samples.bin to play back\n"
+              << "  --replay-speed <x>            replay: speed multiplier, 0 = as fast as possible (default: 1)\n"
+              << "  --replay-loop                 replay: restart from the beginning at the end of the file\n"
+              << "  --record <file>               record received packets to a chunked recording file\n"
+              << "  --record-codec <codec>        raw | xor-bytes | gorilla | shuffle-rle (default: shuffle-rle)\n"
+              << "  --history-dir <dir>           spill history older than the in-memory window to <dir>\n"
+              << "  --history-max-mb <n>          size limit of the history spill file (default: 8192)\n"
+              << "  --history-codec <codec>       compression of spilled history (default: shuffle-rle)\n"
+              << "  --queue-slots <n>             packet queue between receive and processing threads, in slots of\n"
+              << "                                " << PacketQueue::SLOT_PACKETS << " packets; 0 processes on the receive thread (default: "
+              << PacketQueue::DEFAULT_SLOTS << ")\n"
+              << "  --queue-policy <policy>       block | drop-oldest | drop-newest when the queue is full (default: block)\n"
+              << "  --channels <n>                channels per packet (default: 128)\n"
+              << "  --samples-per-packet <n>      samples per channel per packet (default: 8)\n"
+              << "  --sample-rate <hz>            sample rate in Hz (default: 22500)\n"
+              << "  --sample-type <type>          float32 | int16 | int24 (default: float32)\n"
+              << "  --layout <layout>             channel-major | interleaved (default: channel-major)\n"
+              << "  --packet-header               packets start with a sequence header (default: headerless)\n";
+}
+
+bool parseSubscriberArgs(int argc, char** argv, SubscriberConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--replay-loop") == 0) {
+            config.replay_loop = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--packet-header") == 0) {
+            config.stream.packet_header = true;
+            continue;
+        }
+
+        if (std::strcmp(arg, "--transport") == 0 && value) {
+            config.transport = value;
+        } else if (std::strcmp(arg, "--host") == 0 && value) {
+            config.host = value;
+        } else if (std::strcmp(arg, "--port") == 0 && value) {
+            config.port = std::atoi(value);
+        } else if (std::strcmp(arg, "--endpoint") == 0 && value) {
+            config.endpoint = value;
+        } else if (std::strcmp(arg, "--shm-name") == 0 && value) {
+            config.shm_name = value;
+        } else if (std::strcmp(arg, "--replay-file") == 0 && value) {
+            config.replay_path = value;
+        } else if (std::strcmp(arg, "--replay-speed") == 0 && value) {
+            config.replay_speed = std::atof(value);
+        } else if (std::strcmp(arg, "--record") == 0 && value) {
+            config.record_path = value;
+        } else if (std::strcmp(arg, "--history-dir") == 0 && value) {
+            config.history_dir = value;
+        } else if (std::strcmp(arg, "--history-max-mb") == 0 && value) {
+            config.history_max_mb = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--record-codec") == 0 && value) {
+            if (!parseChunkCodec(value, config.record_codec)) {
+                std::cerr << "Unknown codec: " << value << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--history-codec") == 0 && value) {
+            if (!parseChunkCodec(value, config.history_codec)) {
+                std::cerr << "Unknown codec: " << value << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--streams") == 0 && value) {
+            config.streams = std::max<size_t>(std::strtoul(value, nullptr, 10), 1);
+        } else if (std::strcmp(arg, "--socket-threads") == 0 && value) {
+            config.socket_threads = std::max<size_t>(std::strtoul(value, nullptr, 10), 1);
+        } else if (std::strcmp(arg, "--socket-backend") == 0 && value) {
+            if (!parseSocketBackend(value, config.socket_backend)) {
+                std::cerr << "Unknown socket backend: " << value << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--multicast-group") == 0 && value) {
+            config.multicast_group = value;
+        } else if (std::strcmp(arg, "--udp-batch") == 0 && value) {
+            config.udp_batch = std::max<size_t>(std::strtoul(value, nullptr, 10), 1);
+        } else if (std::strcmp(arg, "--queue-slots") == 0 && value) {
+            config.queue_slots = std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--queue-policy") == 0 && value) {
+            if (!parseOverflowPolicy(value, config.queue_policy)) {
+                std::cerr << "Unknown queue policy: " << value << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--channels") == 0 && value) {
+            config.stream.channel_count = std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--samples-per-packet") == 0 && value) {
+            config.stream.samples_per_packet = std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--sample-rate") == 0 && value) {
+            config.stream.sample_rate = std::atof(value);
+        } else if (std::strcmp(arg, "--sample-type") == 0 && value) {
+            if (!parseSampleType(value, config.stream.sample_type)) {
+                std::cerr << "Unknown sample type: " << value << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--layout") == 0 && value) {
+            if (!parseSampleLayout(value, config.stream.layout)) {
+                std::cerr << "Unknown sample layout: " << value << std::endl;
+                return false;
+            }
+        } else {
+            printUsage(argv[0]);
+            return false;
+        }
+        ++i;
+    }
+
+    if (config.transport == "replay") {
+        if (config.replay_path.empty()) {
+            std::cerr << "--transport replay requires --replay-file" << std::endl;
+            return false;
+        }
+        // 录制文件头带有数据流描述，覆盖命令行中的格式参数；旧格式仍按命令行解析
+        StreamDescriptor recorded;
+        if (readRecordingStream(config.replay_path, recorded)) {
+            config.stream = recorded;
+        }
+    }
+
+    if (!config.stream.isValid()) {
+        std::cerr << "Invalid stream geometry: " << config.stream.channel_count << " channels, "
+                  << config.stream.samples_per_packet << " samples/packet, "
+                  << config.stream.sample_rate << " Hz" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,243 @@
+#include "IO/UdpSubscriber.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t CONTROL_SIZE = CMSG_SPACE(sizeof(uint32_t));
+
+} // namespace
+
+UdpSubscriber::UdpSubscriber(const std::string& host, int port, const StreamDescriptor& stream,
+                             const std::string& group, size_t batch_packets)
+    : host(host), port(port), stream(stream), group(group),
+      batch_packets(std::max<size_t>(batch_packets, 1)), packet_size(stream.packetSize()) {}
+
+UdpSubscriber::~UdpSubscriber() {
+    stop();
+}
+
+void UdpSubscriber::startBatch(BatchCallback cb) {
+    if (running) return;
+    batch_callback = cb;
+    if (!openSocket()) return;
+
+    // 每个消息的 iovec 指向接收缓冲中对应的包位置（重排窗口之后），数据报直接落在整批交付的位置上
+    buffer.assign((REORDER_WINDOW + batch_packets) * packet_size, 0);
+    sorted.assign((REORDER_WINDOW + batch_packets) * packet_size, 0);
+    held_count = 0;
+    iovecs.assign(batch_packets, iovec());
+    messages.assign(batch_packets, mmsghdr());
+    controls.assign(batch_packets * CONTROL_SIZE, 0);
+    order.reserve(REORDER_WINDOW + batch_packets);
+    for (size_t i = 0; i < batch_packets; ++i) {
+        iovecs[i].iov_base = buffer.data() + (REORDER_WINDOW + i) * packet_size;
+        iovecs[i].iov_len = packet_size;
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_control = controls.data() + i * CONTROL_SIZE;
+        messages[i].msg_hdr.msg_controllen = CONTROL_SIZE;
+    }
+
+    running = true;
+    worker = std::thread(&UdpSubscriber::run, this);
+}
+
+void UdpSubscriber::stop() {
+    if (!running) return;
+    running = false;
+
+    // 接收等待最多 100ms 后返回并检查 running
+    if (worker.joinable()) {
+        worker.join();
+    }
+    close(sock);
+    sock = -1;
+    std::cout << "UdpSubscriber stopped" << std::endl;
+}
+
+SubscriberStats UdpSubscriber::getStats() const {
+    SubscriberStats stats;
+    stats.packets = packets_received.load(std::memory_order_relaxed);
+    stats.bytes = bytes_received.load(std::memory_order_relaxed);
+    stats.recv_calls = recv_calls.load(std::memory_order_relaxed);
+    stats.syscalls = stats.recv_calls;
+    stats.batches = batches_delivered.load(std::memory_order_relaxed);
+    stats.dropped = kernel_drops.load(std::memory_order_relaxed);
+    stats.invalid = invalid_datagrams.load(std::memory_order_relaxed);
+    stats.reordered = reordered_packets.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool UdpSubscriber::openSocket() {
+    sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        std::cerr << "Failed to create UDP socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 组播时允许同机多个接收端绑定同一端口
+    int opt = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    // 内核缓冲决定接收线程短暂停顿时能吸收多少数据报（受 net.core.rmem_max 限制）
+    int rcvbuf = RECV_BUFFER_BYTES;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    socklen_t rcvbuf_len = sizeof(rcvbuf);
+    getsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, &rcvbuf_len);
+    // 每个数据报附带内核因缓冲溢出丢弃的累计数
+    setsockopt(sock, SOL_SOCKET, SO_RXQ_OVFL, &opt, sizeof(opt));
+    timeval timeout = {0, 100 * 1000};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    // 组播绑定到组地址，只接收该组的数据报
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr(group.empty() ? host.c_str() : group.c_str());
+    if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "Failed to bind UDP socket to " << (group.empty() ? host : group) << ":" << port << " - "
+                  << strerror(errno) << std::endl;
+        close(sock);
+        sock = -1;
+        return false;
+    }
+
+    if (!group.empty()) {
+        ip_mreq membership = {};
+        membership.imr_multiaddr.s_addr = inet_addr(group.c_str());
+        membership.imr_interface.s_addr = inet_addr(host.c_str());
+        if (!IN_MULTICAST(ntohl(membership.imr_multiaddr.s_addr)) ||
+            setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+            std::cerr << "Failed to join multicast group " << group << " on " << host << " - " << strerror(errno)
+                      << std::endl;
+            close(sock);
+            sock = -1;
+            return false;
+        }
+    }
+
+    if (!stream.packet_header) {
+        std::cerr << "UdpSubscriber: stream has no packet header, lost and reordered datagrams cannot be detected"
+                  << std::endl;
+    }
+    std::cout << "UdpSubscriber started, listening on " << (group.empty() ? host : group + " via " + host) << ":"
+              << port << " (" << batch_packets << " datagrams/recvmmsg, " << rcvbuf / 1024 << " KB receive buffer)"
+              << std::endl;
+    return true;
+}
+
+void UdpSubscriber::run() {
+    uint8_t* received = buffer.data() + REORDER_WINDOW * packet_size;
+    uint32_t last_drops = 0;
+    while (running) {
+        int count = recvmmsg(sock, messages.data(), static_cast<unsigned int>(batch_packets), MSG_WAITFORONE,
+                             nullptr);
+        recv_calls.fetch_add(1, std::memory_order_relaxed);
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                // 100ms 没有新的包：窗口中的包不会再等到排在它们之前的包
+                flushHeld();
+                continue;
+            }
+            std::cerr << "recvmmsg error: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        // 去掉长度不对的数据报，其余的包在缓冲中前移保持连续
+        size_t valid = 0;
+        uint64_t bytes = 0;
+        for (int i = 0; i < count; ++i) {
+            msghdr& header = messages[i].msg_hdr;
+            for (cmsghdr* control = CMSG_FIRSTHDR(&header); control; control = CMSG_NXTHDR(&header, control)) {
+                if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SO_RXQ_OVFL) {
+                    std::memcpy(&last_drops, CMSG_DATA(control), sizeof(last_drops));
+                }
+            }
+            bytes += messages[i].msg_len;
+            const bool complete = messages[i].msg_len == packet_size && !(header.msg_flags & MSG_TRUNC);
+            header.msg_controllen = CONTROL_SIZE;
+            if (!complete) {
+                invalid_datagrams.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (valid != static_cast<size_t>(i)) {
+                std::memmove(received + valid * packet_size, received + i * packet_size, packet_size);
+            }
+            ++valid;
+        }
+        kernel_drops.store(last_drops, std::memory_order_relaxed);
+        bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+        if (valid == 0) continue;
+        packets_received.fetch_add(valid, std::memory_order_relaxed);
+
+        // 窗口中留下的包紧挨在接收位置之前，与本批一起排序
+        const size_t total = held_count + valid;
+        size_t keep = 0;
+        const uint8_t* data = reorder(received - held_count * packet_size, total, keep);
+        if (total > keep) {
+            deliver(data, total - keep);
+        }
+        // 序号最大的 keep 个包移到接收位置之前，等下一批（可能与源位置重叠）
+        std::memmove(received - keep * packet_size, data + (total - keep) * packet_size, keep * packet_size);
+        held_count = keep;
+    }
+    flushHeld();
+}
+
+void UdpSubscriber::deliver(const uint8_t* data, size_t count) {
+    PacketBatch batch;
+    batch.data = data;
+    batch.packet_count = count;
+    batch.packet_size = packet_size;
+    if (batch_callback) {
+        batch_callback(batch);
+    }
+    batches_delivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void UdpSubscriber::flushHeld() {
+    if (held_count == 0) return;
+    deliver(buffer.data() + (REORDER_WINDOW - held_count) * packet_size, held_count);
+    held_count = 0;
+}
+
+const uint8_t* UdpSubscriber::reorder(const uint8_t* packets, size_t count, size_t& keep) {
+    keep = 0;
+    if (!stream.packet_header) return packets;
+
+    // 包头无效的包沿用前一个包的序号，留在原处由 DataManager 计数丢弃
+    order.clear();
+    bool in_order = true;
+    uint64_t previous = 0;
+    for (size_t i = 0; i < count; ++i) {
+        PacketHeader header;
+        uint64_t sequence = readPacketHeader(packets + i * packet_size, stream, header) ? header.sequence : previous;
+        if (i > 0 && sequence < previous) {
+            // 后退超过窗口加一批的长度不是乱序，而是发送端重启：全部按到达顺序交付，交给 DataManager 重新对齐
+            if (previous - sequence >= count) return packets;
+            in_order = false;
+        }
+        order.emplace_back(sequence, static_cast<uint32_t>(i));
+        previous = sequence;
+    }
+    keep = std::min(count, REORDER_WINDOW);
+    if (in_order) return packets;
+
+    std::stable_sort(order.begin(), order.end(),
+                     [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b) {
+                         return a.first < b.first;
+                     });
+    uint64_t moved = 0;
+    for (size_t i = 0; i < count; ++i) {
+        std::memcpy(sorted.data() + i * packet_size, packets + order[i].second * packet_size, packet_size);
+        moved += order[i].second != i;
+    }
+    reordered_packets.fetch_add(moved, std::memory_order_relaxed);
+    return sorted.data();
+}
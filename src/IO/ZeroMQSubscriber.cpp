@@ -2,24 +2,45 @@
 #include "IO/ZeroMQSubscriber.h"
 #include <zmq.h>
 #include <iostream>
-#include <thread>
-#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <memory>
 
-ZeroMQSubscriber::ZeroMQSubscriber(const std::string& endpoint) : endpoint(endpoint) {}
+ZeroMQSubscriber::ZeroMQSubscriber(const std::string& endpoint, const StreamDescriptor& stream)
+    : endpoint(endpoint), stream(stream) {}
 
 ZeroMQSubscriber::~ZeroMQSubscriber() {
     stop();
 }
 
-// 新增：二进制数据模式启动
+// 二进制数据模式启动（逐包回调，基于批量接收路径）
 void ZeroMQSubscriber::start(BinaryCallback cb) {
+    auto packet = std::make_shared<std::vector<uint8_t>>();
+    startBatch([cb, packet](const PacketBatch& batch) {
+        for (size_t i = 0; i < batch.packet_count; ++i) {
+            packet->assign(batch.packet(i), batch.packet(i) + batch.packet_size);
+            cb(*packet);
+        }
+    });
+}
+
+void ZeroMQSubscriber::startBatch(BatchCallback cb) {
     if (running) return;
-    binary_callback = cb;
+    batch_callback = cb;
     use_binary_mode = true;
     running = true;
     worker = std::thread(&ZeroMQSubscriber::run, this);
 }
 
+SubscriberStats ZeroMQSubscriber::getStats() const {
+    SubscriberStats stats;
+    stats.packets = packets_received.load(std::memory_order_relaxed);
+    stats.bytes = bytes_received.load(std::memory_order_relaxed);
+    stats.recv_calls = recv_calls.load(std::memory_order_relaxed);
+    stats.batches = batches_delivered.load(std::memory_order_relaxed);
+    return stats;
+}
+
 // 保留原有的字符串模式（向后兼容）
 void ZeroMQSubscriber::startString(StringCallback cb) {
     if (running) return;
@@ -36,6 +57,8 @@ void ZeroMQSubscriber::stop() {
 }
 
 // 二进制数据接收模式 - 使用C API以获得更好的控制
+// zmq_poll 阻塞等待（超时只用于检查停止标志），每次唤醒取空队列中的所有消息，
+// 按 MAX_BATCH_PACKETS 合并到预分配的批量缓冲后一次交付
 void ZeroMQSubscriber::run() {
     void* context = zmq_ctx_new();
     if (!context) {
@@ -50,9 +73,11 @@ void ZeroMQSubscriber::run() {
         return;
     }
     
-    // 设置接收超时
-    int timeout = 100; // 100ms
-    zmq_setsockopt(receiver, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+    // 接收高水位线：允许短时间的处理停顿而不阻塞发送端
+    int hwm = 10000;
+    zmq_setsockopt(receiver, ZMQ_RCVHWM, &hwm, sizeof(hwm));
+    int linger = 0;
+    zmq_setsockopt(receiver, ZMQ_LINGER, &linger, sizeof(linger));
     
     // 绑定到端点（与main.cpp一致）
     if (zmq_bind(receiver, endpoint.c_str()) != 0) {
@@ -62,37 +87,69 @@ void ZeroMQSubscriber::run() {
         return;
     }
 
-    // 数据包大小常量（与main.cpp和DataManager一致）
-    const size_t CHANNEL_COUNT = 128;
-    const size_t SAMPLES_PER_PACKET = 8;
-    const size_t PACKAGE_SIZE = 4 * CHANNEL_COUNT * SAMPLES_PER_PACKET; // 4096字节
+    // 数据包大小由数据流描述决定（与发送端和DataManager一致）
+    const size_t PACKAGE_SIZE = stream.packetSize();
+    
+    // 批量缓冲池：启动时分配一次，运行期间复用
+    std::vector<uint8_t> batch_buffer(MAX_BATCH_PACKETS * PACKAGE_SIZE);
+    zmq_msg_t message;
+    zmq_msg_init(&message);
     
     std::cout << "ZeroMQSubscriber started in binary mode, listening on " << endpoint << std::endl;
 
+    const long POLL_TIMEOUT_MS = 100;
+    zmq_pollitem_t items[] = {{receiver, 0, ZMQ_POLLIN, 0}};
+
     while (running) {
-        std::vector<uint8_t> buffer(PACKAGE_SIZE);
-        int recv_size = zmq_recv(receiver, buffer.data(), buffer.size(), ZMQ_DONTWAIT);
+        int ready = zmq_poll(items, 1, POLL_TIMEOUT_MS);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "ZMQ poll error: " << zmq_strerror(errno) << std::endl;
+            break;
+        }
+        if (ready == 0 || !(items[0].revents & ZMQ_POLLIN)) {
+            continue;
+        }
         
-        if (recv_size > 0) {
-            // 检查数据包大小
-            if (recv_size == static_cast<int>(PACKAGE_SIZE)) {
-                buffer.resize(recv_size); // 确保大小正确
-                if (binary_callback) {
-                    binary_callback(buffer);
+        // 取空当前队列：消息由 zmq_msg_t 接收（不经过中间缓冲），
+        // 再拷贝进批量缓冲中对应的槽位，凑满一批或队列为空时交付
+        size_t batch_count = 0;
+        bool drained = false;
+        while (!drained && running) {
+            int recv_size = zmq_msg_recv(&message, receiver, ZMQ_DONTWAIT);
+            recv_calls.fetch_add(1, std::memory_order_relaxed);
+            
+            if (recv_size < 0) {
+                if (errno != EAGAIN && errno != EINTR) {
+                    std::cerr << "ZMQ recv error: " << zmq_strerror(errno) << std::endl;
                 }
-            } else {
+                drained = true;
+            } else if (recv_size != static_cast<int>(PACKAGE_SIZE)) {
+                // 检查数据包大小
                 std::cerr << "Received unexpected packet size: " << recv_size 
                           << " (expected " << PACKAGE_SIZE << ")" << std::endl;
+            } else {
+                std::memcpy(batch_buffer.data() + batch_count * PACKAGE_SIZE, zmq_msg_data(&message), PACKAGE_SIZE);
+                bytes_received.fetch_add(PACKAGE_SIZE, std::memory_order_relaxed);
+                ++batch_count;
+            }
+            
+            if (batch_count > 0 && (batch_count == MAX_BATCH_PACKETS || drained)) {
+                PacketBatch batch;
+                batch.data = batch_buffer.data();
+                batch.packet_count = batch_count;
+                batch.packet_size = PACKAGE_SIZE;
+                if (batch_callback) {
+                    batch_callback(batch);
+                }
+                packets_received.fetch_add(batch_count, std::memory_order_relaxed);
+                batches_delivered.fetch_add(1, std::memory_order_relaxed);
+                batch_count = 0;
             }
-        } else if (recv_size == -1 && errno != EAGAIN) {
-            // 只有非超时错误才输出
-            std::cerr << "ZMQ recv error: " << zmq_strerror(errno) << std::endl;
         }
-        
-        // 让出CPU时间
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
     
+    zmq_msg_close(&message);
     zmq_close(receiver);
     zmq_ctx_destroy(context);
     std::cout << "ZeroMQSubscriber stopped" << std::endl;
@@ -123,19 +180,23 @@ void ZeroMQSubscriber::runString() {
         return;
     }
 
+    zmq_pollitem_t items[] = {{socket, 0, ZMQ_POLLIN, 0}};
     while (running) {
-        char buffer[1024];
-        int recv_size = zmq_recv(socket, buffer, sizeof(buffer) - 1, ZMQ_DONTWAIT);
+        // 阻塞等待消息，超时只用于检查停止标志
+        if (zmq_poll(items, 1, 100) <= 0) {
+            continue;
+        }
         
-        if (recv_size > 0) {
+        char buffer[1024];
+        int recv_size;
+        while ((recv_size = zmq_recv(socket, buffer, sizeof(buffer) - 1, ZMQ_DONTWAIT)) > 0) {
+            recv_size = std::min(recv_size, static_cast<int>(sizeof(buffer) - 1));
             buffer[recv_size] = '\0'; // null terminate
             std::string json(buffer);
             if (string_callback) {
                 string_callback(json);
             }
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
     
     zmq_close(socket);
@@ -0,0 +1,378 @@
+#include "Storage/Recorder.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+int64_t systemTimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+RecordingChunkHeader* chunkHeader(uint8_t* buffer) {
+    return reinterpret_cast<RecordingChunkHeader*>(buffer);
+}
+
+} // namespace
+
+Recorder::~Recorder() {
+    close();
+}
+
+bool Recorder::open(const std::string& path, const StreamDescriptor& stream, size_t requested_chunk_size,
+                    size_t buffer_count, ChunkCodec codec) {
+    close();
+
+    if (!stream.isValid()) {
+        std::cerr << "Recorder: invalid stream descriptor" << std::endl;
+        return false;
+    }
+    this->stream = stream;
+    packet_size = stream.packetSize();
+    chunk_size = std::max(RecordingFormat::alignUp(requested_chunk_size), recordingMinChunkSize(packet_size));
+    packets_per_chunk = (chunk_size - RecordingFormat::CHUNK_HEADER_SIZE) / packet_size;
+    buffer_count = std::max<size_t>(buffer_count, 2);
+    if (codec != ChunkCodec::Raw && !recordingCodecSupported(stream)) {
+        std::cerr << "Recorder: " << chunkCodecName(codec) << " compression needs float32 samples, recording "
+                  << sampleTypeName(stream.sample_type) << " uncompressed" << std::endl;
+        codec = ChunkCodec::Raw;
+    }
+    chunk_codec = codec;
+
+    // 优先绕过页缓存：录制数据不会很快被读回，避免长时间录制把页缓存挤满；文件系统不支持时退回普通写入
+    direct_io = false;
+#ifdef O_DIRECT
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    direct_io = fd >= 0;
+#endif
+    if (fd < 0) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    if (fd < 0) {
+        std::cerr << "Recorder: open(" << path << ") failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    file_path = path;
+
+    // 一次性分配并预先触碰所有块缓冲，录制过程中不再分配内存或触发缺页
+    for (size_t i = 0; i < buffer_count; ++i) {
+        uint8_t* buffer = static_cast<uint8_t*>(std::aligned_alloc(RecordingFormat::ALIGNMENT, chunk_size));
+        if (!buffer) {
+            std::cerr << "Recorder: failed to allocate " << buffer_count << " x " << chunk_size
+                      << " bytes of chunk buffers" << std::endl;
+            releaseBuffers();
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        std::memset(buffer, 0, chunk_size);
+        buffers.push_back(buffer);
+    }
+    free_buffers = buffers;
+
+    if (codec != ChunkCodec::Raw) {
+        encoder = std::make_unique<RecordingChunkEncoder>(stream, packets_per_chunk, codec);
+        size_t encoded_size = RecordingFormat::alignUp(RecordingFormat::CHUNK_HEADER_SIZE + encoder->maxPayloadSize());
+        encoded_chunk = static_cast<uint8_t*>(std::aligned_alloc(RecordingFormat::ALIGNMENT, encoded_size));
+        if (!encoded_chunk) {
+            std::cerr << "Recorder: failed to allocate the compression buffer" << std::endl;
+            releaseBuffers();
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        std::memset(encoded_chunk, 0, encoded_size);
+    }
+
+    // 文件头占第一页，借用一个块缓冲写出
+    uint8_t* page = free_buffers.back();
+    RecordingFileHeader header = {};
+    header.magic = RecordingFormat::FILE_MAGIC;
+    header.version = RecordingFormat::VERSION;
+    header.chunk_size = static_cast<uint32_t>(chunk_size);
+    header.packets_per_chunk = static_cast<uint32_t>(packets_per_chunk);
+    header.packet_size = static_cast<uint32_t>(packet_size);
+    header.channel_count = static_cast<uint32_t>(stream.channel_count);
+    header.samples_per_packet = static_cast<uint32_t>(stream.samples_per_packet);
+    header.sample_type = static_cast<uint8_t>(stream.sample_type);
+    header.sample_layout = static_cast<uint8_t>(stream.layout);
+    header.codec = static_cast<uint8_t>(codec);
+    header.flags = stream.packet_header ? RecordingFormat::FLAG_PACKET_HEADER : 0;
+    header.sample_rate = stream.sample_rate;
+    header.start_time_ns = systemTimeNs();
+    std::memcpy(page, &header, sizeof(header));
+    bool written = writeAligned(page, RecordingFormat::HEADER_SIZE, 0);
+    std::memset(page, 0, sizeof(header));
+    if (!written) {
+        std::cerr << "Recorder: failed to write header of " << path << ": " << strerror(errno) << std::endl;
+        releaseBuffers();
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    current = nullptr;
+    current_packets = 0;
+    next_chunk_index = 0;
+    next_sample = 0;
+    write_offset = RecordingFormat::HEADER_SIZE;
+    index.clear();
+    packets_recorded = 0;
+    packets_dropped = 0;
+    chunks_written = 0;
+    bytes_written = 0;
+    packet_bytes = 0;
+    pending_peak = 0;
+    write_failed = false;
+    stopping = false;
+    writer = std::thread(&Recorder::run, this);
+
+    std::cout << "Recorder: writing " << path << " (" << chunk_size / 1024 << " KB chunks, "
+              << packets_per_chunk << " packets/chunk, " << buffer_count << " buffers, "
+              << chunkCodecName(codec) << (direct_io ? ", O_DIRECT" : "") << ")" << std::endl;
+    return true;
+}
+
+void Recorder::close() {
+    if (fd < 0) return;
+
+    // 未满的块也按整块写出，块头记录实际包数
+    if (current && current_packets > 0) {
+        sealChunk();
+    } else if (current) {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        free_buffers.push_back(current);
+        current = nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+
+    writeIndex();
+    fsync(fd);
+    ::close(fd);
+    fd = -1;
+    releaseBuffers();
+
+    std::cout << "Recorder: closed " << file_path << " (" << packets_recorded.load() << " packets in "
+              << chunks_written.load() << " chunks, " << packets_dropped.load() << " dropped)" << std::endl;
+}
+
+void Recorder::append(const PacketBatch& batch) {
+    if (fd < 0 || batch.packet_count == 0) return;
+    if (batch.packet_size != packet_size) {
+        packets_dropped.fetch_add(batch.packet_count, std::memory_order_relaxed);
+        return;
+    }
+
+    const int64_t now = systemTimeNs();
+    size_t offset = 0;
+    while (offset < batch.packet_count) {
+        if (!current) {
+            current = acquireBuffer();
+            if (!current) {
+                // 缓冲池耗尽：丢弃剩余的包，样本索引照常推进，读取端可据此看到缺口
+                size_t remaining = batch.packet_count - offset;
+                next_sample += remaining * stream.samples_per_packet;
+                packets_dropped.fetch_add(remaining, std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        RecordingChunkHeader* header = chunkHeader(current);
+        if (current_packets == 0) {
+            header->first_sample = next_sample;
+            header->first_timestamp_ns = now;
+        }
+        header->last_timestamp_ns = now;
+
+        size_t count = std::min(batch.packet_count - offset, packets_per_chunk - current_packets);
+        std::memcpy(current + RecordingFormat::CHUNK_HEADER_SIZE + current_packets * packet_size,
+                    batch.packet(offset), count * packet_size);
+        current_packets += count;
+        offset += count;
+        next_sample += count * stream.samples_per_packet;
+        packets_recorded.fetch_add(count, std::memory_order_relaxed);
+
+        if (current_packets == packets_per_chunk) {
+            sealChunk();
+        }
+    }
+}
+
+RecorderStats Recorder::getStats() const {
+    RecorderStats stats;
+    stats.packets = packets_recorded.load(std::memory_order_relaxed);
+    stats.dropped_packets = packets_dropped.load(std::memory_order_relaxed);
+    stats.chunks_written = chunks_written.load(std::memory_order_relaxed);
+    stats.bytes_written = bytes_written.load(std::memory_order_relaxed);
+    stats.packet_bytes = packet_bytes.load(std::memory_order_relaxed);
+    stats.buffers_peak = pending_peak.load(std::memory_order_relaxed);
+    stats.direct_io = direct_io;
+    stats.write_error = write_failed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// 补全块头、块尾补零，交给写线程
+void Recorder::sealChunk() {
+    RecordingChunkHeader* header = chunkHeader(current);
+    header->magic = RecordingFormat::CHUNK_MAGIC;
+    header->packet_count = static_cast<uint32_t>(current_packets);
+    header->chunk_index = next_chunk_index;
+    header->stored_size = static_cast<uint32_t>(chunk_size);
+    header->payload_size = static_cast<uint32_t>(current_packets * packet_size);
+    size_t used = RecordingFormat::CHUNK_HEADER_SIZE + current_packets * packet_size;
+    std::memset(current + used, 0, chunk_size - used);
+
+    size_t depth;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        pending.push_back({current, next_chunk_index});
+        depth = pending.size();
+    }
+    queue_cv.notify_one();
+    if (depth > pending_peak.load(std::memory_order_relaxed)) {
+        pending_peak.store(depth, std::memory_order_relaxed);
+    }
+
+    ++next_chunk_index;
+    current = nullptr;
+    current_packets = 0;
+}
+
+uint8_t* Recorder::acquireBuffer() {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    if (free_buffers.empty()) {
+        return nullptr;
+    }
+    uint8_t* buffer = free_buffers.back();
+    free_buffers.pop_back();
+    return buffer;
+}
+
+// 写线程：按顺序压缩（如有）并依次追加写入各块，写完归还缓冲
+void Recorder::run() {
+    while (true) {
+        PendingChunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this] { return !pending.empty() || stopping; });
+            if (pending.empty()) break;
+            chunk = pending.front();
+            pending.pop_front();
+        }
+
+        // 写入失败后不再写后续的块，保证文件中的块连续；缓冲照常归还，接收端不受影响
+        if (!write_failed.load(std::memory_order_relaxed)) {
+            RecordingChunkHeader* header = chunkHeader(chunk.buffer);
+            const uint8_t* data = chunk.buffer;
+            const size_t packets_size = size_t(header->packet_count) * packet_size;
+            if (encoder) {
+                const size_t payload = encoder->encode(chunk.buffer + RecordingFormat::CHUNK_HEADER_SIZE,
+                                                       header->packet_count,
+                                                       encoded_chunk + RecordingFormat::CHUNK_HEADER_SIZE,
+                                                       CodecPool::shared());
+                const size_t used = RecordingFormat::CHUNK_HEADER_SIZE + payload;
+                header->payload_size = static_cast<uint32_t>(payload);
+                header->stored_size = static_cast<uint32_t>(RecordingFormat::alignUp(used));
+                std::memcpy(encoded_chunk, header, RecordingFormat::CHUNK_HEADER_SIZE);
+                std::memset(encoded_chunk + used, 0, header->stored_size - used);
+                data = encoded_chunk;
+            }
+
+            if (writeAligned(data, header->stored_size, write_offset)) {
+                RecordingIndexEntry entry = {};
+                entry.first_sample = header->first_sample;
+                entry.first_timestamp_ns = header->first_timestamp_ns;
+                entry.packet_count = header->packet_count;
+                entry.stored_size = header->stored_size;
+                entry.file_offset = write_offset;
+                index.push_back(entry);
+                write_offset += header->stored_size;
+                chunks_written.fetch_add(1, std::memory_order_relaxed);
+                bytes_written.fetch_add(header->stored_size, std::memory_order_relaxed);
+                packet_bytes.fetch_add(packets_size, std::memory_order_relaxed);
+            } else {
+                std::cerr << "Recorder: write to " << file_path << " failed: " << strerror(errno)
+                          << ", recording stopped" << std::endl;
+                write_failed = true;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        free_buffers.push_back(chunk.buffer);
+    }
+}
+
+bool Recorder::writeAligned(const uint8_t* data, size_t size, uint64_t offset) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = pwrite(fd, data + done, size - done, static_cast<off_t>(offset + done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+#ifdef O_DIRECT
+            // 部分文件系统允许以 O_DIRECT 打开但拒绝直接写入
+            if (errno == EINVAL && direct_io) {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+                direct_io = false;
+                continue;
+            }
+#endif
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 索引区：所有块的索引项，尾部固定在页对齐区域的最后，读取端从文件末尾定位
+void Recorder::writeIndex() {
+    if (write_failed) return;
+
+    RecordingFooter footer = {};
+    footer.magic = RecordingFormat::FOOTER_MAGIC;
+    footer.version = RecordingFormat::VERSION;
+    footer.chunk_count = index.size();
+    footer.index_offset = write_offset;
+    footer.total_packets = packets_recorded;
+    footer.dropped_packets = packets_dropped;
+
+    size_t entries_size = index.size() * sizeof(RecordingIndexEntry);
+    size_t region_size = RecordingFormat::alignUp(entries_size + sizeof(footer));
+    uint8_t* region = static_cast<uint8_t*>(std::aligned_alloc(RecordingFormat::ALIGNMENT, region_size));
+    if (!region) return;
+    std::memset(region, 0, region_size);
+    if (entries_size > 0) {
+        std::memcpy(region, index.data(), entries_size);
+    }
+    std::memcpy(region + region_size - sizeof(footer), &footer, sizeof(footer));
+    if (!writeAligned(region, region_size, footer.index_offset)) {
+        std::cerr << "Recorder: failed to write index of " << file_path << ": " << strerror(errno) << std::endl;
+    }
+    std::free(region);
+}
+
+void Recorder::releaseBuffers() {
+    for (uint8_t* buffer : buffers) {
+        std::free(buffer);
+    }
+    buffers.clear();
+    std::free(encoded_chunk);
+    encoded_chunk = nullptr;
+    encoder.reset();
+    free_buffers.clear();
+    pending.clear();
+    current = nullptr;
+}
@@ -0,0 +1,151 @@
+#include "Storage/RecordingCodec.h"
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+size_t tableSize(size_t channel_count) {
+    size_t size = (channel_count + 1) * sizeof(uint32_t) + channel_count;
+    return (size + 3) & ~size_t(3);
+}
+
+// 通道 channel 在数据包中的样本 <-> 连续序列
+void gatherChannel(const StreamDescriptor& stream, const uint8_t* packets, size_t packet_count, size_t channel,
+                   float* out) {
+    const size_t spp = stream.samples_per_packet;
+    const size_t packet_size = stream.packetSize();
+    for (size_t p = 0; p < packet_count; ++p) {
+        const uint8_t* packet = packets + p * packet_size + stream.headerSize();
+        if (stream.layout == SampleLayout::ChannelMajor) {
+            std::memcpy(out + p * spp, packet + channel * spp * sizeof(float), spp * sizeof(float));
+        } else {
+            for (size_t s = 0; s < spp; ++s) {
+                std::memcpy(out + p * spp + s, packet + (s * stream.channel_count + channel) * sizeof(float),
+                            sizeof(float));
+            }
+        }
+    }
+}
+
+void scatterChannel(const StreamDescriptor& stream, const float* samples, size_t packet_count, size_t channel,
+                    uint8_t* packets) {
+    const size_t spp = stream.samples_per_packet;
+    const size_t packet_size = stream.packetSize();
+    for (size_t p = 0; p < packet_count; ++p) {
+        uint8_t* packet = packets + p * packet_size + stream.headerSize();
+        if (stream.layout == SampleLayout::ChannelMajor) {
+            std::memcpy(packet + channel * spp * sizeof(float), samples + p * spp, spp * sizeof(float));
+        } else {
+            for (size_t s = 0; s < spp; ++s) {
+                std::memcpy(packet + (s * stream.channel_count + channel) * sizeof(float), samples + p * spp + s,
+                            sizeof(float));
+            }
+        }
+    }
+}
+
+// 包头原样存放在各通道数据之后
+void gatherHeaders(const StreamDescriptor& stream, const uint8_t* packets, size_t packet_count, uint8_t* out) {
+    for (size_t p = 0; p < packet_count; ++p) {
+        std::memcpy(out + p * stream.headerSize(), packets + p * stream.packetSize(), stream.headerSize());
+    }
+}
+
+void scatterHeaders(const StreamDescriptor& stream, const uint8_t* headers, size_t packet_count, uint8_t* packets) {
+    for (size_t p = 0; p < packet_count; ++p) {
+        std::memcpy(packets + p * stream.packetSize(), headers + p * stream.headerSize(), stream.headerSize());
+    }
+}
+
+} // namespace
+
+bool recordingCodecSupported(const StreamDescriptor& stream) {
+    return stream.sample_type == SampleType::Float32;
+}
+
+RecordingChunkEncoder::RecordingChunkEncoder(const StreamDescriptor& stream, size_t max_packets, ChunkCodec codec)
+    : stream(stream),
+      codec(codec),
+      max_samples(max_packets * stream.samples_per_packet),
+      channel_bound(chunkEncodeBound(codec, max_samples)),
+      series(stream.channel_count * max_samples),
+      encoded(stream.channel_count * channel_bound),
+      encoded_sizes(stream.channel_count),
+      channel_codecs(stream.channel_count) {}
+
+size_t RecordingChunkEncoder::maxPayloadSize() const {
+    return tableSize(stream.channel_count) + stream.channel_count * max_samples * sizeof(float) +
+           max_samples / stream.samples_per_packet * stream.headerSize();
+}
+
+size_t RecordingChunkEncoder::encode(const uint8_t* packets, size_t packet_count, uint8_t* out, CodecPool& pool) {
+    const size_t channels = stream.channel_count;
+    const size_t count = packet_count * stream.samples_per_packet;
+
+    // 各通道互不相关：拆分与编码都在工作线程上完成，写入各自的暂存槽
+    pool.parallelFor(channels, [&](size_t ch) {
+        float* samples = series.data() + ch * max_samples;
+        uint8_t* slot = encoded.data() + ch * channel_bound;
+        gatherChannel(stream, packets, packet_count, ch, samples);
+        size_t size = chunkEncode(codec, samples, count, slot);
+        channel_codecs[ch] = codec;
+        if (size >= count * sizeof(float)) {
+            size = chunkEncode(ChunkCodec::Raw, samples, count, slot);
+            channel_codecs[ch] = ChunkCodec::Raw;
+        }
+        encoded_sizes[ch] = size;
+    });
+
+    uint32_t* offsets = reinterpret_cast<uint32_t*>(out);
+    uint8_t* codecs = out + (channels + 1) * sizeof(uint32_t);
+    size_t offset = tableSize(channels);
+    std::memset(codecs, 0, offset - (channels + 1) * sizeof(uint32_t));
+    for (size_t ch = 0; ch < channels; ++ch) {
+        offsets[ch] = static_cast<uint32_t>(offset);
+        codecs[ch] = static_cast<uint8_t>(channel_codecs[ch]);
+        std::memcpy(out + offset, encoded.data() + ch * channel_bound, encoded_sizes[ch]);
+        offset += encoded_sizes[ch];
+    }
+    offsets[channels] = static_cast<uint32_t>(offset);
+    gatherHeaders(stream, packets, packet_count, out + offset);
+    return offset + packet_count * stream.headerSize();
+}
+
+bool decodeRecordingChunk(const StreamDescriptor& stream, const uint8_t* payload, size_t size, size_t packet_count,
+                          uint8_t* packets, std::vector<float>& scratch, CodecPool& pool) {
+    const size_t channels = stream.channel_count;
+    const size_t count = packet_count * stream.samples_per_packet;
+    const size_t table = tableSize(channels);
+    if (size < table) {
+        return false;
+    }
+
+    // 负载来自文件，先校验偏移表
+    uint32_t offsets[2] = {0, 0};
+    std::memcpy(&offsets[0], payload, sizeof(uint32_t));
+    if (offsets[0] != table) return false;
+    for (size_t ch = 0; ch < channels; ++ch) {
+        std::memcpy(offsets, payload + ch * sizeof(uint32_t), sizeof(offsets));
+        uint8_t codec = payload[(channels + 1) * sizeof(uint32_t) + ch];
+        if (offsets[1] < offsets[0] || offsets[1] > size || codec > static_cast<uint8_t>(ChunkCodec::ShuffleRle)) {
+            return false;
+        }
+    }
+    if (offsets[1] + packet_count * stream.headerSize() != size) return false;
+
+    scratch.resize(channels * count);
+    std::atomic<bool> valid{true};
+    pool.parallelFor(channels, [&](size_t ch) {
+        uint32_t range[2];
+        std::memcpy(range, payload + ch * sizeof(uint32_t), sizeof(range));
+        ChunkCodec codec = static_cast<ChunkCodec>(payload[(channels + 1) * sizeof(uint32_t) + ch]);
+        float* samples = scratch.data() + ch * count;
+        if (!chunkDecode(codec, payload + range[0], range[1] - range[0], samples, count)) {
+            valid = false;
+            return;
+        }
+        scatterChannel(stream, samples, packet_count, ch, packets);
+    });
+    scatterHeaders(stream, payload + offsets[1], packet_count, packets);
+    return valid;
+}
@@ -0,0 +1,224 @@
+#include "Storage/RecordingReader.h"
+#include "Storage/RecordingCodec.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+RecordingReader::~RecordingReader() {
+    close();
+}
+
+bool RecordingReader::open(const std::string& path) {
+    close();
+
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "RecordingReader: open(" << path << ") failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < RecordingFormat::HEADER_SIZE) {
+        std::cerr << "RecordingReader: " << path << " is not a recording" << std::endl;
+        close();
+        return false;
+    }
+    mapping_size = static_cast<size_t>(st.st_size);
+    void* address = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        std::cerr << "RecordingReader: mmap(" << path << ") failed: " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    mapping = static_cast<const uint8_t*>(address);
+
+    // 校验文件头与数据流描述
+    const RecordingFileHeader* header = reinterpret_cast<const RecordingFileHeader*>(mapping);
+    stream_descriptor = recordingStream(*header);
+    bool valid = header->magic == RecordingFormat::FILE_MAGIC && header->version >= RecordingFormat::MIN_VERSION &&
+                 header->version <= RecordingFormat::VERSION &&
+                 header->codec <= static_cast<uint8_t>(ChunkCodec::ShuffleRle) &&
+                 (header->codec == 0 || recordingCodecSupported(stream_descriptor)) &&
+                 stream_descriptor.isValid() && header->packet_size == stream_descriptor.packetSize() &&
+                 header->chunk_size % RecordingFormat::ALIGNMENT == 0 &&
+                 header->packets_per_chunk > 0 &&
+                 RecordingFormat::CHUNK_HEADER_SIZE + static_cast<size_t>(header->packets_per_chunk) *
+                     header->packet_size <= header->chunk_size;
+    if (!valid) {
+        std::cerr << "RecordingReader: " << path << " has an invalid or unsupported header" << std::endl;
+        close();
+        return false;
+    }
+    start_time_ns = header->start_time_ns;
+    chunk_size = header->chunk_size;
+    packets_per_chunk = header->packets_per_chunk;
+    packet_size = header->packet_size;
+    version = header->version;
+    file_codec = static_cast<ChunkCodec>(header->codec);
+
+    if (!loadIndex()) {
+        scanChunks();
+        std::cerr << "RecordingReader: " << path << " has no index (recording was interrupted), recovered "
+                  << chunks.size() << " chunks" << std::endl;
+    }
+
+    // 顺序读取为主：提示内核预读
+    madvise(const_cast<uint8_t*>(mapping), mapping_size, MADV_SEQUENTIAL);
+    return true;
+}
+
+void RecordingReader::close() {
+    if (mapping) {
+        munmap(const_cast<uint8_t*>(mapping), mapping_size);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    mapping_size = 0;
+    chunks.clear();
+    total_packets = 0;
+    dropped_packets = 0;
+    was_recovered = false;
+}
+
+PacketBatch RecordingReader::chunkPackets(size_t chunk) const {
+    PacketBatch batch;
+    if (chunk >= chunks.size() || compressed()) return batch;
+    batch.data = mapping + chunks[chunk].file_offset + RecordingFormat::CHUNK_HEADER_SIZE;
+    batch.packet_count = chunks[chunk].packet_count;
+    batch.packet_size = packet_size;
+    return batch;
+}
+
+bool RecordingReader::decodeChunk(size_t chunk, std::vector<uint8_t>& packets, CodecPool& pool) const {
+    if (chunk >= chunks.size()) return false;
+    const RecordingIndexEntry& entry = chunks[chunk];
+    packets.resize(size_t(entry.packet_count) * packet_size);
+    const uint8_t* payload = mapping + entry.file_offset + RecordingFormat::CHUNK_HEADER_SIZE;
+    if (!compressed()) {
+        std::memcpy(packets.data(), payload, packets.size());
+        return true;
+    }
+    // 负载长度只记录在块头中（索引与块头由同一次写入产生）
+    const RecordingChunkHeader* header = reinterpret_cast<const RecordingChunkHeader*>(mapping + entry.file_offset);
+    if (header->payload_size > entry.stored_size - RecordingFormat::CHUNK_HEADER_SIZE) {
+        return false;
+    }
+    return decodeRecordingChunk(stream_descriptor, payload, header->payload_size, entry.packet_count,
+                                packets.data(), decode_scratch, pool);
+}
+
+size_t RecordingReader::findChunk(uint64_t sample) const {
+    // 最后一个起点不晚于 sample 的块
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), sample,
+                               [](uint64_t value, const RecordingIndexEntry& entry) {
+                                   return value < entry.first_sample;
+                               });
+    if (it == chunks.begin()) {
+        return 0;
+    }
+    size_t chunk = static_cast<size_t>(it - chunks.begin()) - 1;
+    uint64_t end = chunks[chunk].first_sample + uint64_t(chunks[chunk].packet_count) * stream_descriptor.samples_per_packet;
+    return sample < end ? chunk : chunk + 1;
+}
+
+// 从文件末尾读取尾部，校验后载入索引项
+bool RecordingReader::loadIndex() {
+    if (mapping_size < RecordingFormat::HEADER_SIZE + sizeof(RecordingFooter)) {
+        return false;
+    }
+    const RecordingFooter* footer =
+        reinterpret_cast<const RecordingFooter*>(mapping + mapping_size - sizeof(RecordingFooter));
+    if (footer->magic != RecordingFormat::FOOTER_MAGIC || footer->version != version) {
+        return false;
+    }
+    const size_t entry_size = version == 1 ? sizeof(RecordingIndexEntryV1) : sizeof(RecordingIndexEntry);
+    uint64_t index_size = footer->chunk_count * entry_size;
+    if (footer->index_offset < RecordingFormat::HEADER_SIZE ||
+        footer->index_offset + index_size + sizeof(RecordingFooter) > mapping_size) {
+        return false;
+    }
+
+    if (version == 1) {
+        // 版本1的块固定大小、依次排列
+        const RecordingIndexEntryV1* entries =
+            reinterpret_cast<const RecordingIndexEntryV1*>(mapping + footer->index_offset);
+        chunks.resize(footer->chunk_count);
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            chunks[i] = {};
+            chunks[i].first_sample = entries[i].first_sample;
+            chunks[i].first_timestamp_ns = entries[i].first_timestamp_ns;
+            chunks[i].packet_count = entries[i].packet_count;
+            chunks[i].stored_size = static_cast<uint32_t>(chunk_size);
+            chunks[i].file_offset = RecordingFormat::HEADER_SIZE + i * chunk_size;
+        }
+    } else {
+        const RecordingIndexEntry* entries =
+            reinterpret_cast<const RecordingIndexEntry*>(mapping + footer->index_offset);
+        chunks.assign(entries, entries + footer->chunk_count);
+    }
+    for (const RecordingIndexEntry& entry : chunks) {
+        if (entry.packet_count > packets_per_chunk || entry.stored_size < RecordingFormat::CHUNK_HEADER_SIZE ||
+            entry.file_offset < RecordingFormat::HEADER_SIZE ||
+            entry.file_offset + entry.stored_size > footer->index_offset) {
+            chunks.clear();
+            return false;
+        }
+    }
+    total_packets = footer->total_packets;
+    dropped_packets = footer->dropped_packets;
+    return true;
+}
+
+// 没有索引区：逐块检查块头，遇到不完整或无效的块即停止
+void RecordingReader::scanChunks() {
+    was_recovered = true;
+    chunks.clear();
+    total_packets = 0;
+    size_t offset = RecordingFormat::HEADER_SIZE;
+    for (uint64_t chunk = 0;; ++chunk) {
+        if (offset + RecordingFormat::CHUNK_HEADER_SIZE > mapping_size) break;
+
+        const RecordingChunkHeader* header = reinterpret_cast<const RecordingChunkHeader*>(mapping + offset);
+        size_t stored_size = header->stored_size != 0 ? header->stored_size : chunk_size;
+        if (header->magic != RecordingFormat::CHUNK_MAGIC || header->chunk_index != chunk ||
+            header->packet_count == 0 || header->packet_count > packets_per_chunk ||
+            stored_size % RecordingFormat::ALIGNMENT != 0 || offset + stored_size > mapping_size) {
+            break;
+        }
+
+        RecordingIndexEntry entry = {};
+        entry.first_sample = header->first_sample;
+        entry.first_timestamp_ns = header->first_timestamp_ns;
+        entry.packet_count = header->packet_count;
+        entry.stored_size = static_cast<uint32_t>(stored_size);
+        entry.file_offset = offset;
+        chunks.push_back(entry);
+        total_packets += header->packet_count;
+        offset += stored_size;
+    }
+}
+
+bool readRecordingStream(const std::string& path, StreamDescriptor& stream) {
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    RecordingFileHeader header;
+    bool valid = pread(file, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                 header.magic == RecordingFormat::FILE_MAGIC && header.version >= RecordingFormat::MIN_VERSION &&
+                 header.version <= RecordingFormat::VERSION &&
+                 recordingStream(header).isValid();
+    ::close(file);
+    if (valid) {
+        stream = recordingStream(header);
+    }
+    return valid;
+}
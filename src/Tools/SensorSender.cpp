@@ -0,0 +1,501 @@
+// sensor_sender：合成负载发送端，按数据流描述生成数据包，经 TCP / UDP / ZeroMQ / 共享内存发送给 SensorMonitor
+// - 波形：sine | noise | step | spike，可叠加噪声与直流偏置（见 SignalGenerator）
+// - 定速：按流速率的 --rate-mult 倍发送，每 --burst 个包为一组；组的发送时刻按绝对时间表计算，
+//   先睡到时刻前 SPIN_MARGIN 再自旋到点，落后时立即补发，不累积误差；--rate-mult 0 为全速
+// - --stamp：每包负载开头写入 SendStamp（发送时刻 + 序号），供延迟测量使用
+// 每秒打印一次实际速率与最大落后时间，结束时打印汇总
+#include "Core/SignalGenerator.h"
+#include "Core/StreamFormat.h"
+#ifdef SENSORMONITOR_HAS_SHM
+#include "IO/ShmRingWriter.h"
+#endif
+#ifdef SENSORMONITOR_HAS_ZMQ
+#include <zmq.h>
+#endif
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto SPIN_MARGIN = std::chrono::microseconds(200);
+constexpr size_t MAX_BURST = 1024;
+
+std::atomic<bool> stop_requested{false};
+
+struct SenderConfig {
+    std::string transport = "socket";
+    std::string host = "127.0.0.1";
+    int port = 5555;
+    std::string interface_addr;                 // udp 组播：发送接口地址
+    std::string endpoint = "tcp://127.0.0.1:5555";
+    std::string shm_name = "/sensormonitor";
+    size_t shm_slots = 1024;
+    StreamDescriptor stream;
+    SignalConfig signal;
+    double rate_mult = 1.0;                     // 0 表示全速
+    size_t burst = 1;
+    uint64_t packets = 0;                       // 0 表示不限
+    double duration = 0.0;                      // 秒，0 表示不限
+    bool stamp = false;
+};
+
+// 发送一组连续存放的数据包；返回 false 表示连接已不可用
+class PacketSink {
+public:
+    virtual ~PacketSink() = default;
+    virtual bool send(const uint8_t* packets, size_t count, size_t packet_size) = 0;
+    virtual uint64_t dropped() const { return 0; }
+};
+
+class TcpSink : public PacketSink {
+public:
+    ~TcpSink() override {
+        if (fd >= 0) close(fd);
+    }
+
+    bool open(const std::string& host, int port) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = inet_addr(host.c_str());
+        // The receiver may not be up yet
+        while (!stop_requested) {
+            fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) break;
+            close(fd);
+            fd = -1;
+            std::cerr << "Connecting to " << host << ":" << port << " failed (" << strerror(errno)
+                      << "), retrying" << std::endl;
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+        if (fd < 0) return false;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        int sndbuf = 4 * 1024 * 1024;
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+        return true;
+    }
+
+    bool send(const uint8_t* packets, size_t count, size_t packet_size) override {
+        const size_t total = count * packet_size;
+        size_t sent = 0;
+        while (sent < total) {
+            ssize_t n = ::send(fd, packets + sent, total - sent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "send failed: " << strerror(errno) << std::endl;
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+private:
+    int fd = -1;
+};
+
+// 每个数据包一个数据报，一组用一次 sendmmsg
+class UdpSink : public PacketSink {
+public:
+    ~UdpSink() override {
+        if (fd >= 0) close(fd);
+    }
+
+    bool open(const std::string& host, int port, const std::string& interface_addr) {
+        fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        int sndbuf = 4 * 1024 * 1024;
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = inet_addr(host.c_str());
+        if (IN_MULTICAST(ntohl(addr.sin_addr.s_addr))) {
+            unsigned char loop = 1;
+            setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+            if (!interface_addr.empty()) {
+                in_addr interface{};
+                interface.s_addr = inet_addr(interface_addr.c_str());
+                setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &interface, sizeof(interface));
+            }
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            std::cerr << "UDP connect to " << host << ":" << port << " failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        iovecs.resize(MAX_BURST);
+        messages.resize(MAX_BURST);
+        return true;
+    }
+
+    bool send(const uint8_t* packets, size_t count, size_t packet_size) override {
+        for (size_t i = 0; i < count; ++i) {
+            iovecs[i] = {const_cast<uint8_t*>(packets + i * packet_size), packet_size};
+            messages[i] = {};
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        size_t sent = 0;
+        while (sent < count) {
+            int n = sendmmsg(fd, messages.data() + sent, static_cast<unsigned int>(count - sent), 0);
+            if (n < 0) {
+                // No receiver yet / socket buffer full: UDP senders don't stop for that
+                if (errno == EINTR || errno == ENOBUFS || errno == EAGAIN || errno == ECONNREFUSED) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::cerr << "sendmmsg failed: " << strerror(errno) << std::endl;
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+private:
+    int fd = -1;
+    std::vector<iovec> iovecs;
+    std::vector<mmsghdr> messages;
+};
+
+#ifdef SENSORMONITOR_HAS_ZMQ
+// PUSH 连接到接收端绑定的 PULL；每个数据包一条消息，发送高水位满时阻塞
+class ZmqSink : public PacketSink {
+public:
+    ~ZmqSink() override {
+        if (socket) zmq_close(socket);
+        if (context) zmq_ctx_destroy(context);
+    }
+
+    bool open(const std::string& endpoint) {
+        context = zmq_ctx_new();
+        socket = zmq_socket(context, ZMQ_PUSH);
+        int hwm = 100000;
+        zmq_setsockopt(socket, ZMQ_SNDHWM, &hwm, sizeof(hwm));
+        int linger = 1000;
+        zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
+        if (zmq_connect(socket, endpoint.c_str()) != 0) {
+            std::cerr << "ZMQ connect to " << endpoint << " failed: " << zmq_strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool send(const uint8_t* packets, size_t count, size_t packet_size) override {
+        for (size_t i = 0; i < count; ++i) {
+            while (zmq_send(socket, packets + i * packet_size, packet_size, 0) < 0) {
+                if (errno != EINTR) {
+                    std::cerr << "ZMQ send failed: " << zmq_strerror(errno) << std::endl;
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    void* context = nullptr;
+    void* socket = nullptr;
+};
+#endif
+
+#ifdef SENSORMONITOR_HAS_SHM
+// 共享内存环满时不阻塞，数据包计入丢弃（与采集进程的行为一致）
+class ShmSink : public PacketSink {
+public:
+    bool open(const std::string& name, const StreamDescriptor& stream, size_t slots) {
+        return writer.open(name, stream, slots);
+    }
+
+    bool send(const uint8_t* packets, size_t count, size_t packet_size) override {
+        for (size_t i = 0; i < count; ++i) {
+            writer.write(packets + i * packet_size, packet_size);
+        }
+        return true;
+    }
+
+    uint64_t dropped() const override { return writer.droppedCount(); }
+
+private:
+    ShmRingWriter writer;
+};
+#endif
+
+std::unique_ptr<PacketSink> openSink(const SenderConfig& config) {
+    if (config.transport == "socket" || config.transport == "tcp") {
+        auto sink = std::make_unique<TcpSink>();
+        return sink->open(config.host, config.port) ? std::move(sink) : nullptr;
+    }
+    if (config.transport == "udp") {
+        auto sink = std::make_unique<UdpSink>();
+        return sink->open(config.host, config.port, config.interface_addr) ? std::move(sink) : nullptr;
+    }
+    if (config.transport == "zmq") {
+#ifdef SENSORMONITOR_HAS_ZMQ
+        auto sink = std::make_unique<ZmqSink>();
+        return sink->open(config.endpoint) ? std::move(sink) : nullptr;
+#else
+        std::cerr << "ZeroMQ transport is not available in this build" << std::endl;
+        return nullptr;
+#endif
+    }
+    if (config.transport == "shm") {
+#ifdef SENSORMONITOR_HAS_SHM
+        auto sink = std::make_unique<ShmSink>();
+        return sink->open(config.shm_name, config.stream, config.shm_slots) ? std::move(sink) : nullptr;
+#else
+        std::cerr << "Shared-memory transport is not available in this build" << std::endl;
+        return nullptr;
+#endif
+    }
+    std::cerr << "Unknown transport: " << config.transport << std::endl;
+    return nullptr;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --transport <socket|udp|zmq|shm>\n"
+              << "                                data transport (default: socket)\n"
+              << "  --host <address>              socket/udp: receiver address, udp: may be a multicast group\n"
+              << "                                (default: 127.0.0.1)\n"
+              << "  --port <port>                 socket/udp: receiver port (default: 5555)\n"
+              << "  --interface <address>         udp multicast: outgoing interface address\n"
+              << "  --endpoint <endpoint>         zmq: receiver endpoint (default: tcp://127.0.0.1:5555)\n"
+              << "  --shm-name <name>             shm: shared-memory ring name (default: /sensormonitor)\n"
+              << "  --shm-slots <n>               shm: ring slots, rounded up to a power of two (default: 1024)\n"
+              << "  --channels <n>                channels per packet (default: 128)\n"
+              << "  --samples-per-packet <n>      samples per channel per packet (default: 8)\n"
+              << "  --sample-rate <hz>            sample rate in Hz (default: 22500)\n"
+              << "  --sample-type <type>          float32 | int16 | int24 (default: float32)\n"
+              << "  --layout <layout>             channel-major | interleaved (default: channel-major)\n"
+              << "  --packet-header               packets start with a sequence header (default: headerless)\n"
+              << "  --pattern <pattern>           sine | noise | step | spike (default: sine)\n"
+              << "  --frequency <hz>              sine/step/spike frequency (default: 10)\n"
+              << "  --amplitude <x>               peak amplitude, full scale is 1 (default: 0.5)\n"
+              << "  --noise <x>                   standard deviation of noise added to the pattern (default: 0)\n"
+              << "  --offset <x>                  DC offset added to every sample (default: 0)\n"
+              << "  --seed <n>                    noise seed (default: 1)\n"
+              << "  --rate-mult <x>               send at x times the stream rate, 0 = as fast as possible (default: 1)\n"
+              << "  --burst <n>                   packets sent back to back per pacing step, up to " << MAX_BURST
+              << " (default: 1)\n"
+              << "  --packets <n>                 stop after n packets (default: unlimited)\n"
+              << "  --duration <seconds>          stop after this long (default: unlimited)\n"
+              << "  --stamp                       write a send timestamp into the first 16 payload bytes\n";
+}
+
+bool parseArgs(int argc, char** argv, SenderConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--packet-header") == 0) {
+            config.stream.packet_header = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--stamp") == 0) {
+            config.stamp = true;
+            continue;
+        }
+
+        if (std::strcmp(arg, "--transport") == 0 && value) {
+            config.transport = value;
+        } else if (std::strcmp(arg, "--host") == 0 && value) {
+            config.host = value;
+        } else if (std::strcmp(arg, "--port") == 0 && value) {
+            config.port = std::atoi(value);
+        } else if (std::strcmp(arg, "--interface") == 0 && value) {
+            config.interface_addr = value;
+        } else if (std::strcmp(arg, "--endpoint") == 0 && value) {
+            config.endpoint = value;
+        } else if (std::strcmp(arg, "--shm-name") == 0 && value) {
+            config.shm_name = value;
+        } else if (std::strcmp(arg, "--shm-slots") == 0 && value) {
+            config.shm_slots = std::max<size_t>(std::strtoul(value, nullptr, 10), 1);
+        } else if (std::strcmp(arg, "--channels") == 0 && value) {
+            config.stream.channel_count = std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--samples-per-packet") == 0 && value) {
+            config.stream.samples_per_packet = std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--sample-rate") == 0 && value) {
+            config.stream.sample_rate = std::atof(value);
+        } else if (std::strcmp(arg, "--sample-type") == 0 && value) {
+            if (!parseSampleType(value, config.stream.sample_type)) {
+                std::cerr << "Unknown sample type: " << value << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--layout") == 0 && value) {
+            if (!parseSampleLayout(value, config.stream.layout)) {
+                std::cerr << "Unknown sample layout: " << value << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--pattern") == 0 && value) {
+            if (!parseSignalPattern(value, config.signal.pattern)) {
+                std::cerr << "Unknown pattern: " << value << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--frequency") == 0 && value) {
+            config.signal.frequency = std::atof(value);
+        } else if (std::strcmp(arg, "--amplitude") == 0 && value) {
+            config.signal.amplitude = std::atof(value);
+        } else if (std::strcmp(arg, "--noise") == 0 && value) {
+            config.signal.noise = std::atof(value);
+        } else if (std::strcmp(arg, "--offset") == 0 && value) {
+            config.signal.offset = std::atof(value);
+        } else if (std::strcmp(arg, "--seed") == 0 && value) {
+            config.signal.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--rate-mult") == 0 && value) {
+            config.rate_mult = std::max(std::atof(value), 0.0);
+        } else if (std::strcmp(arg, "--burst") == 0 && value) {
+            config.burst = std::min<size_t>(std::max<size_t>(std::strtoul(value, nullptr, 10), 1), MAX_BURST);
+        } else if (std::strcmp(arg, "--packets") == 0 && value) {
+            config.packets = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--duration") == 0 && value) {
+            config.duration = std::atof(value);
+        } else {
+            printUsage(argv[0]);
+            return false;
+        }
+        ++i;
+    }
+
+    if (!config.stream.isValid()) {
+        std::cerr << "Invalid stream geometry: " << config.stream.channel_count << " channels, "
+                  << config.stream.samples_per_packet << " samples/packet, "
+                  << config.stream.sample_rate << " Hz" << std::endl;
+        return false;
+    }
+    if (config.stamp && config.stream.payloadSize() < sizeof(SendStamp)) {
+        std::cerr << "--stamp needs a payload of at least " << sizeof(SendStamp) << " bytes" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// 先睡到 deadline 前 SPIN_MARGIN（避开调度器的唤醒误差），再自旋到点
+void waitUntil(Clock::time_point deadline) {
+    if (Clock::now() + SPIN_MARGIN < deadline) {
+        std::this_thread::sleep_until(deadline - SPIN_MARGIN);
+    }
+    while (Clock::now() < deadline) {
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SenderConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        return 1;
+    }
+    std::signal(SIGINT, [](int) { stop_requested = true; });
+    std::signal(SIGTERM, [](int) { stop_requested = true; });
+
+    const StreamDescriptor& stream = config.stream;
+    const double packets_per_sec = config.rate_mult * stream.packetsPerSecond();
+    std::cout << "sensor_sender: " << config.transport << ", " << stream.channel_count << " channels x "
+              << stream.samples_per_packet << " samples " << sampleTypeName(stream.sample_type) << " "
+              << sampleLayoutName(stream.layout) << (stream.packet_header ? ", sequence headers" : "")
+              << (config.stamp ? ", send stamps" : "") << ", " << stream.packetSize() << " bytes/packet, "
+              << signalPatternName(config.signal.pattern) << std::endl;
+    if (packets_per_sec > 0) {
+        std::cout << "Target " << packets_per_sec << " packets/s ("
+                  << packets_per_sec * stream.packetSize() / (1024.0 * 1024.0) << " MB/s) in bursts of "
+                  << config.burst << std::endl;
+    } else {
+        std::cout << "Sending as fast as possible in bursts of " << config.burst << std::endl;
+    }
+
+    std::unique_ptr<PacketSink> sink = openSink(config);
+    if (!sink) {
+        return 1;
+    }
+
+    SignalGenerator generator(stream, config.signal);
+    const size_t packet_size = stream.packetSize();
+    std::vector<uint8_t> burst_buffer(config.burst * packet_size);
+
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point end = config.duration > 0
+                                      ? start + std::chrono::duration_cast<Clock::duration>(
+                                                    std::chrono::duration<double>(config.duration))
+                                      : Clock::time_point::max();
+    Clock::time_point last_report = start;
+    uint64_t sent = 0, reported = 0;
+    Clock::duration max_lag = Clock::duration::zero(), total_max_lag = Clock::duration::zero();
+    bool ok = true;
+
+    while (!stop_requested && (config.packets == 0 || sent < config.packets)) {
+        const size_t count = config.packets ? std::min<uint64_t>(config.burst, config.packets - sent) : config.burst;
+        for (size_t i = 0; i < count; ++i) {
+            generator.nextPacket(burst_buffer.data() + i * packet_size);
+        }
+
+        // Absolute schedule: a late burst goes out immediately and the next one keeps its own slot
+        if (packets_per_sec > 0) {
+            Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                                     std::chrono::duration<double>(sent / packets_per_sec));
+            waitUntil(deadline);
+            max_lag = std::max(max_lag, Clock::now() - deadline);
+        }
+        Clock::time_point now = Clock::now();
+        if (now >= end) break;
+
+        if (config.stamp) {
+            const int64_t stamp_ns = nowNs();
+            for (size_t i = 0; i < count; ++i) {
+                writeSendStamp(burst_buffer.data() + i * packet_size, stream,
+                               {stamp_ns, generator.sequence() - count + i});
+            }
+        }
+        if (!sink->send(burst_buffer.data(), count, packet_size)) {
+            ok = false;
+            break;
+        }
+        sent += count;
+
+        if (now - last_report >= std::chrono::seconds(1)) {
+            double seconds = std::chrono::duration<double>(now - last_report).count();
+            double rate = (sent - reported) / seconds;
+            std::printf("%8.0f packets/s | %7.2f MB/s | max lag %7.1f us | %llu sent | %llu dropped\n", rate,
+                        rate * packet_size / (1024.0 * 1024.0),
+                        std::chrono::duration<double, std::micro>(max_lag).count(),
+                        static_cast<unsigned long long>(sent), static_cast<unsigned long long>(sink->dropped()));
+            std::fflush(stdout);
+            total_max_lag = std::max(total_max_lag, max_lag);
+            max_lag = Clock::duration::zero();
+            last_report = now;
+            reported = sent;
+        }
+    }
+
+    total_max_lag = std::max(total_max_lag, max_lag);
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::printf("Sent %llu packets in %.2f s (%.0f packets/s, %.2f MB/s), max lag %.1f us, %llu dropped\n",
+                static_cast<unsigned long long>(sent), seconds, seconds > 0 ? sent / seconds : 0.0,
+                seconds > 0 ? sent * packet_size / seconds / (1024.0 * 1024.0) : 0.0,
+                std::chrono::duration<double, std::micro>(total_max_lag).count(),
+                static_cast<unsigned long long>(sink->dropped()));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+#include "UI/HeatmapTexture.h"
+#include <glad/glad.h>
+#include <algorithm>
+
+HeatmapTexture::~HeatmapTexture() {
+    release();
+}
+
+void HeatmapTexture::release() {
+    if (texture) glDeleteTextures(1, &texture);
+    texture = 0;
+    texture_width = 0;
+    texture_height = 0;
+}
+
+bool HeatmapTexture::resize(int width, int height) {
+    if (width <= 0 || height <= 0) return false;
+    if (texture && width == texture_width && height == texture_height) return true;
+
+    if (!texture) glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    texture_width = width;
+    texture_height = height;
+    return true;
+}
+
+void HeatmapTexture::uploadColumns(uint64_t column, int count, const uint32_t* pixels) {
+    if (!texture || count <= 0) return;
+    count = std::min(count, texture_width);
+
+    // Rows of the source are count pixels wide; the wrapped tail starts first_part pixels into each row
+    const int x = static_cast<int>(column % static_cast<uint64_t>(texture_width));
+    const int first_part = std::min(count, texture_width - x);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, count);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, 0, first_part, texture_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    if (first_part < count) {
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, first_part);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, count - first_part, texture_height, GL_RGBA, GL_UNSIGNED_BYTE,
+                        pixels);
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
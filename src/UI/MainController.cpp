@@ -3,50 +3,209 @@
 #include <imgui.h>
 #include <implot.h>
 #include <algorithm>
+#include <cmath>
 #include <vector>
 #include <string>
 #include <cstdio>
 
 using json = nlohmann::json;
 
-MainController::MainController(const std::string& host, int port) : subscriber(host, port) {
-    // Automatically start the SocketSubscriber when MainController is created
-    subscriber.start([this](const std::vector<uint8_t>& packet_data) {
-        dataManager.addBinaryPacket(packet_data);
-    });
-    dataManager.setProcessingEnabled(true);
+namespace {
+
+// 使用优化的颜色生成（基于HSV色彩空间）
+ImVec4 channelColor(int ch, int total_channels) {
+    float hue = (ch * 360.0f) / total_channels;
+    float saturation = 0.8f + 0.2f * ((ch % 5) / 4.0f);
+    float value = 0.7f + 0.3f * ((ch % 3) / 2.0f);
+    
+    // HSV转RGB
+    float c = value * saturation;
+    float x = c * (1 - fabs(fmod(hue / 60.0f, 2) - 1));
+    float m = value - c;
+    
+    float r, g, b;
+    if (hue < 60) { r = c; g = x; b = 0; }
+    else if (hue < 120) { r = x; g = c; b = 0; }
+    else if (hue < 180) { r = 0; g = c; b = x; }
+    else if (hue < 240) { r = 0; g = x; b = c; }
+    else if (hue < 300) { r = x; g = 0; b = c; }
+    else { r = c; g = 0; b = x; }
+    
+    return ImVec4(r + m, g + m, b + m, 0.8f);
+}
+
+// ImDrawList 回调：渲染时在绘图区（命令的裁剪矩形）内执行 GPU 波形绘制
+void renderTraces(const ImDrawList*, const ImDrawCmd* command) {
+    // 裁剪矩形为 ImGui 显示坐标，OpenGL 视口为帧缓冲像素、原点在左下角
+    const ImDrawData* draw_data = ImGui::GetDrawData();
+    const ImVec2 origin = draw_data->DisplayPos;
+    const ImVec2 scale = draw_data->FramebufferScale;
+    const ImVec4 clip = command->ClipRect;
+    const float fb_height = draw_data->DisplaySize.y * scale.y;
+    static_cast<TraceRenderer*>(command->UserCallbackData)
+        ->render(static_cast<int>((clip.x - origin.x) * scale.x),
+                 static_cast<int>(fb_height - (clip.w - origin.y) * scale.y),
+                 static_cast<int>((clip.z - clip.x) * scale.x),
+                 static_cast<int>((clip.w - clip.y) * scale.y));
+}
+
+// 把一个通道的功率谱压缩为每个像素列一个点（列内取最大值，窄峰不会被抽掉）；
+// 可见范围两侧以外的频点各合并为一个点，折线仍连到边缘。返回点数
+size_t decimateSpectrum(const float* power_db, size_t first_bin, size_t bins, double bin_width,
+                        double view_min, double view_max, bool log_x, float width, float* freqs, float* values) {
+    const long columns = std::max(1L, static_cast<long>(width));
+    const double low = log_x ? std::log(std::max(view_min, bin_width * 0.5)) : view_min;
+    const double high = log_x ? std::log(std::max(view_max, bin_width)) : view_max;
+    const double scale = columns / std::max(high - low, 1e-12);
+    size_t count = 0;
+    long current = -2;
+    for (size_t k = first_bin; k < bins; ++k) {
+        const double freq = k * bin_width;
+        const double position = ((log_x ? std::log(freq) : freq) - low) * scale;
+        const long column = static_cast<long>(std::floor(std::min(std::max(position, -1.0), double(columns))));
+        if (column != current || count == 0) {
+            freqs[count] = static_cast<float>(freq);
+            values[count] = power_db[k];
+            ++count;
+            current = column;
+        } else if (power_db[k] > values[count - 1]) {
+            freqs[count - 1] = static_cast<float>(freq);
+            values[count - 1] = power_db[k];
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+MainController::MainController(const SubscriberConfig& config)
+    : subscriber(createSubscriber(config)) {
+    // 只有 socket 接收端区分来源，其余传输方式只有流 0
+    const size_t stream_count = config.transport == "socket" ? std::max<size_t>(config.streams, 1) : 1;
+    for (size_t i = 0; i < stream_count; ++i) {
+        streams.push_back(std::make_unique<DataManager>(config.stream));
+    }
+
+    // 录制文件只容纳一个数据流，录制流 0
+    if (!config.record_path.empty()) {
+        recorder = std::make_unique<Recorder>();
+        if (!recorder->open(config.record_path, config.stream, Recorder::DEFAULT_CHUNK_SIZE,
+                            Recorder::DEFAULT_BUFFER_COUNT, config.record_codec)) {
+            recorder.reset();
+        }
+    }
+
+    // 各流各自溢写到同一目录下的独立文件，大小上限平分
+    if (!config.history_dir.empty()) {
+        for (auto& stream : streams) {
+            stream->enableHistorySpill(config.history_dir, (config.history_max_mb << 20) / streams.size(),
+                                       config.history_codec);
+        }
+    }
+
+    // 接收线程只把数据包拷入队列，解码、录制等在队列的处理线程上进行，
+    // 处理阶段的停顿不会让接收端停止读取
+    if (config.queue_slots > 0) {
+        queue = std::make_unique<PacketQueue>(config.stream.packetSize(), config.queue_slots,
+                                              config.queue_policy);
+        queue->start([this](const PacketBatch& batch) {
+            onPacketBatch(batch);
+        });
+    }
+
+    // Automatically start the subscriber when MainController is created
+    startSubscriber();
+    for (auto& stream : streams) {
+        stream->setFramePacing(true);
+        stream->setProcessingEnabled(true);
+    }
     running = true;
 }
 
+MainController::MainController(const std::string& host, int port)
+    : MainController([&] {
+          SubscriberConfig config;
+          config.host = host;
+          config.port = port;
+          return config;
+      }()) {
+}
+
+void MainController::releaseGraphics() {
+    trace_renderer.reset();
+    heatmap_texture.release();
+    heatmap_uploaded_start = 0;
+    heatmap_uploaded_end = 0;
+}
+
 MainController::~MainController() {
-    subscriber.stop();
-    dataManager.setProcessingEnabled(false);
+    if (subscriber) {
+        subscriber->stop();
+    }
+    // 接收线程已停止：处理完队列中剩余的包，再写出最后的块和索引
+    if (queue) {
+        queue->stop();
+    }
+    if (recorder) {
+        recorder->close();
+    }
+    for (auto& stream : streams) {
+        stream->setProcessingEnabled(false);
+    }
+}
+
+void MainController::onPacketBatch(const PacketBatch& batch) {
+    if (batch.source >= streams.size()) return;
+    streams[batch.source]->addPacketBatch(batch);
+    if (recorder && batch.source == 0) {
+        recorder->append(batch);
+    }
+}
+
+void MainController::startSubscriber() {
+    if (!subscriber) return;
+    // 批量交付：每次接收得到的所有完整数据包一次性入队（或直接处理）
+    if (queue) {
+        subscriber->startBatch([this](const PacketBatch& batch) {
+            queue->push(batch);
+        });
+    } else {
+        subscriber->startBatch([this](const PacketBatch& batch) {
+            onPacketBatch(batch);
+        });
+    }
 }
 
 void MainController::toggle() {
     if (running) {
-        subscriber.stop();
-        dataManager.setProcessingEnabled(false);
+        if (subscriber) {
+            subscriber->stop();
+        }
+        for (auto& stream : streams) {
+            stream->setProcessingEnabled(false);
+        }
         running = false;
     } else {
-        // 使用二进制数据回调而不是JSON
-        subscriber.start([this](const std::vector<uint8_t>& packet_data) {
-            // 将二进制数据包传递给DataManager处理
-            dataManager.addBinaryPacket(packet_data);
-        });
-        dataManager.setProcessingEnabled(true);
+        startSubscriber();
+        for (auto& stream : streams) {
+            stream->setProcessingEnabled(true);
+        }
         running = true;
     }
 }
 
 void MainController::clear() {
-    dataManager.clear();
+    for (auto& stream : streams) {
+        stream->clear();
+    }
 }
 
-// 新增：播放/暂停控制
+// 新增：播放/暂停控制（所有流同时暂停，切换显示的流时时间轴一致）
 void MainController::togglePlayback() {
-    bool current_state = dataManager.isPlaying();
-    dataManager.setPlayState(!current_state);
+    bool playing = !streams[active_stream]->isPlaying();
+    for (auto& stream : streams) {
+        stream->setPlayState(playing);
+    }
 }
 
 void MainController::update() {
@@ -54,6 +213,8 @@ void MainController::update() {
 }
 
 void MainController::drawUI() {
+    DataManager& dataManager = *streams[active_stream];
+    
     // 控制按钮区域（优化布局）
     if (ImGui::Button(running ? "Stop" : "Start", ImVec2(80, 30))) toggle();
     ImGui::SameLine();
@@ -70,10 +231,32 @@ void MainController::drawUI() {
                 running ? "Running" : "Stopped",
                 dataManager.isPlaying() ? "Playing" : "Paused");
     
-    auto channel_data = dataManager.getChannelDisplayData();
-    auto time_values = dataManager.getTimeValues();
+    // 多个发送端时选择显示的流（括号内为该流已接收的包数）
+    if (streams.size() > 1) {
+        char stream_label[64];
+        std::snprintf(stream_label, sizeof(stream_label), "Stream %zu", active_stream);
+        ImGui::SetNextItemWidth(200.0f);
+        if (ImGui::BeginCombo("Stream", stream_label)) {
+            for (size_t i = 0; i < streams.size(); ++i) {
+                std::snprintf(stream_label, sizeof(stream_label), "Stream %zu (%llu packets)", i,
+                              static_cast<unsigned long long>(streams[i]->getPacketStats().packets));
+                if (ImGui::Selectable(stream_label, i == active_stream)) {
+                    active_stream = i;
+                }
+            }
+            ImGui::EndCombo();
+        }
+    }
+    
+    // 按渲染节奏请求下一帧；本帧使用显示线程最近发布的快照，直接引用其内存，无拷贝
+    dataManager.requestDisplayFrame();
+    const DisplayFrame& frame = dataManager.acquireDisplayFrame();
+    const float* time_values = frame.time_values.data();
+    const size_t sample_count = frame.sample_count;
+    const int channel_count = static_cast<int>(dataManager.channelCount());
+    const HistoryRange history = dataManager.getHistoryRange();
     
-    if (channel_data.empty() || time_values.empty()) {
+    if (sample_count == 0 && history.last_time <= history.first_time) {
         ImGui::Text("Waiting for data...");
         return;
     }
@@ -84,29 +267,131 @@ void MainController::drawUI() {
     static int display_channels = 8;
     static float plot_height = 400.0f;
     static bool auto_scale = true;
+    static bool follow_live = true;
+    static float time_window = 0.0f;          // 秒，0 表示使用实时显示窗口
+    static double view_min = 0.0, view_max = 0.0;  // 非跟随模式下上一帧的X轴范围
+    
+    const double live_window = dataManager.displayWindowSamples() / dataManager.sampleRate();
+    const float history_span = static_cast<float>(std::max(history.last_time - history.first_time, live_window));
+    if (time_window <= 0.0f) time_window = static_cast<float>(live_window);
     
     // 控制面板布局
     ImGui::Columns(3, "Control Panel", false);
-    ImGui::SliderInt("Display Channels", &display_channels, 1, std::min(128, static_cast<int>(channel_data.size())));
+    display_channels = std::min(display_channels, channel_count);
+    ImGui::SliderInt("Display Channels", &display_channels, 1, channel_count);
     ImGui::NextColumn();
     ImGui::SliderFloat("Plot Height", &plot_height, 200.0f, 800.0f);
     ImGui::NextColumn();
     ImGui::Checkbox("Auto Scale", &auto_scale);
+    ImGui::NextColumn();
+    ImGui::SliderFloat("Time Window (s)", &time_window, static_cast<float>(live_window), history_span,
+                       "%.3f", ImGuiSliderFlags_Logarithmic);
+    ImGui::NextColumn();
+    bool follow_changed = ImGui::Checkbox("Follow Live", &follow_live);
+    ImGui::NextColumn();
+    static bool gpu_traces = true;
+    ImGui::Checkbox("GPU Traces", &gpu_traces);
+    ImGui::NextColumn();
+    static int view_mode = 0;
+    ImGui::Combo("View", &view_mode, "Lines\0Stacked Lanes\0Heatmap\0");
     ImGui::Columns(1);
     
-    // 使用ImPlot绘制图表
-    if (ImPlot::BeginPlot("Multi-Channel Sensor Data (128 Channels @ 22.5kHz)", ImVec2(-1, plot_height))) {
+    if (ImGui::CollapsingHeader("Filters")) {
+        drawFilterPanel(dataManager.sampleRate());
+    }
+    const bool line_view = view_mode == 0;
+    const bool stacked_view = view_mode == 1;
+    
+    // 只请求需要显示的通道，显示线程据此只拷贝这些通道
+    dataManager.setDisplayChannels(0, static_cast<size_t>(display_channels));
+    
+    // 跟随实时数据且窗口不超过显示帧长度时直接绘制显示帧；
+    // 否则（放大历史、暂停后浏览、手动平移缩放）从包络金字塔按像素生成最小/最大折线
+    const bool following = follow_live && dataManager.isPlaying();
+    // 叠放视图与热图不使用显示帧
+    const bool use_frame = line_view && following && sample_count > 0 && time_window <= live_window * 1.001;
+    
+    double view_start = view_min, view_end = view_max;
+    if (following || follow_changed || view_end <= view_start) {
+        view_end = history.last_time;
+        view_start = view_end - time_window;
+    }
+    
+    // 实时窗口由 GPU 绘制时，只把新样本写入 GPU 环；CPU 不再为每段折线生成四边形
+    if (gpu_traces && use_frame && !trace_renderer && !trace_renderer_failed) {
+        trace_renderer = std::make_unique<TraceRenderer>();
+        if (!trace_renderer->init()) {
+            trace_renderer.reset();
+            trace_renderer_failed = true;
+        }
+    }
+    const bool use_gpu = gpu_traces && use_frame && trace_renderer;
+    if (use_gpu) {
+        trace_renderer->update(frame);
+        const TraceUploader& uploaded = trace_renderer->uploader();
+        trace_styles.resize(uploaded.channelCount());
+        for (size_t c = 0; c < trace_styles.size(); ++c) {
+            ImVec4 color = channelColor(static_cast<int>(uploaded.channelFirst() + c), display_channels);
+            trace_styles[c].color[0] = color.x;
+            trace_styles[c].color[1] = color.y;
+            trace_styles[c].color[2] = color.z;
+            trace_styles[c].color[3] = color.w;
+        }
+        trace_renderer->setChannelStyles(trace_styles);
+    }
+    
+    // 每个像素最多2个点，与历史长度无关
+    const size_t max_points = 2 * static_cast<size_t>(std::max(ImGui::GetContentRegionAvail().x, 64.0f));
+    if (!use_frame && line_view) {
+        size_t needed = static_cast<size_t>(display_channels) * max_points;
+        if (envelope_times.size() < needed) {
+            envelope_times.resize(needed);
+            envelope_values.resize(needed);
+        }
+        envelope_counts.resize(channel_count);
+        for (int ch = 0; ch < display_channels; ++ch) {
+            envelope_counts[ch] = dataManager.queryEnvelope(ch, view_start, view_end, max_points,
+                                                            envelope_times.data() + ch * max_points,
+                                                            envelope_values.data() + ch * max_points);
+        }
+    }
+    
+    // 使用ImPlot绘制图表（标题由数据流描述生成，### 之后的部分作为固定的ID）
+    const StreamDescriptor& stream = dataManager.streamDescriptor();
+    char plot_title[128];
+    std::snprintf(plot_title, sizeof(plot_title), "Multi-Channel Sensor Data (%zu Channels @ %.4gkHz, %s)###SensorPlot",
+                  stream.channel_count, stream.sample_rate / 1000.0, sampleTypeName(stream.sample_type));
+    if (!line_view) {
+        // 叠放视图与热图没有坐标轴交互：不跟随时保持右端，窗口长度取 Time Window
+        view_start = view_end - time_window;
+        if (stacked_view) {
+            drawStackedView(dataManager, view_start, view_end, plot_height, auto_scale);
+        } else {
+            drawHeatmapView(dataManager, view_start, view_end, plot_height);
+        }
+        view_min = view_start;
+        view_max = view_end;
+    } else if (ImPlot::BeginPlot(plot_title, ImVec2(-1, plot_height))) {
         
         // 计算Y轴范围（仅计算显示的通道以提升性能）
         if (auto_scale) {
             float min_val = FLT_MAX, max_val = -FLT_MAX;
-            for (int ch = 0; ch < display_channels && ch < static_cast<int>(channel_data.size()); ++ch) {
-                if (!channel_data[ch].empty()) {
+            for (int ch = 0; ch < display_channels && ch < channel_count; ++ch) {
+                if (use_frame) {
+                    const float* values = frame.channel(ch);
+                    if (!values) continue;
                     // 只计算最近的数据点以提升性能
-                    size_t sample_start = channel_data[ch].size() > 500 ? channel_data[ch].size() - 500 : 0;
-                    for (size_t i = sample_start; i < channel_data[ch].size(); ++i) {
-                        min_val = std::min(min_val, channel_data[ch][i]);
-                        max_val = std::max(max_val, channel_data[ch][i]);
+                    size_t sample_start = sample_count > 500 ? sample_count - 500 : 0;
+                    for (size_t i = sample_start; i < sample_count; ++i) {
+                        float value = values[frame.physicalIndex(i)];
+                        min_val = std::min(min_val, value);
+                        max_val = std::max(max_val, value);
+                    }
+                } else {
+                    const float* values = envelope_values.data() + ch * max_points;
+                    for (size_t i = 0; i < envelope_counts[ch]; ++i) {
+                        min_val = std::min(min_val, values[i]);
+                        max_val = std::max(max_val, values[i]);
                     }
                 }
             }
@@ -116,67 +401,528 @@ void MainController::drawUI() {
             }
         }
         
-        // 设置X轴范围 - 实现滑动时间窗口
-        if (!time_values.empty()) {
-            ImPlot::SetupAxisLimits(ImAxis_X1, time_values.front(), time_values.back(), ImGuiCond_Always);
+        // 设置X轴范围 - 跟随时实现滑动时间窗口，否则允许用户平移缩放
+        if (use_frame) {
+            ImPlot::SetupAxisLimits(ImAxis_X1,
+                                    time_values[frame.physicalIndex(0)],
+                                    time_values[frame.physicalIndex(sample_count - 1)],
+                                    ImGuiCond_Always);
+        } else if (following || follow_changed || view_max <= view_min) {
+            ImPlot::SetupAxisLimits(ImAxis_X1, view_start, view_end, ImGuiCond_Always);
         }
         
         ImPlot::SetupAxis(ImAxis_X1, "Time (s)");
         ImPlot::SetupAxis(ImAxis_Y1, "Amplitude");
         
+        // GPU 绘制：一次实例化绘制所有通道，图例由占位项提供
+        if (use_gpu) {
+            ImPlotRect limits = ImPlot::GetPlotLimits();
+            TraceTransform transform = TraceTransform::fromPlot(trace_renderer->uploader().firstTime(),
+                                                                dataManager.sampleRate(), limits.X.Min, limits.X.Max,
+                                                                limits.Y.Min, limits.Y.Max);
+            if (trace_renderer->prepare(transform)) {
+                // 绘制后恢复 ImGui 的渲染状态（视口、程序、纹理）
+                ImPlot::PushPlotClipRect();
+                ImPlot::GetPlotDrawList()->AddCallback(renderTraces, trace_renderer.get());
+                ImPlot::GetPlotDrawList()->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+                ImPlot::PopPlotClipRect();
+            }
+        }
+        
         // 绘制选定的通道（性能优化：只绘制请求的通道数量）
-        for (int ch = 0; ch < display_channels && ch < static_cast<int>(channel_data.size()); ++ch) {
-            if (!channel_data[ch].empty() && channel_data[ch].size() == time_values.size()) {
-                char label[32];
-                snprintf(label, sizeof(label), "Ch%d", ch);
-                
-                // 使用优化的颜色生成（基于HSV色彩空间）
-                float hue = (ch * 360.0f) / display_channels;
-                float saturation = 0.8f + 0.2f * ((ch % 5) / 4.0f);
-                float value = 0.7f + 0.3f * ((ch % 3) / 2.0f);
-                
-                // HSV转RGB
-                float c = value * saturation;
-                float x = c * (1 - fabs(fmod(hue / 60.0f, 2) - 1));
-                float m = value - c;
-                
-                float r, g, b;
-                if (hue < 60) { r = c; g = x; b = 0; }
-                else if (hue < 120) { r = x; g = c; b = 0; }
-                else if (hue < 180) { r = 0; g = c; b = x; }
-                else if (hue < 240) { r = 0; g = x; b = c; }
-                else if (hue < 300) { r = x; g = 0; b = c; }
-                else { r = c; g = 0; b = x; }
-                
-                ImVec4 color = ImVec4(r + m, g + m, b + m, 0.8f);
-                ImPlot::SetNextLineStyle(color, 1.0f);
-                
-                // 使用数据抽样来提升性能（如果数据点太多）
-                if (time_values.size() > 2000) {
-                    // 抽样绘制以提升性能
-                    std::vector<float> sampled_time, sampled_data;
-                    size_t step = time_values.size() / 1000;  // 抽样到1000个点
-                    for (size_t i = 0; i < time_values.size(); i += step) {
-                        sampled_time.push_back(time_values[i]);
-                        sampled_data.push_back(channel_data[ch][i]);
-                    }
-                    ImPlot::PlotLine(label, sampled_time.data(), sampled_data.data(), 
-                                    static_cast<int>(sampled_time.size()));
-                } else {
-                    ImPlot::PlotLine(label, time_values.data(), channel_data[ch].data(), 
-                                    static_cast<int>(time_values.size()));
+        for (int ch = 0; ch < display_channels && ch < channel_count; ++ch) {
+            char label[32];
+            snprintf(label, sizeof(label), "Ch%d", ch);
+            ImPlot::SetNextLineStyle(channelColor(ch, display_channels), 1.0f);
+            
+            if (use_gpu) {
+                ImPlot::PlotDummy(label);
+            } else if (use_frame) {
+                const float* values = frame.channel(ch);
+                if (values) {
+                    // 显示帧为环形窗口，通过 offset 参数从最旧的样本开始绘制
+                    ImPlot::PlotLine(label, time_values, values, static_cast<int>(sample_count),
+                                     0, static_cast<int>(frame.offset));
                 }
+            } else if (envelope_counts[ch] > 0) {
+                ImPlot::PlotLine(label, envelope_times.data() + ch * max_points,
+                                 envelope_values.data() + ch * max_points,
+                                 static_cast<int>(envelope_counts[ch]));
             }
         }
         
+        // 记录当前X轴范围，供非跟随模式下一帧查询包络
+        ImPlotRect limits = ImPlot::GetPlotLimits();
+        view_min = limits.X.Min;
+        view_max = limits.X.Max;
+        
         ImPlot::EndPlot();
     }
     
+    if (ImGui::CollapsingHeader("Spectrum")) {
+        drawSpectrumPanel(dataManager, plot_height, auto_scale);
+    }
+    
     // 性能统计信息
     ImGui::Separator();
-    ImGui::Text("Performance: %.1f FPS | Display %d/%zu channels | %zu data points | Sample Rate: 22.5kHz", 
+    ImGui::Text("Performance: %.1f FPS | Display %d/%zu channels | %zu data points | History %.2f s | Sample Rate: %.4gkHz | %s",
                 ImGui::GetIO().Framerate, 
                 display_channels, 
-                channel_data.size(),
-                time_values.size());
-}
\ No newline at end of file
+                dataManager.channelCount(),
+                use_frame ? sample_count : stacked_view ? strip_chart.columns()
+                                         : !line_view ? static_cast<size_t>(heatmap_uploaded_end - heatmap_uploaded_start)
+                                         : (envelope_counts.empty() ? 0 : envelope_counts[0]),
+                history.last_time - history.first_time,
+                dataManager.sampleRate() / 1000.0,
+                stacked_view ? "Stacked lanes" : !line_view ? "Heatmap" : use_gpu ? "GPU traces" : "ImPlot lines");
+    
+    // 接收统计：每秒根据累计计数计算一次速率
+    static SubscriberStats last_stats;
+    static double last_stats_time = 0.0;
+    static double packets_per_sec = 0.0, bytes_per_sec = 0.0, recv_per_sec = 0.0, syscalls_per_sec = 0.0;
+    double now = ImGui::GetTime();
+    if (subscriber && now - last_stats_time >= 1.0) {
+        SubscriberStats stats = subscriber->getStats();
+        double elapsed = now - last_stats_time;
+        packets_per_sec = (stats.packets - last_stats.packets) / elapsed;
+        bytes_per_sec = (stats.bytes - last_stats.bytes) / elapsed;
+        recv_per_sec = (stats.recv_calls - last_stats.recv_calls) / elapsed;
+        syscalls_per_sec = (stats.syscalls - last_stats.syscalls) / elapsed;
+        last_stats = stats;
+        last_stats_time = now;
+    }
+    ImGui::Text("Receive [%s]: %.0f packets/s | %.2f MB/s | %.0f recv/s | %.1f packets/recv | %.0f syscalls/s",
+                subscriber ? subscriber->name() : "none",
+                packets_per_sec, bytes_per_sec / (1024.0 * 1024.0), recv_per_sec,
+                recv_per_sec > 0 ? packets_per_sec / recv_per_sec : 0.0, syscalls_per_sec);
+    if (streams.size() > 1) {
+        ImGui::SameLine();
+        ImGui::Text("| %llu/%zu connections | %llu waiting",
+                    static_cast<unsigned long long>(last_stats.connections), streams.size(),
+                    static_cast<unsigned long long>(last_stats.waiting));
+    }
+    if (last_stats.dropped + last_stats.invalid + last_stats.reordered > 0) {
+        ImGui::SameLine();
+        ImGui::Text("| %llu dropped by kernel | %llu invalid | %llu reordered",
+                    static_cast<unsigned long long>(last_stats.dropped),
+                    static_cast<unsigned long long>(last_stats.invalid),
+                    static_cast<unsigned long long>(last_stats.reordered));
+    }
+    
+    if (queue) {
+        PacketQueueStats queue_stats = queue->getStats();
+        ImGui::Text("Queue [%s]: %zu/%zu slots (%zu packets) | high-water %zu slots (%zu packets) | "
+                    "%llu dropped | %llu blocked",
+                    overflowPolicyName(queue->policy()),
+                    queue_stats.depth_slots, queue_stats.slot_count, queue_stats.depth_packets,
+                    queue_stats.high_water_slots, queue_stats.high_water_packets,
+                    static_cast<unsigned long long>(queue_stats.dropped_newest + queue_stats.dropped_oldest),
+                    static_cast<unsigned long long>(queue_stats.blocked_pushes));
+    }
+    
+    if (dataManager.streamDescriptor().packet_header) {
+        PacketLossStats loss = dataManager.getPacketStats();
+        ImGui::Text("Sequence: %llu lost | %llu duplicate | %llu out of order | %llu invalid | %llu gaps (%.3f s) | %llu resyncs",
+                    static_cast<unsigned long long>(loss.lost_packets),
+                    static_cast<unsigned long long>(loss.duplicate_packets),
+                    static_cast<unsigned long long>(loss.reordered_packets),
+                    static_cast<unsigned long long>(loss.invalid_packets),
+                    static_cast<unsigned long long>(loss.gaps),
+                    loss.gap_samples / dataManager.sampleRate(),
+                    static_cast<unsigned long long>(loss.resyncs));
+    }
+    
+    if (recorder) {
+        RecorderStats record_stats = recorder->getStats();
+        ImGui::Text("Record: %s | %llu packets | %.1f MB written (%s, %.2fx) | %llu dropped%s",
+                    recorder->path().c_str(),
+                    static_cast<unsigned long long>(record_stats.packets),
+                    record_stats.bytes_written / (1024.0 * 1024.0),
+                    chunkCodecName(recorder->codec()),
+                    record_stats.bytes_written ? double(record_stats.packet_bytes) / record_stats.bytes_written : 0.0,
+                    static_cast<unsigned long long>(record_stats.dropped_packets),
+                    record_stats.write_error ? " | WRITE ERROR" : "");
+    }
+    
+    if (dataManager.isHistorySpillEnabled()) {
+        HistorySpillStats spill_stats = dataManager.getHistorySpillStats();
+        ImGui::Text("History spill: %llu blocks | %.1f MB on disk (%.2fx) | %llu evicted | %llu missed",
+                    static_cast<unsigned long long>(spill_stats.blocks),
+                    spill_stats.stored_bytes / (1024.0 * 1024.0),
+                    spill_stats.stored_bytes ? double(spill_stats.raw_bytes) / spill_stats.stored_bytes : 0.0,
+                    static_cast<unsigned long long>(spill_stats.evicted_blocks),
+                    static_cast<unsigned long long>(spill_stats.missed_blocks));
+    }
+}
+
+void MainController::drawStackedView(const DataManager& dataManager, double view_start, double view_end,
+                                     float height, bool auto_scale) {
+    static float lane_height = 24.0f;
+    ImGui::SetNextItemWidth(200.0f);
+    ImGui::SliderFloat("Lane Height", &lane_height, StripChart::MIN_LANE_HEIGHT, 120.0f, "%.0f px");
+    lane_height = std::max(lane_height, StripChart::MIN_LANE_HEIGHT);
+    
+    // 道高与视图高度的下限/上限决定了每帧最多处理 StripChart::MAX_VISIBLE_LANES 道
+    const int channel_count = static_cast<int>(dataManager.channelCount());
+    ImGui::BeginChild("StackedLanes", ImVec2(-1, std::min(height, StripChart::MAX_VIEW_HEIGHT)), true);
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    const float label_width = ImGui::CalcTextSize("Ch0000").x + ImGui::GetStyle().ItemSpacing.x;
+    const float lane_width = ImGui::GetContentRegionAvail().x;
+    const size_t columns = static_cast<size_t>(std::max(lane_width - label_width, 16.0f));
+    const float pad = std::min(2.0f, lane_height * 0.1f);
+    
+    // 只处理滚动区域内可见的道：每帧代价为 可见道数 x 像素列数，与通道总数和采样率无关
+    size_t drawn_first = 0, drawn_lanes = 0;
+    ImGuiListClipper clipper;
+    clipper.Begin(channel_count, lane_height);
+    while (clipper.Step()) {
+        const size_t first = static_cast<size_t>(clipper.DisplayStart);
+        const size_t lanes = static_cast<size_t>(clipper.DisplayEnd - clipper.DisplayStart);
+        strip_chart.update(dataManager, first, lanes, view_start, view_end, columns);
+        if (drawn_lanes == 0) drawn_first = first;
+        drawn_lanes += strip_chart.laneCount();
+        
+        // 不自动缩放时所有可见道使用同一量程，便于比较幅度
+        float shared_low = FLT_MAX, shared_high = -FLT_MAX;
+        for (size_t lane = 0; lane < strip_chart.laneCount(); ++lane) {
+            shared_low = std::min(shared_low, strip_chart.laneLow(lane));
+            shared_high = std::max(shared_high, strip_chart.laneHigh(lane));
+        }
+        
+        for (size_t lane = 0; lane < strip_chart.laneCount(); ++lane) {
+            const int ch = static_cast<int>(first + lane);
+            const ImVec2 top_left = ImGui::GetCursorScreenPos();
+            ImGui::Dummy(ImVec2(lane_width, lane_height));
+            if (ch % 2) {
+                draw_list->AddRectFilled(top_left, ImVec2(top_left.x + lane_width, top_left.y + lane_height),
+                                         ImGui::GetColorU32(ImGuiCol_FrameBg));
+            }
+            char label[16];
+            std::snprintf(label, sizeof(label), "Ch%d", ch);
+            draw_list->AddText(ImVec2(top_left.x, top_left.y + (lane_height - ImGui::GetTextLineHeight()) * 0.5f),
+                               ImGui::GetColorU32(ImGuiCol_Text), label);
+            
+            const float low = auto_scale ? strip_chart.laneLow(lane) : shared_low;
+            const float high = auto_scale ? strip_chart.laneHigh(lane) : shared_high;
+            if (high < low) continue;
+            // 平直的信号画在道的中线上
+            const float span = high > low ? high - low : 1.0f;
+            const float y_scale = (lane_height - 2.0f * pad) / span;
+            const float y_base = high > low ? top_left.y + pad + high * y_scale
+                                            : top_left.y + lane_height * 0.5f + low * y_scale;
+            
+            // 每列一条竖线（1像素宽的矩形，无抗锯齿），相邻列的区间已衔接
+            const ImU32 color = ImGui::GetColorU32(channelColor(ch, channel_count));
+            const float* mins = strip_chart.laneMin(lane);
+            const float* maxs = strip_chart.laneMax(lane);
+            const float x0 = top_left.x + label_width;
+            for (size_t c = 0; c < strip_chart.columns(); ++c) {
+                if (std::isnan(mins[c])) continue;
+                const float y_top = y_base - maxs[c] * y_scale;
+                const float y_bottom = std::max(y_base - mins[c] * y_scale, y_top + 1.0f);
+                draw_list->AddRectFilled(ImVec2(x0 + c, y_top), ImVec2(x0 + c + 1.0f, y_bottom), color);
+            }
+        }
+    }
+    ImGui::EndChild();
+    
+    ImGui::Text("Stacked lanes: %.3f - %.3f s | %zu lanes drawn from Ch%zu of %d | %zu columns",
+                view_start, view_end, drawn_lanes, drawn_first, channel_count, columns);
+}
+
+void MainController::drawHeatmapView(DataManager& dataManager, double view_start, double view_end, float height) {
+    // 每列 10ms，结果环保留 2048 列（约20秒，长于原始环形缓冲）；计算线程在首次显示时启动
+    const size_t column_samples = std::max<size_t>(1, static_cast<size_t>(dataManager.sampleRate() * 0.01));
+    ChannelHeatmap* heatmap = dataManager.enableHeatmap(column_samples, 2048);
+    const size_t channels = heatmap->channelCount();
+    const double column_seconds = heatmap->columnSamples() / dataManager.sampleRate();
+    
+    static int metric = 0;
+    static float range_db[2] = {-60.0f, 0.0f};
+    ImGui::SetNextItemWidth(120.0f);
+    bool recolor = ImGui::Combo("Metric", &metric, "RMS\0Peak\0");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(200.0f);
+    recolor |= ImGui::DragFloatRange2("Range (dB)", &range_db[0], &range_db[1], 0.5f, -160.0f, 40.0f, "%.0f dB");
+    heatmap->setMetric(metric == 1 ? HeatmapMetric::Peak : HeatmapMetric::Rms);
+    
+    if (heatmap_lut.empty()) {
+        heatmap_lut.resize(256);
+        for (size_t i = 0; i < heatmap_lut.size(); ++i) {
+            heatmap_lut[i] = ImGui::ColorConvertFloat4ToU32(ImPlot::SampleColormap(i / 255.0f, ImPlotColormap_Viridis));
+        }
+    }
+    if (!heatmap_texture.resize(static_cast<int>(heatmap->columnCapacity()), static_cast<int>(channels))) {
+        return;
+    }
+    // 切换数据流后列号不再连续，整幅重新上传
+    if (heatmap != heatmap_source) {
+        heatmap_source = heatmap;
+        heatmap_uploaded_start = 0;
+        heatmap_uploaded_end = 0;
+    }
+    
+    // 只上传计算线程新产生的列；调整量程时重新着色全部保留的列
+    const uint64_t start = heatmap->startColumn();
+    const uint64_t end = heatmap->endColumn();
+    const uint64_t from = recolor || heatmap_uploaded_end < start ? start : heatmap_uploaded_end;
+    if (end > from) {
+        const size_t count = static_cast<size_t>(end - from);
+        heatmap_values.resize(channels * count);
+        heatmap_pixels.resize(channels * count);
+        if (heatmap->copyColumns(from, count, heatmap_values.data())) {
+            const float db_low = range_db[0];
+            const float db_scale = 255.0f / std::max(range_db[1] - range_db[0], 1e-3f);
+            for (size_t i = 0; i < heatmap_values.size(); ++i) {
+                const float value = heatmap_values[i];
+                if (!(value >= 0.0f)) {
+                    heatmap_pixels[i] = 0;      // NaN（缺口、落后）透明
+                    continue;
+                }
+                const float db = 20.0f * std::log10(std::max(value, 1e-12f));
+                const float index = std::min(std::max((db - db_low) * db_scale, 0.0f), 255.0f);
+                heatmap_pixels[i] = heatmap_lut[static_cast<size_t>(index)];
+            }
+            heatmap_texture.uploadColumns(from, static_cast<int>(count), heatmap_pixels.data());
+            if (from == start) heatmap_uploaded_start = start;
+            heatmap_uploaded_end = end;
+        }
+    }
+    
+    if (ImPlot::BeginPlot("Channel Heatmap###Heatmap", ImVec2(-80.0f, height))) {
+        ImPlot::SetupAxes("Time (s)", "Channel");
+        ImPlot::SetupAxisLimits(ImAxis_X1, view_start, view_end, ImGuiCond_Always);
+        ImPlot::SetupAxisLimits(ImAxis_Y1, 0.0, static_cast<double>(channels), ImGuiCond_Always);
+        
+        // 纹理中保留的列与可见时间范围的交集；u 坐标先减去纹理宽度的整数倍，保持浮点精度
+        const uint64_t width = static_cast<uint64_t>(heatmap_texture.width());
+        const uint64_t kept = std::max(heatmap_uploaded_start,
+                                       heatmap_uploaded_end > width ? heatmap_uploaded_end - width : 0);
+        const double origin = dataManager.sampleTime(0);
+        const double first_visible = std::floor((view_start - origin) / column_seconds);
+        const double last_visible = std::ceil((view_end - origin) / column_seconds);
+        const uint64_t c0 = std::max<uint64_t>(kept, static_cast<uint64_t>(std::max(first_visible, 0.0)));
+        const uint64_t c1 = std::min<uint64_t>(heatmap_uploaded_end,
+                                               static_cast<uint64_t>(std::max(last_visible, 0.0)));
+        if (c1 > c0) {
+            const uint64_t wrap = c0 / width * width;
+            ImPlot::PlotImage("##heatmap", (ImTextureID)(intptr_t)heatmap_texture.id(),
+                              ImPlotPoint(origin + c0 * column_seconds, 0.0),
+                              ImPlotPoint(origin + c1 * column_seconds, static_cast<double>(channels)),
+                              ImVec2(static_cast<float>(double(c0 - wrap) / width), 0.0f),
+                              ImVec2(static_cast<float>(double(c1 - wrap) / width), 1.0f));
+        }
+        ImPlot::EndPlot();
+    }
+    ImGui::SameLine();
+    ImPlot::ColormapScale("dB", range_db[0], range_db[1], ImVec2(70.0f, height), "%.0f", 0, ImPlotColormap_Viridis);
+    
+    HeatmapStats stats = heatmap->getStats();
+    ImGui::Text("Heatmap [%s, %.0f ms columns]: %llu columns | worker %.2f%% of one core | %llu missed",
+                heatmapMetricName(heatmap->metric()), column_seconds * 1000.0,
+                static_cast<unsigned long long>(stats.columns),
+                stats.columns ? 100.0 * stats.busy_seconds / (stats.columns * column_seconds) : 0.0,
+                static_cast<unsigned long long>(stats.missed_columns));
+}
+
+void MainController::drawFilterPanel(double sample_rate) {
+    // 每行一级：勾选启用，参数在右侧；顺序固定为 直流隔离 → 陷波 → 高通 → 低通 → 带通 → 抽取 FIR
+    static bool dc_block = false, notch = false, high_pass = false, low_pass = false, band_pass = false, fir = false;
+    static float dc_cutoff = 0.5f;
+    static int mains_index = 0;
+    static float notch_q = 30.0f;
+    static int notch_harmonics = 1;
+    static float high_cutoff = 5.0f, low_cutoff = 2000.0f;
+    static float band_center = 1000.0f, band_q = 0.7071f;
+    static float fir_cutoff = 1000.0f;
+    static int fir_taps = 63, fir_decimation = 4;
+    const float nyquist = static_cast<float>(sample_rate / 2.0);
+    
+    bool changed = false;
+    changed |= ImGui::Checkbox("DC Block", &dc_block);
+    ImGui::SameLine(160.0f);
+    ImGui::SetNextItemWidth(160.0f);
+    changed |= ImGui::SliderFloat("Cutoff (Hz)##dc", &dc_cutoff, 0.05f, 20.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+    
+    changed |= ImGui::Checkbox("Notch", &notch);
+    ImGui::SameLine(160.0f);
+    ImGui::SetNextItemWidth(80.0f);
+    changed |= ImGui::Combo("Mains##notch", &mains_index, "50 Hz\0" "60 Hz\0");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    changed |= ImGui::SliderFloat("Q##notch", &notch_q, 1.0f, 100.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    // 其余 5 级全部启用时谐波陷波最多 3 级，不超过 ChannelFilterBank::MAX_STAGES
+    changed |= ImGui::SliderInt("Harmonics", &notch_harmonics, 1, 3);
+    
+    changed |= ImGui::Checkbox("High-pass", &high_pass);
+    ImGui::SameLine(160.0f);
+    ImGui::SetNextItemWidth(160.0f);
+    changed |= ImGui::SliderFloat("Cutoff (Hz)##hp", &high_cutoff, 0.1f, nyquist, "%.1f", ImGuiSliderFlags_Logarithmic);
+    
+    changed |= ImGui::Checkbox("Low-pass", &low_pass);
+    ImGui::SameLine(160.0f);
+    ImGui::SetNextItemWidth(160.0f);
+    changed |= ImGui::SliderFloat("Cutoff (Hz)##lp", &low_cutoff, 1.0f, nyquist, "%.0f", ImGuiSliderFlags_Logarithmic);
+    
+    changed |= ImGui::Checkbox("Band-pass", &band_pass);
+    ImGui::SameLine(160.0f);
+    ImGui::SetNextItemWidth(160.0f);
+    changed |= ImGui::SliderFloat("Center (Hz)##bp", &band_center, 1.0f, nyquist, "%.0f", ImGuiSliderFlags_Logarithmic);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    changed |= ImGui::SliderFloat("Q##bp", &band_q, 0.1f, 20.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+    
+    changed |= ImGui::Checkbox("Decimating FIR", &fir);
+    ImGui::SameLine(160.0f);
+    ImGui::SetNextItemWidth(160.0f);
+    // 截止频率不超过抽取后的奈奎斯特频率（ChannelFilterBank 同样会限制）
+    fir_cutoff = std::min(fir_cutoff, nyquist / fir_decimation);
+    changed |= ImGui::SliderFloat("Cutoff (Hz)##fir", &fir_cutoff, 10.0f, nyquist / fir_decimation, "%.0f",
+                                  ImGuiSliderFlags_Logarithmic);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    changed |= ImGui::SliderInt("Taps", &fir_taps, 3, static_cast<int>(ChannelFilterBank::MAX_FIR_TAPS));
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    changed |= ImGui::SliderInt("Decimation", &fir_decimation, 1, static_cast<int>(ChannelFilterBank::MAX_DECIMATION));
+    
+    if (changed) {
+        std::vector<FilterStage> chain;
+        auto add = [&chain](FilterType type, double frequency, double q) {
+            FilterStage stage;
+            stage.type = type;
+            stage.frequency = frequency;
+            stage.q = q;
+            chain.push_back(stage);
+        };
+        if (dc_block) add(FilterType::DcBlock, dc_cutoff, 0.0);
+        if (notch) {
+            // 谐波的 Q 同比放大，保持各陷波的 -3dB 带宽一致
+            const double mains = mains_index == 1 ? 60.0 : 50.0;
+            for (int k = 1; k <= notch_harmonics && mains * k < nyquist; ++k) {
+                add(FilterType::Notch, mains * k, notch_q * k);
+            }
+        }
+        if (high_pass) add(FilterType::HighPass, high_cutoff, 0.7071);
+        if (low_pass) add(FilterType::LowPass, low_cutoff, 0.7071);
+        if (band_pass) add(FilterType::BandPass, band_center, band_q);
+        if (fir) {
+            FilterStage stage;
+            stage.type = FilterType::DecimatingFir;
+            stage.frequency = fir_cutoff;
+            stage.taps = static_cast<size_t>(fir_taps);
+            stage.decimation = static_cast<size_t>(fir_decimation);
+            chain.push_back(stage);
+        }
+        for (auto& stream : streams) {
+            stream->setFilterChain(chain);
+        }
+    }
+    
+    const std::vector<FilterStage> active = streams[active_stream]->filterChain();
+    if (active.empty()) {
+        ImGui::TextDisabled("No filters: traces show raw samples");
+    } else {
+        std::string summary;
+        for (const FilterStage& stage : active) {
+            char text[64];
+            std::snprintf(text, sizeof(text), "%s%s %.1f Hz", summary.empty() ? "" : " -> ",
+                          filterTypeName(stage.type), stage.frequency);
+            summary += text;
+        }
+        ImGui::Text("Chain: %s (history recorded before this change is unfiltered)", summary.c_str());
+    }
+}
+
+void MainController::drawSpectrumPanel(DataManager& dataManager, float height, bool auto_scale) {
+    // 计算线程在首次展开时启动；控件变化或切换数据流时重新配置（重新开始平均）
+    SpectrumAnalyzer* analyzer = dataManager.enableSpectrum();
+    static const char* const size_names[] = {"1024", "2048", "4096", "8192", "16384", "32768", "65536"};
+    static int size_index = 2;
+    static int window_index = 0;
+    static float overlap_percent = 50.0f;
+    static int averages = 8;
+    static int first_channel = 0;
+    static int spectrum_channels = 4;
+    static bool log_frequency = true;
+    const int channel_count = static_cast<int>(dataManager.channelCount());
+    
+    bool changed = analyzer != spectrum_source;
+    ImGui::SetNextItemWidth(100.0f);
+    changed |= ImGui::Combo("FFT Size", &size_index, size_names, IM_ARRAYSIZE(size_names));
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(110.0f);
+    changed |= ImGui::Combo("Window", &window_index, "Hann\0Blackman\0");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    changed |= ImGui::SliderFloat("Overlap", &overlap_percent, 0.0f,
+                                  static_cast<float>(SpectrumAnalyzer::MAX_OVERLAP * 100.0), "%.0f%%");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    changed |= ImGui::SliderInt("Averages", &averages, 1, static_cast<int>(SpectrumAnalyzer::MAX_AVERAGES));
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    changed |= ImGui::SliderInt("First Channel", &first_channel, 0, channel_count - 1);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    changed |= ImGui::SliderInt("Channels##spectrum", &spectrum_channels, 1, 16);
+    ImGui::SameLine();
+    ImGui::Checkbox("Log Frequency", &log_frequency);
+    
+    if (changed) {
+        SpectrumConfig config;
+        config.fft_size = size_t(1024) << size_index;
+        config.window = window_index == 1 ? SpectrumWindow::Blackman : SpectrumWindow::Hann;
+        config.overlap = overlap_percent / 100.0;
+        config.averages = static_cast<size_t>(averages);
+        config.channels.clear();
+        for (int ch = first_channel; ch < std::min(first_channel + spectrum_channels, channel_count); ++ch) {
+            config.channels.push_back(static_cast<size_t>(ch));
+        }
+        analyzer->configure(config);
+        spectrum_source = analyzer;
+    }
+    
+    const SpectrumSnapshot& snapshot = analyzer->acquireSnapshot();
+    const double nyquist = dataManager.sampleRate() / 2.0;
+    if (ImPlot::BeginPlot("Power Spectral Density###Spectrum", ImVec2(-1, height))) {
+        ImPlot::SetupAxes("Frequency (Hz)", "PSD (dB/Hz)", 0, auto_scale ? ImPlotAxisFlags_AutoFit : 0);
+        if (log_frequency) {
+            ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+        }
+        ImPlot::SetupAxisLimits(ImAxis_X1, log_frequency ? 1.0 : 0.0, nyquist, ImGuiCond_Once);
+        ImPlot::SetupAxisLimits(ImAxis_Y1, -140.0, 0.0, ImGuiCond_Once);
+        
+        if (snapshot.generation > 0 && snapshot.bins > 1) {
+            // 按上一帧的坐标范围抽取，每个像素列一个点，绘制代价与 FFT 长度无关
+            const float width = std::max(ImPlot::GetPlotSize().x, 64.0f);
+            const size_t capacity = static_cast<size_t>(width) + 4;
+            spectrum_freqs.resize(capacity);
+            spectrum_values.resize(capacity);
+            const size_t first_bin = log_frequency ? 1 : 0;   // 对数坐标下跳过直流
+            for (size_t i = 0; i < snapshot.channels.size(); ++i) {
+                const size_t count = decimateSpectrum(snapshot.channel(i), first_bin, snapshot.bins, snapshot.bin_width,
+                                                      spectrum_view_min, spectrum_view_max, log_frequency, width,
+                                                      spectrum_freqs.data(), spectrum_values.data());
+                char label[32];
+                std::snprintf(label, sizeof(label), "Ch%zu", snapshot.channels[i]);
+                ImPlot::SetNextLineStyle(channelColor(static_cast<int>(snapshot.channels[i]), channel_count), 1.0f);
+                ImPlot::PlotLine(label, spectrum_freqs.data(), spectrum_values.data(), static_cast<int>(count));
+            }
+        }
+        ImPlotRect limits = ImPlot::GetPlotLimits();
+        spectrum_view_min = limits.X.Min;
+        spectrum_view_max = limits.X.Max;
+        ImPlot::EndPlot();
+    }
+    
+    SpectrumStats stats = analyzer->getStats();
+    ImGui::Text("Spectrum [%zu-point %s, %.3f Hz bins, %zu/%d averaged]: %llu transforms | %.3f ms per transform | "
+                "%llu missed",
+                snapshot.fft_size, spectrumWindowName(snapshot.window), snapshot.bin_width, snapshot.averaged, averages,
+                static_cast<unsigned long long>(stats.transforms),
+                stats.transforms ? stats.busy_seconds * 1000.0 / stats.transforms : 0.0,
+                static_cast<unsigned long long>(stats.missed_segments));
+}
@@ -0,0 +1,205 @@
+#include "UI/TraceRenderer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// 与 traceVertex() 逐项一致
+const char* VERTEX_SHADER = R"(#version 330 core
+uniform samplerBuffer u_samples;
+uniform samplerBuffer u_styles;
+uniform int u_channels;
+uniform int u_stride;
+uniform int u_start;
+uniform vec4 u_transform;
+out vec4 v_color;
+out float v_valid;
+void main() {
+    int channel = gl_InstanceID;
+    int slot = (u_start + gl_VertexID) % u_stride;
+    float value = texelFetch(u_samples, slot * u_channels + channel).r;
+    vec4 style = texelFetch(u_styles, channel * 2);
+    v_color = texelFetch(u_styles, channel * 2 + 1);
+    v_valid = isnan(value) ? 0.0 : 1.0;
+    float shown = isnan(value) ? 0.0 : value * style.y + style.x;
+    gl_Position = vec4(float(gl_VertexID) * u_transform.x + u_transform.y, shown * u_transform.z + u_transform.w,
+                       0.0, 1.0);
+}
+)";
+
+// 与 NaN 样本相连的线段上 v_valid 小于1，整段丢弃
+const char* FRAGMENT_SHADER = R"(#version 330 core
+in vec4 v_color;
+in float v_valid;
+out vec4 out_color;
+void main() {
+    if (v_valid < 0.999) discard;
+    out_color = v_color;
+}
+)";
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Trace shader compile failed: " << log << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+} // namespace
+
+TraceRenderer::~TraceRenderer() {
+    if (program) glDeleteProgram(program);
+    if (vao) glDeleteVertexArrays(1, &vao);
+    if (sample_texture) glDeleteTextures(1, &sample_texture);
+    if (style_texture) glDeleteTextures(1, &style_texture);
+    if (sample_buffer) glDeleteBuffers(1, &sample_buffer);
+    if (style_buffer) glDeleteBuffers(1, &style_buffer);
+}
+
+bool TraceRenderer::init() {
+    GLuint vertex = compileShader(GL_VERTEX_SHADER, VERTEX_SHADER);
+    GLuint fragment = compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+    if (!vertex || !fragment) {
+        if (vertex) glDeleteShader(vertex);
+        if (fragment) glDeleteShader(fragment);
+        return false;
+    }
+    GLuint linked = glCreateProgram();
+    glAttachShader(linked, vertex);
+    glAttachShader(linked, fragment);
+    glLinkProgram(linked);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    GLint ok = GL_FALSE;
+    glGetProgramiv(linked, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetProgramInfoLog(linked, sizeof(log), nullptr, log);
+        std::cerr << "Trace shader link failed: " << log << std::endl;
+        glDeleteProgram(linked);
+        return false;
+    }
+
+    u_samples = glGetUniformLocation(linked, "u_samples");
+    u_styles = glGetUniformLocation(linked, "u_styles");
+    u_channels = glGetUniformLocation(linked, "u_channels");
+    u_stride = glGetUniformLocation(linked, "u_stride");
+    u_start = glGetUniformLocation(linked, "u_start");
+    u_transform = glGetUniformLocation(linked, "u_transform");
+
+    // No vertex attributes: positions come from gl_VertexID / gl_InstanceID, but core profile needs a VAO bound
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &sample_buffer);
+    glGenBuffers(1, &style_buffer);
+    glGenTextures(1, &sample_texture);
+    glGenTextures(1, &style_texture);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, sample_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(float), nullptr, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, sample_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, sample_buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, style_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, 8 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, style_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, style_buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    program = linked;
+    return true;
+}
+
+void TraceRenderer::update(const DisplayFrame& frame) {
+    if (!program) return;
+    TraceUploadRange ranges[2];
+    bool whole = false;
+    const size_t range_count = trace_uploader.update(frame, ranges, whole);
+    if (range_count == 0) return;
+
+    const size_t channels = trace_uploader.channelCount();
+    glBindBuffer(GL_TEXTURE_BUFFER, sample_buffer);
+    if (whole) {
+        // Orphan: the driver hands out fresh storage while the previous frame may still be drawing from the old one
+        glBufferData(GL_TEXTURE_BUFFER, trace_uploader.bufferFloats() * sizeof(float), nullptr, GL_STREAM_DRAW);
+    }
+    for (size_t r = 0; r < range_count; ++r) {
+        const GLintptr offset = static_cast<GLintptr>(ranges[r].slot_first * channels * sizeof(float));
+        const GLsizeiptr size = static_cast<GLsizeiptr>(ranges[r].slot_count * channels * sizeof(float));
+        void* dst = glMapBufferRange(GL_TEXTURE_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        if (!dst) continue;
+        std::memcpy(dst, ranges[r].data, static_cast<size_t>(size));
+        glUnmapBuffer(GL_TEXTURE_BUFFER);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void TraceRenderer::setChannelStyles(const std::vector<TraceChannelStyle>& new_styles) {
+    if (new_styles.size() == styles.size() &&
+        std::equal(new_styles.begin(), new_styles.end(), styles.begin(),
+                   [](const TraceChannelStyle& a, const TraceChannelStyle& b) {
+                       return std::memcmp(&a, &b, sizeof(a)) == 0;
+                   })) {
+        return;
+    }
+    styles = new_styles;
+    styles_dirty = true;
+}
+
+bool TraceRenderer::prepare(const TraceTransform& transform) {
+    if (!program || trace_uploader.sampleCount() < 2 || styles.size() < trace_uploader.channelCount()) return false;
+
+    if (styles_dirty) {
+        // Two RGBA32F texels per channel: (offset, scale, 0, 0) and the colour
+        std::vector<float> texels(styles.size() * 8, 0.0f);
+        for (size_t c = 0; c < styles.size(); ++c) {
+            texels[c * 8 + 0] = styles[c].offset;
+            texels[c * 8 + 1] = styles[c].scale;
+            std::memcpy(&texels[c * 8 + 4], styles[c].color, sizeof(styles[c].color));
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, style_buffer);
+        glBufferData(GL_TEXTURE_BUFFER, texels.size() * sizeof(float), texels.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        styles_dirty = false;
+    }
+
+    pending_transform = transform;
+    pending_start = trace_uploader.startSlot();
+    pending_count = trace_uploader.sampleCount();
+    return true;
+}
+
+void TraceRenderer::render(int x, int y, int width, int height) {
+    if (!program || pending_count < 2 || width <= 0 || height <= 0) return;
+
+    glViewport(x, y, width, height);
+    glScissor(x, y, width, height);
+    glUseProgram(program);
+    glBindVertexArray(vao);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, sample_texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, style_texture);
+    glUniform1i(u_samples, 0);
+    glUniform1i(u_styles, 1);
+    glUniform1i(u_channels, static_cast<GLint>(trace_uploader.channelCount()));
+    glUniform1i(u_stride, static_cast<GLint>(trace_uploader.stride()));
+    glUniform1i(u_start, static_cast<GLint>(pending_start));
+    glUniform4f(u_transform, pending_transform.x_scale, pending_transform.x_bias, pending_transform.y_scale,
+                pending_transform.y_bias);
+    glDrawArraysInstanced(GL_LINE_STRIP, 0, static_cast<GLsizei>(pending_count),
+                          static_cast<GLsizei>(trace_uploader.channelCount()));
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
@@ -13,7 +13,13 @@ static void glfw_error_callback(int error, const char* description) { //
 }
 
 // 使用重构后的MainController架构的主函数
-int main() {
+int main(int argc, char** argv) {
+    // 解析接收端配置（--transport socket|zmq 等）
+    SubscriberConfig subscriber_config;
+    if (!parseSubscriberArgs(argc, argv, subscriber_config)) {
+        return 1;
+    }
+
     // 设置GLFW错误回调函数
     glfwSetErrorCallback(glfw_error_callback);
 
@@ -54,13 +60,40 @@ int main() {
     ImGui_ImplOpenGL3_Init("#version 330 core");
 
     // 创建主控制器实例（使用重构后的架构）
-    
-    MainController mainController("127.0.0.1", 5555);
+    MainController mainController(subscriber_config);
     
     std::cout << "SensorMonitorApp started with refactored architecture" << std::endl;
     std::cout << "Features:" << std::endl;
-    std::cout << "- 128 channels @ 22.5kHz sampling rate" << std::endl;
+    std::cout << "- " << subscriber_config.stream.channel_count << " channels @ "
+              << subscriber_config.stream.sample_rate / 1000.0 << "kHz sampling rate ("
+              << sampleTypeName(subscriber_config.stream.sample_type) << ", "
+              << subscriber_config.stream.samples_per_packet << " samples/packet"
+              << (subscriber_config.stream.packet_header ? ", sequence headers" : "") << ")" << std::endl;
     std::cout << "- Binary data format support" << std::endl;
+    if (subscriber_config.transport == "socket") {
+        std::cout << "- Socket receive backend: " << socketBackendName(subscriber_config.socket_backend) << std::endl;
+    }
+    if (subscriber_config.transport == "socket" && subscriber_config.streams > 1) {
+        std::cout << "- Up to " << subscriber_config.streams << " concurrent senders on "
+                  << subscriber_config.socket_threads << " receive thread"
+                  << (subscriber_config.socket_threads > 1 ? "s" : "") << std::endl;
+    }
+    if (subscriber_config.transport == "udp") {
+        std::cout << "- UDP receive on " << subscriber_config.host << ":" << subscriber_config.port
+                  << (subscriber_config.multicast_group.empty() ? "" : " (multicast " + subscriber_config.multicast_group + ")")
+                  << ", " << subscriber_config.udp_batch << " datagrams per recvmmsg" << std::endl;
+    }
+    if (!subscriber_config.record_path.empty()) {
+        std::cout << "- Recording to " << subscriber_config.record_path << " ("
+                  << chunkCodecName(subscriber_config.record_codec) << ")" << std::endl;
+    }
+    if (!subscriber_config.history_dir.empty()) {
+        std::cout << "- Spilling history to " << subscriber_config.history_dir << std::endl;
+    }
+    if (subscriber_config.queue_slots > 0) {
+        std::cout << "- Packet queue: " << subscriber_config.queue_slots << " slots x " << PacketQueue::SLOT_PACKETS
+                  << " packets (" << overflowPolicyName(subscriber_config.queue_policy) << ")" << std::endl;
+    }
     std::cout << "- ImPlot-based professional charts" << std::endl;
     std::cout << "- Modular MVC architecture" << std::endl;
     std::cout << "- Play/Pause functionality" << std::endl;
@@ -90,7 +123,8 @@ int main() {
         glfwSwapBuffers(window);
     }
 
-    // 清理资源
+    // 清理资源：GPU 资源在 OpenGL 上下文销毁之前释放（mainController 在 main 结束时才析构）
+    mainController.releaseGraphics();
     ImPlot::DestroyContext();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();